@@ -92,6 +92,8 @@ enum class AspectType : quint64 {
 			Spreadsheet = 0x0412000,
 				LiveDataSource = 0x0412001,
 				MQTTTopic = 0x0412002,
+				LiveDataJoin = 0x0412004,
+				LiveDataRollup = 0x0412008,
 		CantorWorksheet = 0x0420001,
 		Datapicker = 0x0420002,
 		DatapickerImage = 0x0420004,
@@ -33,6 +33,8 @@
 #include "backend/core/Project.h"
 #include "backend/core/Workbook.h"
 #include "backend/core/column/Column.h"
+#include "backend/datasources/LiveDataJoin.h"
+#include "backend/datasources/LiveDataRollup.h"
 #include "backend/datasources/LiveDataSource.h"
 #include "backend/matrix/Matrix.h"
 #include "backend/note/Note.h"
@@ -301,6 +303,20 @@ bool Folder::readChildAspectElement(XmlStreamReader* reader, bool preview) {
 			return false;
 		}
 		addChildFast(liveDataSource);
+	} else if (element_name == QLatin1String("liveDataJoin")) {
+		LiveDataJoin* join = new LiveDataJoin(QString(), true);
+		if (!join->load(reader, preview)) {
+			delete join;
+			return false;
+		}
+		addChildFast(join);
+	} else if (element_name == QLatin1String("liveDataRollup")) {
+		LiveDataRollup* rollup = new LiveDataRollup(QString(), true);
+		if (!rollup->load(reader, preview)) {
+			delete rollup;
+			return false;
+		}
+		addChildFast(rollup);
 	} else if (element_name == QLatin1String("datapicker")) {
 		Datapicker* datapicker = new Datapicker(QString(), true);
 		if (!datapicker->load(reader, preview)) {
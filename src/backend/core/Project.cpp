@@ -27,7 +27,10 @@
  *                                                                         *
  ***************************************************************************/
 #include "backend/core/Project.h"
+#include "backend/core/ProjectArchive.h"
 #include "backend/lib/XmlStreamReader.h"
+#include "backend/datasources/LiveDataJoin.h"
+#include "backend/datasources/LiveDataRollup.h"
 #include "backend/datasources/LiveDataSource.h"
 #include "backend/spreadsheet/Spreadsheet.h"
 #include "backend/worksheet/Worksheet.h"
@@ -54,6 +57,8 @@
 #include <KLocalizedString>
 #include <KMessageBox>
 
+#include <memory>
+
 /**
  * \class Project
  * \ingroup core
@@ -96,6 +101,7 @@ public:
 	QDateTime modificationTime;
 	bool changed{false};
 	bool aspectAddedSignalSuppressed{false};
+	std::shared_ptr<ProjectArchive> archive;	//archive the project is currently saved into or loaded from
 };
 
 Project::Project() : Folder(i18n("Project"), AspectType::Project), d(new Private()) {
@@ -353,19 +359,41 @@ void Project::navigateTo(const QString& path) {
 
 bool Project::isLabPlotProject(const QString& fileName) {
 	return fileName.endsWith(QStringLiteral(".lml"), Qt::CaseInsensitive) || fileName.endsWith(QStringLiteral(".lml.gz"), Qt::CaseInsensitive)
-		|| fileName.endsWith(QStringLiteral(".lml.bz2"), Qt::CaseInsensitive) || fileName.endsWith(QStringLiteral(".lml.xz"), Qt::CaseInsensitive);
+		|| fileName.endsWith(QStringLiteral(".lml.bz2"), Qt::CaseInsensitive) || fileName.endsWith(QStringLiteral(".lml.xz"), Qt::CaseInsensitive)
+		|| isArchive(fileName);
+}
+
+/*!
+ * returns \c true if the project is to be saved as an archive with binary column data
+ * (file ending .lmlz), \c false otherwise.
+ */
+bool Project::isArchive(const QString& fileName) {
+	return fileName.endsWith(QStringLiteral(".lmlz"), Qt::CaseInsensitive);
 }
 
 QString Project::supportedExtensions() {
-	static const QString extensions = "*.lml *.lml.gz *.lml.bz2 *.lml.xz *.LML *.LML.GZ *.LML.BZ2 *.LML.XZ";
+	static const QString extensions = "*.lml *.lml.gz *.lml.bz2 *.lml.xz *.lmlz *.LML *.LML.GZ *.LML.BZ2 *.LML.XZ *.LMLZ";
 	return extensions;
 }
 
+/*!
+ * returns the archive the project is currently saved into or loaded from,
+ * \c nullptr if the project is saved/loaded as plain XML.
+ */
+ProjectArchive* Project::archive() const {
+	return d->archive.get();
+}
+
 //##############################################################################
 //##################  Serialization/Deserialization  ###########################
 //##############################################################################
 
 void Project::save(const QPixmap& thumbnail, QXmlStreamWriter* writer) const {
+	//the data is read completely when saving and the project file is overwritten,
+	//disconnect the columns from the archive the project was loaded from
+	for (auto* column : children<Column>(AbstractAspect::Recursive | AbstractAspect::IncludeHidden))
+		column->detachData();
+
 	//set the version and the modification time to the current values
 	d->version = LVERSION;
 	d->modificationTime = QDateTime::currentDateTime();
@@ -395,6 +423,29 @@ void Project::save(const QPixmap& thumbnail, QXmlStreamWriter* writer) const {
 	save(writer);
 }
 
+/*!
+ * saves the project into the archive \c fileName. The data of the numeric and integer columns
+ * is written as binary blobs, the remaining project XML is written as the manifest of the archive.
+ */
+bool Project::saveArchive(const QPixmap& thumbnail, const QString& fileName) const {
+	auto archive = std::make_shared<ProjectArchive>(fileName);
+	if (!archive->open(QIODevice::WriteOnly))
+		return false;
+
+	QByteArray xml;
+	QBuffer buffer(&xml);
+	buffer.open(QIODevice::WriteOnly);
+	QXmlStreamWriter writer(&buffer);
+
+	d->archive = archive;
+	save(thumbnail, &writer);
+	d->archive.reset();
+
+	const bool rc = archive->writeManifest(xml);
+	archive->close();
+	return rc;
+}
+
 /**
  * \brief Save as XML
  */
@@ -416,8 +467,17 @@ void Project::save(QXmlStreamWriter* writer) const {
 
 bool Project::load(const QString& filename, bool preview) {
 	QIODevice* file;
+	std::shared_ptr<ProjectArchive> archive;
+	if (ProjectArchive::isArchive(filename)) {
+		archive = std::make_shared<ProjectArchive>(filename);
+		file = archive->open(QIODevice::ReadOnly) ? archive->manifest() : nullptr;
+		if (!file) {
+			KMessageBox::error(nullptr, i18n("Sorry. Could not open file for reading."));
+			return false;
+		}
+	}
 	// first try gzip compression, because projects can be gzipped and end with .lml
-	if (filename.endsWith(QLatin1String(".lml"), Qt::CaseInsensitive))
+	else if (filename.endsWith(QLatin1String(".lml"), Qt::CaseInsensitive))
 		file = new KCompressionDevice(filename,KFilterDev::compressionTypeForMimeType("application/x-gzip"));
 	else	// opens filename using file ending
 		file = new KFilterDev(filename);
@@ -427,6 +487,7 @@ bool Project::load(const QString& filename, bool preview) {
 
 	if (!file->open(QIODevice::ReadOnly)) {
 		KMessageBox::error(nullptr, i18n("Sorry. Could not open file for reading."));
+		delete file;
 		return false;
 	}
 
@@ -443,8 +504,12 @@ bool Project::load(const QString& filename, bool preview) {
 	//parse XML
 	XmlStreamReader reader(file);
 	setIsLoading(true);
+	d->archive = archive;
 	rc = this->load(&reader, preview);
+	d->archive.reset();
 	setIsLoading(false);
+	file->close();
+	delete file;
 	if (rc == false) {
 		RESET_CURSOR;
 		QString msg = reader.errorString();
@@ -464,9 +529,6 @@ bool Project::load(const QString& filename, bool preview) {
 // 		KMessageBox::error(this, msg, i18n("Project loading partly failed"));
 	}
 
-	file->close();
-	delete file;
-
 	return true;
 }
 
@@ -522,6 +584,19 @@ bool Project::load(XmlStreamReader* reader, bool preview) {
 		//wait until all columns are decoded from base64-encoded data
 		QThreadPool::globalInstance()->waitForDone();
 
+		//bind the columns to the binary data stored in the project archive, the data is read on first access.
+		//the data of unmodified columns is released again if more than the configured cache size was read.
+		if (d->archive) {
+			KConfig config;
+			const qint64 cacheSize = config.group("Settings_General").readEntry("ProjectDataCacheSize", 2048);
+			d->archive->setCacheSize(cacheSize * 1024 * 1024);
+
+			for (auto* column : children<Column>(AbstractAspect::Recursive | AbstractAspect::IncludeHidden)) {
+				if (!column->setDataArchive(d->archive))
+					reader->raiseWarning(i18n("Failed to read the data of the column '%1'.", column->path()));
+			}
+		}
+
 		//LiveDataSource:
 		//call finalizeLoad() to replace relative with absolute paths if required
 		//and to create columns during the initial read
@@ -531,6 +606,16 @@ bool Project::load(XmlStreamReader* reader, bool preview) {
 			source->finalizeLoad();
 		}
 
+		//LiveDataJoin:
+		//restore the pointers to the joined sources and join their data
+		for (auto* join : children<LiveDataJoin>(AbstractAspect::Recursive))
+			join->finalizeLoad();
+
+		//LiveDataRollup:
+		//restore the pointers to the aggregated columns and aggregate their data
+		for (auto* rollup : children<LiveDataRollup>(AbstractAspect::Recursive))
+			rollup->finalizeLoad();
+
 		//everything is read now.
 		//restore the pointer to the data sets (columns) in xy-curves etc.
 		QVector<Column*> columns = children<Column>(AbstractAspect::Recursive);
@@ -33,6 +33,7 @@
 #include "backend/core/Folder.h"
 #include "backend/lib/macros.h"
 
+class ProjectArchive;
 class QString;
 
 class Project : public Folder {
@@ -77,10 +78,13 @@ public:
 	bool aspectAddedSignalSuppressed() const;
 
 	void save(const QPixmap&, QXmlStreamWriter*) const;
+	bool saveArchive(const QPixmap&, const QString& fileName) const;
 	bool load(XmlStreamReader*, bool preview) override;
 	bool load(const QString&, bool preview = false);
+	ProjectArchive* archive() const;
 
 	static bool isLabPlotProject(const QString& fileName);
+	static bool isArchive(const QString& fileName);
 	static QString supportedExtensions();
 
 public slots:
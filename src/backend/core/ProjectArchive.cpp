@@ -0,0 +1,296 @@
+/***************************************************************************
+    File                 : ProjectArchive.cpp
+    Project              : LabPlot
+    Description          : Container for projects with binary column data
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "backend/core/ProjectArchive.h"
+#include "backend/core/column/ColumnPrivate.h"
+#include "backend/lib/macros.h"
+
+#include <KZip>
+#include <QThread>
+#include <QVector>
+
+#include <algorithm>
+#include <cstring>
+
+/*!
+\class ProjectArchive
+\brief Zip container for LabPlot projects with binary column data.
+
+The archive contains the project XML in the entry "project.xml" (the manifest) and
+the data of the numeric and integer columns as raw little endian blobs in "data/<n>.bin".
+The columns in the manifest only reference their blob, no text encoding/decoding is involved.
+A blob is deflated only if the compression pays off, uncompressed blobs are mapped
+directly from the archive file into the memory when reading.
+
+Columns loaded from the archive read their blob on first access only. The archive keeps track
+of the size of the data read so far and releases the data of the least recently used unmodified
+columns again if the configured cache size is exceeded.
+
+\ingroup core
+*/
+
+static const QString manifestName = QStringLiteral("project.xml");
+static const qint64 blockSize = 64 * 1024;
+
+static void swapBytes(void* data, qint64 count, int elementSize) {
+	auto* bytes = static_cast<char*>(data);
+	for (qint64 i = 0; i < count; ++i)
+		std::reverse(bytes + i * elementSize, bytes + (i + 1) * elementSize);
+}
+
+ProjectArchive::ProjectArchive(const QString& fileName) : m_fileName(fileName), m_zip(new KZip(fileName)), m_file(fileName) {}
+
+ProjectArchive::~ProjectArchive() {
+	close();
+	delete m_zip;
+}
+
+bool ProjectArchive::open(QIODevice::OpenMode mode) {
+	if (!m_zip->open(mode)) {
+		DEBUG("Failed to open the project archive " << m_fileName.toStdString());
+		return false;
+	}
+
+	//the file is only needed for mapping, reading the blobs via the zip device is still possible on failure
+	if (mode == QIODevice::ReadOnly)
+		m_file.open(QIODevice::ReadOnly);
+
+	m_blobCount = 0;
+	return true;
+}
+
+void ProjectArchive::close() {
+	if (m_zip->isOpen())
+		m_zip->close();
+	if (m_file.isOpen())
+		m_file.close();
+}
+
+/*!
+ * writes the project XML. Should be called after all blobs were written.
+ */
+bool ProjectArchive::writeManifest(const QByteArray& xml) {
+	m_zip->setCompression(KZip::DeflateCompression);
+	return m_zip->writeFile(manifestName, xml);
+}
+
+/*!
+ * returns the device to read the project XML from, the caller takes the ownership.
+ */
+QIODevice* ProjectArchive::manifest() const {
+	const KArchiveEntry* entry = m_zip->directory()->entry(manifestName);
+	if (!entry || !entry->isFile()) {
+		DEBUG("No manifest found in the project archive " << m_fileName.toStdString());
+		return nullptr;
+	}
+
+	return static_cast<const KArchiveFile*>(entry)->createDevice();
+}
+
+/*!
+ * writes \c count elements of the size \c elementSize into a new blob.
+ * Returns the name of the blob in the archive or an empty string on failure.
+ */
+QString ProjectArchive::writeBlob(const void* data, qint64 count, int elementSize) {
+	const QString name = QLatin1String("data/") + QString::number(m_blobCount++) + QLatin1String(".bin");
+	const qint64 size = count * elementSize;
+	const char* bytes = static_cast<const char*>(data);
+
+	//compress the blob only if this pays off, checked on the first block of data
+	const int probeSize = (int)std::min(size, blockSize);
+	const QByteArray probe = qCompress(reinterpret_cast<const uchar*>(bytes), probeSize, 1);
+	const bool compress = (probe.size() < 0.8 * probeSize);
+	m_zip->setCompression(compress ? KZip::DeflateCompression : KZip::NoCompression);
+
+	if (!m_zip->prepareWriting(name, QString(), QString(), size))
+		return QString();
+
+	bool rc = true;
+	if (QSysInfo::ByteOrder == QSysInfo::LittleEndian)
+		rc = m_zip->writeData(bytes, size);
+	else {
+		//blobs are stored in little endian byte order
+		for (qint64 offset = 0; rc && offset < size; offset += blockSize) {
+			QByteArray block(bytes + offset, (int)std::min(size - offset, blockSize));
+			swapBytes(block.data(), block.size() / elementSize, elementSize);
+			rc = m_zip->writeData(block.constData(), block.size());
+		}
+	}
+
+	if (!rc || !m_zip->finishWriting(size)) {
+		DEBUG("Failed to write the blob " << name.toStdString());
+		return QString();
+	}
+
+	return name;
+}
+
+/*!
+ * returns \c true if the archive contains the blob \c name with \c count elements of the size \c elementSize.
+ */
+bool ProjectArchive::hasBlob(const QString& name, qint64 count, int elementSize) const {
+	const KArchiveEntry* entry = m_zip->directory()->entry(name);
+	return entry && entry->isFile() && static_cast<const KArchiveFile*>(entry)->size() == count * elementSize;
+}
+
+/*!
+ * reads the blob \c name containing \c count elements of the size \c elementSize into \c data.
+ */
+bool ProjectArchive::readBlob(const QString& name, void* data, qint64 count, int elementSize) {
+	QMutexLocker locker(&m_mutex);
+	const KArchiveEntry* entry = m_zip->directory()->entry(name);
+	if (!entry || !entry->isFile()) {
+		DEBUG("Blob " << name.toStdString() << " not found in the project archive");
+		return false;
+	}
+
+	const auto* file = static_cast<const KZipFileEntry*>(entry);
+	const qint64 size = count * elementSize;
+	if (file->size() != size) {
+		DEBUG("Size of the blob " << name.toStdString() << " doesn't match, expected " << size << ", found " << file->size());
+		return false;
+	}
+	if (size == 0)
+		return true;
+
+	bool rc = false;
+	if (file->encoding() == 0 && m_file.isOpen()) {
+		//stored blob: copy the mapped region of the archive directly into the target
+		uchar* mapped = m_file.map(file->position(), size);
+		if (mapped) {
+			memcpy(data, mapped, size);
+			m_file.unmap(mapped);
+			rc = true;
+		}
+	}
+
+	if (!rc) {
+		QIODevice* device = file->createDevice();
+		if (device) {
+			char* bytes = static_cast<char*>(data);
+			qint64 read = 0;
+			while (read < size) {
+				const qint64 n = device->read(bytes + read, size - read);
+				if (n <= 0)
+					break;
+				read += n;
+			}
+			rc = (read == size);
+			delete device;
+		}
+	}
+
+	if (rc && QSysInfo::ByteOrder != QSysInfo::LittleEndian)
+		swapBytes(data, count, elementSize);
+
+	return rc;
+}
+
+/*!
+ * sets the maximal size in bytes of the column data read from the archive that is kept in the memory.
+ */
+void ProjectArchive::setCacheSize(qint64 size) {
+	QMutexLocker locker(&m_mutex);
+	m_cacheSize = size;
+}
+
+/*!
+ * registers the data of the size \c size read for the column \c column.
+ * Returns \c true if the cache size is exceeded and releaseCachedData() needs to be called.
+ */
+bool ProjectArchive::addCachedData(ColumnPrivate* column, qint64 size) {
+	QMutexLocker locker(&m_mutex);
+	m_cachedSize += size - m_cachedData.value(column, 0);
+	m_cachedData[column] = size;
+
+	if (m_cacheSize <= 0 || m_cachedSize <= m_cacheSize || m_releaseRequested)
+		return false;
+
+	m_releaseRequested = true;
+	return true;
+}
+
+/*!
+ * removes the column \c column from the bookkeeping, called when the column
+ * was modified or deleted and its data is not backed by the archive anymore.
+ */
+void ProjectArchive::removeCachedData(ColumnPrivate* column) {
+	QMutexLocker locker(&m_mutex);
+	m_cachedSize -= m_cachedData.take(column);
+}
+
+/*!
+ * releases the data of the least recently used columns until the size
+ * of the data read from the archive is below the cache size again.
+ * Called from the event loop of the GUI thread, the columns are only accessed there.
+ */
+void ProjectArchive::releaseCachedData() {
+	QVector<ColumnPrivate*> columns;
+	{
+		QMutexLocker locker(&m_mutex);
+		m_releaseRequested = false;
+
+		//code running a nested event loop (e.g. a modal dialog) might still use the data of the columns,
+		//the release is requested again with the next data read
+		if (QThread::currentThread()->loopLevel() > 1)
+			return;
+
+		columns.reserve(m_cachedData.size());
+		for (auto it = m_cachedData.constBegin(); it != m_cachedData.constEnd(); ++it)
+			columns << it.key();
+	}
+
+	std::sort(columns.begin(), columns.end(), [](const ColumnPrivate* a, const ColumnPrivate* b) {
+		return a->lastDataAccess() < b->lastDataAccess();
+	});
+
+	for (auto* column : columns) {
+		{
+			QMutexLocker locker(&m_mutex);
+			if (m_cacheSize <= 0 || m_cachedSize <= m_cacheSize)
+				break;
+		}
+		column->releaseData();	//calls removeCachedData()
+	}
+
+#ifndef NDEBUG
+	QMutexLocker locker(&m_mutex);
+	DEBUG("ProjectArchive::releaseCachedData() size of the cached data " << m_cachedSize);
+#endif
+}
+
+/*!
+ * returns \c true if the file \c fileName is a project archive (zip file), \c false otherwise.
+ */
+bool ProjectArchive::isArchive(const QString& fileName) {
+	QFile file(fileName);
+	if (!file.open(QIODevice::ReadOnly))
+		return false;
+
+	return file.read(4) == QByteArray("PK\x03\x04", 4);
+}
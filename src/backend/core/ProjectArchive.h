@@ -0,0 +1,76 @@
+/***************************************************************************
+    File                 : ProjectArchive.h
+    Project              : LabPlot
+    Description          : Container for projects with binary column data
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef PROJECTARCHIVE_H
+#define PROJECTARCHIVE_H
+
+#include <QFile>
+#include <QHash>
+#include <QMutex>
+#include <QString>
+
+class ColumnPrivate;
+class KZip;
+class QIODevice;
+
+class ProjectArchive {
+public:
+	explicit ProjectArchive(const QString& fileName);
+	~ProjectArchive();
+
+	bool open(QIODevice::OpenMode);
+	void close();
+
+	bool writeManifest(const QByteArray&);
+	QIODevice* manifest() const;
+
+	QString writeBlob(const void* data, qint64 count, int elementSize);
+	bool hasBlob(const QString& name, qint64 count, int elementSize) const;
+	bool readBlob(const QString& name, void* data, qint64 count, int elementSize);
+
+	//bookkeeping of the column data read lazily from the archive
+	void setCacheSize(qint64);
+	bool addCachedData(ColumnPrivate*, qint64 size);
+	void removeCachedData(ColumnPrivate*);
+	void releaseCachedData();
+
+	static bool isArchive(const QString& fileName);
+
+private:
+	QString m_fileName;
+	KZip* m_zip;
+	QFile m_file;	//the archive file, used to map uncompressed blobs into the memory
+	QMutex m_mutex;
+	int m_blobCount{0};
+	QHash<ColumnPrivate*, qint64> m_cachedData;	//columns holding data read from the archive and the size of the data
+	qint64 m_cachedSize{0};
+	qint64 m_cacheSize{0};	//max. size of the cached data, 0 means no limit
+	bool m_releaseRequested{false};
+};
+
+#endif
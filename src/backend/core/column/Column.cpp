@@ -33,6 +33,7 @@
 #include "backend/core/column/ColumnStringIO.h"
 #include "backend/core/column/columncommands.h"
 #include "backend/core/Project.h"
+#include "backend/core/ProjectArchive.h"
 #include "backend/lib/XmlStreamReader.h"
 #include "backend/core/datatypes/String2DateTimeFilter.h"
 #include "backend/core/datatypes/DateTime2StringFilter.h"
@@ -752,6 +753,54 @@ void* Column::data() const {
 	return d->data();
 }
 
+/*!
+ * removes the first \c count rows without changing the number of rows, the column is used
+ * as a circular buffer: the freed rows become the last rows of the column and are to be
+ * filled via ringData(). Used for live data with a fixed number of values to keep.
+ */
+void Column::evictRows(int count) {
+	d->evictRows(count);
+}
+
+/*!
+ * returns the index of the first row in the vector returned by ringData().
+ */
+int Column::ringOffset() const {
+	return d->ringOffset();
+}
+
+/*!
+ * returns the total number of rows removed via evictRows(). The rows of the column
+ * were shifted if the number was changed.
+ */
+qint64 Column::evictedRows() const {
+	return d->evictedRows();
+}
+
+/*!
+ * returns the pointer to the data in the circular buffer mode, the row \c i
+ * is located at the index (i + ringOffset()) % rowCount() in the vector.
+ * In contrast to data() the values are not rotated into the logical order.
+ */
+void* Column::ringData() const {
+	return d->ringData();
+}
+
+/*!
+ * sets the history the rows removed via evictRows() are moved to instead of being discarded.
+ * The column takes the ownership of \c history, \c nullptr deletes the current history.
+ */
+void Column::setHistory(ColumnHistory* history) {
+	d->setHistory(history);
+}
+
+/*!
+ * returns the history of the rows removed via evictRows(), \c nullptr if the removed rows are discarded.
+ */
+ColumnHistory* Column::history() const {
+	return d->history();
+}
+
 /*!
  * return \c true if the column has numeric values, \c false otherwise.
  */
@@ -841,6 +890,7 @@ int Column::integerAt(int row) const {
  * This is used e.g. in \c XYFitCurvePrivate::recalculate()
  */
 void Column::setChanged() {
+	d->detachData();
     d->propertiesAvailable = false;
 
 	if (!m_suppressDataChangedSignal)
@@ -870,10 +920,23 @@ QIcon Column::icon() const {
  * \brief Save the column as XML
  */
 void Column::save(QXmlStreamWriter* writer) const {
+	//if the project is saved into an archive, store numeric and integer values as binary blobs
+	QString blob;
+	const Project* project = const_cast<Column*>(this)->project();
+	ProjectArchive* archive = project ? project->archive() : nullptr;
+	if (archive && rowCount() > 0) {
+		if (columnMode() == AbstractColumn::Numeric)
+			blob = archive->writeBlob(static_cast<QVector<double>*>(d->data())->constData(), rowCount(), sizeof(double));
+		else if (columnMode() == AbstractColumn::Integer)
+			blob = archive->writeBlob(static_cast<QVector<int>*>(d->data())->constData(), rowCount(), sizeof(int));
+	}
+
 	writer->writeStartElement("column");
 	writeBasicAttributes(writer);
 
 	writer->writeAttribute("rows", QString::number(rowCount()));
+	if (!blob.isEmpty())
+		writer->writeAttribute("blob", blob);
 	writer->writeAttribute("designation", QString::number(plotDesignation()));
 	writer->writeAttribute("mode", QString::number(columnMode()));
 	writer->writeAttribute("width", QString::number(width()));
@@ -919,6 +982,12 @@ void Column::save(QXmlStreamWriter* writer) const {
 	// 		writer->writeEndElement();
 	// 	}
 
+	//the values are stored in the blob
+	if (!blob.isEmpty()) {
+		writer->writeEndElement(); // "column"
+		return;
+	}
+
 	int i;
 	switch (columnMode()) {
 	case AbstractColumn::Numeric: {
@@ -992,8 +1061,11 @@ bool Column::load(XmlStreamReader* reader, bool preview) {
 	QXmlStreamAttributes attribs = reader->attributes();
 
 	QString str = attribs.value("rows").toString();
+	const QString blob = attribs.value("blob").toString();
 	if (str.isEmpty())
 		reader->raiseWarning(attributeWarning.subs("rows").toString());
+	else if (!blob.isEmpty())
+		d->setDataBlob(blob, str.toInt()); //the values are read from the project archive on first access
 	else
 		d->resizeTo(str.toInt());
 
@@ -1035,6 +1107,8 @@ bool Column::load(XmlStreamReader* reader, bool preview) {
 				ret_val = XmlReadFormula(reader);
 			else if (reader->name() == "row")
 				ret_val = XmlReadRow(reader);
+			else if (reader->name() == "data")
+				ret_val = XmlReadData(reader);
 			else { // unknown element
 				reader->raiseWarning(i18n("unknown element '%1'", reader->name().toString()));
 				if (!reader->skipToEndElement()) return false;
@@ -1058,6 +1132,23 @@ void Column::finalizeLoad() {
 	d->finalizeLoad();
 }
 
+/*!
+ * binds the column to the project archive \c archive the project was loaded from.
+ * The values referenced in the project XML are read from the archive on first access.
+ * Does nothing if the column doesn't reference any data in the archive.
+ */
+bool Column::setDataArchive(const std::shared_ptr<ProjectArchive>& archive) {
+	return d->setDataSource(archive);
+}
+
+/*!
+ * reads the remaining values from the project archive the column was loaded from,
+ * the values are kept in the memory afterwards and are not connected to the archive anymore.
+ */
+void Column::detachData() {
+	d->detachData();
+}
+
 /**
  * \brief Read XML input filter element
  */
@@ -1140,6 +1231,28 @@ bool Column::XmlReadFormula(XmlStreamReader* reader) {
 /**
  * \brief Read XML row element
  */
+/**
+ * \brief Read XML data element referencing the binary data in the project archive
+ *
+ * Archives written before the blob was stored as attribute of the column element
+ * reference the data in this child element, the rows were already allocated in load().
+ */
+bool Column::XmlReadData(XmlStreamReader* reader) {
+	Q_ASSERT(reader->isStartElement() == true && reader->name() == "data");
+
+	const QString blob = reader->attributes().value("blob").toString();
+	if (blob.isEmpty()) {
+		reader->raiseError(i18n("invalid or missing data blob"));
+		return false;
+	}
+
+	const int rows = rowCount();
+	d->resizeTo(0);
+	d->setDataBlob(blob, rows); //the values are read from the project archive on first access
+
+	return reader->skipToEndElement();
+}
+
 bool Column::XmlReadRow(XmlStreamReader* reader) {
 	Q_ASSERT(reader->isStartElement() == true && reader->name() == "row");
 
@@ -1368,16 +1481,17 @@ double Column::minimum(int startIndex, int endIndex) const {
 	ColumnMode mode = columnMode();
 	Properties property = properties();
 	if (property == Properties::No) {
+		// the values are read from the circular buffer directly, data() would rotate it into the logical order.
 		// skipping values is only in Properties::No needed, because
 		// when there are invalid values the property must be Properties::No
 		switch (mode) {
 		case Numeric: {
-			auto* vec = static_cast<QVector<double>*>(data());
+			auto* vec = static_cast<QVector<double>*>(ringData());
 			for (int row = startIndex; row < endIndex; ++row) {
 				if (!isValid(row) || isMasked(row))
 					continue;
 
-				const double val = vec->at(row);
+				const double val = vec->at(d->ringRow(row));
 				if (std::isnan(val))
 					continue;
 
@@ -1387,12 +1501,12 @@ double Column::minimum(int startIndex, int endIndex) const {
 			break;
 		}
 		case Integer: {
-			auto* vec = static_cast<QVector<int>*>(data());
+			auto* vec = static_cast<QVector<int>*>(ringData());
 			for (int row = startIndex; row < endIndex; ++row) {
 				if (!isValid(row) || isMasked(row))
 					continue;
 
-				const int val = vec->at(row);
+				const int val = vec->at(d->ringRow(row));
 
 				if (val < min)
 					min = val;
@@ -1402,12 +1516,12 @@ double Column::minimum(int startIndex, int endIndex) const {
 		case Text:
 			break;
 		case DateTime: {
-			auto* vec = static_cast<QVector<QDateTime>*>(data());
+			auto* vec = static_cast<QVector<QDateTime>*>(ringData());
 			for (int row = startIndex; row < endIndex; ++row) {
 				if (!isValid(row) || isMasked(row))
 					continue;
 
-				const qint64 val = vec->at(row).toMSecsSinceEpoch();
+				const qint64 val = vec->at(d->ringRow(row)).toMSecsSinceEpoch();
 
 				if (val < min)
 					min = val;
@@ -1501,11 +1615,11 @@ double Column::maximum(int startIndex, int endIndex) const {
 	if (property == Properties::No) {
 		switch (mode) {
 		case Numeric: {
-			auto* vec = static_cast<QVector<double>*>(data());
+			auto* vec = static_cast<QVector<double>*>(ringData());
 			for (int row = startIndex; row < endIndex; ++row) {
 				if (!isValid(row) || isMasked(row))
 					continue;
-				const double val = vec->at(row);
+				const double val = vec->at(d->ringRow(row));
 				if (std::isnan(val))
 					continue;
 
@@ -1515,11 +1629,11 @@ double Column::maximum(int startIndex, int endIndex) const {
 			break;
 		}
 		case Integer: {
-			auto* vec = static_cast<QVector<int>*>(data());
+			auto* vec = static_cast<QVector<int>*>(ringData());
 			for (int row = startIndex; row < endIndex; ++row) {
 				if (!isValid(row) || isMasked(row))
 					continue;
-				const int val = vec->at(row);
+				const int val = vec->at(d->ringRow(row));
 
 				if (val > max)
 					max = val;
@@ -1529,11 +1643,11 @@ double Column::maximum(int startIndex, int endIndex) const {
 		case Text:
 			break;
 		case DateTime: {
-			auto* vec = static_cast<QVector<QDateTime>*>(data());
+			auto* vec = static_cast<QVector<QDateTime>*>(ringData());
 			for (int row = startIndex; row < endIndex; ++row) {
 				if (!isValid(row) || isMasked(row))
 					continue;
-				const qint64 val = vec->at(row).toMSecsSinceEpoch();
+				const qint64 val = vec->at(d->ringRow(row)).toMSecsSinceEpoch();
 
 				if (val > max)
 					max = val;
@@ -36,7 +36,9 @@
 #include "backend/core/column/ColumnPrivate.h"
 
 class CartesianPlot;
+class ColumnHistory;
 class ColumnStringIO;
+class ProjectArchive;
 class QActionGroup;
 
 class Column : public AbstractColumn {
@@ -96,6 +98,12 @@ public:
 
 	const AbstractColumn::ColumnStatistics& statistics() const;
 	void* data() const;
+	void evictRows(int count);
+	int ringOffset() const;
+	qint64 evictedRows() const;
+	void* ringData() const;
+	void setHistory(ColumnHistory*);
+	ColumnHistory* history() const;
 	bool hasValues() const;
 
 	QString textAt(int) const override;
@@ -135,6 +143,8 @@ public:
 	void save(QXmlStreamWriter*) const override;
 	bool load(XmlStreamReader*, bool preview) override;
 	void finalizeLoad();
+	bool setDataArchive(const std::shared_ptr<ProjectArchive>&);
+	void detachData();
 
 public slots:
 	void updateFormula();
@@ -144,6 +154,7 @@ private:
 	bool XmlReadOutputFilter(XmlStreamReader*);
 	bool XmlReadFormula(XmlStreamReader*);
 	bool XmlReadRow(XmlStreamReader*);
+	bool XmlReadData(XmlStreamReader*);
 
 	void handleRowInsertion(int before, int count) override;
 	void handleRowRemoval(int first, int count) override;
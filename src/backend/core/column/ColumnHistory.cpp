@@ -0,0 +1,243 @@
+/***************************************************************************
+    File                 : ColumnHistory.cpp
+    Project              : LabPlot
+    Description          : Older values of a live data column stored on disk
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "backend/core/column/ColumnHistory.h"
+#include "backend/lib/macros.h"
+
+#include <QDir>
+
+#include <cmath>
+#include <cstring>
+
+/*!
+  \class ColumnHistory
+  \brief Keeps the values evicted from a column used as a circular buffer on disk.
+
+  Live data sources keeping only the last N values in memory can move the older values into a history
+  instead of discarding them. The values are collected in blocks of blockRows rows, every block is
+  compressed and appended to a temporary segment file. The memory used by the history is bounded by
+  the block being filled, one decompressed block for the random access and the summary of the values:
+  for consecutive rows (bins) the minimum, the maximum, the first and the last value are kept in memory
+  and are used to draw the complete history zoomed out without reading the file. The bins are merged
+  pairwise whenever their number reaches maxBins.
+
+  All values are stored as doubles, DateTime values in ms since the epoch.
+  Consecutive values are XOR-ed before the compression, slowly changing values and timestamps compress well.
+
+  \ingroup backend
+*/
+ColumnHistory::ColumnHistory(AbstractColumn::ColumnMode mode) : m_columnMode(mode),
+	m_file(QDir::tempPath() + QLatin1String("/labplot_history_XXXXXX")) {
+
+	m_fileOpen = m_file.open();
+	if (!m_fileOpen)
+		DEBUG("ColumnHistory: failed to create the segment file " << m_file.fileTemplate().toStdString());
+
+	m_blockOffsets << 0;
+	m_pending.reserve(blockRows);
+}
+
+AbstractColumn::ColumnMode ColumnHistory::columnMode() const {
+	return m_columnMode;
+}
+
+qint64 ColumnHistory::rowCount() const {
+	return m_rowCount;
+}
+
+/*!
+ * returns the number of bytes written to the segment file.
+ */
+qint64 ColumnHistory::diskSize() const {
+	return m_blockOffsets.constLast();
+}
+
+void ColumnHistory::append(double value) {
+	m_pending << value;
+	++m_rowCount;
+
+	if (!std::isnan(value)) {
+		m_bin.min = qMin(m_bin.min, value);
+		m_bin.max = qMax(m_bin.max, value);
+		m_minimum = qMin(m_minimum, value);
+		m_maximum = qMax(m_maximum, value);
+	}
+	if (m_binFill == 0)
+		m_bin.first = value;
+	m_bin.last = value;
+
+	if (++m_binFill == m_binRows) {
+		m_bins << m_bin;
+		m_bin = Bin();
+		m_binFill = 0;
+
+		if (m_bins.size() == maxBins) {
+			for (int i = 0; i < maxBins/2; ++i) {
+				m_bins[i] = m_bins.at(2*i);
+				merge(m_bins[i], m_bins.at(2*i + 1));
+			}
+			m_bins.resize(maxBins/2);
+			m_binRows *= 2;
+		}
+	}
+
+	if (m_pending.size() == blockRows)
+		writeBlock();
+}
+
+/*!
+ * compresses the pending rows and appends them as a new block to the segment file.
+ */
+void ColumnHistory::writeBlock() {
+	QByteArray bytes(m_pending.size() * (int)sizeof(quint64), Qt::Uninitialized);
+	auto* encoded = reinterpret_cast<quint64*>(bytes.data());
+	quint64 previous = 0;
+	for (int i = 0; i < m_pending.size(); ++i) {
+		quint64 bits;
+		std::memcpy(&bits, &m_pending.at(i), sizeof(bits));
+		encoded[i] = bits ^ previous;
+		previous = bits;
+	}
+
+	const QByteArray block = qCompress(bytes, 1);
+	qint64 end = m_blockOffsets.constLast();
+	if (m_fileOpen && m_file.seek(end) && m_file.write(block) == block.size())
+		end += block.size();
+	else
+		DEBUG("ColumnHistory::writeBlock(): failed to write to the segment file, " << m_pending.size() << " values are lost");
+
+	m_blockOffsets << end;
+	m_pending.clear();
+}
+
+/*!
+ * reads and decompresses the block \c block into the cache.
+ */
+void ColumnHistory::readBlock(int block) const {
+	if (m_cachedBlock == block)
+		return;
+
+	m_cachedBlock = block;
+	m_cache.resize(blockRows);
+
+	const qint64 offset = m_blockOffsets.at(block);
+	const qint64 size = m_blockOffsets.at(block + 1) - offset;
+	QByteArray bytes;
+	if (size > 0 && m_file.seek(offset))
+		bytes = qUncompress(m_file.read(size));
+
+	if (bytes.size() != blockRows * (int)sizeof(quint64)) {
+		DEBUG("ColumnHistory::readBlock(): failed to read the block " << block);
+		m_cache.fill(NAN);
+		return;
+	}
+
+	const auto* encoded = reinterpret_cast<const quint64*>(bytes.constData());
+	quint64 previous = 0;
+	for (int i = 0; i < blockRows; ++i) {
+		const quint64 bits = encoded[i] ^ previous;
+		std::memcpy(&m_cache[i], &bits, sizeof(bits));
+		previous = bits;
+	}
+}
+
+double ColumnHistory::valueAt(qint64 row) const {
+	if (row < 0 || row >= m_rowCount)
+		return NAN;
+
+	const qint64 written = m_rowCount - m_pending.size();
+	if (row >= written)
+		return m_pending.at(row - written);
+
+	readBlock(row / blockRows);
+	return m_cache.at(row % blockRows);
+}
+
+/*!
+ * copies the \c count values starting at the row \c first into \c data.
+ */
+void ColumnHistory::read(qint64 first, qint64 count, double* data) const {
+	const qint64 written = m_rowCount - m_pending.size();
+	qint64 row = first;
+	const qint64 end = qMin(first + count, m_rowCount);
+	while (row < end) {
+		if (row >= written) {
+			std::memcpy(data, m_pending.constData() + (row - written), (end - row) * sizeof(double));
+			return;
+		}
+
+		readBlock(row / blockRows);
+		const int index = row % blockRows;
+		const int n = qMin(end - row, (qint64)(blockRows - index));
+		std::memcpy(data, m_cache.constData() + index, n * sizeof(double));
+		data += n;
+		row += n;
+	}
+}
+
+/*!
+ * returns the smallest value in the history, ignoring NAN values.
+ */
+double ColumnHistory::minimum() const {
+	return m_minimum;
+}
+
+/*!
+ * returns the largest value in the history, ignoring NAN values.
+ */
+double ColumnHistory::maximum() const {
+	return m_maximum;
+}
+
+/*!
+ * returns the summary of the complete history with at most \c binCount bins. Histories of columns filled
+ * with the same number of rows (e.g. the columns of one data source) return bins of the same rows.
+ */
+QVector<ColumnHistory::Bin> ColumnHistory::summary(int binCount) const {
+	const int count = m_bins.size() + (m_binFill > 0 ? 1 : 0);
+	binCount = qMax(binCount, 1);
+	const int factor = qMax((count + binCount - 1)/binCount, 1);
+
+	QVector<Bin> bins;
+	bins.reserve(count/factor + 1);
+	for (int i = 0; i < count; ++i) {
+		const Bin& bin = (i < m_bins.size()) ? m_bins.at(i) : m_bin;
+		if (i % factor == 0)
+			bins << bin;
+		else
+			merge(bins.last(), bin);
+	}
+
+	return bins;
+}
+
+void ColumnHistory::merge(Bin& bin, const Bin& other) {
+	bin.min = qMin(bin.min, other.min);
+	bin.max = qMax(bin.max, other.max);
+	bin.last = other.last;
+}
@@ -0,0 +1,88 @@
+/***************************************************************************
+    File                 : ColumnHistory.h
+    Project              : LabPlot
+    Description          : Older values of a live data column stored on disk
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef COLUMNHISTORY_H
+#define COLUMNHISTORY_H
+
+#include "backend/core/AbstractColumn.h"
+
+#include <QTemporaryFile>
+#include <QVector>
+
+#include <cmath>
+
+class ColumnHistory {
+public:
+	//summary of consecutive rows, used to draw the history zoomed out
+	struct Bin {
+		double min{INFINITY};
+		double max{-INFINITY};
+		double first{NAN};
+		double last{NAN};
+	};
+
+	explicit ColumnHistory(AbstractColumn::ColumnMode);
+
+	AbstractColumn::ColumnMode columnMode() const;
+	qint64 rowCount() const;
+	qint64 diskSize() const;
+
+	void append(double);
+	double valueAt(qint64 row) const;
+	void read(qint64 first, qint64 count, double* data) const;
+
+	double minimum() const;
+	double maximum() const;
+	QVector<Bin> summary(int binCount) const;
+
+	static const int blockRows = 65536;	// number of rows compressed together
+	static const int maxBins = 65536;	// max. number of bins kept in memory
+
+private:
+	void writeBlock();
+	void readBlock(int block) const;
+	static void merge(Bin&, const Bin&);
+
+	AbstractColumn::ColumnMode m_columnMode;
+	mutable QTemporaryFile m_file;	//segment file with the compressed blocks
+	bool m_fileOpen{false};
+	QVector<qint64> m_blockOffsets;	//positions of the blocks in the file and the end of the last block
+	QVector<double> m_pending;	//rows not written to the file yet
+	qint64 m_rowCount{0};
+
+	QVector<Bin> m_bins;	//summaries of the complete bins
+	Bin m_bin;		//summary of the bin being filled
+	int m_binRows{256};	//number of rows in a bin, doubled whenever maxBins is reached
+	int m_binFill{0};	//number of rows in m_bin
+	double m_minimum{INFINITY};
+	double m_maximum{-INFINITY};
+
+	mutable int m_cachedBlock{-1};
+	mutable QVector<double> m_cache;	//values of the last block read from the file
+};
+
+#endif
@@ -28,11 +28,20 @@
  ***************************************************************************/
 
 #include "ColumnPrivate.h"
+#include "ColumnHistory.h"
 #include "ColumnStringIO.h"
 #include "Column.h"
 #include "backend/spreadsheet/Spreadsheet.h"
 #include "backend/core/datatypes/filter.h"
 #include "backend/gsl/ExpressionParser.h"
+#include "backend/core/ProjectArchive.h"
+
+#include <KLocalizedString>
+#include <QThread>
+#include <QTimer>
+
+#include <algorithm>
+#include <atomic>
 
 ColumnPrivate::ColumnPrivate(Column* owner, AbstractColumn::ColumnMode mode) :
 	m_column_mode(mode), m_owner(owner) {
@@ -129,6 +138,9 @@ ColumnPrivate::ColumnPrivate(Column* owner, AbstractColumn::ColumnMode mode, voi
 }
 
 ColumnPrivate::~ColumnPrivate() {
+	if (m_archive)
+		m_archive->removeCachedData(this);
+
 	if (!m_data) return;
 
 	switch (m_column_mode) {
@@ -166,6 +178,9 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
 		<< " -> " << ENUM_TO_STRING(AbstractColumn, ColumnMode, mode))
 	if (mode == m_column_mode) return;
 
+	detach();
+	linearize();
+
 	void* old_data = m_data;
 	// remark: the deletion of the old data will be done in the dtor of a command
 
@@ -413,6 +428,8 @@ void ColumnPrivate::setColumnMode(AbstractColumn::ColumnMode mode) {
  */
 void ColumnPrivate::replaceModeData(AbstractColumn::ColumnMode mode, void* data,
 				AbstractSimpleFilter* in_filter, AbstractSimpleFilter* out_filter) {
+	detach();
+	linearize();
 	DEBUG("ColumnPrivate::replaceModeData()");
 	emit m_owner->modeAboutToChange(m_owner);
 	// disconnect formatChanged()
@@ -472,6 +489,8 @@ void ColumnPrivate::replaceModeData(AbstractColumn::ColumnMode mode, void* data,
  * \brief Replace data pointer
  */
 void ColumnPrivate::replaceData(void* data) {
+	detach();
+	linearize();
 	DEBUG("ColumnPrivate::replaceData()");
 	emit m_owner->dataAboutToChange(m_owner);
 	m_data = data;
@@ -487,6 +506,8 @@ void ColumnPrivate::replaceData(void* data) {
  * Use a filter to convert a column to another type.
  */
 bool ColumnPrivate::copy(const AbstractColumn* other) {
+	detach();
+	linearize();
 	DEBUG("ColumnPrivate::copy(other)");
 	if (other->columnMode() != columnMode()) return false;
 	DEBUG("	mode = " << ENUM_TO_STRING(AbstractColumn, ColumnMode, columnMode()));
@@ -543,6 +564,8 @@ bool ColumnPrivate::copy(const AbstractColumn* other) {
  * \param num_rows the number of rows to copy
  */
 bool ColumnPrivate::copy(const AbstractColumn* source, int source_start, int dest_start, int num_rows) {
+	detach();
+	linearize();
 	DEBUG("ColumnPrivate::copy()");
 	if (source->columnMode() != m_column_mode) return false;
 	if (num_rows == 0) return true;
@@ -590,6 +613,8 @@ bool ColumnPrivate::copy(const AbstractColumn* source, int source_start, int des
  * Use a filter to convert a column to another type.
  */
 bool ColumnPrivate::copy(const ColumnPrivate* other) {
+	detach();
+	linearize();
 	if (other->columnMode() != m_column_mode) return false;
 	int num_rows = other->rowCount();
 
@@ -639,6 +664,8 @@ bool ColumnPrivate::copy(const ColumnPrivate* other) {
  * \param num_rows the number of rows to copy
  */
 bool ColumnPrivate::copy(const ColumnPrivate* source, int source_start, int dest_start, int num_rows) {
+	detach();
+	linearize();
 	if (source->columnMode() != m_column_mode) return false;
 	if (num_rows == 0) return true;
 
@@ -686,6 +713,9 @@ bool ColumnPrivate::copy(const ColumnPrivate* source, int source_start, int dest
  * plots etc.
  */
 int ColumnPrivate::rowCount() const {
+	if (!m_dataLoaded)
+		return m_dataRows;
+
 	switch (m_column_mode) {
 	case AbstractColumn::Numeric:
 		return static_cast<QVector<double>*>(m_data)->size();
@@ -713,6 +743,8 @@ int ColumnPrivate::rowCount() const {
  * must be emitted.
  */
 void ColumnPrivate::resizeTo(int new_size) {
+	detach();
+	linearize();
 	int old_size = rowCount();
 	if (new_size == old_size)
 		return;
@@ -761,6 +793,8 @@ void ColumnPrivate::resizeTo(int new_size) {
  * \brief Insert some empty (or initialized with zero) rows
  */
 void ColumnPrivate::insertRows(int before, int count) {
+	detach();
+	linearize();
 	if (count == 0) return;
 
 	m_formulas.insertRows(before, count);
@@ -791,6 +825,8 @@ void ColumnPrivate::insertRows(int before, int count) {
  * \brief Remove 'count' rows starting from row 'first'
  */
 void ColumnPrivate::removeRows(int first, int count) {
+	detach();
+	linearize();
 	if (count == 0) return;
 
 	m_formulas.removeRows(first, count);
@@ -858,8 +894,13 @@ void ColumnPrivate::setWidth(int value) {
 
 /**
  * \brief Return the data pointer
+ *
+ * The data read from a project archive is released from the top level event loop only,
+ * the pointer is valid until the control returns there.
  */
 void* ColumnPrivate::data() const {
+	loadData();
+	linearize();
 	return m_data;
 }
 
@@ -925,6 +966,251 @@ void ColumnPrivate::finalizeLoad() {
 	}
 }
 
+/*!
+ * sets the name of the blob in the project archive containing the \c rows values of the column.
+ * Called during the load, the column is bound to the archive in setDataSource() afterwards.
+ */
+void ColumnPrivate::setDataBlob(const QString& blob, int rows) {
+	m_dataBlob = blob;
+	m_dataRows = rows;
+}
+
+/*!
+ * binds the column to the project archive \c archive. The data is not read here
+ * but on first access to it, until then rowCount() returns the number of rows in the archive.
+ * Returns \c false if the archive doesn't contain the expected data, the column is filled
+ * with empty values in this case.
+ */
+bool ColumnPrivate::setDataSource(const std::shared_ptr<ProjectArchive>& archive) {
+	if (m_dataBlob.isEmpty())
+		return true;
+
+	bool valid = false;
+	if (m_column_mode == AbstractColumn::Numeric)
+		valid = archive->hasBlob(m_dataBlob, m_dataRows, sizeof(double));
+	else if (m_column_mode == AbstractColumn::Integer)
+		valid = archive->hasBlob(m_dataBlob, m_dataRows, sizeof(int));
+
+	if (!valid) {
+		DEBUG("ColumnPrivate::setDataSource() invalid blob " << m_dataBlob.toStdString());
+		m_dataBlob.clear();
+		resizeTo(m_dataRows);
+		return false;
+	}
+
+	m_archive = archive;
+	m_dataLoaded = false;
+	return true;
+}
+
+static std::atomic<quint64> dataAccessCounter{0};
+
+/*!
+ * reads the data from the project archive if not done yet and updates the time of the last access.
+ * If the data cannot be read, the column is detached from the archive and filled with empty values.
+ * The state of the data read on demand is not synchronized, columns backed by an archive are only
+ * accessed in the thread of the column (the GUI thread). The analysis curves copy the data there.
+ */
+void ColumnPrivate::readData() const {
+	Q_ASSERT(QThread::currentThread() == m_owner->thread());
+	m_lastDataAccess = ++dataAccessCounter;
+	if (m_dataLoaded)
+		return;
+
+	qint64 size = 0;
+	bool rc = false;
+	if (m_column_mode == AbstractColumn::Numeric) {
+		auto* data = static_cast<QVector<double>*>(m_data);
+		data->resize(m_dataRows);
+		size = m_dataRows * sizeof(double);
+		rc = m_archive->readBlob(m_dataBlob, data->data(), m_dataRows, sizeof(double));
+		if (!rc)
+			data->fill(NAN);
+	} else if (m_column_mode == AbstractColumn::Integer) {
+		auto* data = static_cast<QVector<int>*>(m_data);
+		data->resize(m_dataRows);
+		size = m_dataRows * sizeof(int);
+		rc = m_archive->readBlob(m_dataBlob, data->data(), m_dataRows, sizeof(int));
+		if (!rc)
+			data->fill(0);
+	}
+
+	m_dataLoaded = true;
+	if (!rc) {
+		//the empty values are not backed by the archive anymore, don't try to read them again
+		DEBUG("ColumnPrivate::readData() failed to read the blob " << m_dataBlob.toStdString());
+		m_archive.reset();
+		m_owner->info(i18n("Failed to read the data of the column \"%1\" from the project file.", m_owner->name()));
+		return;
+	}
+
+	if (m_archive->addCachedData(const_cast<ColumnPrivate*>(this), size)) {
+		//the cache size is exceeded. release the data of other columns after the current
+		//operation is finished, the data of the columns might be in use right now.
+		std::shared_ptr<ProjectArchive> archive = m_archive;
+		QTimer::singleShot(0, m_owner, [archive]() { archive->releaseCachedData(); });
+	}
+}
+
+/*!
+ * reads the remaining data from the archive and disconnects the column from it.
+ * Called before the data is modified, modified data cannot be released anymore.
+ */
+void ColumnPrivate::detachData() {
+	if (!m_archive)
+		return;
+
+	readData();
+	m_archive->removeCachedData(this);
+	m_archive.reset();
+}
+
+/*!
+ * releases the data read from the project archive, the data is read again on the next access.
+ * Returns \c false if the data is not backed by the archive or not read yet.
+ */
+bool ColumnPrivate::releaseData() {
+	Q_ASSERT(QThread::currentThread() == m_owner->thread());
+	if (!m_archive || !m_dataLoaded)
+		return false;
+
+	m_dataRows = rowCount();
+	if (m_column_mode == AbstractColumn::Numeric)
+		*static_cast<QVector<double>*>(m_data) = QVector<double>();
+	else if (m_column_mode == AbstractColumn::Integer)
+		*static_cast<QVector<int>*>(m_data) = QVector<int>();
+
+	m_dataLoaded = false;
+	m_archive->removeCachedData(this);
+	return true;
+}
+
+bool ColumnPrivate::dataLoaded() const {
+	return m_dataLoaded;
+}
+
+quint64 ColumnPrivate::lastDataAccess() const {
+	return m_lastDataAccess;
+}
+
+/*!
+ * removes the first \c count rows in the circular buffer mode. Instead of moving the remaining values,
+ * only the offset of the first row in the underlying vector is shifted and the freed rows become
+ * the last (empty) rows of the column, the number of rows is not changed.
+ * The rows are accessed via valueAt(), integerAt() etc. or via ringData() and ringOffset().
+ * data() returns the values in the logical order, the vector is rotated in this case if required.
+ */
+void ColumnPrivate::evictRows(int count) {
+	detach();
+	const int size = rowCount();
+	if (count <= 0 || size == 0)
+		return;
+	if (count > size)
+		count = size;
+
+	for (int i = 0; i < count; ++i) {
+		const int row = ringRow(i);
+		switch (m_column_mode) {
+		case AbstractColumn::Numeric: {
+			double& value = (*static_cast<QVector<double>*>(m_data))[row];
+			if (m_history)
+				m_history->append(value);
+			value = NAN;
+			break;
+		}
+		case AbstractColumn::Integer: {
+			int& value = (*static_cast<QVector<int>*>(m_data))[row];
+			if (m_history)
+				m_history->append(value);
+			value = 0;
+			break;
+		}
+		case AbstractColumn::Text:
+			(*static_cast<QVector<QString>*>(m_data))[row].clear();
+			break;
+		case AbstractColumn::DateTime:
+		case AbstractColumn::Month:
+		case AbstractColumn::Day: {
+			QDateTime& value = (*static_cast<QVector<QDateTime>*>(m_data))[row];
+			if (m_history)
+				m_history->append(value.isValid() ? value.toMSecsSinceEpoch() : NAN);
+			value = QDateTime();
+			break;
+		}
+		}
+	}
+
+	m_ringOffset = (m_ringOffset + count) % size;
+	m_evictedRows += count;
+}
+
+/*!
+ * sets the history the rows removed in evictRows() are moved to, takes the ownership of \c history.
+ * The current history is deleted, \c nullptr disables the history.
+ */
+void ColumnPrivate::setHistory(ColumnHistory* history) {
+	m_history.reset(history);
+}
+
+ColumnHistory* ColumnPrivate::history() const {
+	return m_history.get();
+}
+
+/*!
+ * returns the index of the first row in the vector returned by ringData().
+ */
+int ColumnPrivate::ringOffset() const {
+	return m_ringOffset;
+}
+
+/*!
+ * returns the total number of rows removed in evictRows().
+ */
+qint64 ColumnPrivate::evictedRows() const {
+	return m_evictedRows;
+}
+
+/*!
+ * returns the pointer to the data without bringing the values into the logical order,
+ * the row \c i is located at the index (i + ringOffset()) % rowCount().
+ */
+void* ColumnPrivate::ringData() const {
+	loadData();
+	return m_data;
+}
+
+/*!
+ * rotates the values in the vector so that the first row is located at the index 0 again.
+ */
+void ColumnPrivate::linearizeRing() const {
+	switch (m_column_mode) {
+	case AbstractColumn::Numeric: {
+		auto* data = static_cast<QVector<double>*>(m_data);
+		std::rotate(data->begin(), data->begin() + m_ringOffset, data->end());
+		break;
+	}
+	case AbstractColumn::Integer: {
+		auto* data = static_cast<QVector<int>*>(m_data);
+		std::rotate(data->begin(), data->begin() + m_ringOffset, data->end());
+		break;
+	}
+	case AbstractColumn::Text: {
+		auto* data = static_cast<QVector<QString>*>(m_data);
+		std::rotate(data->begin(), data->begin() + m_ringOffset, data->end());
+		break;
+	}
+	case AbstractColumn::DateTime:
+	case AbstractColumn::Month:
+	case AbstractColumn::Day: {
+		auto* data = static_cast<QVector<QDateTime>*>(m_data);
+		std::rotate(data->begin(), data->begin() + m_ringOffset, data->end());
+		break;
+	}
+	}
+
+	m_ringOffset = 0;
+}
+
 /*!
  * \brief ColumnPrivate::connectFormulaColumn
  * This function is used to connect the columns to the needed slots for updating formulas
@@ -1123,7 +1409,7 @@ void ColumnPrivate::clearFormulas() {
  */
 QString ColumnPrivate::textAt(int row) const {
 	if (m_column_mode != AbstractColumn::Text) return QString();
-	return static_cast<QVector<QString>*>(m_data)->value(row);
+	return static_cast<QVector<QString>*>(m_data)->value(ringRow(row));
 }
 
 /**
@@ -1162,7 +1448,7 @@ QDateTime ColumnPrivate::dateTimeAt(int row) const {
 	        m_column_mode != AbstractColumn::Month &&
 	        m_column_mode != AbstractColumn::Day)
 		return QDateTime();
-	return static_cast<QVector<QDateTime>*>(m_data)->value(row);
+	return static_cast<QVector<QDateTime>*>(m_data)->value(ringRow(row));
 }
 
 /**
@@ -1171,6 +1457,8 @@ QDateTime ColumnPrivate::dateTimeAt(int row) const {
  * For cases where the integer value is needed without any implicit conversions, \sa intergAt() has to be used.
  */
 double ColumnPrivate::valueAt(int row) const {
+	loadData();
+	row = ringRow(row);
 	if (m_column_mode == AbstractColumn::Numeric)
 		return static_cast<QVector<double>*>(m_data)->value(row, NAN);
 	else if (m_column_mode == AbstractColumn::Integer)
@@ -1183,8 +1471,9 @@ double ColumnPrivate::valueAt(int row) const {
  * \brief Return the int value in row 'row'
  */
 int ColumnPrivate::integerAt(int row) const {
+	loadData();
 	if (m_column_mode != AbstractColumn::Integer) return 0;
-	return static_cast<QVector<int>*>(m_data)->value(row, 0);
+	return static_cast<QVector<int>*>(m_data)->value(ringRow(row), 0);
 }
 
 /**
@@ -1193,6 +1482,7 @@ int ColumnPrivate::integerAt(int row) const {
  * Use this only when columnMode() is Text
  */
 void ColumnPrivate::setTextAt(int row, const QString& new_value) {
+	linearize();
 	if (m_column_mode != AbstractColumn::Text) return;
 
 	emit m_owner->dataAboutToChange(m_owner);
@@ -1210,6 +1500,7 @@ void ColumnPrivate::setTextAt(int row, const QString& new_value) {
  * Use this only when columnMode() is Text
  */
 void ColumnPrivate::replaceTexts(int first, const QVector<QString>& new_values) {
+	linearize();
 	if (m_column_mode != AbstractColumn::Text) return;
 
 	emit m_owner->dataAboutToChange(m_owner);
@@ -1258,6 +1549,7 @@ void ColumnPrivate::setTimeAt(int row, QTime new_value) {
  * Use this only when columnMode() is DateTime, Month or Day
  */
 void ColumnPrivate::setDateTimeAt(int row, const QDateTime& new_value) {
+	linearize();
 	if (m_column_mode != AbstractColumn::DateTime &&
 	        m_column_mode != AbstractColumn::Month &&
 	        m_column_mode != AbstractColumn::Day)
@@ -1278,6 +1570,7 @@ void ColumnPrivate::setDateTimeAt(int row, const QDateTime& new_value) {
  * Use this only when columnMode() is DateTime, Month or Day
  */
 void ColumnPrivate::replaceDateTimes(int first, const QVector<QDateTime>& new_values) {
+	linearize();
 	if (m_column_mode != AbstractColumn::DateTime &&
 	        m_column_mode != AbstractColumn::Month &&
 	        m_column_mode != AbstractColumn::Day)
@@ -1301,6 +1594,8 @@ void ColumnPrivate::replaceDateTimes(int first, const QVector<QDateTime>& new_va
  * Use this only when columnMode() is Numeric
  */
 void ColumnPrivate::setValueAt(int row, double new_value) {
+	detach();
+	linearize();
 //	DEBUG("ColumnPrivate::setValueAt()");
 	if (m_column_mode != AbstractColumn::Numeric) return;
 
@@ -1319,6 +1614,8 @@ void ColumnPrivate::setValueAt(int row, double new_value) {
  * Use this only when columnMode() is Numeric
  */
 void ColumnPrivate::replaceValues(int first, const QVector<double>& new_values) {
+	detach();
+	linearize();
 	DEBUG("ColumnPrivate::replaceValues()");
 	if (m_column_mode != AbstractColumn::Numeric) return;
 
@@ -1341,6 +1638,8 @@ void ColumnPrivate::replaceValues(int first, const QVector<double>& new_values)
  * Use this only when columnMode() is Integer
  */
 void ColumnPrivate::setIntegerAt(int row, int new_value) {
+	detach();
+	linearize();
 	DEBUG("ColumnPrivate::setIntegerAt()");
 	if (m_column_mode != AbstractColumn::Integer) return;
 
@@ -1359,6 +1658,8 @@ void ColumnPrivate::setIntegerAt(int row, int new_value) {
  * Use this only when columnMode() is Integer
  */
 void ColumnPrivate::replaceInteger(int first, const QVector<int>& new_values) {
+	detach();
+	linearize();
 	DEBUG("ColumnPrivate::replaceInteger()");
 	if (m_column_mode != AbstractColumn::Integer) return;
 
@@ -33,7 +33,11 @@
 #include "backend/core/AbstractColumn.h"
 #include "backend/lib/IntervalAttribute.h"
 
+#include <memory>
+
 class Column;
+class ColumnHistory;
+class ProjectArchive;
 
 class ColumnPrivate : public QObject {
 	Q_OBJECT
@@ -120,6 +124,22 @@ public:
 
 	void finalizeLoad();
 
+	//data read on demand from the project archive
+	void setDataBlob(const QString& blob, int rows);
+	bool setDataSource(const std::shared_ptr<ProjectArchive>&);
+	void detachData();
+	bool releaseData();
+	bool dataLoaded() const;
+	quint64 lastDataAccess() const;
+
+	//circular buffer mode used for the data with a fixed number of rows
+	void evictRows(int count);
+	int ringOffset() const;
+	qint64 evictedRows() const;
+	void* ringData() const;
+	void setHistory(ColumnHistory*);
+	ColumnHistory* history() const;
+
 	mutable AbstractColumn::ColumnStatistics statistics;
 	bool statisticsAvailable{false}; //is 'statistics' already available or needs to be (re-)calculated?
 
@@ -145,8 +165,41 @@ private:
 	Column* m_owner{nullptr};
 	QVector<QMetaObject::Connection> m_connectionsUpdateFormula;
 
+	//data read on demand, only accessed in the thread of the column, see readData()
+	mutable std::shared_ptr<ProjectArchive> m_archive; //archive the data is read from, nullptr if the data is not backed by an archive
+	QString m_dataBlob; //name of the blob in the archive
+	mutable bool m_dataLoaded{true};
+	mutable quint64 m_lastDataAccess{0};
+	int m_dataRows{0}; //number of rows in the archive as long as the data was not read yet
+	mutable int m_ringOffset{0}; //index of the first row in the vector in the circular buffer mode
+	qint64 m_evictedRows{0}; //total number of rows removed in the circular buffer mode
+	std::unique_ptr<ColumnHistory> m_history; //on-disk storage of the rows removed in the circular buffer mode
+
 private:
 	void connectFormulaColumn(const AbstractColumn* column);
+	void readData() const;
+	void loadData() const {
+		if (m_archive)
+			readData();
+	}
+	void detach() {
+		if (m_archive)
+			detachData();
+	}
+	void linearizeRing() const;
+	void linearize() const {
+		if (m_ringOffset)
+			linearizeRing();
+	}
+	int ringRow(int row) const {
+		if (!m_ringOffset || row < 0)
+			return row;
+		const int size = rowCount();
+		if (row >= size)
+			return row;
+		row += m_ringOffset;
+		return (row >= size) ? row - size : row;
+	}
 
 private slots:
 	void formulaVariableColumnRemoved(const AbstractAspect*);
@@ -0,0 +1,542 @@
+/***************************************************************************
+    File                 : LiveDataJoin.cpp
+    Project              : LabPlot
+    Description          : Timestamp aligned join of several live data sources
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "backend/datasources/LiveDataJoin.h"
+#include "backend/core/Project.h"
+#include "backend/core/column/Column.h"
+#include "backend/lib/XmlStreamReader.h"
+#include "backend/lib/macros.h"
+#include "backend/lib/trace.h"
+#include "backend/worksheet/plots/cartesian/PlotUpdateScheduler.h"
+#include "commonfrontend/spreadsheet/SpreadsheetView.h"
+
+#include <QDateTime>
+
+#include <KLocalizedString>
+
+#include <cmath>
+
+/*!
+  \class LiveDataJoin
+  \brief Joins the data of several live data sources on their timestamps ("as-of" join).
+
+  Every source (LiveDataSource, MQTTTopic or any other spreadsheet) provides a key column with the
+  timestamps of its rows, by default the first DateTime column or the first numeric column if there is
+  no DateTime column, and the numeric value columns. The join contains a timestamp column and one column
+  for every value column of every source. The timestamps are either on a regular grid with the distance
+  interval() or the keys of the first source. The values of the sources at these timestamps are
+  determined with the method method().
+
+  A timestamp is joined once all sources have a row at or after it, already joined rows don't change anymore.
+  On new live data only the new rows are processed: for every source the row before the last joined timestamp
+  is kept as a cursor, the next row to process is found via a binary search on the key column.
+  The keys of every source are expected to be sorted ascending.
+
+  \ingroup datasources
+*/
+LiveDataJoin::LiveDataJoin(const QString& name, bool loading) : Spreadsheet(name, true, AspectType::LiveDataJoin) {
+	Q_UNUSED(loading)
+	setUndoAware(false);
+	connect(PlotUpdateScheduler::instance(), &PlotUpdateScheduler::dataChanged, this, &LiveDataJoin::sourceDataChanged);
+}
+
+QWidget* LiveDataJoin::view() const {
+	if (!m_partView) {
+		m_view = new SpreadsheetView(const_cast<LiveDataJoin*>(this), true);
+		m_partView = m_view;
+	}
+	return m_partView;
+}
+
+/*!
+ * adds the spreadsheet \c spreadsheet to the joined sources. The timestamps of its rows
+ * are taken from the column \c keyColumnName, or from the first DateTime column if empty.
+ */
+void LiveDataJoin::addSource(Spreadsheet* spreadsheet, const QString& keyColumnName) {
+	Source source;
+	source.spreadsheet = spreadsheet;
+	source.path = spreadsheet->path();
+	source.keyColumnName = keyColumnName;
+	m_sources << source;
+
+	connectSource(spreadsheet);
+	recalculate();
+}
+
+void LiveDataJoin::removeSource(const Spreadsheet* spreadsheet) {
+	for (int i = 0; i < m_sources.size(); ++i) {
+		if (m_sources.at(i).spreadsheet == spreadsheet) {
+			m_sources.remove(i);
+			recalculate();
+			return;
+		}
+	}
+}
+
+QVector<Spreadsheet*> LiveDataJoin::sources() const {
+	QVector<Spreadsheet*> spreadsheets;
+	for (const auto& source : m_sources) {
+		if (source.spreadsheet)
+			spreadsheets << source.spreadsheet;
+	}
+	return spreadsheets;
+}
+
+QString LiveDataJoin::keyColumnName(const Spreadsheet* spreadsheet) const {
+	for (const auto& source : m_sources) {
+		if (source.spreadsheet == spreadsheet)
+			return source.keyColumnName;
+	}
+	return QString();
+}
+
+void LiveDataJoin::setMethod(Method method) {
+	m_method = method;
+	recalculate();
+}
+
+LiveDataJoin::Method LiveDataJoin::method() const {
+	return m_method;
+}
+
+/*!
+ * sets the distance of the joined timestamps in ms for DateTime keys, in the units of the keys otherwise.
+ * If 0, the keys of the first source are used as timestamps.
+ */
+void LiveDataJoin::setInterval(double interval) {
+	m_interval = qMax(interval, 0.);
+	recalculate();
+}
+
+double LiveDataJoin::interval() const {
+	return m_interval;
+}
+
+/*!
+ * sets the number of the last rows to keep, 0 to keep all rows.
+ */
+void LiveDataJoin::setKeepNValues(int keepNValues) {
+	m_keepNValues = qMax(keepNValues, 0);
+	recalculate();
+}
+
+int LiveDataJoin::keepNValues() const {
+	return m_keepNValues;
+}
+
+/*!
+ * recreates the joined columns and joins all rows currently available in the sources.
+ */
+void LiveDataJoin::recalculate() {
+	m_prepared = false;
+	update();
+}
+
+/*!
+ * returns the key of the row \c row in ms for DateTime columns, -INFINITY for rows without a valid key.
+ */
+static double keyAt(const Column* column, int row) {
+	if (column->columnMode() == AbstractColumn::DateTime) {
+		const QDateTime& dateTime = column->dateTimeAt(row);
+		return dateTime.isValid() ? dateTime.toMSecsSinceEpoch() : -INFINITY;
+	}
+
+	const double value = column->valueAt(row);
+	return std::isnan(value) ? -INFINITY : value;
+}
+
+/*!
+ * returns the first row of the first \c rows rows of \c column with a key larger than \c key.
+ */
+static int upperBound(const Column* column, int rows, double key) {
+	int first = 0;
+	while (rows > 0) {
+		const int step = rows/2;
+		if (keyAt(column, first + step) <= key) {
+			first += step + 1;
+			rows -= step + 1;
+		} else
+			rows = step;
+	}
+	return first;
+}
+
+/*!
+ * determines the key and value columns of the sources and creates the joined columns.
+ * Returns \c false if not all sources provide a key column yet.
+ */
+bool LiveDataJoin::prepare() {
+	if (m_sources.isEmpty())
+		return false;
+
+	for (auto& source : m_sources) {
+		if (!source.spreadsheet)
+			return false;
+
+		source.keyColumn = nullptr;
+		source.valueColumns.clear();
+		for (auto* column : source.spreadsheet->children<Column>()) {
+			const bool isKey = source.keyColumnName.isEmpty() ? (column->columnMode() == AbstractColumn::DateTime)
+						: (column->name() == source.keyColumnName);
+			if (!source.keyColumn && isKey)
+				source.keyColumn = column;
+			else if (column->columnMode() == AbstractColumn::Numeric || column->columnMode() == AbstractColumn::Integer)
+				source.valueColumns << column;
+		}
+
+		//no DateTime column, use the first numeric column (e.g. the index) as key
+		if (!source.keyColumn && source.keyColumnName.isEmpty() && !source.valueColumns.isEmpty())
+			source.keyColumn = source.valueColumns.takeFirst();
+
+		if (!source.keyColumn)
+			return false;
+	}
+
+	//create the joined columns
+	m_dateTimeKey = (m_sources.constFirst().keyColumn->columnMode() == AbstractColumn::DateTime);
+	removeColumns(0, columnCount());
+
+	auto* timeColumn = new Column(i18n("timestamp"), m_dateTimeKey ? AbstractColumn::DateTime : AbstractColumn::Numeric);
+	timeColumn->setPlotDesignation(AbstractColumn::X);
+	addChild(timeColumn);
+	for (const auto& source : m_sources) {
+		for (const auto* valueColumn : source.valueColumns) {
+			auto* column = new Column(source.spreadsheet->name() + QLatin1Char('.') + valueColumn->name(), AbstractColumn::Numeric);
+			column->setPlotDesignation(AbstractColumn::Y);
+			addChild(column);
+		}
+	}
+
+	for (auto* column : children<Column>()) {
+		column->setUndoAware(false);
+		column->setSuppressDataChangedSignal(true);
+	}
+
+	//the columns are used as circular buffers if only the last values are kept
+	if (m_keepNValues > 0)
+		setRowCount(m_keepNValues);
+
+	//reset the cursors
+	for (auto& source : m_sources) {
+		source.leftKey = -INFINITY;
+		source.leftValues.fill(NAN, source.valueColumns.size());
+	}
+	m_lastTime = -INFINITY;
+	m_gridStart = NAN;
+	m_gridIndex = 0;
+
+	m_prepared = true;
+	return true;
+}
+
+/*!
+ * joins the rows of the sources available since the last call.
+ */
+void LiveDataJoin::update() {
+	if (!m_prepared && !prepare())
+		return;
+
+	PERFTRACE("LiveDataJoin::update()");
+
+	//all timestamps up to the smallest last key of the sources can be joined
+	double end = INFINITY;
+	double start = INFINITY;
+	for (const auto& source : m_sources) {
+		if (!source.spreadsheet)
+			return;
+
+		const Column* key = source.keyColumn;
+		const int rows = key->rowCount();
+		const double last = (rows > 0) ? keyAt(key, rows - 1) : -INFINITY;
+		if (last == -INFINITY)
+			return;	//no data yet
+
+		end = qMin(end, last);
+		if (std::isnan(m_gridStart))
+			start = qMin(start, keyAt(key, upperBound(key, rows, -INFINITY)));
+	}
+
+	//determine the new timestamps
+	QVector<double> times;
+	if (m_interval > 0.) {
+		if (std::isnan(m_gridStart))
+			m_gridStart = std::floor(start/m_interval) * m_interval;
+
+		double time;
+		while ((time = m_gridStart + m_gridIndex * m_interval) <= end) {
+			times << time;
+			++m_gridIndex;
+		}
+	} else {
+		const Column* key = m_sources.constFirst().keyColumn;
+		const int rows = key->rowCount();
+		for (int row = upperBound(key, rows, m_lastTime); row < rows; ++row) {
+			const double time = keyAt(key, row);
+			if (time > end)
+				break;
+			times << time;
+		}
+	}
+
+	if (times.isEmpty())
+		return;
+
+	m_lastTime = times.constLast();
+
+	//determine the values of the sources at the new timestamps, the rows of every source are processed only once
+	QVector<QVector<double>> values;
+	for (auto& source : m_sources) {
+		const Column* key = source.keyColumn;
+		const int rows = key->rowCount();
+		const int cols = source.valueColumns.size();
+		const int offset = values.size();
+		values.resize(offset + cols);
+		for (int c = 0; c < cols; ++c)
+			values[offset + c].reserve(times.size());
+
+		int row = upperBound(key, rows, source.leftKey);
+		for (double time : times) {
+			//advance the cursor to the last row before or at the timestamp
+			while (row < rows) {
+				const double k = keyAt(key, row);
+				if (k > time)
+					break;
+				source.leftKey = k;
+				for (int c = 0; c < cols; ++c)
+					source.leftValues[c] = source.valueColumns.at(c)->valueAt(row);
+				++row;
+			}
+
+			//the timestamp is not after the last key, a next row exists if the last row is not at the timestamp
+			const bool interpolate = (m_method != LastValue && source.leftKey != time && row < rows);
+			const double rightKey = interpolate ? keyAt(key, row) : NAN;
+			for (int c = 0; c < cols; ++c) {
+				double value = source.leftValues.at(c);
+				if (interpolate) {
+					const double rightValue = source.valueColumns.at(c)->valueAt(row);
+					if (m_method == Nearest) {
+						if (rightKey - time < time - source.leftKey)
+							value = rightValue;
+					} else
+						value += (rightValue - value) * (time - source.leftKey)/(rightKey - source.leftKey);
+				}
+				values[offset + c] << value;
+			}
+		}
+	}
+
+	//append the new rows, if only the last values are kept the oldest rows are evicted
+	const int newRows = times.size();
+	const int cols = columnCount();
+	int size;	//size of the columns
+	int row;	//first row to write to
+	int skip = 0;	//number of new rows not fitting into the columns with a fixed size
+	if (m_keepNValues == 0) {
+		row = rowCount();
+		setRowCount(row + newRows);
+		size = rowCount();
+	} else {
+		size = rowCount();
+		const int n = qMin(newRows, size);
+		skip = newRows - n;
+		row = size - n;
+		for (int c = 0; c < cols; ++c)
+			column(c)->evictRows(n);
+	}
+
+	QVector<Column*> columns;
+	for (int c = 0; c < cols; ++c) {
+		Column* col = column(c);
+		columns << col;
+		void* data = (m_keepNValues == 0) ? col->data() : col->ringData();
+		const int ringOffset = (m_keepNValues == 0) ? 0 : col->ringOffset();
+		for (int i = skip; i < newRows; ++i) {
+			const int index = (row + i - skip + ringOffset) % size;
+			if (c == 0 && m_dateTimeKey)
+				(*static_cast<QVector<QDateTime>*>(data))[index] = QDateTime::fromMSecsSinceEpoch((qint64)times.at(i));
+			else
+				(*static_cast<QVector<double>*>(data))[index] = (c == 0) ? times.at(i) : values.at(c - 1).at(i);
+		}
+	}
+
+	PlotUpdateScheduler::instance()->setChanged(columns);
+}
+
+/*!
+ * called when new live data was written to the columns \c columns.
+ */
+void LiveDataJoin::sourceDataChanged(const QVector<Column*>& columns) {
+	for (const auto* column : columns) {
+		for (const auto& source : m_sources) {
+			if (source.spreadsheet && column->parentAspect() == source.spreadsheet) {
+				update();
+				return;
+			}
+		}
+	}
+}
+
+/*!
+ * the sources are removed from the join if they or one of their parents are removed.
+ * If a column of a source is removed, the columns are determined again on the next update.
+ */
+void LiveDataJoin::sourceAboutToBeRemoved(const AbstractAspect* aspect) {
+	for (int i = m_sources.size() - 1; i >= 0; --i) {
+		const Spreadsheet* spreadsheet = m_sources.at(i).spreadsheet;
+		if (!spreadsheet)
+			continue;
+
+		if (aspect->parentAspect() == spreadsheet) {
+			m_prepared = false;
+			continue;
+		}
+
+		for (const AbstractAspect* parent = spreadsheet; parent; parent = parent->parentAspect()) {
+			if (parent == aspect) {
+				m_sources.remove(i);
+				m_prepared = false;
+				break;
+			}
+		}
+	}
+}
+
+void LiveDataJoin::connectSource(const Spreadsheet* spreadsheet) {
+	for (const AbstractAspect* parent = spreadsheet; parent; parent = parent->parentAspect())
+		connect(parent, &AbstractAspect::aspectAboutToBeRemoved, this, &LiveDataJoin::sourceAboutToBeRemoved, Qt::UniqueConnection);
+}
+
+//##############################################################################
+//##################  Serialization/Deserialization  ###########################
+//##############################################################################
+/*!
+  Saves as XML. The joined columns are not saved, they are recalculated from the sources on load.
+ */
+void LiveDataJoin::save(QXmlStreamWriter* writer) const {
+	writer->writeStartElement("liveDataJoin");
+	writeBasicAttributes(writer);
+	writeCommentElement(writer);
+
+	writer->writeStartElement("general");
+	writer->writeAttribute("method", QString::number(m_method));
+	writer->writeAttribute("interval", QString::number(m_interval, 'g', 16));
+	writer->writeAttribute("keepNValues", QString::number(m_keepNValues));
+	writer->writeEndElement();
+
+	for (const auto& source : m_sources) {
+		writer->writeStartElement("source");
+		writer->writeAttribute("path", source.spreadsheet ? source.spreadsheet->path() : source.path);
+		writer->writeAttribute("keyColumn", source.keyColumnName);
+		writer->writeEndElement();
+	}
+
+	writer->writeEndElement(); // "liveDataJoin"
+}
+
+/*!
+  Loads from XML.
+*/
+bool LiveDataJoin::load(XmlStreamReader* reader, bool preview) {
+	Q_UNUSED(preview)
+	if (!readBasicAttributes(reader))
+		return false;
+
+	KLocalizedString attributeWarning = ki18n("Attribute '%1' missing or empty, default value is used");
+	QXmlStreamAttributes attribs;
+	QString str;
+
+	while (!reader->atEnd()) {
+		reader->readNext();
+		if (reader->isEndElement() && reader->name() == "liveDataJoin")
+			break;
+
+		if (!reader->isStartElement())
+			continue;
+
+		if (reader->name() == "comment") {
+			if (!readCommentElement(reader))
+				return false;
+		} else if (reader->name() == "general") {
+			attribs = reader->attributes();
+
+			str = attribs.value("method").toString();
+			if (str.isEmpty())
+				reader->raiseWarning(attributeWarning.subs("method").toString());
+			else
+				m_method = static_cast<Method>(str.toInt());
+
+			str = attribs.value("interval").toString();
+			if (str.isEmpty())
+				reader->raiseWarning(attributeWarning.subs("interval").toString());
+			else
+				m_interval = str.toDouble();
+
+			str = attribs.value("keepNValues").toString();
+			if (str.isEmpty())
+				reader->raiseWarning(attributeWarning.subs("keepNValues").toString());
+			else
+				m_keepNValues = str.toInt();
+		} else if (reader->name() == "source") {
+			attribs = reader->attributes();
+			Source source;
+			source.path = attribs.value("path").toString();
+			source.keyColumnName = attribs.value("keyColumn").toString();
+			m_sources << source;
+		} else {// unknown element
+			reader->raiseWarning(i18n("unknown element '%1'", reader->name().toString()));
+			if (!reader->skipToEndElement()) return false;
+		}
+	}
+
+	return !reader->hasError();
+}
+
+/*!
+ * restores the pointers to the sources after the project was loaded and joins their data.
+ */
+void LiveDataJoin::finalizeLoad() {
+	const Project* project = this->project();
+	const auto spreadsheets = project ? project->children<Spreadsheet>(AbstractAspect::Recursive) : QVector<Spreadsheet*>();
+	for (int i = m_sources.size() - 1; i >= 0; --i) {
+		auto& source = m_sources[i];
+		for (auto* spreadsheet : spreadsheets) {
+			if (spreadsheet->path() == source.path) {
+				source.spreadsheet = spreadsheet;
+				connectSource(spreadsheet);
+				break;
+			}
+		}
+
+		if (!source.spreadsheet) {
+			DEBUG("LiveDataJoin::finalizeLoad(): source " << source.path.toStdString() << " not found");
+			m_sources.remove(i);
+		}
+	}
+
+	recalculate();
+}
@@ -0,0 +1,104 @@
+/***************************************************************************
+    File                 : LiveDataJoin.h
+    Project              : LabPlot
+    Description          : Timestamp aligned join of several live data sources
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef LIVEDATAJOIN_H
+#define LIVEDATAJOIN_H
+
+#include "backend/spreadsheet/Spreadsheet.h"
+
+#include <QPointer>
+#include <QVector>
+
+class LiveDataJoin : public Spreadsheet {
+	Q_OBJECT
+
+public:
+	enum Method {
+		Nearest = 0,	// value of the row nearest to the timestamp
+		Linear,		// linear interpolation between the rows before and after the timestamp
+		LastValue	// value of the last row before or at the timestamp
+	};
+
+	explicit LiveDataJoin(const QString& name, bool loading = false);
+
+	void addSource(Spreadsheet*, const QString& keyColumnName = QString());
+	void removeSource(const Spreadsheet*);
+	QVector<Spreadsheet*> sources() const;
+	QString keyColumnName(const Spreadsheet*) const;
+
+	void setMethod(Method);
+	Method method() const;
+
+	void setInterval(double);
+	double interval() const;
+
+	void setKeepNValues(int);
+	int keepNValues() const;
+
+	void recalculate();
+
+	QWidget* view() const override;
+
+	void save(QXmlStreamWriter*) const override;
+	bool load(XmlStreamReader*, bool preview) override;
+	void finalizeLoad();
+
+private slots:
+	void sourceDataChanged(const QVector<Column*>&);
+	void sourceAboutToBeRemoved(const AbstractAspect*);
+
+private:
+	struct Source {
+		QPointer<Spreadsheet> spreadsheet;
+		QString path;		// path of the source, used on load
+		QString keyColumnName;	// name of the key (timestamp) column, the first DateTime column if empty
+		Column* keyColumn{nullptr};
+		QVector<Column*> valueColumns;
+
+		//cursor, the last row with a key before or at the last joined timestamp
+		double leftKey{0.};
+		QVector<double> leftValues;
+	};
+
+	bool prepare();
+	void reset();
+	void update();
+	void connectSource(const Spreadsheet*);
+
+	QVector<Source> m_sources;
+	Method m_method{LastValue};
+	double m_interval{1000.};	// distance of the timestamps in ms or in units of the key, 0 - keys of the first source
+	int m_keepNValues{0};		// number of rows to keep (0 - all)
+
+	bool m_prepared{false};
+	bool m_dateTimeKey{false};	// the keys are DateTime values, the timestamps are stored as DateTime
+	double m_lastTime{0.};		// last joined timestamp
+	double m_gridStart{0.};		// first timestamp of the regular grid
+	qint64 m_gridIndex{0};		// index of the next timestamp on the regular grid
+};
+
+#endif
@@ -0,0 +1,503 @@
+/***************************************************************************
+    File                 : LiveDataReader.cpp
+    Project              : LabPlot
+    Description          : Reads and parses the data of a live data source in a separate thread
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "backend/datasources/LiveDataReader.h"
+#include "backend/datasources/filters/AsciiFilter.h"
+#include "backend/lib/macros.h"
+
+#include <QFile>
+#include <QFileInfo>
+#include <QFileSystemWatcher>
+#include <QLocalSocket>
+#include <QTcpSocket>
+#include <QUdpSocket>
+
+#ifdef Q_OS_UNIX
+#include <sys/stat.h>
+#endif
+
+/*!
+  \class LiveDataReader
+  \brief Reads the data of a LiveDataSource from the device and parses it in a separate thread.
+
+  The device (file, pipe or socket) is created and read in the reader thread. The parsed rows are
+  collected in blocks of typed column data that are passed to the GUI thread via a lock-free
+  single producer/single consumer ring buffer. The GUI thread only appends the finished blocks
+  to the columns (see LiveDataSource::consumeData()) and notifies the columns and plots once
+  for all blocks available at that moment.
+
+  If the consumer doesn't keep up and the ring is full, the reader stops reading from files and
+  stream sockets until blocks were taken from the ring (back-pressure). For UDP sockets the
+  datagrams not read in time would be lost anyway, here the new rows are dropped instead.
+  The number of the stalls and of the dropped rows is available via stalls() and droppedRows().
+
+  Files updated on new data are followed like with "tail -F": the reader thread watches the file
+  itself and reads the appended bytes immediately after each change, continuing at the position
+  where it stopped and keeping the incomplete last line until its line break arrives. If the file
+  is truncated or replaced by a new file (e.g. log rotation), reading continues at the beginning
+  of the new content. No timer is involved, an unchanged file causes no activity at all.
+
+  \ingroup datasources
+*/
+
+/*!
+ * creates the reader for the data source \c source, the data is parsed with the settings of \c filter.
+ * At most \c ringCapacity blocks wait for the consumer.
+ */
+LiveDataReader::LiveDataReader(const LiveDataSource* source, AsciiFilter* filter, int ringCapacity) :
+	m_ring(ringCapacity),
+	m_sourceType(source->sourceType()),
+	m_updateType(source->updateType()),
+	m_fileName(source->fileName()),
+	m_localSocketName(source->localSocketName()),
+	m_host(source->host()),
+	m_port(source->port()),
+	m_columnModes(filter->columnModes()),
+	m_separator(filter->separator()),
+	m_commentCharacter(filter->commentCharacter()),
+	m_dateTimeFormat(filter->dateTimeFormat()),
+	m_locale(filter->numberFormat()),
+	m_nanValue(filter->NaNValueToZeroEnabled() ? 0. : NAN),
+	m_skipEmptyParts(filter->skipEmptyParts()),
+	m_simplifyWhitespaces(filter->simplifyWhitespacesEnabled()),
+	m_removeQuotes(filter->removeQuotesEnabled()),
+	m_createIndex(filter->createIndexEnabled()) {
+}
+
+LiveDataReader::~LiveDataReader() {
+	stop();
+}
+
+/*!
+ * starts reading from the position \c from of the device in the reader thread.
+ * \c firstIndex is the first value written into the index column if the index is created.
+ */
+void LiveDataReader::start(qint64 from, int firstIndex) {
+	m_from = from;
+	m_index = firstIndex;
+	newBlock();
+
+	moveToThread(&m_thread);
+	m_thread.start();
+	QMetaObject::invokeMethod(this, "open", Qt::QueuedConnection);
+}
+
+/*!
+ * closes the device and stops the reader thread. Rows not taken yet are discarded.
+ */
+void LiveDataReader::stop() {
+	if (!m_thread.isRunning())
+		return;
+
+	QMetaObject::invokeMethod(this, "close", Qt::BlockingQueuedConnection);
+	m_thread.quit();
+	m_thread.wait();
+}
+
+/*!
+ * requests the reader thread to read new data, called periodically or if the file was changed.
+ */
+void LiveDataReader::requestRead() {
+	QMetaObject::invokeMethod(this, "read", Qt::QueuedConnection);
+}
+
+/*!
+ * moves all blocks parsed so far into \c blocks. Called in the GUI thread.
+ */
+void LiveDataReader::takeBlocks(QVector<LiveDataBlock>& blocks) {
+	//reset the flag before taking the blocks, a block pushed afterwards triggers a new notification
+	m_notified = false;
+
+	LiveDataBlock block;
+	while (m_ring.pop(block))
+		blocks.push_back(std::move(block));
+
+	//the reader stopped reading since the ring was full, continue now
+	if (m_blocked)
+		QMetaObject::invokeMethod(this, "readyRead", Qt::QueuedConnection);
+}
+
+/*!
+ * returns the number of rows dropped since the consumer didn't keep up with the data received via UDP.
+ */
+quint64 LiveDataReader::droppedRows() const {
+	return m_droppedRows;
+}
+
+/*!
+ * returns how often the reader had to wait for the consumer to take the parsed data.
+ */
+quint64 LiveDataReader::stalls() const {
+	return m_stalls;
+}
+
+//##############################################################################
+//##########################  reader thread  ###################################
+//##############################################################################
+void LiveDataReader::open() {
+	switch (m_sourceType) {
+	case LiveDataSource::FileOrPipe: {
+		if (!openFile(m_from))
+			return;
+
+		//tail mode: watch the file and its directory to get notified about appends, truncation and replacement
+		if (m_updateType == LiveDataSource::NewData && !m_device->isSequential()) {
+			m_watcher = new QFileSystemWatcher(this);
+			m_watcher->addPath(m_fileName);
+			m_watcher->addPath(QFileInfo(m_fileName).absolutePath());
+			connect(m_watcher, &QFileSystemWatcher::fileChanged, this, &LiveDataReader::fileChanged);
+			connect(m_watcher, &QFileSystemWatcher::directoryChanged, this, &LiveDataReader::fileChanged);
+
+			//read the data appended since the last read in the GUI thread
+			readDevice();
+		}
+		break;
+	}
+	case LiveDataSource::NetworkTcpSocket: {
+		auto* socket = new QTcpSocket(this);
+		//limit the buffered data so the sender is slowed down by the TCP flow control when we stop reading
+		socket->setReadBufferSize(4 * 1024 * 1024);
+		connect(socket, &QTcpSocket::readyRead, this, &LiveDataReader::readyRead);
+		socket->connectToHost(m_host, m_port, QIODevice::ReadOnly);
+		m_device = socket;
+		break;
+	}
+	case LiveDataSource::NetworkUdpSocket: {
+		auto* socket = new QUdpSocket(this);
+		socket->bind(QHostAddress(m_host), m_port);
+		socket->connectToHost(m_host, 0, QUdpSocket::ReadOnly);
+		if (m_updateType == LiveDataSource::NewData)
+			connect(socket, &QUdpSocket::readyRead, this, &LiveDataReader::readyRead);
+		m_device = socket;
+		break;
+	}
+	case LiveDataSource::LocalSocket: {
+		auto* socket = new QLocalSocket(this);
+		connect(socket, &QLocalSocket::readyRead, this, &LiveDataReader::readyRead);
+		socket->connectToServer(m_localSocketName, QLocalSocket::ReadOnly);
+		m_device = socket;
+		break;
+	}
+	case LiveDataSource::SerialPort:
+	case LiveDataSource::MQTT:
+		break;
+	}
+}
+
+void LiveDataReader::close() {
+	delete m_watcher;
+	m_watcher = nullptr;
+	delete m_device;
+	m_device = nullptr;
+}
+
+/*!
+ * returns the identity of the file \c fileName or of the file opened with the descriptor \c handle
+ * (device and inode), 0 if not available.
+ */
+static quint64 fileId(const QString& fileName, int handle = -1) {
+#ifdef Q_OS_UNIX
+	struct stat info;
+	const int rc = (handle != -1) ? fstat(handle, &info) : stat(QFile::encodeName(fileName).constData(), &info);
+	if (rc == 0)
+		return ((quint64)info.st_dev << 32) ^ (quint64)info.st_ino;
+#else
+	Q_UNUSED(fileName);
+	Q_UNUSED(handle);
+#endif
+	return 0;
+}
+
+/*!
+ * opens the file and starts reading at the position \c from. Returns \c false if the file couldn't be opened.
+ */
+bool LiveDataReader::openFile(qint64 from) {
+	auto* file = new QFile(m_fileName, this);
+	if (!file->open(QIODevice::ReadOnly | QIODevice::Unbuffered)) {
+		DEBUG("LiveDataReader::openFile(): failed to open the file " << m_fileName.toStdString());
+		delete file;
+		return false;
+	}
+	if (!file->isSequential())
+		file->seek(from);
+	m_fileId = fileId(m_fileName, file->handle());
+	m_device = file;
+	return true;
+}
+
+/*!
+ * called in the tail mode when the watched file or its directory was changed.
+ * Detects the truncation and the replacement of the file and reads the new data.
+ */
+void LiveDataReader::fileChanged() {
+	//the file was removed or renamed, inotify stops watching it. Read the rest of the old file
+	//and wait for the new file, it's opened once it was created in the watched directory.
+	if (!QFileInfo::exists(m_fileName)) {
+		readDevice();
+		return;
+	}
+	if (!m_watcher->files().contains(m_fileName))
+		m_watcher->addPath(m_fileName);
+
+	auto* file = static_cast<QFile*>(m_device);
+	const quint64 id = fileId(m_fileName);
+	const bool replaced = !file || (id != 0 && id != m_fileId);
+	const bool truncated = !replaced && file->size() < file->pos();
+	if (replaced || truncated) {
+		//waiting for the consumer, the change is handled with the next notification
+		if (m_blocked)
+			return;
+
+		DEBUG("LiveDataReader::fileChanged(): file " << (replaced ? "replaced" : "truncated") << ", reading from the beginning");
+		//take the rest of the old content including the incomplete last line
+		if (replaced && file) {
+			readDevice();
+			if (m_blocked)
+				return;
+			if (!m_remainder.isEmpty()) {
+				parseLine(QString::fromUtf8(m_remainder));
+				m_block.bytes += m_remainder.size();
+			}
+		}
+		m_remainder.clear();
+
+		//start a new block, the consumer starts counting the bytes read at the beginning of the file
+		if (m_block.rows == 0)
+			m_block.bytes = 0;
+		if (!publishBlock())
+			return;
+		if (replaced) {
+			delete m_device;
+			m_device = nullptr;
+			if (!openFile(0))
+				return;
+		} else
+			file->seek(0);
+		m_block.restarted = true;
+	}
+
+	readDevice();
+}
+
+/*!
+ * reads new data, for sockets a new connection is made to request new data from the server.
+ */
+void LiveDataReader::read() {
+	if (!m_device)
+		return;
+
+	switch (m_sourceType) {
+	case LiveDataSource::FileOrPipe:
+	case LiveDataSource::NetworkUdpSocket:
+		readDevice();
+		break;
+	case LiveDataSource::NetworkTcpSocket: {
+		auto* socket = static_cast<QTcpSocket*>(m_device);
+		socket->abort();
+		socket->connectToHost(m_host, m_port, QIODevice::ReadOnly);
+		break;
+	}
+	case LiveDataSource::LocalSocket: {
+		auto* socket = static_cast<QLocalSocket*>(m_device);
+		if (socket->state() == QLocalSocket::ConnectingState)
+			socket->abort();
+		socket->connectToServer(m_localSocketName, QLocalSocket::ReadOnly);
+		if (socket->waitForConnected())
+			socket->waitForReadyRead();
+		break;
+	}
+	case LiveDataSource::SerialPort:
+	case LiveDataSource::MQTT:
+		break;
+	}
+}
+
+/*!
+ * called when new data is available in a socket.
+ */
+void LiveDataReader::readyRead() {
+	readDevice();
+
+	//request the next data from the server like in LiveDataSource::readyRead(),
+	//but not while waiting for the consumer
+	if (m_updateType == LiveDataSource::NewData && !m_blocked
+		&& (m_sourceType == LiveDataSource::NetworkTcpSocket || m_sourceType == LiveDataSource::LocalSocket))
+		read();
+}
+
+/*!
+ * reads all data available in the device, parses the complete lines and passes the rows to the consumer.
+ */
+void LiveDataReader::readDevice() {
+	if (!m_device)
+		return;
+
+	//the last block is still waiting for free space in the ring, don't read any further
+	if (m_blocked && !publishBlock())
+		return;
+
+	static const qint64 chunkSize = 1024 * 1024;
+	while (true) {
+		const QByteArray data = m_device->read(chunkSize);
+		if (data.isEmpty())
+			break;
+
+		m_remainder.append(data);
+		int start = 0;
+		int end;
+		while ((end = m_remainder.indexOf('\n', start)) != -1) {
+			int length = end - start;
+			if (length > 0 && m_remainder.at(end - 1) == '\r')
+				--length;
+			parseLine(QString::fromUtf8(m_remainder.constData() + start, length));
+			m_block.bytes += end + 1 - start;
+			start = end + 1;
+		}
+		m_remainder.remove(0, start);
+
+		//every datagram is complete, don't wait for a line break
+		if (m_sourceType == LiveDataSource::NetworkUdpSocket && !m_remainder.isEmpty()) {
+			parseLine(QString::fromUtf8(m_remainder));
+			m_block.bytes += m_remainder.size();
+			m_remainder.clear();
+		}
+
+		if (m_block.rows >= blockRows && !publishBlock())
+			return;
+	}
+
+	publishBlock();
+}
+
+void LiveDataReader::newBlock() {
+	const int cols = m_columnModes.size();
+	m_block = LiveDataBlock();
+	m_block.numericData.resize(cols);
+	m_block.integerData.resize(cols);
+	m_block.dateTimeData.resize(cols);
+	m_block.textData.resize(cols);
+}
+
+/*!
+ * passes the current block to the consumer. Returns \c false if the ring is full and the block
+ * is kept to be passed later, the reading has to be stopped then. Returns \c true otherwise.
+ */
+bool LiveDataReader::publishBlock() {
+	if (m_block.rows == 0)
+		return true;
+
+	if (!m_ring.push(std::move(m_block))) {
+		if (m_sourceType == LiveDataSource::NetworkUdpSocket) {
+			m_droppedRows += m_block.rows;
+			DEBUG("LiveDataReader: consumer too slow, " << m_block.rows << " rows dropped");
+			newBlock();
+			return true;
+		}
+
+		//set the flag before trying again: either the consumer took blocks in the meantime
+		//and the second attempt succeeds or the consumer sees the flag and resumes the reading
+		m_blocked = true;
+		if (!m_ring.push(std::move(m_block))) {
+			++m_stalls;
+			return false;
+		}
+	}
+
+	m_blocked = false;
+	newBlock();
+
+	//notify the consumer only once until it took the blocks
+	if (!m_notified.exchange(true))
+		emit dataAvailable();
+
+	return true;
+}
+
+/*!
+ * parses the line \c line and appends the values to the current block.
+ * The conversion of the values is the same as in AsciiFilter::readFromLiveDevice().
+ */
+void LiveDataReader::parseLine(const QString& line) {
+	if (line.isEmpty() || (!m_commentCharacter.isEmpty() && line.startsWith(m_commentCharacter))) // skip empty or commented lines
+		return;
+
+	QStringList lineStringList;
+	// only FileOrPipe support multiple columns
+	if (m_sourceType == LiveDataSource::FileOrPipe)
+		lineStringList = line.split(m_separator, (QString::SplitBehavior)m_skipEmptyParts);
+	else
+		lineStringList << line;
+
+	if (m_simplifyWhitespaces) {
+		for (int i = 0; i < lineStringList.size(); ++i)
+			lineStringList[i] = lineStringList[i].simplified();
+	}
+
+	int offset = 0;
+	if (m_createIndex) {
+		m_block.integerData[0].push_back(m_index++);
+		offset = 1;
+	}
+
+	for (int n = offset; n < m_columnModes.size(); ++n) {
+		const bool missing = (n - offset >= lineStringList.size());
+		QString valueString;
+		if (!missing) {
+			valueString = lineStringList.at(n - offset);
+			if (m_removeQuotes)
+				valueString.remove(QLatin1Char('"'));
+		}
+
+		switch (m_columnModes.at(n)) {
+		case AbstractColumn::Numeric: {
+			bool isNumber = false;
+			const double value = missing ? 0. : m_locale.toDouble(valueString, &isNumber);
+			m_block.numericData[n].push_back(isNumber ? value : m_nanValue);
+			break;
+		}
+		case AbstractColumn::Integer: {
+			bool isNumber = false;
+			const int value = missing ? 0 : m_locale.toInt(valueString, &isNumber);
+			m_block.integerData[n].push_back(isNumber ? value : 0);
+			break;
+		}
+		case AbstractColumn::DateTime:
+			m_block.dateTimeData[n].push_back(missing ? QDateTime() : QDateTime::fromString(valueString, m_dateTimeFormat));
+			break;
+		case AbstractColumn::Text:
+			m_block.textData[n].push_back(valueString);
+			break;
+		case AbstractColumn::Month:
+		case AbstractColumn::Day:
+			//TODO
+			break;
+		}
+	}
+
+	m_block.rows++;
+}
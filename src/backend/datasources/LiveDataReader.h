@@ -0,0 +1,115 @@
+/***************************************************************************
+    File                 : LiveDataReader.h
+    Project              : LabPlot
+    Description          : Reads and parses the data of a live data source in a separate thread
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef LIVEDATAREADER_H
+#define LIVEDATAREADER_H
+
+#include "backend/datasources/LiveDataSource.h"
+#include "backend/lib/SPSCRingBuffer.h"
+
+#include <QDateTime>
+#include <QLocale>
+#include <QThread>
+
+#include <atomic>
+
+class AsciiFilter;
+class QFileSystemWatcher;
+
+class LiveDataReader : public QObject {
+	Q_OBJECT
+
+public:
+	LiveDataReader(const LiveDataSource*, AsciiFilter*, int ringCapacity = ringSize);
+	~LiveDataReader() override;
+
+	void start(qint64 from, int firstIndex);
+	void stop();
+	void requestRead();
+
+	void takeBlocks(QVector<LiveDataBlock>&);
+	quint64 droppedRows() const;
+	quint64 stalls() const;
+
+	static const int blockRows = 4096;	// max. number of rows in one block
+	static const int ringSize = 64;		// default max. number of blocks waiting for the consumer
+
+signals:
+	void dataAvailable();
+
+private slots:
+	void open();
+	void close();
+	void read();
+	void readyRead();
+	void readDevice();
+	void fileChanged();
+
+private:
+	bool openFile(qint64 from);
+	void newBlock();
+	bool publishBlock();
+	void parseLine(const QString&);
+
+	QThread m_thread;
+	SPSCRingBuffer<LiveDataBlock> m_ring;
+	std::atomic<bool> m_notified{false};
+	std::atomic<bool> m_blocked{false};
+	std::atomic<quint64> m_droppedRows{0};
+	std::atomic<quint64> m_stalls{0};
+
+	//settings of the data source, copied when creating the reader
+	LiveDataSource::SourceType m_sourceType;
+	LiveDataSource::UpdateType m_updateType;
+	QString m_fileName;
+	QString m_localSocketName;
+	QString m_host;
+	quint16 m_port;
+
+	//settings of the filter, copied when creating the reader
+	QVector<AbstractColumn::ColumnMode> m_columnModes;
+	QString m_separator;
+	QString m_commentCharacter;
+	QString m_dateTimeFormat;
+	QLocale m_locale;
+	double m_nanValue;
+	bool m_skipEmptyParts;
+	bool m_simplifyWhitespaces;
+	bool m_removeQuotes;
+	bool m_createIndex;
+
+	//state of the reader, only accessed in the reader thread
+	QIODevice* m_device{nullptr};
+	QFileSystemWatcher* m_watcher{nullptr};	//watches the file in the tail mode
+	quint64 m_fileId{0};	//identity (inode) of the opened file, 0 if not available
+	qint64 m_from{0};
+	int m_index{1};
+	QByteArray m_remainder;	//incomplete last line read from the device
+	LiveDataBlock m_block;	//block being filled or waiting for free space in the ring
+};
+
+#endif
@@ -0,0 +1,490 @@
+/***************************************************************************
+    File                 : LiveDataRollup.cpp
+    Project              : LabPlot
+    Description          : Aggregates of a live data column in time windows
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "backend/datasources/LiveDataRollup.h"
+#include "backend/core/Project.h"
+#include "backend/core/column/Column.h"
+#include "backend/lib/XmlStreamReader.h"
+#include "backend/lib/macros.h"
+#include "backend/lib/trace.h"
+#include "backend/worksheet/plots/cartesian/PlotUpdateScheduler.h"
+#include "commonfrontend/spreadsheet/SpreadsheetView.h"
+
+#include <QDateTime>
+
+#include <KLocalizedString>
+
+#include <cmath>
+
+/*!
+  \class LiveDataRollup
+  \brief Aggregates the values of a live data column in time windows ("rollup").
+
+  The rows of the column are grouped into windows of the size window() of the key column, by default
+  the first DateTime column of the spreadsheet containing the column, or its first numeric column if there
+  is no DateTime column. The windows are aligned to multiples of the window size, e.g. to full seconds
+  or minutes for DateTime keys. For every window the count, mean, minimum, maximum, last value and
+  the standard deviation of the non-NAN values are calculated, the aggregates to calculate are set via
+  setAggregates(). Windows without rows are skipped.
+
+  The aggregates are updated incrementally on new live data, the new rows are found via a binary search
+  on the key column and every row is processed only once. A window is appended once a row after it
+  arrives, the rows already appended don't change anymore. The keys are expected to be sorted ascending.
+  Plots bound to the rollup only have to process the windows instead of the raw rows.
+
+  \ingroup datasources
+*/
+LiveDataRollup::LiveDataRollup(const QString& name, bool loading) : Spreadsheet(name, true, AspectType::LiveDataRollup) {
+	Q_UNUSED(loading)
+	setUndoAware(false);
+	connect(PlotUpdateScheduler::instance(), &PlotUpdateScheduler::dataChanged, this, &LiveDataRollup::sourceDataChanged);
+}
+
+QWidget* LiveDataRollup::view() const {
+	if (!m_partView) {
+		m_view = new SpreadsheetView(const_cast<LiveDataRollup*>(this), true);
+		m_partView = m_view;
+	}
+	return m_partView;
+}
+
+/*!
+ * sets the column \c column to aggregate. The windows are determined by the column \c keyColumnName
+ * of the same spreadsheet, or by its first DateTime column if empty.
+ */
+void LiveDataRollup::setSourceColumn(Column* column, const QString& keyColumnName) {
+	m_column = column;
+	m_columnPath = column ? column->path() : QString();
+	m_keyColumnName = keyColumnName;
+
+	connectSource();
+	recalculate();
+}
+
+Column* LiveDataRollup::sourceColumn() const {
+	return m_column;
+}
+
+QString LiveDataRollup::keyColumnName() const {
+	return m_keyColumnName;
+}
+
+/*!
+ * sets the size of the windows in ms for DateTime keys, in the units of the key otherwise.
+ */
+void LiveDataRollup::setWindow(double window) {
+	if (window <= 0.)
+		return;
+
+	m_window = window;
+	recalculate();
+}
+
+double LiveDataRollup::window() const {
+	return m_window;
+}
+
+void LiveDataRollup::setAggregates(Aggregates aggregates) {
+	m_aggregates = aggregates;
+	recalculate();
+}
+
+LiveDataRollup::Aggregates LiveDataRollup::aggregates() const {
+	return m_aggregates;
+}
+
+/*!
+ * sets the number of the last windows to keep, 0 to keep all windows.
+ */
+void LiveDataRollup::setKeepNValues(int keepNValues) {
+	m_keepNValues = qMax(keepNValues, 0);
+	recalculate();
+}
+
+int LiveDataRollup::keepNValues() const {
+	return m_keepNValues;
+}
+
+/*!
+ * recreates the columns and aggregates all rows currently available in the source.
+ */
+void LiveDataRollup::recalculate() {
+	m_prepared = false;
+	update();
+}
+
+/*!
+ * returns the key of the row \c row in ms for DateTime columns, -INFINITY for rows without a valid key.
+ */
+static double keyAt(const Column* column, int row) {
+	if (column->columnMode() == AbstractColumn::DateTime) {
+		const QDateTime& dateTime = column->dateTimeAt(row);
+		return dateTime.isValid() ? dateTime.toMSecsSinceEpoch() : -INFINITY;
+	}
+
+	const double value = column->valueAt(row);
+	return std::isnan(value) ? -INFINITY : value;
+}
+
+/*!
+ * returns the first row of the first \c rows rows of \c column with a key larger than \c key.
+ */
+static int upperBound(const Column* column, int rows, double key) {
+	int first = 0;
+	while (rows > 0) {
+		const int step = rows/2;
+		if (keyAt(column, first + step) <= key) {
+			first += step + 1;
+			rows -= step + 1;
+		} else
+			rows = step;
+	}
+	return first;
+}
+
+/*!
+ * determines the key column and creates the columns for the windows and for the aggregates.
+ * Returns \c false if the source doesn't provide a key column.
+ */
+bool LiveDataRollup::prepare() {
+	if (!m_column)
+		return false;
+
+	const auto* spreadsheet = dynamic_cast<const Spreadsheet*>(m_column->parentAspect());
+	if (!spreadsheet)
+		return false;
+
+	m_keyColumn = nullptr;
+	Column* firstNumeric = nullptr;
+	for (auto* column : spreadsheet->children<Column>()) {
+		if (m_keyColumnName.isEmpty()) {
+			if (column->columnMode() == AbstractColumn::DateTime) {
+				m_keyColumn = column;
+				break;
+			}
+			if (!firstNumeric && column != m_column
+				&& (column->columnMode() == AbstractColumn::Numeric || column->columnMode() == AbstractColumn::Integer))
+				firstNumeric = column;
+		} else if (column->name() == m_keyColumnName) {
+			m_keyColumn = column;
+			break;
+		}
+	}
+
+	//no DateTime column, use the first numeric column (e.g. the index) as key
+	if (!m_keyColumn)
+		m_keyColumn = firstNumeric;
+
+	if (!m_keyColumn || m_keyColumn == m_column)
+		return false;
+
+	//create the columns
+	m_dateTimeKey = (m_keyColumn->columnMode() == AbstractColumn::DateTime);
+	removeColumns(0, columnCount());
+
+	auto* windowColumn = new Column(i18n("window"), m_dateTimeKey ? AbstractColumn::DateTime : AbstractColumn::Numeric);
+	windowColumn->setPlotDesignation(AbstractColumn::X);
+	addChild(windowColumn);
+
+	if (m_aggregates & Count)
+		addChild(new Column(i18n("count"), AbstractColumn::Integer));
+	if (m_aggregates & Mean)
+		addChild(new Column(i18n("mean"), AbstractColumn::Numeric));
+	if (m_aggregates & Minimum)
+		addChild(new Column(i18n("min"), AbstractColumn::Numeric));
+	if (m_aggregates & Maximum)
+		addChild(new Column(i18n("max"), AbstractColumn::Numeric));
+	if (m_aggregates & Last)
+		addChild(new Column(i18n("last"), AbstractColumn::Numeric));
+	if (m_aggregates & StandardDeviation)
+		addChild(new Column(i18n("stddev"), AbstractColumn::Numeric));
+
+	for (auto* column : children<Column>()) {
+		if (column != windowColumn)
+			column->setPlotDesignation(AbstractColumn::Y);
+		column->setUndoAware(false);
+		column->setSuppressDataChangedSignal(true);
+	}
+
+	//the columns are used as circular buffers if only the last values are kept
+	if (m_keepNValues > 0)
+		setRowCount(m_keepNValues);
+
+	m_lastKey = -INFINITY;
+	m_windowOpen = false;
+
+	m_prepared = true;
+	return true;
+}
+
+/*!
+ * processes the rows of the source added since the last call and appends the completed windows.
+ */
+void LiveDataRollup::update() {
+	if (!m_prepared && !prepare())
+		return;
+
+	if (!m_column || !m_keyColumn)
+		return;
+
+	PERFTRACE("LiveDataRollup::update()");
+
+	const int rows = qMin(m_keyColumn->rowCount(), m_column->rowCount());
+	QVector<QVector<double>> values(columnCount());	// rows of the completed windows, column by column
+
+	for (int row = upperBound(m_keyColumn, rows, m_lastKey); row < rows; ++row) {
+		const double key = keyAt(m_keyColumn, row);
+		if (key == -INFINITY)
+			continue;
+		m_lastKey = key;
+
+		const qint64 index = (qint64)std::floor(key/m_window);
+		if (m_windowOpen && index != m_windowIndex) {
+			//the window is complete
+			int c = 0;
+			values[c++] << m_windowIndex * m_window;
+			if (m_aggregates & Count)
+				values[c++] << m_count;
+			if (m_aggregates & Mean)
+				values[c++] << (m_count > 0 ? m_mean : NAN);
+			if (m_aggregates & Minimum)
+				values[c++] << (m_count > 0 ? m_min : NAN);
+			if (m_aggregates & Maximum)
+				values[c++] << (m_count > 0 ? m_max : NAN);
+			if (m_aggregates & Last)
+				values[c++] << (m_count > 0 ? m_last : NAN);
+			if (m_aggregates & StandardDeviation)
+				values[c++] << (m_count > 1 ? std::sqrt(m_m2/(m_count - 1)) : NAN);
+			m_windowOpen = false;
+		}
+
+		if (!m_windowOpen) {
+			m_windowOpen = true;
+			m_windowIndex = index;
+			m_count = 0;
+			m_mean = 0.;
+			m_m2 = 0.;
+			m_min = INFINITY;
+			m_max = -INFINITY;
+			m_last = NAN;
+		}
+
+		const double value = m_column->valueAt(row);
+		if (std::isnan(value))
+			continue;
+
+		//Welford's algorithm for the mean and the variance
+		++m_count;
+		const double delta = value - m_mean;
+		m_mean += delta/m_count;
+		m_m2 += delta * (value - m_mean);
+		m_min = qMin(m_min, value);
+		m_max = qMax(m_max, value);
+		m_last = value;
+	}
+
+	const int newRows = values.isEmpty() ? 0 : values.constFirst().size();
+	if (newRows == 0)
+		return;
+
+	//append the new rows, if only the last values are kept the oldest rows are evicted
+	const int cols = columnCount();
+	int size;	//size of the columns
+	int first;	//first row to write to
+	int skip = 0;	//number of new rows not fitting into the columns with a fixed size
+	if (m_keepNValues == 0) {
+		first = rowCount();
+		setRowCount(first + newRows);
+		size = rowCount();
+	} else {
+		size = rowCount();
+		const int n = qMin(newRows, size);
+		skip = newRows - n;
+		first = size - n;
+		for (int c = 0; c < cols; ++c)
+			column(c)->evictRows(n);
+	}
+
+	QVector<Column*> columns;
+	for (int c = 0; c < cols; ++c) {
+		Column* col = column(c);
+		columns << col;
+		void* data = (m_keepNValues == 0) ? col->data() : col->ringData();
+		const int ringOffset = (m_keepNValues == 0) ? 0 : col->ringOffset();
+		for (int i = skip; i < newRows; ++i) {
+			const int index = (first + i - skip + ringOffset) % size;
+			const double value = values.at(c).at(i);
+			switch (col->columnMode()) {
+			case AbstractColumn::DateTime:
+				(*static_cast<QVector<QDateTime>*>(data))[index] = QDateTime::fromMSecsSinceEpoch((qint64)value);
+				break;
+			case AbstractColumn::Integer:
+				(*static_cast<QVector<int>*>(data))[index] = (int)value;
+				break;
+			default:
+				(*static_cast<QVector<double>*>(data))[index] = value;
+			}
+		}
+	}
+
+	PlotUpdateScheduler::instance()->setChanged(columns);
+}
+
+/*!
+ * called when new live data was written to the columns \c columns.
+ */
+void LiveDataRollup::sourceDataChanged(const QVector<Column*>& columns) {
+	if (m_column && columns.contains(m_column))
+		update();
+}
+
+/*!
+ * the column is removed from the rollup if it or one of its parents is removed.
+ * If another column of the source is removed, the key column is determined again on the next update.
+ */
+void LiveDataRollup::sourceAboutToBeRemoved(const AbstractAspect* aspect) {
+	if (!m_column)
+		return;
+
+	for (const AbstractAspect* parent = m_column; parent; parent = parent->parentAspect()) {
+		if (parent == aspect) {
+			m_column = nullptr;
+			m_keyColumn = nullptr;
+			m_prepared = false;
+			return;
+		}
+	}
+
+	if (aspect->parentAspect() == m_column->parentAspect())
+		m_prepared = false;
+}
+
+void LiveDataRollup::connectSource() {
+	if (!m_column)
+		return;
+
+	for (const AbstractAspect* parent = m_column->parentAspect(); parent; parent = parent->parentAspect())
+		connect(parent, &AbstractAspect::aspectAboutToBeRemoved, this, &LiveDataRollup::sourceAboutToBeRemoved, Qt::UniqueConnection);
+}
+
+//##############################################################################
+//##################  Serialization/Deserialization  ###########################
+//##############################################################################
+/*!
+  Saves as XML. The columns are not saved, the aggregates are recalculated from the source on load.
+ */
+void LiveDataRollup::save(QXmlStreamWriter* writer) const {
+	writer->writeStartElement("liveDataRollup");
+	writeBasicAttributes(writer);
+	writeCommentElement(writer);
+
+	writer->writeStartElement("general");
+	writer->writeAttribute("column", m_column ? m_column->path() : m_columnPath);
+	writer->writeAttribute("keyColumn", m_keyColumnName);
+	writer->writeAttribute("window", QString::number(m_window, 'g', 16));
+	writer->writeAttribute("aggregates", QString::number(static_cast<int>(m_aggregates)));
+	writer->writeAttribute("keepNValues", QString::number(m_keepNValues));
+	writer->writeEndElement();
+
+	writer->writeEndElement(); // "liveDataRollup"
+}
+
+/*!
+  Loads from XML.
+*/
+bool LiveDataRollup::load(XmlStreamReader* reader, bool preview) {
+	Q_UNUSED(preview)
+	if (!readBasicAttributes(reader))
+		return false;
+
+	KLocalizedString attributeWarning = ki18n("Attribute '%1' missing or empty, default value is used");
+	QXmlStreamAttributes attribs;
+	QString str;
+
+	while (!reader->atEnd()) {
+		reader->readNext();
+		if (reader->isEndElement() && reader->name() == "liveDataRollup")
+			break;
+
+		if (!reader->isStartElement())
+			continue;
+
+		if (reader->name() == "comment") {
+			if (!readCommentElement(reader))
+				return false;
+		} else if (reader->name() == "general") {
+			attribs = reader->attributes();
+			m_columnPath = attribs.value("column").toString();
+			m_keyColumnName = attribs.value("keyColumn").toString();
+
+			str = attribs.value("window").toString();
+			if (str.isEmpty() || str.toDouble() <= 0.)
+				reader->raiseWarning(attributeWarning.subs("window").toString());
+			else
+				m_window = str.toDouble();
+
+			str = attribs.value("aggregates").toString();
+			if (str.isEmpty())
+				reader->raiseWarning(attributeWarning.subs("aggregates").toString());
+			else
+				m_aggregates = Aggregates(QFlag(str.toInt()));
+
+			str = attribs.value("keepNValues").toString();
+			if (str.isEmpty())
+				reader->raiseWarning(attributeWarning.subs("keepNValues").toString());
+			else
+				m_keepNValues = str.toInt();
+		} else {// unknown element
+			reader->raiseWarning(i18n("unknown element '%1'", reader->name().toString()));
+			if (!reader->skipToEndElement()) return false;
+		}
+	}
+
+	return !reader->hasError();
+}
+
+/*!
+ * restores the pointer to the aggregated column after the project was loaded and aggregates its data.
+ */
+void LiveDataRollup::finalizeLoad() {
+	const Project* project = this->project();
+	if (project) {
+		for (auto* column : project->children<Column>(AbstractAspect::Recursive)) {
+			if (column->path() == m_columnPath) {
+				m_column = column;
+				break;
+			}
+		}
+	}
+
+	if (!m_column)
+		DEBUG("LiveDataRollup::finalizeLoad(): column " << m_columnPath.toStdString() << " not found");
+
+	connectSource();
+	recalculate();
+}
@@ -0,0 +1,107 @@
+/***************************************************************************
+    File                 : LiveDataRollup.h
+    Project              : LabPlot
+    Description          : Aggregates of a live data column in time windows
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef LIVEDATAROLLUP_H
+#define LIVEDATAROLLUP_H
+
+#include "backend/spreadsheet/Spreadsheet.h"
+
+#include <QPointer>
+
+class LiveDataRollup : public Spreadsheet {
+	Q_OBJECT
+
+public:
+	enum Aggregate {
+		Count = 0x01,
+		Mean = 0x02,
+		Minimum = 0x04,
+		Maximum = 0x08,
+		Last = 0x10,
+		StandardDeviation = 0x20,
+		All = 0x3F
+	};
+	Q_DECLARE_FLAGS(Aggregates, Aggregate)
+
+	explicit LiveDataRollup(const QString& name, bool loading = false);
+
+	void setSourceColumn(Column*, const QString& keyColumnName = QString());
+	Column* sourceColumn() const;
+	QString keyColumnName() const;
+
+	void setWindow(double);
+	double window() const;
+
+	void setAggregates(Aggregates);
+	Aggregates aggregates() const;
+
+	void setKeepNValues(int);
+	int keepNValues() const;
+
+	void recalculate();
+
+	QWidget* view() const override;
+
+	void save(QXmlStreamWriter*) const override;
+	bool load(XmlStreamReader*, bool preview) override;
+	void finalizeLoad();
+
+private slots:
+	void sourceDataChanged(const QVector<Column*>&);
+	void sourceAboutToBeRemoved(const AbstractAspect*);
+
+private:
+	bool prepare();
+	void update();
+	void connectSource();
+
+	QPointer<Column> m_column;	// aggregated column
+	QString m_columnPath;		// path of the aggregated column, used on load
+	QString m_keyColumnName;	// name of the key (timestamp) column, the first DateTime column if empty
+	Column* m_keyColumn{nullptr};
+	double m_window{1000.};		// size of the windows in ms or in units of the key
+	Aggregates m_aggregates{All};
+	int m_keepNValues{0};		// number of windows to keep (0 - all)
+
+	bool m_prepared{false};
+	bool m_dateTimeKey{false};	// the keys are DateTime values, the windows are stored as DateTime
+	double m_lastKey{0.};		// key of the last processed row
+
+	//aggregates of the open window, updated incrementally
+	bool m_windowOpen{false};
+	qint64 m_windowIndex{0};
+	int m_count{0};
+	double m_mean{0.};
+	double m_m2{0.};		// sum of the squared differences from the mean
+	double m_min{0.};
+	double m_max{0.};
+	double m_last{0.};
+};
+
+Q_DECLARE_OPERATORS_FOR_FLAGS(LiveDataRollup::Aggregates)
+
+#endif
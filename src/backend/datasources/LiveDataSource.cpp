@@ -29,11 +29,16 @@ Copyright	: (C) 2018 Stefan Gerlach (stefan.gerlach@uni.kn)
 ***************************************************************************/
 
 #include "backend/datasources/LiveDataSource.h"
+#include "backend/datasources/LiveDataReader.h"
 #include "backend/datasources/filters/AsciiFilter.h"
 #include "backend/datasources/filters/FITSFilter.h"
 #include "backend/datasources/filters/BinaryFilter.h"
 #include "backend/datasources/filters/ROOTFilter.h"
 #include "backend/core/Project.h"
+#include "backend/core/column/Column.h"
+#include "backend/core/column/ColumnHistory.h"
+#include "backend/lib/trace.h"
+#include "backend/worksheet/plots/cartesian/PlotUpdateScheduler.h"
 #include "commonfrontend/spreadsheet/SpreadsheetView.h"
 #include "kdefrontend/spreadsheet/PlotDataDialog.h"
 
@@ -71,6 +76,7 @@ LiveDataSource::LiveDataSource(const QString& name, bool loading) : Spreadsheet(
 LiveDataSource::~LiveDataSource() {
 	//stop reading before deleting the objects
 	pauseReading();
+	delete m_dataReader;
 
 	delete m_filter;
 	delete m_fileSystemWatcher;
@@ -199,6 +205,20 @@ AbstractFileFilter* LiveDataSource::filter() const {
 	return m_filter;
 }
 
+/*!
+ * returns the number of rows dropped by the reader thread since the data wasn't taken fast enough.
+ */
+quint64 LiveDataSource::droppedRows() const {
+	return m_dataReader ? m_dataReader->droppedRows() : 0;
+}
+
+/*!
+ * returns how often the reader thread had to stop reading since the data wasn't taken fast enough.
+ */
+quint64 LiveDataSource::readerStalls() const {
+	return m_dataReader ? m_dataReader->stalls() : 0;
+}
+
 /*!
  * \brief Sets the serial port's baud rate
  * \param baudrate
@@ -231,12 +251,42 @@ int LiveDataSource::updateInterval() const {
  */
 void LiveDataSource::setKeepNValues(int keepnvalues) {
 	m_keepNValues = keepnvalues;
+	updateHistory();
 }
 
 int LiveDataSource::keepNValues() const {
 	return m_keepNValues;
 }
 
+/*!
+ * \brief Sets whether the values removed from the columns when only the last values are kept
+ * are moved to an on-disk history instead of being discarded
+ * \param enabled
+ */
+void LiveDataSource::setHistoryEnabled(bool enabled) {
+	m_history = enabled;
+	updateHistory();
+}
+
+bool LiveDataSource::historyEnabled() const {
+	return m_history;
+}
+
+/*!
+ * creates the histories of the columns if the history is enabled and only the last values
+ * are kept in memory, deletes them otherwise. Text columns have no history.
+ */
+void LiveDataSource::updateHistory() {
+	const bool enabled = m_history && m_keepNValues > 0;
+	for (auto* col : children<Column>()) {
+		if (enabled && col->columnMode() != AbstractColumn::Text) {
+			if (!col->history() || col->history()->columnMode() != col->columnMode())
+				col->setHistory(new ColumnHistory(col->columnMode()));
+		} else if (col->history())
+			col->setHistory(nullptr);
+	}
+}
+
 /*!
  * \brief Sets the network socket's port to port
  * \param port
@@ -303,6 +353,12 @@ LiveDataSource::SourceType LiveDataSource::sourceType() const {
  */
 void LiveDataSource::setReadingType(ReadingType readingType) {
 	m_readingType = readingType;
+
+	//only reading till the end is done in the reader thread, continue with the direct reading otherwise
+	if (m_dataReader && !useDataReader()) {
+		stopDataReader();
+		read();
+	}
 }
 
 LiveDataSource::ReadingType LiveDataSource::readingType() const {
@@ -314,39 +370,53 @@ LiveDataSource::ReadingType LiveDataSource::readingType() const {
  * \param updatetype
  */
 void LiveDataSource::setUpdateType(UpdateType updatetype) {
-	switch (updatetype) {
-	case NewData: {
+	if (updatetype == NewData)
 		m_updateTimer->stop();
-		if (!m_fileSystemWatcher)
-			m_fileSystemWatcher = new QFileSystemWatcher(this);
-
-		m_fileSystemWatcher->addPath(m_fileName);
-		QFileInfo file(m_fileName);
-		// If the watched file currently does not exist (because it is recreated for instance), watch its containing
-		// directory instead. Once the file exists again, switch to watching the file in readOnUpdate().
-		// Reading will only start 100ms after the last update, to prevent continuous re-reading while the file is updated.
-		// If the watched file intentionally is updated more often than that, the user should switch to periodic reading.
-		if (m_fileSystemWatcher->files().contains(m_fileName))
-			m_fileSystemWatcher->removePath(file.absolutePath());
-		else
-			m_fileSystemWatcher->addPath(file.absolutePath());
+	m_updateType = updatetype;
+	updateFileWatcher();
 
-		connect(m_fileSystemWatcher, &QFileSystemWatcher::fileChanged, this, [&](){ m_watchTimer->start(); });
-		connect(m_fileSystemWatcher, &QFileSystemWatcher::directoryChanged, this, [&](){ m_watchTimer->start(); });
-		break;
-	}
-	case TimeInterval:
-		delete m_fileSystemWatcher;
-		m_fileSystemWatcher = nullptr;
-		break;
+	//restart the reader thread with the new update type
+	if (m_dataReader) {
+		stopDataReader();
+		read();
 	}
-	m_updateType = updatetype;
 }
 
 LiveDataSource::UpdateType LiveDataSource::updateType() const {
 	return m_updateType;
 }
 
+/*!
+ * watches the file if it's read on new data. If the file is followed in the reader thread
+ * (tail mode, see LiveDataReader), the reader watches the file itself.
+ */
+void LiveDataSource::updateFileWatcher() {
+	if (m_updateType != NewData || m_dataReader) {
+		m_watchTimer->stop();
+		delete m_fileSystemWatcher;
+		m_fileSystemWatcher = nullptr;
+		return;
+	}
+
+	if (m_fileSystemWatcher)
+		return;
+
+	m_fileSystemWatcher = new QFileSystemWatcher(this);
+	m_fileSystemWatcher->addPath(m_fileName);
+	QFileInfo file(m_fileName);
+	// If the watched file currently does not exist (because it is recreated for instance), watch its containing
+	// directory instead. Once the file exists again, switch to watching the file in readOnUpdate().
+	// Reading will only start 100ms after the last update, to prevent continuous re-reading while the file is updated.
+	// If the watched file intentionally is updated more often than that, the user should switch to periodic reading.
+	if (m_fileSystemWatcher->files().contains(m_fileName))
+		m_fileSystemWatcher->removePath(file.absolutePath());
+	else
+		m_fileSystemWatcher->addPath(file.absolutePath());
+
+	connect(m_fileSystemWatcher, &QFileSystemWatcher::fileChanged, this, [&](){ m_watchTimer->start(); });
+	connect(m_fileSystemWatcher, &QFileSystemWatcher::directoryChanged, this, [&](){ m_watchTimer->start(); });
+}
+
 /*!
  * \brief Sets the network socket's host
  * \param host
@@ -440,6 +510,9 @@ QMenu* LiveDataSource::createContextMenu() {
  * presumably has finished. Also see LiveDataSource::setUpdateType().
  */
 void LiveDataSource::readOnUpdate() {
+	if (!m_fileSystemWatcher)
+		return;
+
 	if (!m_fileSystemWatcher->files().contains(m_fileName)) {
 		m_fileSystemWatcher->addPath(m_fileName);
 		QFileInfo file(m_fileName);
@@ -465,10 +538,29 @@ void LiveDataSource::read() {
 	if (!m_filter)
 		return;
 
+	//the data is read and parsed in the reader thread, take the rows parsed so far and request new data
+	if (m_dataReader) {
+		consumeData();
+		m_dataReader->requestRead();
+		return;
+	}
+
 	if (m_reading)
 		return;
 
 	m_reading = true;
+	updateHistory();
+
+	//sockets are opened and read in the reader thread, only the columns are prepared here
+	if (!m_prepared && useDataReader() && m_sourceType != FileOrPipe) {
+		auto* filter = static_cast<AsciiFilter*>(m_filter);
+		if (!filter->isPrepared())
+			filter->prepareLiveDataSource(this);
+		startDataReader();
+		m_prepared = true;
+		m_reading = false;
+		return;
+	}
 
 	//initialize the device (file, socket, serial port) when calling this function for the first time
 	if (!m_prepared) {
@@ -540,6 +632,10 @@ void LiveDataSource::read() {
 				bytes = static_cast<AsciiFilter*>(m_filter)->readFromLiveDevice(*m_device, this, m_bytesRead);
 				m_bytesRead += bytes;
 				DEBUG("Read " << bytes << " bytes, in total: " << m_bytesRead);
+
+				//the columns are known after the first read, continue in the reader thread
+				if (useDataReader() && static_cast<AsciiFilter*>(m_filter)->isPrepared())
+					startDataReader();
 			}
 			break;
 		case AbstractFileFilter::Binary:
@@ -562,6 +658,15 @@ void LiveDataSource::read() {
 		}
 		break;
 	case NetworkTcpSocket:
+		//binary records are streamed over a persistent connection, reconnect only if it was lost
+		if (m_fileType == AbstractFileFilter::Binary) {
+			if (m_tcpSocket->state() == QAbstractSocket::UnconnectedState)
+				m_tcpSocket->connectToHost(m_host, m_port, QIODevice::ReadOnly);
+			else
+				static_cast<BinaryFilter*>(m_filter)->readFromLiveDeviceNotFile(*m_device, this);
+			break;
+		}
+
 		DEBUG("reading from TCP socket. state before abort = " << m_tcpSocket->state());
 		m_tcpSocket->abort();
 		m_tcpSocket->connectToHost(m_host, m_port, QIODevice::ReadOnly);
@@ -573,8 +678,18 @@ void LiveDataSource::read() {
 		// reading data here
 		if (m_fileType == AbstractFileFilter::Ascii)
 			static_cast<AsciiFilter*>(m_filter)->readFromLiveDeviceNotFile(*m_device, this);
+		else if (m_fileType == AbstractFileFilter::Binary)
+			static_cast<BinaryFilter*>(m_filter)->readFromLiveDeviceNotFile(*m_device, this);
 		break;
 	case LocalSocket:
+		if (m_fileType == AbstractFileFilter::Binary) {
+			if (m_localSocket->state() == QLocalSocket::UnconnectedState)
+				m_localSocket->connectToServer(m_localSocketName, QLocalSocket::ReadOnly);
+			else
+				static_cast<BinaryFilter*>(m_filter)->readFromLiveDeviceNotFile(*m_device, this);
+			break;
+		}
+
 		DEBUG("	Reading from local socket. state before abort = " << m_localSocket->state());
 		if (m_localSocket->state() == QLocalSocket::ConnectingState)
 			m_localSocket->abort();
@@ -589,6 +704,8 @@ void LiveDataSource::read() {
 		// reading data here
 		if (m_fileType == AbstractFileFilter::Ascii)
 			static_cast<AsciiFilter*>(m_filter)->readFromLiveDeviceNotFile(*m_device, this);
+		else if (m_fileType == AbstractFileFilter::Binary)
+			static_cast<BinaryFilter*>(m_filter)->readFromLiveDeviceNotFile(*m_device, this);
 		break;
 	case MQTT:
 		break;
@@ -597,6 +714,172 @@ void LiveDataSource::read() {
 	m_reading = false;
 }
 
+/*!
+ * returns \c true if the data is read and parsed in a separate thread (LiveDataReader).
+ * This is done when reading ASCII data till the end from files, pipes and sockets.
+ * The other reading types limit the number of lines read per update and are handled directly in read().
+ */
+bool LiveDataSource::useDataReader() const {
+	return m_fileType == AbstractFileFilter::Ascii && m_readingType == TillEnd
+		&& m_sourceType != SerialPort && m_sourceType != MQTT;
+}
+
+void LiveDataSource::startDataReader() {
+	auto* filter = static_cast<AsciiFilter*>(m_filter);
+
+	//the device is opened in the reader thread
+	delete m_device;
+	m_device = nullptr;
+	m_tcpSocket = nullptr;
+	m_udpSocket = nullptr;
+	m_localSocket = nullptr;
+
+	//continue the index after the last row read so far
+	int firstIndex = 1;
+	if (filter->createIndexEnabled() && rowCount() > 0)
+		firstIndex = column(0)->integerAt(rowCount() - 1) + 1;
+
+	m_dataReader = new LiveDataReader(this, filter);
+	connect(m_dataReader, &LiveDataReader::dataAvailable, this, &LiveDataSource::dataAvailable);
+	m_dataReader->start(m_bytesRead, firstIndex);
+
+	//files are followed in the reader thread, see LiveDataReader
+	updateFileWatcher();
+}
+
+/*!
+ * takes the rows parsed so far and stops the reader thread. The devices are created again in the next call of read().
+ */
+void LiveDataSource::stopDataReader() {
+	consumeData();
+	delete m_dataReader;
+	m_dataReader = nullptr;
+	m_prepared = false;
+	updateFileWatcher();
+}
+
+/*!
+ * called when the reader thread parsed new data.
+ */
+void LiveDataSource::dataAvailable() {
+	//in the TimeInterval mode the data is taken in read() once per interval
+	if (m_updateType == NewData)
+		consumeData();
+}
+
+/*!
+ * writes the values of the column \c col of all blocks into \c data starting at the index \c index
+ * and skips the first \c skip values. The index wraps around at \c size for circular buffers.
+ */
+template <typename T>
+static void writeRows(T* data, int size, int index, int skip, const QVector<LiveDataBlock>& blocks,
+		QVector<QVector<T>> LiveDataBlock::*values, int col) {
+	for (const auto& block : blocks) {
+		const QVector<T>& blockValues = (block.*values).at(col);
+		const int first = qMin(skip, blockValues.size());
+		skip -= first;
+		for (int i = first; i < blockValues.size(); ++i) {
+			data[index] = blockValues.at(i);
+			if (++index == size)
+				index = 0;
+		}
+	}
+}
+
+/*!
+ * appends the rows parsed in the reader thread to the columns.
+ */
+void LiveDataSource::consumeData() {
+	if (!m_dataReader)
+		return;
+
+	if (m_paused) {
+		//take the data once the user decides to continue reading,
+		//the reader thread stops reading or drops data if it doesn't fit into the ring anymore
+		m_pending = true;
+		return;
+	}
+
+	QVector<LiveDataBlock> blocks;
+	m_dataReader->takeBlocks(blocks);
+	if (blocks.isEmpty())
+		return;
+
+	DEBUG("LiveDataSource::consumeData(): " << blocks.size() << " blocks, "
+		<< m_dataReader->droppedRows() << " rows dropped, " << m_dataReader->stalls() << " stalls");
+	appendData(blocks);
+}
+
+/*!
+ * appends the rows of the blocks \c blocks to the columns. If only the last values are kept,
+ * the oldest rows are evicted. The columns and the plots are notified only once for all rows.
+ */
+void LiveDataSource::appendData(const QVector<LiveDataBlock>& blocks) {
+	if (blocks.isEmpty())
+		return;
+
+	PERFTRACE("LiveDataSource::appendData()");
+	int rows = 0;
+	for (const auto& block : blocks) {
+		rows += block.rows;
+		if (block.restarted)
+			m_bytesRead = 0;
+		m_bytesRead += block.bytes;
+	}
+	if (rows == 0)
+		return;
+
+	const int cols = qMin(columnCount(), blocks.constFirst().numericData.size());
+	int size;	//size of the columns
+	int row;	//first row to write to
+	int skip = 0;	//number of new rows not fitting into the columns with a fixed size
+	if (m_keepNValues == 0) {
+		row = rowCount();
+		setRowCount(row + rows);
+		size = rowCount();
+	} else {
+		//the columns are used as circular buffers, evict the oldest rows
+		size = rowCount();
+		if (size == 0)
+			return;
+		const int newRows = qMin(rows, size);
+		skip = rows - newRows;
+		row = size - newRows;
+		updateHistory();
+		for (int n = 0; n < cols; ++n)
+			column(n)->evictRows(newRows);
+	}
+
+	for (int n = 0; n < cols; ++n) {
+		Column* col = column(n);
+		void* data = (m_keepNValues == 0) ? col->data() : col->ringData();
+		const int index = (m_keepNValues == 0) ? row : (row + col->ringOffset()) % size;
+		switch (col->columnMode()) {
+		case AbstractColumn::Numeric:
+			writeRows(static_cast<QVector<double>*>(data)->data(), size, index, skip, blocks, &LiveDataBlock::numericData, n);
+			break;
+		case AbstractColumn::Integer:
+			writeRows(static_cast<QVector<int>*>(data)->data(), size, index, skip, blocks, &LiveDataBlock::integerData, n);
+			break;
+		case AbstractColumn::DateTime:
+			writeRows(static_cast<QVector<QDateTime>*>(data)->data(), size, index, skip, blocks, &LiveDataBlock::dateTimeData, n);
+			break;
+		case AbstractColumn::Text:
+			writeRows(static_cast<QVector<QString>*>(data)->data(), size, index, skip, blocks, &LiveDataBlock::textData, n);
+			break;
+		case AbstractColumn::Month:
+		case AbstractColumn::Day:
+			break;
+		}
+	}
+
+	//notify all affected columns about the changes, the dependent plots are updated in the next frame
+	QVector<Column*> columns;
+	for (int n = 0; n < cols; ++n)
+		columns << column(n);
+	PlotUpdateScheduler::instance()->setChanged(columns);
+}
+
 /*!
  * Slot for the signal that is emitted once every time new data is available for reading from the device (not UDP or Serial).
  * It will only be emitted again once new data is available, such as when a new payload of network data has arrived on the network socket,
@@ -608,10 +891,11 @@ void LiveDataSource::readyRead() {
 
 	if (m_fileType == AbstractFileFilter::Ascii)
 		static_cast<AsciiFilter*>(m_filter)->readFromLiveDeviceNotFile(*m_device, this);
-
-//TODO: not implemented yet
-//	else if (m_fileType == AbstractFileFilter::Binary)
-//		dynamic_cast<BinaryFilter*>(m_filter)->readFromLiveDeviceNotFile(*m_device, this);
+	else if (m_fileType == AbstractFileFilter::Binary) {
+		//all complete frames were read, the connection is kept open
+		static_cast<BinaryFilter*>(m_filter)->readFromLiveDeviceNotFile(*m_device, this);
+		return;
+	}
 
 	//since we won't have the timer to call read() where we create new connections
 	//for sequential devices in read() we just request data/connect to servers
@@ -759,6 +1043,7 @@ void LiveDataSource::save(QXmlStreamWriter* writer) const {
 	writer->writeAttribute("readingType", QString::number(m_readingType));
 	writer->writeAttribute("sourceType", QString::number(m_sourceType));
 	writer->writeAttribute("keepNValues", QString::number(m_keepNValues));
+	writer->writeAttribute("history", QString::number(m_history));
 
 	if (m_updateType == TimeInterval)
 		writer->writeAttribute("updateInterval", QString::number(m_updateInterval));
@@ -847,6 +1132,14 @@ bool LiveDataSource::load(XmlStreamReader* reader, bool preview) {
 			else
 				m_readingType =  static_cast<ReadingType>(str.toInt());
 
+			str = attribs.value("keepNValues").toString();
+			if (!str.isEmpty())
+				m_keepNValues = str.toInt();
+
+			str = attribs.value("history").toString();
+			if (!str.isEmpty())
+				m_history = str.toInt();
+
 			if (m_updateType == TimeInterval) {
 				str = attribs.value("updateInterval").toString();
 				if (str.isEmpty())
@@ -33,6 +33,7 @@
 #include "backend/spreadsheet/Spreadsheet.h"
 #include "backend/matrix/Matrix.h"
 
+#include <QDateTime>
 #include <QLocalSocket>
 #include <QSerialPort>
 #include <QTimer>
@@ -41,11 +42,26 @@
 
 class QString;
 class AbstractFileFilter;
+class LiveDataReader;
 class QFileSystemWatcher;
 class QAction;
 class QTcpSocket;
 class QUdpSocket;
 
+/*!
+ * rows read from a live device by the LiveDataReader or by the BinaryFilter.
+ * For every column only the vector matching the mode of the column is filled.
+ */
+struct LiveDataBlock {
+	int rows{0};
+	qint64 bytes{0};	//number of bytes consumed from the device for these rows
+	bool restarted{false};	//the file was truncated or replaced, the bytes were read from its beginning
+	QVector<QVector<double>> numericData;
+	QVector<QVector<int>> integerData;
+	QVector<QVector<QDateTime>> dateTimeData;
+	QVector<QVector<QString>> textData;
+};
+
 class LiveDataSource : public Spreadsheet {
 	Q_OBJECT
 	Q_ENUMS(SourceType)
@@ -118,6 +134,9 @@ public:
 	void setKeepNValues(int);
 	int keepNValues() const;
 
+	void setHistoryEnabled(bool);
+	bool historyEnabled() const;
+
 	void setKeepLastValues(bool);
 	bool keepLastValues() const;
 
@@ -140,6 +159,10 @@ public:
 	void setFilter(AbstractFileFilter*);
 	AbstractFileFilter* filter() const;
 
+	quint64 droppedRows() const;
+	quint64 readerStalls() const;
+	void appendData(const QVector<LiveDataBlock>&);
+
 	QIcon icon() const override;
 	QMenu* createContextMenu() override;
 	QWidget* view() const override;
@@ -150,6 +173,12 @@ public:
 
 private:
 	void initActions();
+	bool useDataReader() const;
+	void startDataReader();
+	void stopDataReader();
+	void consumeData();
+	void updateFileWatcher();
+	void updateHistory();
 
 	QString m_fileName;
 	QString m_dirName;
@@ -169,6 +198,7 @@ private:
 	bool m_prepared{false};
 	bool m_reading{false};
 	bool m_pending{false};
+	bool m_history{false};	// move the values not kept in memory to the on-disk history
 
 	int m_sampleSize{1};
 	int m_keepNValues{0};	// number of values to keep (0 - all)
@@ -189,6 +219,7 @@ private:
 	QUdpSocket* m_udpSocket{nullptr};
 	QSerialPort* m_serialPort{nullptr};
 	QIODevice* m_device{nullptr};
+	LiveDataReader* m_dataReader{nullptr};
 	QAction* m_plotDataAction{nullptr};
 
 public slots:
@@ -198,6 +229,7 @@ public slots:
 private slots:
 	void plotData();
 	void readyRead();
+	void dataAvailable();
 
 	void localSocketError(QLocalSocket::LocalSocketError);
 	void tcpSocketError(QAbstractSocket::SocketError);
@@ -170,6 +170,21 @@ int MQTTClient::keepNValues() const {
 	return m_keepNValues;
 }
 
+/*!
+ * \brief Sets whether the values not kept in memory are moved to an on-disk history
+ * \param enabled
+ */
+void MQTTClient::setHistoryEnabled(bool enabled) {
+	m_history = enabled;
+}
+
+/*!
+ * \brief Returns whether the values not kept in memory are moved to an on-disk history
+ */
+bool MQTTClient::historyEnabled() const {
+	return m_history;
+}
+
 /*!
  * \brief Provides information about whether the reading is paused or not
  *
@@ -1038,14 +1053,13 @@ void MQTTClient::onMQTTConnect() {
 void MQTTClient::MQTTSubscriptionMessageReceived(const QMqttMessage& msg) {
 	//Decide to interpret retain message or not
 	if (!msg.retain() || m_MQTTRetain) {
-		//If this is the first message from the topic, save its name
-		if (!m_topicNames.contains(msg.topic().name()))
-			m_topicNames.push_back(msg.topic().name());
-
 		//Pass the message and the topic name to the MQTTSubscription which contains the topic
+		const QString& topicName = msg.topic().name();
 		for (auto* subscription : m_MQTTSubscriptions) {
-			if (checkTopicContains(subscription->subscriptionName(), msg.topic().name())) {
-				subscription->messageArrived(msg.payload(), msg.topic().name());
+			if (checkTopicContains(subscription->subscriptionName(), topicName)) {
+				//If this is the first message from the topic, save its name
+				if (subscription->messageArrived(msg.payload(), topicName) && !m_topicNames.contains(topicName))
+					m_topicNames.push_back(topicName);
 				break;
 			}
 		}
@@ -1122,6 +1136,7 @@ void MQTTClient::save(QXmlStreamWriter* writer) const {
 	writer->writeAttribute("updateType", QString::number(m_updateType));
 	writer->writeAttribute("readingType", QString::number(m_readingType));
 	writer->writeAttribute("keepValues", QString::number(m_keepNValues));
+	writer->writeAttribute("history", QString::number(m_history));
 
 	if (m_updateType == TimeInterval)
 		writer->writeAttribute("updateInterval", QString::number(m_updateInterval));
@@ -1198,6 +1213,10 @@ bool MQTTClient::load(XmlStreamReader* reader, bool preview) {
 			else
 				m_keepNValues =  str.toInt();
 
+			str = attribs.value("history").toString();
+			if (!str.isEmpty())
+				m_history = str.toInt();
+
 			str = attribs.value("updateType").toString();
 			if (str.isEmpty())
 				reader->raiseWarning(attributeWarning.arg("'updateType'"));
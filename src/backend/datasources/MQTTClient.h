@@ -125,6 +125,9 @@ public:
 	void setKeepNValues(int);
 	int keepNValues() const;
 
+	void setHistoryEnabled(bool);
+	bool historyEnabled() const;
+
 	void setKeepLastValues(bool);
 	bool keepLastValues() const;
 
@@ -217,6 +220,7 @@ private:
 	bool m_prepared{false};
 	int m_sampleSize{1};
 	int m_keepNValues{0};
+	bool m_history{false};
 	int m_updateInterval{1000};
 	AsciiFilter* m_filter{nullptr};
 	QTimer* m_updateTimer;
@@ -31,6 +31,7 @@ Copyright	: (C) 2018 Kovacs Ferencz (kferike98@gmail.com)
 
 #include <KLocalizedString>
 #include <QIcon>
+#include <QTimer>
 
 /*!
   \class MQTTSubscription
@@ -66,40 +67,79 @@ MQTTClient* MQTTSubscription::mqttClient() const {
 	return m_MQTTClient;
 }
 
+/*!
+ *\brief Returns the MQTTTopic child with the name \c topicName or \c nullptr if there is no such topic
+ *
+ * The topics are looked up in a hash, the children are only searched if the topic is not known yet
+ * or was moved to another subscription or deleted in the meantime.
+ */
+MQTTTopic* MQTTSubscription::topic(const QString& topicName) {
+	MQTTTopic* topic = m_topics.value(topicName);
+	if (topic && topic->parentAspect() == this)
+		return topic;
+
+	m_topics.remove(topicName);
+	for (auto* child : children<MQTTTopic>()) {
+		if (child->topicName() == topicName) {
+			m_topics[topicName] = child;
+			return child;
+		}
+	}
+
+	return nullptr;
+}
+
 /*!
  *\brief Called when a message arrived to a topic contained by the MQTTSubscription
  * If the topic can't be found among the children, a new MQTTTopic is instantiated
  * Passes the messages to the appropriate MQTTTopic
  *
+ * In the NewData mode the messages are not read immediately. All messages arriving until
+ * the control returns to the event loop are read in one batch per topic.
+ *
  * \param message the message to pass
  * \param topicName the name of the topic the message was sent to
+ * \return \c true if a new MQTTTopic was created for the message, \c false otherwise
  */
-void MQTTSubscription::messageArrived(const QString& message, const QString& topicName) {
-	bool found = false;
-	QVector<MQTTTopic*> topics = children<MQTTTopic>();
-	//search for the topic among the MQTTTopic children
-	for (auto* topic: topics) {
-		if (topicName == topic->topicName()) {
-			//pass the message to the topic
-			topic->newMessage(message);
-
-			//read the message if needed
-			if ((m_MQTTClient->updateType() == MQTTClient::UpdateType::NewData) &&
-			        !m_MQTTClient->isPaused())
-				topic->read();
-
-			found = true;
-			break;
+bool MQTTSubscription::messageArrived(const QString& message, const QString& topicName) {
+	bool newTopic = false;
+	MQTTTopic* messageTopic = topic(topicName);
+
+	//if the topic can't be found, we add it as a new MQTTTopic
+	if (!messageTopic) {
+		messageTopic = new MQTTTopic(topicName, this, false);
+		addChildFast(messageTopic); //no need for undo/redo here
+		m_topics[topicName] = messageTopic;
+		newTopic = true;
+	}
+
+	//pass the message to the topic
+	messageTopic->newMessage(message);
+
+	//schedule the reading of the message if needed
+	if ((m_MQTTClient->updateType() == MQTTClient::UpdateType::NewData) && !m_MQTTClient->isPaused()) {
+		m_pendingTopics.insert(topicName);
+		if (!m_readScheduled) {
+			m_readScheduled = true;
+			QTimer::singleShot(0, this, &MQTTSubscription::readPendingTopics);
 		}
 	}
 
-	//if the topic can't be found, we add it as a new MQTTTopic, and read from it if needed
-	if (!found) {
-		MQTTTopic* newTopic = new MQTTTopic(topicName, this, false);
-		addChildFast(newTopic); //no need for undo/redo here
-		newTopic->newMessage(message);
-		if ((m_MQTTClient->updateType() == MQTTClient::UpdateType::NewData) && !m_MQTTClient->isPaused())
-			newTopic->read();
+	return newTopic;
+}
+
+/*!
+ *\brief Reads the messages of all topics that received messages since the last call
+ */
+void MQTTSubscription::readPendingTopics() {
+	m_readScheduled = false;
+	const QSet<QString> topicNames = m_pendingTopics;
+	m_pendingTopics.clear();
+
+	for (const auto& topicName : topicNames) {
+		MQTTTopic* pendingTopic = topic(topicName);
+		if (pendingTopic)
+			pendingTopic->read();
 	}
 }
 
@@ -183,6 +223,7 @@ bool MQTTSubscription::load(XmlStreamReader* reader, bool preview) {
 				return false;
 			}
 			addChildFast(topic);
+			m_topics[topic->topicName()] = topic;
 		} else {// unknown element
 			reader->raiseWarning(i18n("unknown element '%1'", reader->name().toString()));
 			if (!reader->skipToEndElement()) return false;
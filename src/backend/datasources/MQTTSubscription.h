@@ -31,6 +31,10 @@ Copyright	: (C) 2018 Kovacs Ferencz (kferike98@gmail.com)
 
 #include "backend/core/Folder.h"
 
+#include <QHash>
+#include <QPointer>
+#include <QSet>
+
 class MQTTClient;
 class MQTTTopic;
 class QString;
@@ -46,15 +50,23 @@ public:
 	QString subscriptionName() const;
 	const QVector<MQTTTopic*> topics() const;
 	MQTTClient* mqttClient() const;
-	void messageArrived(const QString&, const QString&);
+	bool messageArrived(const QString&, const QString&);
 
 	QIcon icon() const override;
 	void save(QXmlStreamWriter*) const override;
 	bool load(XmlStreamReader*, bool preview) override;
 
 private:
+	MQTTTopic* topic(const QString&);
+
 	QString m_subscriptionName;
 	MQTTClient* m_MQTTClient{nullptr};
+	QHash<QString, QPointer<MQTTTopic>> m_topics;	//topic name -> topic, for the dispatching of the messages
+	QSet<QString> m_pendingTopics;	//topics with messages not read yet
+	bool m_readScheduled{false};
+
+private slots:
+	void readPendingTopics();
 
 signals:
 	void loaded(const QString &);
@@ -32,6 +32,8 @@ Copyright	: (C) 2018 Kovacs Ferencz (kferike98@gmail.com)
 #include "kdefrontend/spreadsheet/PlotDataDialog.h"
 #include "commonfrontend/spreadsheet/SpreadsheetView.h"
 #include "backend/datasources/filters/AsciiFilter.h"
+#include "backend/core/column/Column.h"
+#include "backend/core/column/ColumnHistory.h"
 
 #include <QMenu>
 #include <QIcon>
@@ -143,6 +145,8 @@ QWidget* MQTTTopic::view() const {
  */
 void MQTTTopic::newMessage(const QString& message) {
 	m_messagePuffer.push_back(message);
+	m_messageTimes.push_back(QDateTime::currentDateTime());
+	m_messagePufferLength += message.length() + 1;
 }
 
 /*!
@@ -181,12 +185,66 @@ void MQTTTopic::plotData() {
 
 /*!
  *\brief Reads every message from the message puffer
+ *
+ * For the reading type TillEnd the buffered messages are passed to the filter in one batch, so the new data
+ * is appended to the columns and the columns and plots are notified about the changes only once.
+ * The sample size of the other reading types applies to a single message, these messages are read one by one.
+ * Every row gets the arrival time of its message as timestamp.
  */
 void MQTTTopic::read() {
-	while (!m_messagePuffer.isEmpty()) {
-		qDebug() << "Reading from topic " << m_topicName;
-		const QString tempMessage = m_messagePuffer.takeFirst();
-		m_filter->readMQTTTopic(tempMessage, this);
+	if (m_messagePuffer.isEmpty())
+		return;
+
+	const QVector<QString> messages = m_messagePuffer;
+	const QVector<QDateTime> times = m_messageTimes;
+	const int length = m_messagePufferLength;
+	m_messagePuffer.clear();
+	m_messageTimes.clear();
+	m_messagePufferLength = 0;
+
+	updateHistory();
+
+	//the arrival time of a message is used for all of its lines
+	const QRegExp lineSeparator(QStringLiteral("\n|\r\n|\r"));
+	const bool timestamps = m_filter->createTimestampEnabled();
+	auto addLineTimes = [&](QVector<QDateTime>& lineTimes, int i) {
+		if (timestamps)
+			lineTimes.insert(lineTimes.size(), messages.at(i).split(lineSeparator, QString::SkipEmptyParts).size(), times.at(i));
+	};
+
+	if (m_MQTTClient->readingType() != MQTTClient::ReadingType::TillEnd) {
+		for (int i = 0; i < messages.size(); ++i) {
+			QVector<QDateTime> lineTimes;
+			addLineTimes(lineTimes, i);
+			m_filter->readMQTTTopic(messages.at(i), this, lineTimes);
+		}
+		return;
+	}
+
+	QString batch;
+	batch.reserve(length);
+	QVector<QDateTime> lineTimes;
+	for (int i = 0; i < messages.size(); ++i) {
+		batch += messages.at(i);
+		batch += QLatin1Char('\n');
+		addLineTimes(lineTimes, i);
+	}
+
+	m_filter->readMQTTTopic(batch, this, lineTimes);
+}
+
+/*!
+ * creates the histories of the columns if the history is enabled in the client and only
+ * the last values are kept in memory, deletes them otherwise. Text columns have no history.
+ */
+void MQTTTopic::updateHistory() {
+	const bool enabled = m_MQTTClient->historyEnabled() && m_MQTTClient->keepNValues() > 0;
+	for (auto* col : children<Column>()) {
+		if (enabled && col->columnMode() != AbstractColumn::Text) {
+			if (!col->history() || col->history()->columnMode() != col->columnMode())
+				col->setHistory(new ColumnHistory(col->columnMode()));
+		} else if (col->history())
+			col->setHistory(nullptr);
 	}
 }
 
@@ -283,7 +341,7 @@ bool MQTTTopic::load(XmlStreamReader* reader, bool preview) {
 				if (str.isEmpty())
 					reader->raiseWarning(attributeWarning.arg("'message"+QString::number(i)+'\''));
 				else
-					m_messagePuffer.push_back(str);
+					newMessage(str);
 			}
 		} else if (reader->name() == "asciiFilter") {
 			if (!m_filter->load(reader))
@@ -31,6 +31,8 @@ Copyright	: (C) 2018 Kovacs Ferencz (kferike98@gmail.com)
 
 #include "backend/spreadsheet/Spreadsheet.h"
 
+#include <QDateTime>
+
 class MQTTSubscription;
 class MQTTClient;
 
@@ -59,11 +61,14 @@ public:
 
 private:
 	void initActions();
+	void updateHistory();
 
 	QString m_topicName;
 	MQTTClient* m_MQTTClient;
 	AsciiFilter* m_filter;
 	QVector<QString> m_messagePuffer;
+	QVector<QDateTime> m_messageTimes;	//arrival times of the buffered messages
+	int m_messagePufferLength{0};	//total length of the buffered messages including the separators
 	QAction* m_plotDataAction;
 
 public slots:
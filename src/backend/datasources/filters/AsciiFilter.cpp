@@ -33,6 +33,7 @@ Copyright            : (C) 2009-2019 Alexander Semke (alexander.semke@web.de)
 #include "backend/datasources/filters/AsciiFilterPrivate.h"
 #include "backend/worksheet/plots/cartesian/CartesianPlot.h"
 #include "backend/worksheet/plots/cartesian/XYCurve.h"
+#include "backend/worksheet/plots/cartesian/PlotUpdateScheduler.h"
 #include "backend/lib/macros.h"
 #include "backend/lib/trace.h"
 
@@ -75,6 +76,13 @@ qint64 AsciiFilter::readFromLiveDevice(QIODevice& device, AbstractDataSource* da
 	return d->readFromLiveDevice(device, dataSource, from);
 }
 
+/*!
+  prepares the columns of the live data source \c dataSource for a sequential device without reading any data.
+*/
+void AsciiFilter::prepareLiveDataSource(LiveDataSource* dataSource) {
+	d->prepareLiveDataSource(dataSource);
+}
+
 #ifdef HAVE_MQTT
 QVector<QStringList> AsciiFilter::preview(const QString& message) {
 	return d->preview(message);
@@ -82,9 +90,11 @@ QVector<QStringList> AsciiFilter::preview(const QString& message) {
 
 /*!
   reads the content of a message received by the topic.
+  \c lineTimes contains the arrival times used as timestamps of the lines in \c message,
+  the current time is used for lines without an arrival time.
 */
-void AsciiFilter::readMQTTTopic(const QString& message, AbstractDataSource* dataSource) {
-	d->readMQTTTopic(message, dataSource);
+void AsciiFilter::readMQTTTopic(const QString& message, AbstractDataSource* dataSource, const QVector<QDateTime>& lineTimes) {
+	d->readMQTTTopic(message, dataSource, lineTimes);
 }
 
 /*!
@@ -680,6 +690,105 @@ void AsciiFilterPrivate::readDataFromFile(const QString& fileName, AbstractDataS
 	readingFile = false;
 }
 
+/*!
+ * sets the columns used for the sequential live data sources (sockets, serial port):
+ * one numeric value column and optionally the index column.
+ */
+void AsciiFilterPrivate::initLiveColumnsNotFile() {
+	if (createIndexEnabled) {
+		m_actualCols = 2;
+		columnModes << AbstractColumn::Integer << AbstractColumn::Numeric;
+		vectorNames << i18n("Index") << i18n("Value");
+	} else {
+		m_actualCols = 1;
+		columnModes << AbstractColumn::Numeric;
+		vectorNames << i18n("Value");
+	}
+	QDEBUG("	vector names = " << vectorNames);
+}
+
+/*!
+ * creates and prepares the columns in the live data source \c spreadsheet
+ * according to the column modes determined during the preparation.
+ */
+void AsciiFilterPrivate::initLiveDataSource(LiveDataSource* spreadsheet) {
+	// prepare import for spreadsheet
+	spreadsheet->setUndoAware(false);
+	spreadsheet->resize(AbstractFileFilter::Replace, vectorNames, m_actualCols);
+
+	//columns in a file data source don't have any manual changes.
+	//make the available columns undo unaware and suppress the "data changed" signal.
+	//data changes will be propagated via an explicit Column::setChanged() call once new data was read.
+	for (int i = 0; i < spreadsheet->childCount<Column>(); i++) {
+		spreadsheet->child<Column>(i)->setUndoAware(false);
+		spreadsheet->child<Column>(i)->setSuppressDataChangedSignal(true);
+	}
+
+	int keepNValues = spreadsheet->keepNValues();
+	if (keepNValues == 0)
+		spreadsheet->setRowCount(m_actualRows > 1 ? m_actualRows : 1);
+	else {
+		spreadsheet->setRowCount(keepNValues);
+		m_actualRows = keepNValues;
+	}
+	m_dataContainer.resize(m_actualCols);
+
+	DEBUG("	data source resized to col: " << m_actualCols);
+	DEBUG("	data source rowCount: " << spreadsheet->rowCount());
+
+	DEBUG("	Setting data ..");
+	for (int n = 0; n < m_actualCols; ++n) {
+		// data() returns a void* which is a pointer to any data type (see ColumnPrivate.cpp)
+		spreadsheet->child<Column>(n)->setColumnMode(columnModes[n]);
+		switch (columnModes[n]) {
+		case AbstractColumn::Numeric: {
+			QVector<double>* vector = static_cast<QVector<double>* >(spreadsheet->child<Column>(n)->data());
+			vector->resize(m_actualRows);
+			m_dataContainer[n] = static_cast<void *>(vector);
+			break;
+		}
+		case AbstractColumn::Integer: {
+			QVector<int>* vector = static_cast<QVector<int>* >(spreadsheet->child<Column>(n)->data());
+			vector->resize(m_actualRows);
+			m_dataContainer[n] = static_cast<void *>(vector);
+			break;
+		}
+		case AbstractColumn::Text: {
+			QVector<QString>* vector = static_cast<QVector<QString>*>(spreadsheet->child<Column>(n)->data());
+			vector->resize(m_actualRows);
+			m_dataContainer[n] = static_cast<void *>(vector);
+			break;
+		}
+		case AbstractColumn::DateTime: {
+			QVector<QDateTime>* vector = static_cast<QVector<QDateTime>* >(spreadsheet->child<Column>(n)->data());
+			vector->resize(m_actualRows);
+			m_dataContainer[n] = static_cast<void *>(vector);
+			break;
+		}
+		//TODO
+		case AbstractColumn::Month:
+		case AbstractColumn::Day:
+			break;
+		}
+	}
+}
+
+/*!
+ * prepares the live data source \c spreadsheet for a sequential device (socket)
+ * without reading any data, the data is read by the LiveDataReader then.
+ */
+void AsciiFilterPrivate::prepareLiveDataSource(LiveDataSource* spreadsheet) {
+	m_actualRows = 0;
+	initLiveColumnsNotFile();
+	initLiveDataSource(spreadsheet);
+
+	//no data was read yet, start with empty columns when all values are kept
+	if (spreadsheet->keepNValues() == 0)
+		spreadsheet->setRowCount(0);
+
+	m_prepared = true;
+}
+
 qint64 AsciiFilterPrivate::readFromLiveDevice(QIODevice& device, AbstractDataSource* dataSource, qint64 from) {
 	DEBUG("AsciiFilterPrivate::readFromLiveDevice(): bytes available = " << device.bytesAvailable() << ", from = " << from);
 	if (device.bytesAvailable() <= 0) {
@@ -711,81 +820,13 @@ qint64 AsciiFilterPrivate::readFromLiveDevice(QIODevice& device, AbstractDataSou
 		case LiveDataSource::SourceType::LocalSocket:
 		case LiveDataSource::SourceType::SerialPort:
 			m_actualRows = 1;
-			if (createIndexEnabled) {
-				m_actualCols = 2;
-				columnModes << AbstractColumn::Integer << AbstractColumn::Numeric;
-				vectorNames << i18n("Index") << i18n("Value");
-			} else {
-				m_actualCols = 1;
-				columnModes << AbstractColumn::Numeric;
-				vectorNames << i18n("Value");
-			}
-			QDEBUG("	vector names = " << vectorNames);
+			initLiveColumnsNotFile();
 			break;
 		case LiveDataSource::SourceType::MQTT:
 			break;
 		}
 
-		// prepare import for spreadsheet
-		spreadsheet->setUndoAware(false);
-		spreadsheet->resize(AbstractFileFilter::Replace, vectorNames, m_actualCols);
-
-		//columns in a file data source don't have any manual changes.
-		//make the available columns undo unaware and suppress the "data changed" signal.
-		//data changes will be propagated via an explicit Column::setChanged() call once new data was read.
-		for (int i = 0; i < spreadsheet->childCount<Column>(); i++) {
-			spreadsheet->child<Column>(i)->setUndoAware(false);
-			spreadsheet->child<Column>(i)->setSuppressDataChangedSignal(true);
-		}
-
-		int keepNValues = spreadsheet->keepNValues();
-		if (keepNValues == 0)
-			spreadsheet->setRowCount(m_actualRows > 1 ? m_actualRows : 1);
-		else {
-			spreadsheet->setRowCount(keepNValues);
-			m_actualRows = keepNValues;
-		}
-		m_dataContainer.resize(m_actualCols);
-
-		DEBUG("	data source resized to col: " << m_actualCols);
-		DEBUG("	data source rowCount: " << spreadsheet->rowCount());
-
-		DEBUG("	Setting data ..");
-		for (int n = 0; n < m_actualCols; ++n) {
-			// data() returns a void* which is a pointer to any data type (see ColumnPrivate.cpp)
-			spreadsheet->child<Column>(n)->setColumnMode(columnModes[n]);
-			switch (columnModes[n]) {
-			case AbstractColumn::Numeric: {
-				QVector<double>* vector = static_cast<QVector<double>* >(spreadsheet->child<Column>(n)->data());
-				vector->resize(m_actualRows);
-				m_dataContainer[n] = static_cast<void *>(vector);
-				break;
-			}
-			case AbstractColumn::Integer: {
-				QVector<int>* vector = static_cast<QVector<int>* >(spreadsheet->child<Column>(n)->data());
-				vector->resize(m_actualRows);
-				m_dataContainer[n] = static_cast<void *>(vector);
-				break;
-			}
-			case AbstractColumn::Text: {
-				QVector<QString>* vector = static_cast<QVector<QString>*>(spreadsheet->child<Column>(n)->data());
-				vector->resize(m_actualRows);
-				m_dataContainer[n] = static_cast<void *>(vector);
-				break;
-			}
-			case AbstractColumn::DateTime: {
-				QVector<QDateTime>* vector = static_cast<QVector<QDateTime>* >(spreadsheet->child<Column>(n)->data());
-				vector->resize(m_actualRows);
-				m_dataContainer[n] = static_cast<void *>(vector);
-				break;
-			}
-			//TODO
-			case AbstractColumn::Month:
-			case AbstractColumn::Day:
-				break;
-			}
-		}
-
+		initLiveDataSource(spreadsheet);
 		DEBUG("	Prepared!");
 	}
 
@@ -901,6 +942,7 @@ qint64 AsciiFilterPrivate::readFromLiveDevice(QIODevice& device, AbstractDataSou
 	int currentRow = 0; // indexes the position in the vector(column)
 	int linesToRead = 0;
 	int keepNValues = spreadsheet->keepNValues();
+	QVector<int> ringOffsets(m_actualCols, 0); //index of the first row in the columns used as circular buffers
 
 	DEBUG("	Increase row count. keepNValues = " << keepNValues);
 	if (m_prepared) {
@@ -1043,43 +1085,13 @@ qint64 AsciiFilterPrivate::readFromLiveDevice(QIODevice& device, AbstractDataSou
 			for (int col = 0; col < m_actualCols; ++col)
 				spreadsheet->child<Column>(col)->setSuppressDataChangedSignal(false);
 
-			for (int row = 0; row < linesToRead; ++row) {
-				for (int col = 0; col < m_actualCols; ++col) {
-					switch (columnModes[col]) {
-					case AbstractColumn::Numeric: {
-						QVector<double>* vector = static_cast<QVector<double>* >(spreadsheet->child<Column>(col)->data());
-						vector->pop_front();
-						vector->resize(m_actualRows);
-						m_dataContainer[col] = static_cast<void *>(vector);
-						break;
-					}
-					case AbstractColumn::Integer: {
-						QVector<int>* vector = static_cast<QVector<int>* >(spreadsheet->child<Column>(col)->data());
-						vector->pop_front();
-						vector->resize(m_actualRows);
-						m_dataContainer[col] = static_cast<void *>(vector);
-						break;
-					}
-					case AbstractColumn::Text: {
-						QVector<QString>* vector = static_cast<QVector<QString>*>(spreadsheet->child<Column>(col)->data());
-						vector->pop_front();
-						vector->resize(m_actualRows);
-						m_dataContainer[col] = static_cast<void *>(vector);
-						break;
-					}
-					case AbstractColumn::DateTime: {
-						QVector<QDateTime>* vector = static_cast<QVector<QDateTime>* >(spreadsheet->child<Column>(col)->data());
-						vector->pop_front();
-						vector->resize(m_actualRows);
-						m_dataContainer[col] = static_cast<void *>(vector);
-						break;
-					}
-					//TODO
-					case AbstractColumn::Month:
-					case AbstractColumn::Day:
-						break;
-					}
-				}
+			//the columns are used as circular buffers: evict the oldest linesToRead rows,
+			//the freed rows at the end are filled with the new data below
+			for (int col = 0; col < m_actualCols; ++col) {
+				Column* column = spreadsheet->child<Column>(col);
+				column->evictRows(linesToRead);
+				m_dataContainer[col] = column->ringData();
+				ringOffsets[col] = column->ringOffset();
 			}
 		}
 	}
@@ -1166,6 +1178,7 @@ qint64 AsciiFilterPrivate::readFromLiveDevice(QIODevice& device, AbstractDataSou
 			QDEBUG("	column modes = " << columnModes);
 			for (int n = 0; n < m_actualCols; ++n) {
 				DEBUG("	actual col = " << n);
+				const int dataRow = ringOffsets.at(n) ? (currentRow + ringOffsets.at(n)) % m_actualRows : currentRow;
 				if (n < lineStringList.size()) {
 					QString valueString = lineStringList.at(n);
 					if (removeQuotesEnabled)
@@ -1178,7 +1191,7 @@ qint64 AsciiFilterPrivate::readFromLiveDevice(QIODevice& device, AbstractDataSou
 						DEBUG("	Numeric");
 						bool isNumber;
 						const double value = locale.toDouble(valueString, &isNumber);
-						static_cast<QVector<double>*>(m_dataContainer[n])->operator[](currentRow) = (isNumber ? value : nanValue);
+						static_cast<QVector<double>*>(m_dataContainer[n])->operator[](dataRow) = (isNumber ? value : nanValue);
 // 						qDebug() << "dataContainer[" << n << "] size:" << static_cast<QVector<double>*>(m_dataContainer[n])->size();
 						break;
 					}
@@ -1186,18 +1199,18 @@ qint64 AsciiFilterPrivate::readFromLiveDevice(QIODevice& device, AbstractDataSou
 						DEBUG("	Integer");
 						bool isNumber;
 						const int value = locale.toInt(valueString, &isNumber);
-						static_cast<QVector<int>*>(m_dataContainer[n])->operator[](currentRow) = (isNumber ? value : 0);
+						static_cast<QVector<int>*>(m_dataContainer[n])->operator[](dataRow) = (isNumber ? value : 0);
 // 						qDebug() << "dataContainer[" << n << "] size:" << static_cast<QVector<int>*>(m_dataContainer[n])->size();
 
 						break;
 					}
 					case AbstractColumn::DateTime: {
 						const QDateTime valueDateTime = QDateTime::fromString(valueString, dateTimeFormat);
-						static_cast<QVector<QDateTime>*>(m_dataContainer[n])->operator[](currentRow) = valueDateTime.isValid() ? valueDateTime : QDateTime();
+						static_cast<QVector<QDateTime>*>(m_dataContainer[n])->operator[](dataRow) = valueDateTime.isValid() ? valueDateTime : QDateTime();
 						break;
 					}
 					case AbstractColumn::Text:
-						static_cast<QVector<QString>*>(m_dataContainer[n])->operator[](currentRow) = valueString;
+						static_cast<QVector<QString>*>(m_dataContainer[n])->operator[](dataRow) = valueString;
 						break;
 					case AbstractColumn::Month:
 						//TODO
@@ -1210,16 +1223,16 @@ qint64 AsciiFilterPrivate::readFromLiveDevice(QIODevice& device, AbstractDataSou
 					DEBUG("	missing columns in this line");
 					switch (columnModes[n]) {
 					case AbstractColumn::Numeric:
-						static_cast<QVector<double>*>(m_dataContainer[n])->operator[](currentRow) = nanValue;
+						static_cast<QVector<double>*>(m_dataContainer[n])->operator[](dataRow) = nanValue;
 						break;
 					case AbstractColumn::Integer:
-						static_cast<QVector<int>*>(m_dataContainer[n])->operator[](currentRow) = 0;
+						static_cast<QVector<int>*>(m_dataContainer[n])->operator[](dataRow) = 0;
 						break;
 					case AbstractColumn::DateTime:
-						static_cast<QVector<QDateTime>*>(m_dataContainer[n])->operator[](currentRow) = QDateTime();
+						static_cast<QVector<QDateTime>*>(m_dataContainer[n])->operator[](dataRow) = QDateTime();
 						break;
 					case AbstractColumn::Text:
-						static_cast<QVector<QString>*>(m_dataContainer[n])->operator[](currentRow).clear();
+						static_cast<QVector<QString>*>(m_dataContainer[n])->operator[](dataRow).clear();
 						break;
 					case AbstractColumn::Month:
 						//TODO
@@ -1238,23 +1251,11 @@ qint64 AsciiFilterPrivate::readFromLiveDevice(QIODevice& device, AbstractDataSou
 		//notify all affected columns and plots about the changes
 		PERFTRACE("AsciiLiveDataImport, notify affected columns and plots");
 
-		//determine the dependent plots
-		QVector<CartesianPlot*> plots;
-		for (int n = 0; n < m_actualCols; ++n)
-			spreadsheet->column(n)->addUsedInPlots(plots);
-
-		//suppress retransform in the dependent plots
-		for (auto* plot : plots)
-			plot->setSuppressDataChangedSignal(true);
-
+		//the dependent plots are updated in the next frame
+		QVector<Column*> columns;
 		for (int n = 0; n < m_actualCols; ++n)
-			spreadsheet->column(n)->setChanged();
-
-		//retransform the dependent plots
-		for (auto* plot : plots) {
-			plot->setSuppressDataChangedSignal(false);
-			plot->dataChanged();
-		}
+			columns << spreadsheet->column(n);
+		PlotUpdateScheduler::instance()->setChanged(columns);
 	} else
 		m_prepared = true;
 
@@ -1974,8 +1975,9 @@ AbstractColumn::ColumnMode AsciiFilterPrivate::MQTTColumnMode() const {
  * \param message
  * \param topic
  * \param dataSource
+ * \param lineTimes arrival times of the lines in message
  */
-void AsciiFilterPrivate::readMQTTTopic(const QString& message, AbstractDataSource* dataSource) {
+void AsciiFilterPrivate::readMQTTTopic(const QString& message, AbstractDataSource* dataSource, const QVector<QDateTime>& lineTimes) {
 	//If the message is empty, there is nothing to do
 	if (message.isEmpty()) {
 		DEBUG("No new data available");
@@ -2273,6 +2275,7 @@ void AsciiFilterPrivate::readMQTTTopic(const QString& message, AbstractDataSourc
 
 	int currentRow = 0; // indexes the position in the vector(column)
 	int linesToRead = 0;
+	QVector<int> ringOffsets(m_actualCols, 0); //index of the first row in the columns used as circular buffers
 
 	if (m_prepared) {
 		//increase row count if we don't have a fixed size
@@ -2392,47 +2395,13 @@ void AsciiFilterPrivate::readMQTTTopic(const QString& message, AbstractDataSourc
 #ifdef PERFTRACE_LIVE_IMPORT
 			PERFTRACE("AsciiLiveDataImportPopping: ");
 #endif
-			for (int row = 0; row < linesToRead; ++row) {
-				for (int col = 0;  col < m_actualCols; ++col) {
-					switch (columnModes[col]) {
-					case AbstractColumn::Numeric: {
-						QVector<double>* vector = static_cast<QVector<double>* >(spreadsheet->child<Column>(col)->data());
-						vector->pop_front();
-						vector->reserve(m_actualRows);
-						vector->resize(m_actualRows);
-						m_dataContainer[col] = static_cast<void *>(vector);
-						break;
-					}
-					case AbstractColumn::Integer: {
-						QVector<int>* vector = static_cast<QVector<int>* >(spreadsheet->child<Column>(col)->data());
-						vector->pop_front();
-						vector->reserve(m_actualRows);
-						vector->resize(m_actualRows);
-						m_dataContainer[col] = static_cast<void *>(vector);
-						break;
-					}
-					case AbstractColumn::Text: {
-						QVector<QString>* vector = static_cast<QVector<QString>*>(spreadsheet->child<Column>(col)->data());
-						vector->pop_front();
-						vector->reserve(m_actualRows);
-						vector->resize(m_actualRows);
-						m_dataContainer[col] = static_cast<void *>(vector);
-						break;
-					}
-					case AbstractColumn::DateTime: {
-						QVector<QDateTime>* vector = static_cast<QVector<QDateTime>* >(spreadsheet->child<Column>(col)->data());
-						vector->pop_front();
-						vector->reserve(m_actualRows);
-						vector->resize(m_actualRows);
-						m_dataContainer[col] = static_cast<void *>(vector);
-						break;
-					}
-					//TODO
-					case AbstractColumn::Month:
-					case AbstractColumn::Day:
-						break;
-					}
-				}
+			//the columns are used as circular buffers: evict the oldest linesToRead rows,
+			//the freed rows at the end are filled with the new data below
+			for (int col = 0; col < m_actualCols; ++col) {
+				Column* column = spreadsheet->child<Column>(col);
+				column->evictRows(linesToRead);
+				m_dataContainer[col] = column->ringData();
+				ringOffsets[col] = column->ringOffset();
 			}
 		}
 	}
@@ -2460,11 +2429,8 @@ void AsciiFilterPrivate::readMQTTTopic(const QString& message, AbstractDataSourc
 		int row = 0;
 		QLocale locale(numberFormat);
 		for (; row < linesToRead; ++row) {
-			QString line;
-			if (readingType == MQTTClient::ReadingType::FromEnd)
-				line = newData.at(newDataIdx++);
-			else
-				line = newData.at(row);
+			const int lineIdx = (readingType == MQTTClient::ReadingType::FromEnd) ? newDataIdx++ : row;
+			QString line = newData.at(lineIdx);
 
 			if (simplifyWhitespacesEnabled)
 				line = line.simplified();
@@ -2472,17 +2438,23 @@ void AsciiFilterPrivate::readMQTTTopic(const QString& message, AbstractDataSourc
 			if (line.isEmpty() || (!commentCharacter.isEmpty() && line.startsWith(commentCharacter)))
 				continue;
 
+			//position of the current row in the vectors, the columns are circular buffers for a fixed size
+			auto dataRow = [&](int col) {
+				return ringOffsets.at(col) ? (currentRow + ringOffsets.at(col)) % m_actualRows : currentRow;
+			};
+
 			//add index if required
 			int offset = 0;
 			if (createIndexEnabled) {
 				int index = (keepNValues != 0) ? indexColumnIdx++ : currentRow;
-				static_cast<QVector<int>*>(m_dataContainer[0])->operator[](currentRow) = index;
+				static_cast<QVector<int>*>(m_dataContainer[0])->operator[](dataRow(0)) = index;
 				++offset;
 			}
 
-			//add current timestamp if required
+			//add the arrival time of the line as timestamp if required
 			if (createTimestampEnabled) {
-				static_cast<QVector<QDateTime>*>(m_dataContainer[offset])->operator[](currentRow) = QDateTime::currentDateTime();
+				static_cast<QVector<QDateTime>*>(m_dataContainer[offset])->operator[](dataRow(offset)) =
+					(lineIdx < lineTimes.size()) ? lineTimes.at(lineIdx) : QDateTime::currentDateTime();
 				++offset;
 			}
 
@@ -2502,24 +2474,24 @@ void AsciiFilterPrivate::readMQTTTopic(const QString& message, AbstractDataSourc
 					case AbstractColumn::Numeric: {
 						bool isNumber;
 						const double value = locale.toDouble(valueString, &isNumber);
-						static_cast<QVector<double>*>(m_dataContainer[col])->operator[](currentRow) = (isNumber ? value : nanValue);
+						static_cast<QVector<double>*>(m_dataContainer[col])->operator[](dataRow(col)) = (isNumber ? value : nanValue);
 						break;
 					}
 					case AbstractColumn::Integer: {
 						bool isNumber;
 						const int value = locale.toInt(valueString, &isNumber);
-						static_cast<QVector<int>*>(m_dataContainer[col])->operator[](currentRow) = (isNumber ? value : 0);
+						static_cast<QVector<int>*>(m_dataContainer[col])->operator[](dataRow(col)) = (isNumber ? value : 0);
 						break;
 					}
 					case AbstractColumn::DateTime: {
 						const QDateTime valueDateTime = QDateTime::fromString(valueString, dateTimeFormat);
-						static_cast<QVector<QDateTime>*>(m_dataContainer[col])->operator[](currentRow) = valueDateTime.isValid() ? valueDateTime : QDateTime();
+						static_cast<QVector<QDateTime>*>(m_dataContainer[col])->operator[](dataRow(col)) = valueDateTime.isValid() ? valueDateTime : QDateTime();
 						break;
 					}
 					case AbstractColumn::Text:
 						if (removeQuotesEnabled)
 							valueString.remove(QLatin1Char('"'));
-						static_cast<QVector<QString>*>(m_dataContainer[col])->operator[](currentRow) = valueString;
+						static_cast<QVector<QString>*>(m_dataContainer[col])->operator[](dataRow(col)) = valueString;
 						break;
 					case AbstractColumn::Month:
 						//TODO
@@ -2532,16 +2504,16 @@ void AsciiFilterPrivate::readMQTTTopic(const QString& message, AbstractDataSourc
 					DEBUG("	missing columns in this line");
 					switch (columnModes[n]) {
 					case AbstractColumn::Numeric:
-						static_cast<QVector<double>*>(m_dataContainer[col])->operator[](currentRow) = nanValue;
+						static_cast<QVector<double>*>(m_dataContainer[col])->operator[](dataRow(col)) = nanValue;
 						break;
 					case AbstractColumn::Integer:
-						static_cast<QVector<int>*>(m_dataContainer[col])->operator[](currentRow) = 0;
+						static_cast<QVector<int>*>(m_dataContainer[col])->operator[](dataRow(col)) = 0;
 						break;
 					case AbstractColumn::DateTime:
-						static_cast<QVector<QDateTime>*>(m_dataContainer[col])->operator[](currentRow) = QDateTime();
+						static_cast<QVector<QDateTime>*>(m_dataContainer[col])->operator[](dataRow(col)) = QDateTime();
 						break;
 					case AbstractColumn::Text:
-						static_cast<QVector<QString>*>(m_dataContainer[col])->operator[](currentRow).clear();
+						static_cast<QVector<QString>*>(m_dataContainer[col])->operator[](dataRow(col)).clear();
 						break;
 					case AbstractColumn::Month:
 						//TODO
@@ -2560,33 +2532,11 @@ void AsciiFilterPrivate::readMQTTTopic(const QString& message, AbstractDataSourc
 		//notify all affected columns and plots about the changes
 		PERFTRACE("AsciiLiveDataImport, notify affected columns and plots");
 
-		const Project* project = spreadsheet->project();
-		QVector<const XYCurve*> curves = project->children<const XYCurve>(AbstractAspect::Recursive);
-		QVector<CartesianPlot*> plots;
-
-		for (int n = 0; n < m_actualCols; ++n) {
-			Column* column = spreadsheet->column(n);
-
-			//determine the plots where the column is consumed
-			for (const auto* curve : curves) {
-				if (curve->xColumn() == column || curve->yColumn() == column) {
-					CartesianPlot* plot = dynamic_cast<CartesianPlot*>(curve->parentAspect());
-					if (plots.indexOf(plot) == -1) {
-						plots << plot;
-						plot->setSuppressDataChangedSignal(true);
-					}
-				}
-			}
-
-			column->setChanged();
-		}
-
-		//loop over all affected plots and retransform them
-		for (auto* const plot : plots) {
-			//TODO setting this back to true triggers again a lot of retransforms in the plot (one for each curve).
-			// 				plot->setSuppressDataChangedSignal(false);
-			plot->dataChanged();
-		}
+		//the dependent plots are updated in the next frame
+		QVector<Column*> columns;
+		for (int n = 0; n < m_actualCols; ++n)
+			columns << spreadsheet->column(n);
+		PlotUpdateScheduler::instance()->setChanged(columns);
 	} else
 		m_prepared = true;
 
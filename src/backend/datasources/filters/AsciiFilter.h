@@ -32,7 +32,9 @@ Copyright            : (C) 2017 Stefan Gerlach (stefan.gerlach@uni.kn)
 #include "backend/core/AbstractColumn.h"
 
 class Spreadsheet;
+class LiveDataSource;
 class QStringList;
+class QDateTime;
 class QIODevice;
 class AsciiFilterPrivate;
 class QAbstractSocket;
@@ -61,6 +63,7 @@ public:
 	                        AbstractFileFilter::ImportMode = AbstractFileFilter::Replace, int lines = -1);
 	void readFromLiveDeviceNotFile(QIODevice& device, AbstractDataSource*dataSource);
 	qint64 readFromLiveDevice(QIODevice& device, AbstractDataSource*, qint64 from = -1);
+	void prepareLiveDataSource(LiveDataSource*);
 	// overloaded function to read from file
 	void readDataFromFile(const QString& fileName, AbstractDataSource* = nullptr,
 	                      AbstractFileFilter::ImportMode = AbstractFileFilter::Replace) override;
@@ -76,7 +79,7 @@ public:
 	QVector<QStringList> preview(const QString& message);
 	QString MQTTColumnStatistics(const MQTTTopic*) const;
 	AbstractColumn::ColumnMode MQTTColumnMode() const;
-	void readMQTTTopic(const QString& message, AbstractDataSource*);
+	void readMQTTTopic(const QString& message, AbstractDataSource*, const QVector<QDateTime>& lineTimes = QVector<QDateTime>());
 	void setPreparedForMQTT(bool, MQTTTopic*, const QString&);
 #endif
 
@@ -35,6 +35,7 @@ class AbstractDataSource;
 class AbstractColumn;
 class AbstractAspect;
 class Spreadsheet;
+class LiveDataSource;
 class MQTTTopic;
 
 class AsciiFilterPrivate {
@@ -49,6 +50,7 @@ public:
 	void readFromLiveDeviceNotFile(QIODevice& device, AbstractDataSource*,
 			AbstractFileFilter::ImportMode = AbstractFileFilter::Replace);
 	qint64 readFromLiveDevice(QIODevice&, AbstractDataSource*, qint64 from = -1);
+	void prepareLiveDataSource(LiveDataSource*);
 	void readDataFromFile(const QString& fileName, AbstractDataSource* = nullptr,
 			AbstractFileFilter::ImportMode = AbstractFileFilter::Replace);
 	void write(const QString& fileName, AbstractDataSource*);
@@ -63,7 +65,7 @@ public:
 	QVector<QStringList> preview(const QString& message);
 	AbstractColumn::ColumnMode MQTTColumnMode() const;
 	QString MQTTColumnStatistics(const MQTTTopic*) const;
-	void readMQTTTopic(const QString& message, AbstractDataSource*);
+	void readMQTTTopic(const QString& message, AbstractDataSource*, const QVector<QDateTime>& lineTimes);
 	void setPreparedForMQTT(bool, MQTTTopic*, const QString&);
 #endif
 
@@ -96,6 +98,9 @@ public:
 	QString readingFileName;
 
 private:
+	void initLiveColumnsNotFile();
+	void initLiveDataSource(LiveDataSource*);
+
 	static const unsigned int m_dataTypeLines = 10;	// maximum lines to read for determining data types
 	QString m_separator;
 	int m_actualStartRow{1};
@@ -28,13 +28,18 @@ Copyright            : (C) 2017 Alexander Semke (alexander.semke@web.de)
 #include "backend/datasources/filters/BinaryFilter.h"
 #include "backend/datasources/filters/BinaryFilterPrivate.h"
 #include "backend/datasources/AbstractDataSource.h"
+#include "backend/datasources/LiveDataSource.h"
 #include "backend/core/column/Column.h"
+#include "backend/lib/trace.h"
 
 #include <QDataStream>
+#include <QUdpSocket>
+#include <QtEndian>
 #include <KLocalizedString>
 #include <KFilterDev>
 #include <array>
 #include <cmath>
+#include <cstring>
 
 /*!
 \class BinaryFilter
@@ -60,6 +65,14 @@ void BinaryFilter::readDataFromDevice(QIODevice& device, AbstractDataSource* dat
 	d->readDataFromDevice(device, dataSource, importMode, lines);
 }
 
+/*!
+  reads the binary records available in the sequential device \c device (socket, serial port)
+  and appends them to the live data source \c dataSource. Returns the number of bytes read.
+*/
+qint64 BinaryFilter::readFromLiveDeviceNotFile(QIODevice& device, AbstractDataSource* dataSource) {
+	return d->readFromLiveDeviceNotFile(device, dataSource);
+}
+
 QVector<QStringList> BinaryFilter::preview(const QString& fileName, int lines) {
 	return d->preview(fileName, lines);
 }
@@ -197,6 +210,43 @@ void BinaryFilter::setCreateIndexEnabled(bool b) {
 	d->createIndexEnabled = b;
 }
 
+/*!
+  sets the types of the fields of one record read from a live device.
+  If the layout is empty, a record consists of vectors() fields of the type dataType().
+*/
+void BinaryFilter::setRecordLayout(const QVector<BinaryFilter::DataType>& layout) {
+	d->recordLayout = layout;
+}
+
+QVector<BinaryFilter::DataType> BinaryFilter::recordLayout() const {
+	return d->recordLayout;
+}
+
+/*!
+  if enabled, the records read from a live device are sent in frames, every frame is prefixed with
+  the number of bytes following as unsigned 32 bit integer in the byte order byteOrder().
+  Otherwise the records are sent without any separation.
+*/
+void BinaryFilter::setFramesEnabled(const bool b) {
+	d->framesEnabled = b;
+}
+
+bool BinaryFilter::framesEnabled() const {
+	return d->framesEnabled;
+}
+
+/*!
+  sets the field of a record containing its timestamp (-1 for none). Integer fields are interpreted as
+  milliseconds, floating point fields as seconds since 1970-01-01 UTC. The timestamps are stored in a DateTime column.
+*/
+void BinaryFilter::setTimestampField(const int field) {
+	d->timestampField = field;
+}
+
+int BinaryFilter::timestampField() const {
+	return d->timestampField;
+}
+
 void BinaryFilter::setAutoModeEnabled(bool b) {
 	d->autoModeEnabled = b;
 }
@@ -517,6 +567,259 @@ void BinaryFilterPrivate::readDataFromDevice(QIODevice& device, AbstractDataSour
 	dataSource->finalizeImport(columnOffset, 1, m_actualCols, QString(), importMode);
 }
 
+/*!
+ * returns the value of the field of the type \c type stored at \c data with the byte order \c byteOrder.
+ */
+static double fieldValue(const uchar* data, BinaryFilter::DataType type, QDataStream::ByteOrder byteOrder) {
+	const bool little = (byteOrder == QDataStream::LittleEndian);
+	switch (type) {
+	case BinaryFilter::INT8:
+		return static_cast<qint8>(data[0]);
+	case BinaryFilter::INT16:
+		return little ? qFromLittleEndian<qint16>(data) : qFromBigEndian<qint16>(data);
+	case BinaryFilter::INT32:
+		return little ? qFromLittleEndian<qint32>(data) : qFromBigEndian<qint32>(data);
+	case BinaryFilter::INT64:
+		return little ? qFromLittleEndian<qint64>(data) : qFromBigEndian<qint64>(data);
+	case BinaryFilter::UINT8:
+		return data[0];
+	case BinaryFilter::UINT16:
+		return little ? qFromLittleEndian<quint16>(data) : qFromBigEndian<quint16>(data);
+	case BinaryFilter::UINT32:
+		return little ? qFromLittleEndian<quint32>(data) : qFromBigEndian<quint32>(data);
+	case BinaryFilter::UINT64:
+		return little ? qFromLittleEndian<quint64>(data) : qFromBigEndian<quint64>(data);
+	case BinaryFilter::REAL32: {
+		const quint32 bits = little ? qFromLittleEndian<quint32>(data) : qFromBigEndian<quint32>(data);
+		float value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+	case BinaryFilter::REAL64: {
+		const quint64 bits = little ? qFromLittleEndian<quint64>(data) : qFromBigEndian<quint64>(data);
+		double value;
+		memcpy(&value, &bits, sizeof(value));
+		return value;
+	}
+	}
+
+	return NAN;
+}
+
+/*!
+ * returns the mode of the column the values of the type \c type are stored in.
+ */
+static AbstractColumn::ColumnMode fieldColumnMode(BinaryFilter::DataType type) {
+	switch (type) {
+	case BinaryFilter::INT8:
+	case BinaryFilter::INT16:
+	case BinaryFilter::INT32:
+	case BinaryFilter::UINT8:
+	case BinaryFilter::UINT16:
+		return AbstractColumn::Integer;
+	case BinaryFilter::INT64:
+	case BinaryFilter::UINT32:
+	case BinaryFilter::UINT64:
+	case BinaryFilter::REAL32:
+	case BinaryFilter::REAL64:
+		break;
+	}
+
+	return AbstractColumn::Numeric;
+}
+
+/*!
+ * creates the columns in the live data source \c spreadsheet for the fields of the record layout:
+ * the optional index column, one DateTime column for the timestamp field and one column per other field.
+ */
+void BinaryFilterPrivate::prepareLiveDataSource(LiveDataSource* spreadsheet) {
+	m_fields = recordLayout;
+	if (m_fields.isEmpty())
+		m_fields.fill(dataType, (int)vectors);
+
+	m_fieldOffsets.clear();
+	m_recordSize = 0;
+	for (auto type : m_fields) {
+		m_fieldOffsets << m_recordSize;
+		m_recordSize += BinaryFilter::dataSize(type);
+	}
+
+	QStringList vectorNames;
+	columnModes.clear();
+	if (createIndexEnabled) {
+		vectorNames << i18n("Index");
+		columnModes << AbstractColumn::Integer;
+	}
+	for (int i = 0; i < m_fields.size(); ++i) {
+		if (i == timestampField) {
+			vectorNames << i18n("Timestamp");
+			columnModes << AbstractColumn::DateTime;
+		} else {
+			vectorNames << i18n("Field %1", i + 1);
+			columnModes << fieldColumnMode(m_fields.at(i));
+		}
+	}
+	m_actualCols = columnModes.size();
+
+	spreadsheet->setUndoAware(false);
+	spreadsheet->resize(AbstractFileFilter::Replace, vectorNames, m_actualCols);
+
+	//data changes are propagated via an explicit Column::setChanged() call once new data was read
+	for (int n = 0; n < m_actualCols; ++n) {
+		Column* column = spreadsheet->child<Column>(n);
+		column->setUndoAware(false);
+		column->setSuppressDataChangedSignal(true);
+		column->setColumnMode(columnModes.at(n));
+	}
+	spreadsheet->setRowCount(spreadsheet->keepNValues());
+
+	m_index = 1;
+	m_livePrepared = true;
+	DEBUG("BinaryFilterPrivate::prepareLiveDataSource(): " << m_fields.size() << " fields, record size = " << m_recordSize);
+}
+
+/*!
+ * decodes the complete records in \c data of size \c size and appends them to \c block.
+ * Returns the number of bytes used.
+ */
+int BinaryFilterPrivate::readRecords(const char* data, int size, LiveDataBlock& block) {
+	const int records = size / m_recordSize;
+	const int fieldColumn = createIndexEnabled ? 1 : 0;
+
+	const auto* record = reinterpret_cast<const uchar*>(data);
+	for (int r = 0; r < records; ++r, record += m_recordSize) {
+		if (createIndexEnabled)
+			block.integerData[0] << m_index++;
+
+		for (int i = 0; i < m_fields.size(); ++i) {
+			const int col = fieldColumn + i;
+			const BinaryFilter::DataType type = m_fields.at(i);
+			const double value = fieldValue(record + m_fieldOffsets.at(i), type, byteOrder);
+			switch (columnModes.at(col)) {
+			case AbstractColumn::Numeric:
+				block.numericData[col] << value;
+				break;
+			case AbstractColumn::Integer:
+				block.integerData[col] << static_cast<int>(value);
+				break;
+			case AbstractColumn::DateTime: {
+				const qint64 msecs = (type == BinaryFilter::REAL32 || type == BinaryFilter::REAL64) ? qRound64(value * 1000.) : static_cast<qint64>(value);
+				block.dateTimeData[col] << QDateTime::fromMSecsSinceEpoch(msecs, Qt::UTC);
+				break;
+			}
+			case AbstractColumn::Text:
+			case AbstractColumn::Month:
+			case AbstractColumn::Day:
+				break;
+			}
+		}
+	}
+
+	block.rows += records;
+	return records * m_recordSize;
+}
+
+/*!
+ * decodes the complete frames in \c data of size \c size and appends their records to \c block.
+ * Returns the number of bytes used, an incomplete last frame is not used.
+ */
+int BinaryFilterPrivate::readFrames(const char* data, int size, LiveDataBlock& block) {
+	int pos = 0;
+	while (size - pos >= 4) {
+		const auto* prefix = reinterpret_cast<const uchar*>(data + pos);
+		const quint32 length = (byteOrder == QDataStream::LittleEndian) ? qFromLittleEndian<quint32>(prefix) : qFromBigEndian<quint32>(prefix);
+		if (length > maxFrameSize) {
+			//no valid frame, the stream cannot be synchronized anymore
+			DEBUG("BinaryFilterPrivate::readFrames(): invalid frame length " << length << ", data discarded");
+			return size;
+		}
+		if ((quint32)(size - pos - 4) < length)
+			break;
+
+		const int used = readRecords(data + pos + 4, (int)length, block);
+		if (used < (int)length)
+			DEBUG("BinaryFilterPrivate::readFrames(): " << length - used << " bytes of an incomplete record ignored");
+		pos += 4 + (int)length;
+	}
+
+	return pos;
+}
+
+/*!
+ * reads the binary records available in the sequential device \c device and appends them to
+ * the live data source \c dataSource. Every UDP datagram contains complete frames or records,
+ * for streams (TCP, local socket, serial port) only the complete frames or records are read
+ * and the remaining bytes are kept in the device until more data has arrived.
+ */
+qint64 BinaryFilterPrivate::readFromLiveDeviceNotFile(QIODevice& device, AbstractDataSource* dataSource) {
+	auto* spreadsheet = dynamic_cast<LiveDataSource*>(dataSource);
+	if (!spreadsheet)
+		return 0;
+
+	PERFTRACE("BinaryFilterPrivate::readFromLiveDeviceNotFile()");
+	if (!m_livePrepared)
+		prepareLiveDataSource(spreadsheet);
+	if (m_recordSize == 0)
+		return 0;
+
+	LiveDataBlock block;
+	block.numericData.resize(m_actualCols);
+	block.integerData.resize(m_actualCols);
+	block.dateTimeData.resize(m_actualCols);
+	block.textData.resize(m_actualCols);
+
+	auto* udpSocket = qobject_cast<QUdpSocket*>(&device);
+	if (udpSocket) {
+		QByteArray datagram;
+		while (udpSocket->hasPendingDatagrams()) {
+			datagram.resize((int)udpSocket->pendingDatagramSize());
+			const qint64 size = udpSocket->readDatagram(datagram.data(), datagram.size());
+			if (size < 0)
+				break;
+
+			block.bytes += size;
+			const int used = framesEnabled ? readFrames(datagram.constData(), (int)size, block)
+						: readRecords(datagram.constData(), (int)size, block);
+			if (used < size)
+				DEBUG("BinaryFilterPrivate::readFromLiveDeviceNotFile(): " << size - used << " bytes of an incomplete datagram ignored");
+		}
+	} else {
+		//peek the available data and remove only the bytes of the complete frames or records from the device
+		const QByteArray data = device.peek(device.bytesAvailable());
+		const int records = data.size() / m_recordSize;
+		for (int col = 0; col < m_actualCols; ++col) {
+			switch (columnModes.at(col)) {
+			case AbstractColumn::Numeric:
+				block.numericData[col].reserve(records);
+				break;
+			case AbstractColumn::Integer:
+				block.integerData[col].reserve(records);
+				break;
+			case AbstractColumn::DateTime:
+				block.dateTimeData[col].reserve(records);
+				break;
+			case AbstractColumn::Text:
+			case AbstractColumn::Month:
+			case AbstractColumn::Day:
+				break;
+			}
+		}
+
+		const int used = framesEnabled ? readFrames(data.constData(), data.size(), block)
+					: readRecords(data.constData(), data.size(), block);
+		if (used > 0)
+			device.read(used);
+		block.bytes = used;
+	}
+
+	DEBUG("BinaryFilterPrivate::readFromLiveDeviceNotFile(): " << block.rows << " records, " << block.bytes << " bytes");
+	const qint64 bytes = block.bytes;
+	if (block.rows > 0)
+		spreadsheet->appendData(QVector<LiveDataBlock>{block});
+
+	return bytes;
+}
+
 /*!
     writes the content of \c dataSource to the file \c fileName.
 */
@@ -544,6 +847,12 @@ void BinaryFilter::save(QXmlStreamWriter* writer) const {
 	writer->writeAttribute("skipStartBytes", QString::number(d->skipStartBytes) );
 	writer->writeAttribute("skipBytes", QString::number(d->skipBytes) );
 	writer->writeAttribute( "createIndex", QString::number(d->createIndexEnabled) );
+	QStringList layout;
+	for (auto type : d->recordLayout)
+		layout << QString::number(type);
+	writer->writeAttribute("recordLayout", layout.join(QLatin1Char(',')));
+	writer->writeAttribute("frames", QString::number(d->framesEnabled));
+	writer->writeAttribute("timestampField", QString::number(d->timestampField));
 	writer->writeEndElement();
 }
 
@@ -609,5 +918,21 @@ bool BinaryFilter::load(XmlStreamReader* reader) {
 	else
 		d->createIndexEnabled = str.toInt();
 
+	//settings for live data, not available in older projects
+	d->recordLayout.clear();
+	str = attribs.value("recordLayout").toString();
+	if (!str.isEmpty()) {
+		for (const auto& type : str.split(QLatin1Char(',')))
+			d->recordLayout << (BinaryFilter::DataType)type.toInt();
+	}
+
+	str = attribs.value("frames").toString();
+	if (!str.isEmpty())
+		d->framesEnabled = str.toInt();
+
+	str = attribs.value("timestampField").toString();
+	if (!str.isEmpty())
+		d->timestampField = str.toInt();
+
 	return true;
 }
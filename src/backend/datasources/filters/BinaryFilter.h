@@ -28,6 +28,7 @@ Copyright            : (C) 2015-2018 Stefan Gerlach (stefan.gerlach@uni.kn)
 #define BINARYFILTER_H
 
 #include <QDataStream>
+#include <QVector>
 #include "backend/datasources/filters/AbstractFileFilter.h"
 
 class BinaryFilterPrivate;
@@ -54,6 +55,7 @@ public:
 	void readDataFromDevice(QIODevice&, AbstractDataSource* = nullptr,
 			AbstractFileFilter::ImportMode = AbstractFileFilter::Replace, int lines = -1);
 	void readDataFromFile(const QString& fileName, AbstractDataSource*, AbstractFileFilter::ImportMode = AbstractFileFilter::Replace) override;
+	qint64 readFromLiveDeviceNotFile(QIODevice&, AbstractDataSource*);
 	void write(const QString& fileName, AbstractDataSource*) override;
 	QVector<QStringList> preview(const QString& fileName, int lines);
 
@@ -76,6 +78,12 @@ public:
 	void setSkipBytes(const size_t);
 	size_t skipBytes() const;
 	void setCreateIndexEnabled(const bool);
+	void setRecordLayout(const QVector<BinaryFilter::DataType>&);
+	QVector<BinaryFilter::DataType> recordLayout() const;
+	void setFramesEnabled(const bool);
+	bool framesEnabled() const;
+	void setTimestampField(const int);
+	int timestampField() const;
 
 	void setAutoModeEnabled(const bool);
 	bool isAutoModeEnabled() const;
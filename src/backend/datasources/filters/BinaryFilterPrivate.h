@@ -31,6 +31,8 @@ Copyright            : (C) 2015-2017 Stefan Gerlach (stefan.gerlach@uni.kn)
 
 class AbstractDataSource;
 class AbstractColumn;
+class LiveDataSource;
+struct LiveDataBlock;
 
 class BinaryFilterPrivate {
 
@@ -42,6 +44,7 @@ public:
 			AbstractFileFilter::ImportMode = AbstractFileFilter::Replace, int lines = -1);
 	void readDataFromFile(const QString& fileName, AbstractDataSource* = nullptr,
 			AbstractFileFilter::ImportMode = AbstractFileFilter::Replace);
+	qint64 readFromLiveDeviceNotFile(QIODevice&, AbstractDataSource*);
 	void write(const QString& fileName, AbstractDataSource*);
 	QVector<QStringList> preview(const QString& fileName, int lines);
 
@@ -61,9 +64,26 @@ public:
 
 	bool autoModeEnabled{true};
 
+	// live data from sockets and serial ports
+	QVector<BinaryFilter::DataType> recordLayout;	// types of the fields of one record (empty - vectors x dataType)
+	bool framesEnabled{true};	// records are sent in frames prefixed with their length (uint32)
+	int timestampField{-1};		// field containing the timestamp of the record (-1 - none)
+
+	static const quint32 maxFrameSize = 16*1024*1024;
+
 private:
+	void prepareLiveDataSource(LiveDataSource*);
+	int readFrames(const char* data, int size, LiveDataBlock&);
+	int readRecords(const char* data, int size, LiveDataBlock&);
+
 	int m_actualRows{0};
 	int m_actualCols{0};
+
+	bool m_livePrepared{false};
+	int m_index{1};			// index of the next record read from the live device
+	int m_recordSize{0};		// size of one record in bytes
+	QVector<BinaryFilter::DataType> m_fields;
+	QVector<int> m_fieldOffsets;
 };
 
 #endif
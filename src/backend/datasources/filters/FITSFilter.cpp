@@ -41,6 +41,8 @@ Copyright            : (C) 2017 Alexander Semke (alexander.semke@web.de)
 #include <QFile>
 #include <QDebug>
 
+#include <cmath>
+
 /*! \class FITSFilter
  * \brief Manages the import/export of data from/to a FITS file.
  * \since 2.2.0
@@ -310,6 +312,8 @@ QVector<QStringList> FITSFilterPrivate::readCHDU(const QString& fileName, Abstra
 
 		if (naxis == 0)
 			return dataStrings;
+		if (naxis == 1)
+			naxes[1] = 1;
 		actualRows = naxes[1];
 		actualCols = naxes[0];
 		if (lines == -1)
@@ -321,71 +325,96 @@ QVector<QStringList> FITSFilterPrivate::readCHDU(const QString& fileName, Abstra
 
 		if (endRow != -1) {
 			if (!noDataSource)
-				lines = endRow;
+				lines = qMin((long)endRow, actualRows);
 		}
 		if (endColumn != -1)
-			actualCols = endColumn;
-		if (noDataSource)
-			dataStrings.reserve(lines);
+			actualCols = qMin((long)endColumn, naxes[0]);
 
-		int i = 0;
-		int j = 0;
-		if (startRow != 1)
-			i = startRow;
-		if (startColumn != 1)
-			j = startColumn;
+		const long firstRow = (startRow > 1) ? startRow - 1 : 0;
+		const int firstCol = (startColumn > 1) ? startColumn - 1 : 0;
+		if (firstRow >= lines || firstCol >= actualCols) {
+			fits_close_file(m_fitsFile, &status);
+			return dataStrings;
+		}
+		const long importedRows = lines - firstRow;
+		const int importedCols = actualCols - firstCol;
+		if (noDataSource)
+			dataStrings.reserve(importedRows);
 
-		const int jstart = j;
+		// integer images (taking BSCALE/BZERO into account) are imported into integer columns
+		int equivType = bitpix;
+		fits_get_img_equivtype(m_fitsFile, &equivType, &status);
+		status = 0;
+		const bool isInteger = (equivType == BYTE_IMG || equivType == SBYTE_IMG || equivType == SHORT_IMG
+		                        || equivType == USHORT_IMG || equivType == LONG_IMG);
 
-		//TODO: support other modes
-		QVector<AbstractColumn::ColumnMode> columnModes;
-		columnModes.resize(actualCols - j);
+		QVector<AbstractColumn::ColumnMode> columnModes(importedCols, isInteger ? AbstractColumn::Integer : AbstractColumn::Numeric);
 		QStringList vectorNames;
 
 		std::vector<void*> dataContainer;
 		if (!noDataSource) {
-			dataContainer.reserve(actualCols - j);
-			columnOffset = dataSource->prepareImport(dataContainer, importMode, lines - i, actualCols - j, vectorNames, columnModes);
-		}
-
-		long pixelCount = lines * actualCols;
-		double* data = new double[pixelCount];
-
-		if (!data) {
-			qDebug() << "Not enough memory for data";
-			return dataStrings;
+			dataContainer.reserve(importedCols);
+			columnOffset = dataSource->prepareImport(dataContainer, importMode, importedRows, importedCols, vectorNames, columnModes);
 		}
 
-		if (fits_read_img(m_fitsFile, TDOUBLE, 1, pixelCount, nullptr, data, nullptr, &status)) {
-			printError(status);
-			return dataStrings << (QStringList() << QString("Error"));
-		}
+		// read the image in tiles of complete image rows to keep the temporary buffer small for large images
+		const long rowsPerTile = qMax(1L, imageTileSize / naxes[0]);
+		std::vector<double> doubleTile;
+		std::vector<int> intTile;
+		if (isInteger)
+			intTile.resize(rowsPerTile * naxes[0]);
+		else
+			doubleTile.resize(rowsPerTile * naxes[0]);
+
+		DEBUG("	Import " << importedRows << " lines in tiles of " << rowsPerTile << " rows");
+		for (long row = firstRow; row < lines; row += rowsPerTile) {
+			const long tileRows = qMin(rowsPerTile, lines - row);
+			const LONGLONG firstPixel = (LONGLONG)row * naxes[0] + 1;
+			const LONGLONG pixelCount = (LONGLONG)tileRows * naxes[0];
+			if (isInteger)
+				fits_read_img(m_fitsFile, TINT, firstPixel, pixelCount, nullptr, intTile.data(), nullptr, &status);
+			else
+				fits_read_img(m_fitsFile, TDOUBLE, firstPixel, pixelCount, nullptr, doubleTile.data(), nullptr, &status);
+			if (status) {
+				printError(status);
+				status = 0;
+				fits_close_file(m_fitsFile, &status);
+				return dataStrings << (QStringList() << QString("Error"));
+			}
 
-		int ii = 0;
-		DEBUG("	Import " << lines << " lines");
-		for (; i < lines; ++i) {
-			int jj = 0;
-			QStringList line;
-			line.reserve(actualCols - j);
-			for (; j < actualCols; ++j) {
-				if (noDataSource)
-					line << QString::number(data[i*naxes[0] +j]);
-				else
-					static_cast<QVector<double>*>(dataContainer[jj++])->operator[](ii) = data[i* naxes[0] + j];
+			for (long r = 0; r < tileRows; ++r) {
+				const long offset = r * naxes[0] + firstCol;
+				const long targetRow = row - firstRow + r;
+				if (noDataSource) {
+					QStringList line;
+					line.reserve(importedCols);
+					for (int c = 0; c < importedCols; ++c) {
+						if (isInteger)
+							line << QString::number(intTile[offset + c]);
+						else
+							line << QString::number(doubleTile[offset + c]);
+					}
+					dataStrings << line;
+				} else {
+					for (int c = 0; c < importedCols; ++c) {
+						if (isInteger)
+							(*static_cast<QVector<int>*>(dataContainer[c]))[targetRow] = intTile[offset + c];
+						else
+							(*static_cast<QVector<double>*>(dataContainer[c]))[targetRow] = doubleTile[offset + c];
+					}
+				}
 			}
-			dataStrings << line;
-			j = jstart;
-			ii++;
+
+			if (!noDataSource)
+				emit q->completed(100 * (row - firstRow + tileRows)/importedRows);
 		}
-		delete[] data;
 
 		if (dataSource)
-			dataSource->finalizeImport(columnOffset, 1, actualCols, QString(), importMode);
+			dataSource->finalizeImport(columnOffset, 1, importedCols, QString(), importMode);
 
 		fits_close_file(m_fitsFile, &status);
 
 		return dataStrings;
-
 	} else if ((chduType == ASCII_TBL) || (chduType == BINARY_TBL)) {
 		DEBUG("ASCII_TBL or BINARY_TBL");
 
@@ -435,174 +464,209 @@ QVector<QStringList> FITSFilterPrivate::readCHDU(const QString& fileName, Abstra
 
 		if (endRow != -1)
 			lines = endRow;
-		QVector<QStringList*> stringDataPointers;
-		std::vector<void*> numericDataPointers;
-		QList<bool> columnNumericTypes;
-
-		int startCol = 0;
-		if (startColumn != 1)
-			startCol = startColumn;
-		int startRrow = 0;
-		if (startRow != 1)
-			startRrow = startRow;
-
-		columnNumericTypes.reserve(actualCols);
-		int datatype;
-		int c = 1;
-		if (startColumn != 1) {
-			if (startColumn != 0)
-				c = startColumn;
-		}
+		const int firstCol = (startColumn > 1) ? startColumn : 1;
+		const long firstRow = (startRow > 1) ? startRow : 1;
+
+		// determine the (scaled) type of the columns and the column mode they are imported into.
+		// vector and bit columns are read as strings cell by cell, all other columns are read in bulk.
+		QVector<AbstractColumn::ColumnMode> columnModes;
+		QVector<bool> bulkReadable;
+		QVector<long> stringWidths;
+		columnModes.reserve(actualCols - firstCol + 1);
+		bulkReadable.reserve(actualCols - firstCol + 1);
+		stringWidths.reserve(actualCols - firstCol + 1);
 		QList<int> matrixNumericColumnIndices;
-		for (; c <= actualCols; ++c) {
-			fits_get_coltype(m_fitsFile, c, &datatype, nullptr, nullptr, &status);
+		for (int c = firstCol; c <= actualCols; ++c) {
+			int datatype;
+			long repeat;
+			long width;
+			fits_get_eqcoltype(m_fitsFile, c, &datatype, &repeat, &width, &status);
 
 			switch (datatype) {
-			case TSTRING:
-				columnNumericTypes.append(false);
-				break;
+			case TBYTE:
+			case TSBYTE:
 			case TSHORT:
-				columnNumericTypes.append(true);
-				break;
+			case TUSHORT:
+			case TINT:
 			case TLONG:
-				columnNumericTypes.append(true);
+				// only the first element of vector columns is read, as a string converted to double
+				columnModes << (repeat == 1 ? AbstractColumn::Integer : AbstractColumn::Numeric);
+				bulkReadable << (repeat == 1);
 				break;
+			case TUINT:
+			case TULONG:
+			case TLONGLONG:
 			case TFLOAT:
-				columnNumericTypes.append(true);
-				break;
 			case TDOUBLE:
-				columnNumericTypes.append(true);
-				break;
-			case TLOGICAL:
-				columnNumericTypes.append(false);
+				columnModes << AbstractColumn::Numeric;
+				bulkReadable << (repeat == 1);
 				break;
 			case TBIT:
-				columnNumericTypes.append(true);
-				break;
-			case TBYTE:
-				columnNumericTypes.append(true);
-				break;
 			case TCOMPLEX:
-				columnNumericTypes.append(true);
+			case TDBLCOMPLEX:
+				columnModes << AbstractColumn::Numeric;
+				bulkReadable << false;
+				break;
+			case TSTRING:
+				columnModes << AbstractColumn::Text;
+				bulkReadable << true;
 				break;
+			case TLOGICAL:
 			default:
-				columnNumericTypes.append(false);
+				columnModes << AbstractColumn::Text;
+				bulkReadable << false;
 				break;
 			}
+			stringWidths << qMax(width, (long)columnsWidth.at(c - firstCol));
+
 			if ((datatype != TSTRING) && (datatype != TLOGICAL))
 				matrixNumericColumnIndices.append(c);
 		}
+		status = 0;
 
-		if (noDataSource)
+		if (noDataSource) {
 			*okToMatrix = matrixNumericColumnIndices.isEmpty() ? false : true;
-		if (!noDataSource) {
-			DEBUG("HAS DataSource");
-			auto* spreadsheet = dynamic_cast<Spreadsheet*>(dataSource);
-			if (spreadsheet) {
-				numericDataPointers.reserve(actualCols - startCol);
-
-				stringDataPointers.reserve(actualCols - startCol);
-				spreadsheet->setUndoAware(false);
-				columnOffset = spreadsheet->resize(importMode, columnNames, actualCols - startCol);
-
-				if (importMode == AbstractFileFilter::Replace) {
-					spreadsheet->clear();
-					spreadsheet->setRowCount(lines - startRrow);
-				} else {
-					if (spreadsheet->rowCount() < (lines - startRrow))
-						spreadsheet->setRowCount(lines - startRrow);
-				}
-				DEBUG("Reading columns ...");
-				for (int n = 0; n < actualCols - startCol; ++n) {
-					if (columnNumericTypes.at(n)) {
-						spreadsheet->column(columnOffset+ n)->setColumnMode(AbstractColumn::Numeric);
-						auto* datap = static_cast<QVector<double>* >(spreadsheet->column(columnOffset+n)->data());
-						numericDataPointers.push_back(datap);
-						if (importMode == AbstractFileFilter::Replace)
-							datap->clear();
-					} else {
-						spreadsheet->column(columnOffset+ n)->setColumnMode(AbstractColumn::Text);
-						auto* list = static_cast<QStringList*>(spreadsheet->column(columnOffset+n)->data());
-						stringDataPointers.push_back(list);
-						if (importMode == AbstractFileFilter::Replace)
-							list->clear();
-					}
-				}
-				DEBUG("	... DONE");
-				stringDataPointers.squeeze();
-			} else {
-				numericDataPointers.reserve(matrixNumericColumnIndices.size());
 
-				columnOffset = dataSource->prepareImport(numericDataPointers, importMode, lines - startRrow, matrixNumericColumnIndices.size());
+			// preview: only the first lines are read, cell by cell as strings
+			char array[FLEN_VALUE];
+			char* tmpArr[1] = {array};
+			dataStrings.reserve(lines - firstRow + 1);
+			for (long row = firstRow; row <= lines; ++row) {
+				QStringList line;
+				line.reserve(actualCols - firstCol + 1);
+				for (int col = firstCol; col <= actualCols; ++col) {
+					if (fits_read_col_str(m_fitsFile, col, row, 1, 1, nullptr, tmpArr, nullptr, &status))
+						printError(status);
+					QString tmpColstr = QString::fromLatin1(array).simplified();
+					if (tmpColstr.isEmpty())
+						line << QLatin1String("NULL");
+					else
+						line << tmpColstr;
+				}
+				dataStrings << line;
 			}
+
+			fits_close_file(m_fitsFile, &status);
+			return dataStrings;
 		}
 
-		int row = 1;
-		if (startRow != 1) {
-			if (startRow != 0)
-				row = startRow;
+		DEBUG("HAS DataSource");
+		const long importedRows = lines - firstRow + 1;
+		if (importedRows <= 0) {
+			fits_close_file(m_fitsFile, &status);
+			return dataStrings;
 		}
 
-		int coll = 1;
-		if (startColumn != 1) {
-			if (startColumn != 0)
-				coll = startColumn;
+		// columns to be imported: all columns for spreadsheets, only the numeric ones for matrices
+		QVector<int> importedColumns;
+		QVector<AbstractColumn::ColumnMode> importedModes;
+		const bool isMatrix = (dynamic_cast<Matrix*>(dataSource) != nullptr);
+		for (int c = firstCol; c <= actualCols; ++c) {
+			if (isMatrix) {
+				if (!matrixNumericColumnIndices.contains(c))
+					continue;
+				importedModes << AbstractColumn::Numeric;	// all columns of a matrix have the same mode
+			} else
+				importedModes << columnModes.at(c - firstCol);
+			importedColumns << c;
 		}
-		bool isMatrix = false;
-		if (dynamic_cast<Matrix*>(dataSource)) {
-			isMatrix = true;
-			coll = matrixNumericColumnIndices.first();
-			actualCols = matrixNumericColumnIndices.last();
-			if (importMode == AbstractFileFilter::Replace) {
-				for (auto* col : numericDataPointers)
-					static_cast<QVector<double>*>(col)->clear();
-			}
+		if (importedColumns.isEmpty()) {
+			fits_close_file(m_fitsFile, &status);
+			return dataStrings;
 		}
 
-		char array[FLEN_VALUE];
-		char* tmpArr[1] = {array};
-		for (; row <= lines; ++row) {
-			int numericixd = 0;
-			int stringidx = 0;
-			QStringList line;
-			line.reserve(actualCols-coll);
-			for (int col = coll; col <= actualCols; ++col) {
-				if (isMatrix) {
-					if (!matrixNumericColumnIndices.contains(col))
-						continue;
-				}
-				if (fits_read_col_str(m_fitsFile, col, row, 1, 1, nullptr, tmpArr, nullptr, &status))
-					printError(status);
-				if (!noDataSource) {
-					QString str = QString::fromLatin1(array);
-					if (str.isEmpty()) {
-						if (columnNumericTypes.at(col - 1))
-							static_cast<QVector<double>*>(numericDataPointers[numericixd++])->push_back(0);
-						else
-							stringDataPointers[stringidx++]->append(QLatin1String("NULL"));
-					} else {
-						if (columnNumericTypes.at(col - 1))
-							static_cast<QVector<double>*>(numericDataPointers[numericixd++])->push_back(str.toDouble());
-						else {
-							if (!stringDataPointers.isEmpty())
-								stringDataPointers[stringidx++]->operator<<(str.simplified());
-						}
+		std::vector<void*> dataContainer;
+		dataContainer.reserve(importedColumns.size());
+		columnOffset = dataSource->prepareImport(dataContainer, importMode, importedRows, importedColumns.size(), columnNames, importedModes);
 
+		// read the table in chunks of rows that fit into the CFITSIO buffers,
+		// within a chunk every column is read with one call directly into the column data
+		long chunkRows = 0;
+		fits_get_rowsize(m_fitsFile, &chunkRows, &status);
+		status = 0;
+		chunkRows = qMax(chunkRows, 1024L);
+
+		DEBUG("	Import " << importedRows << " rows in chunks of " << chunkRows << " rows");
+		std::vector<char> stringBuffer;
+		std::vector<char*> stringPointers(chunkRows);
+		for (long row = firstRow; row <= lines; row += chunkRows) {
+			const long rows = qMin(chunkRows, lines - row + 1);
+			const long targetRow = row - firstRow;
+
+			for (int n = 0; n < importedColumns.size(); ++n) {
+				const int col = importedColumns.at(n);
+				const int index = col - firstCol;
+				int anynul = 0;
+				if (bulkReadable.at(index)) {
+					switch (importedModes.at(n)) {
+					case AbstractColumn::Numeric: {
+						double nulval = NAN;
+						double* data = static_cast<QVector<double>*>(dataContainer[n])->data() + targetRow;
+						fits_read_col(m_fitsFile, TDOUBLE, col, row, 1, rows, &nulval, data, &anynul, &status);
+						break;
+					}
+					case AbstractColumn::Integer: {
+						int nulval = 0;
+						int* data = static_cast<QVector<int>*>(dataContainer[n])->data() + targetRow;
+						fits_read_col(m_fitsFile, TINT, col, row, 1, rows, &nulval, data, &anynul, &status);
+						break;
+					}
+					case AbstractColumn::Text: {
+						const long width = stringWidths.at(index) + 1;
+						stringBuffer.resize(rows * width);
+						for (long i = 0; i < rows; ++i)
+							stringPointers[i] = stringBuffer.data() + i * width;
+						fits_read_col_str(m_fitsFile, col, row, 1, rows, nullptr, stringPointers.data(), &anynul, &status);
+						auto* vector = static_cast<QVector<QString>*>(dataContainer[n]);
+						for (long i = 0; i < rows; ++i) {
+							const QString str = QString::fromLatin1(stringPointers[i]).simplified();
+							(*vector)[targetRow + i] = str.isEmpty() ? QLatin1String("NULL") : str;
+						}
+						break;
+					}
+					case AbstractColumn::Month:
+					case AbstractColumn::Day:
+					case AbstractColumn::DateTime:
+						break;
 					}
 				} else {
-					QString tmpColstr = QString::fromLatin1(array);
-					tmpColstr = tmpColstr.simplified();
-					if (tmpColstr.isEmpty())
-						line << QLatin1String("NULL");
-					else
-						line << tmpColstr;
+					// vector, bit, complex and logical columns: read the first element as a string
+					char array[FLEN_VALUE];
+					char* tmpArr[1] = {array};
+					for (long i = 0; i < rows; ++i) {
+						if (fits_read_col_str(m_fitsFile, col, row + i, 1, 1, nullptr, tmpArr, nullptr, &status)) {
+							printError(status);
+							status = 0;
+						}
+						const QString str = QString::fromLatin1(array).simplified();
+						switch (importedModes.at(n)) {
+						case AbstractColumn::Text:
+							(*static_cast<QVector<QString>*>(dataContainer[n]))[targetRow + i] = str.isEmpty() ? QLatin1String("NULL") : str;
+							break;
+						case AbstractColumn::Integer:
+							(*static_cast<QVector<int>*>(dataContainer[n]))[targetRow + i] = str.isEmpty() ? 0 : str.toInt();
+							break;
+						case AbstractColumn::Numeric:
+							(*static_cast<QVector<double>*>(dataContainer[n]))[targetRow + i] = str.isEmpty() ? 0. : str.toDouble();
+							break;
+						case AbstractColumn::Month:
+						case AbstractColumn::Day:
+						case AbstractColumn::DateTime:
+							break;
+						}
+					}
+				}
+
+				if (status) {
+					printError(status);
+					status = 0;
 				}
 			}
-			dataStrings << line;
+
+			emit q->completed(100 * (targetRow + rows)/importedRows);
 		}
 
-		if (!noDataSource)
-			dataSource->finalizeImport(columnOffset, 1, actualCols, QString(), importMode);
+		dataSource->finalizeImport(columnOffset, 1, importedColumns.size(), QString(), importMode);
 
 		fits_close_file(m_fitsFile, &status);
 		return dataStrings;
@@ -66,6 +66,10 @@ public:
 
 	bool commentsAsUnits{false};
 	int exportTo{0};
+
+	// number of pixels read from an image at once (rounded down to complete image rows)
+	static const long imageTileSize = 1 << 20;
+
 private:
 	void printError(int status) const;
 
@@ -31,6 +31,7 @@
 
 #include "backend/datasources/filters/JsonFilter.h"
 #include "backend/datasources/filters/JsonFilterPrivate.h"
+#include "backend/datasources/filters/JsonStreamReader.h"
 #include "backend/datasources/AbstractDataSource.h"
 #include "backend/core/column/Column.h"
 #include "backend/spreadsheet/Spreadsheet.h"
@@ -40,9 +41,12 @@
 #include <QJsonArray>
 #include <QDataStream>
 #include <QDateTime>
+#include <QHash>
 #include <KLocalizedString>
 #include <KFilterDev>
 
+#include <algorithm>
+
 /*!
 \class JsonFilter
 \brief Manages the import/export of data from/to a file formatted using JSON.
@@ -517,6 +521,17 @@ void JsonFilterPrivate::readDataFromFile(const QString& fileName, AbstractDataSo
 reads the content of device \c device to the data source \c dataSource. Uses the settings defined in the data source.
 */
 void JsonFilterPrivate::readDataFromDevice(QIODevice& device, AbstractDataSource* dataSource, AbstractFileFilter::ImportMode importMode, int lines) {
+	if (!m_prepared && dataSource) {
+		const bool opened = device.isOpen();
+		if (readDataFromStream(device, dataSource, importMode))
+			return;
+
+		//fall back to the import via QJsonDocument
+		DEBUG("streaming import not possible");
+		if (!opened && device.isOpen())
+			device.close();
+	}
+
 	if (!m_prepared) {
 		const int deviceError = prepareDeviceToRead(device);
 		if (deviceError != 0) {
@@ -529,6 +544,276 @@ void JsonFilterPrivate::readDataFromDevice(QIODevice& device, AbstractDataSource
 	importData(dataSource, importMode, lines);
 }
 
+/*!
+reads the content of device \c device to the data source \c dataSource without creating a QJsonDocument.
+
+The device is read twice: the first pass determines the number of rows and columns and the column modes
+(from the first row), the second pass writes the values directly into the data containers.
+Only the data of the columns and a small read buffer are kept in memory.
+returns \c false if the device or the structure of the document doesn't allow to use the streaming import.
+*/
+bool JsonFilterPrivate::readDataFromStream(QIODevice& device, AbstractDataSource* dataSource, AbstractFileFilter::ImportMode importMode) {
+	if (device.isSequential())
+		return false;
+	if (!device.isOpen() && !device.open(QIODevice::ReadOnly))
+		return false;
+
+	JsonStreamReader reader(device);
+	if (!seekToModelNode(reader))
+		return false;
+
+	containerType = (reader.tokenType() == JsonStreamReader::BeginArray) ? JsonFilter::Array : JsonFilter::Object;
+	const JsonStreamReader::TokenType containerEnd = (containerType == JsonFilter::Array) ? JsonStreamReader::EndArray : JsonStreamReader::EndObject;
+	const JsonStreamReader::TokenType rowBegin = (rowType == QJsonValue::Array) ? JsonStreamReader::BeginArray : JsonStreamReader::BeginObject;
+	if (rowType != QJsonValue::Array && rowType != QJsonValue::Object)
+		return false;
+	importObjectNames = (importObjectNames && (rowType == QJsonValue::Object));
+	const qint64 containerPos = reader.position();
+
+	//first pass: determine the number of elements in every row, the names and the positions of the rows
+	QVector<int> rowCounts;
+	QStringList rowNames;
+	QVector<qint64> rowPositions;
+	QJsonValue firstRow;
+	while (reader.readNext() != containerEnd) {
+		if (containerType == JsonFilter::Object) {
+			if (reader.tokenType() != JsonStreamReader::Name)
+				return false;
+			rowNames << reader.string();
+			rowPositions << reader.position();
+			reader.readNext();
+		}
+
+		if (reader.tokenType() != rowBegin) {
+			if (!reader.skipValue())
+				return false;
+			rowCounts << 0;
+			continue;
+		}
+
+		if (containerType == JsonFilter::Array && rowCounts.size() == startRow - 1) {
+			firstRow = reader.readValue();
+			rowCounts << ((rowType == QJsonValue::Array) ? firstRow.toArray().count() : firstRow.toObject().count());
+			continue;
+		}
+
+		int count = 0;
+		while (true) {
+			const JsonStreamReader::TokenType token = reader.readNext();
+			if (token == JsonStreamReader::EndArray || token == JsonStreamReader::EndObject)
+				break;
+			if (rowType == QJsonValue::Object) {
+				if (token != JsonStreamReader::Name)
+					return false;
+				reader.readNext();
+			}
+			if (!reader.skipValue())
+				return false;
+			++count;
+		}
+		rowCounts << count;
+	}
+	if (reader.hasError())
+		return false;
+
+	const int totalRows = rowCounts.size();
+	if (totalRows < startRow)
+		return false;
+	const int endRowOffset = (endRow == -1 || endRow > totalRows) ? totalRows : endRow;
+
+	//the members of an object are ordered by their names in QJsonObject, use the same order for the rows
+	QVector<int> rowOrder(totalRows);
+	for (int i = 0; i < totalRows; ++i)
+		rowOrder[i] = i;
+	if (containerType == JsonFilter::Object)
+		std::stable_sort(rowOrder.begin(), rowOrder.end(), [&rowNames](int a, int b) { return rowNames.at(a) < rowNames.at(b); });
+
+	int countCols = -1;
+	for (int i = startRow - 1; i < endRowOffset; ++i) {
+		const int count = rowCounts.at(rowOrder.at(i));
+		if (count == 0)
+			return false;
+		countCols = (countCols == -1 || countCols > count) ? count : countCols;
+	}
+
+	QString firstRowName;
+	if (containerType == JsonFilter::Object) {
+		const int index = rowOrder.at(startRow - 1);
+		firstRowName = rowNames.at(index);
+		if (!reader.seek(rowPositions.at(index)))
+			return false;
+		reader.readNext();
+		firstRow = reader.readValue();
+	}
+	rowPositions.clear();
+
+	if (endColumn == -1 || endColumn > countCols)
+		endColumn = countCols;
+
+	m_actualRows = endRowOffset - startRow + 1;
+	m_actualCols = endColumn - startColumn + 1 + createIndexEnabled + importObjectNames;
+
+	if (parseColumnModes(firstRow, firstRowName) != 0)
+		return false;
+
+	DEBUG("streaming import: start/end column: = " << startColumn << ' ' << endColumn);
+	DEBUG("streaming import: actual cols/rows = " << m_actualCols << ' ' << m_actualRows);
+
+	//map the file position of the rows to the rows in the data source
+	QVector<int> targetRows(totalRows, -1);
+	for (int i = startRow - 1; i < endRowOffset; ++i)
+		targetRows[rowOrder.at(i)] = i - (startRow - 1);
+	rowOrder.clear();
+
+	//columns of object rows are identified by the names of the members in the first row
+	const int colOffset = (int)createIndexEnabled + (int)importObjectNames;
+	const int dataCols = m_actualCols - colOffset;
+	QHash<QString, int> columnIndices;
+	if (rowType == QJsonValue::Object) {
+		const QStringList keys = firstRow.toObject().keys();
+		for (int n = 0; n < dataCols; ++n)
+			columnIndices[keys.at(n + startColumn - 1)] = n;
+	}
+
+	//second pass: read the values directly into the data containers
+	m_columnOffset = dataSource->prepareImport(m_dataContainer, importMode, m_actualRows, m_actualCols, vectorNames, columnModes);
+	if (!reader.seek(containerPos))
+		return false;
+
+	const qint64 deviceSize = device.size();
+	QVector<bool> columnRead(dataCols);
+	for (int i = 0; i < totalRows; ++i) {
+		if (containerType == JsonFilter::Object)
+			reader.readNext();	// name of the row
+		reader.readNext();
+
+		const int row = targetRows.at(i);
+		if (row == -1) {
+			reader.skipValue();
+			continue;
+		}
+
+		if (createIndexEnabled)
+			static_cast<QVector<int>*>(m_dataContainer[0])->operator[](row) = row + 1;
+		if (importObjectNames)
+			setValueFromString((int)createIndexEnabled, row, rowNames.at(i));
+
+		columnRead.fill(false);
+		int n = 0;
+		while (true) {
+			JsonStreamReader::TokenType token = reader.readNext();
+			if (token == JsonStreamReader::EndArray || token == JsonStreamReader::EndObject
+				|| token == JsonStreamReader::Invalid || token == JsonStreamReader::EndOfDocument)
+				break;
+
+			int column;
+			if (rowType == QJsonValue::Object) {
+				column = columnIndices.value(reader.string(), -1);
+				reader.readNext();
+			} else {
+				column = n - (startColumn - 1);
+				if (column >= dataCols)
+					column = -1;
+			}
+			++n;
+
+			if (column < 0) {
+				reader.skipValue();
+				continue;
+			}
+
+			setValueFromStream(reader, colOffset + column, row);
+			columnRead[column] = true;
+		}
+
+		for (int column = 0; column < dataCols; ++column) {
+			if (!columnRead.at(column))
+				setEmptyValue(colOffset + column, row);
+		}
+
+		if (deviceSize > 0 && (i % 1000) == 0)
+			emit q->completed(100 * reader.position()/deviceSize);
+	}
+
+	finalizeImport(dataSource, importMode);
+
+	return true;
+}
+
+/*!
+moves the reader to the begin of the data container selected in the JSON model via \c modelRows.
+*/
+bool JsonFilterPrivate::seekToModelNode(JsonStreamReader& reader) {
+	reader.readNext();
+	if (reader.tokenType() != JsonStreamReader::BeginArray && reader.tokenType() != JsonStreamReader::BeginObject)
+		return false;
+
+	//the first index in modelRows corresponds to the root item of the model
+	for (int level = 1; level < modelRows.size(); ++level) {
+		const int index = modelRows.at(level);
+		if (reader.tokenType() == JsonStreamReader::BeginArray) {
+			for (int i = 0; i < index; ++i) {
+				const JsonStreamReader::TokenType token = reader.readNext();
+				if (token == JsonStreamReader::EndArray || !reader.skipValue())
+					return false;
+			}
+			reader.readNext();
+		} else {
+			//the members of objects are ordered by their names in the model
+			QStringList names;
+			QVector<qint64> positions;
+			while (reader.readNext() == JsonStreamReader::Name) {
+				names << reader.string();
+				positions << reader.position();
+				reader.readNext();
+				if (!reader.skipValue())
+					return false;
+			}
+			if (index >= names.size())
+				return false;
+
+			QStringList sortedNames = names;
+			std::sort(sortedNames.begin(), sortedNames.end());
+			if (!reader.seek(positions.at(names.lastIndexOf(sortedNames.at(index)))))
+				return false;
+			reader.readNext();
+		}
+
+		if (reader.tokenType() != JsonStreamReader::BeginArray && reader.tokenType() != JsonStreamReader::BeginObject)
+			return false;
+	}
+
+	return true;
+}
+
+void JsonFilterPrivate::setValueFromStream(JsonStreamReader& reader, int column, int row) {
+	switch (reader.tokenType()) {
+	case JsonStreamReader::Number:
+		if (columnModes[column] == AbstractColumn::Numeric)
+			static_cast<QVector<double>*>(m_dataContainer[column])->operator[](row) = reader.number();
+		else
+			setEmptyValue(column, row);
+		break;
+	case JsonStreamReader::String:
+		setValueFromString(column, row, reader.string());
+		break;
+	case JsonStreamReader::BeginArray:
+	case JsonStreamReader::BeginObject:
+		reader.skipValue();
+		setEmptyValue(column, row);
+		break;
+	case JsonStreamReader::Invalid:
+	case JsonStreamReader::EndObject:
+	case JsonStreamReader::EndArray:
+	case JsonStreamReader::Name:
+	case JsonStreamReader::Bool:
+	case JsonStreamReader::Null:
+	case JsonStreamReader::EndOfDocument:
+		setEmptyValue(column, row);
+		break;
+	}
+}
+
 /*!
 reads the content of document \c doc to the data source \c dataSource. Uses the settings defined in the data source.
 */
@@ -615,6 +900,10 @@ void JsonFilterPrivate::importData(AbstractDataSource* dataSource, AbstractFileF
 		emit q->completed(100 * i/m_actualRows);
 	}
 
+	finalizeImport(dataSource, importMode);
+}
+
+void JsonFilterPrivate::finalizeImport(AbstractDataSource* dataSource, AbstractFileFilter::ImportMode importMode) {
 	//set the plot designation to 'X' for index and name columns, if available
 	Spreadsheet* spreadsheet = dynamic_cast<Spreadsheet*>(dataSource);
 	if (createIndexEnabled)
@@ -35,6 +35,7 @@ class QJsonDocument;
 class KFilterDev;
 class AbstractDataSource;
 class AbstractColumn;
+class JsonStreamReader;
 
 class JsonFilterPrivate {
 
@@ -55,6 +56,8 @@ public:
 			AbstractFileFilter::ImportMode = AbstractFileFilter::Replace);
 	void readDataFromDocument(const QJsonDocument& doc, AbstractDataSource* = nullptr,
 	                          AbstractFileFilter::ImportMode = AbstractFileFilter::Replace, int lines = -1);
+	bool readDataFromStream(QIODevice& device, AbstractDataSource*,
+	                        AbstractFileFilter::ImportMode = AbstractFileFilter::Replace);
 
 	void importData(AbstractDataSource* = nullptr, AbstractFileFilter::ImportMode = AbstractFileFilter::Replace,
 	                int lines = -1);
@@ -86,6 +89,10 @@ public:
 	int endColumn{-1};	// end column
 
 private:
+	bool seekToModelNode(JsonStreamReader&);
+	void setValueFromStream(JsonStreamReader&, int column, int row);
+	void finalizeImport(AbstractDataSource*, AbstractFileFilter::ImportMode);
+
 	int m_actualRows{0};
 	int m_actualCols{0};
 	int m_prepared{false};
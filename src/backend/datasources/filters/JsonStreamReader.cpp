@@ -0,0 +1,383 @@
+/***************************************************************************
+    File                 : JsonStreamReader.cpp
+    Project              : LabPlot
+    Description          : Pull parser for JSON documents read from a QIODevice
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "backend/datasources/filters/JsonStreamReader.h"
+
+#include <QIODevice>
+#include <QJsonArray>
+#include <QJsonObject>
+
+/*!
+\class JsonStreamReader
+\brief Token based reader for JSON documents.
+
+In contrast to QJsonDocument the document is not loaded completely into the memory,
+the device is read in small blocks and the tokens are provided one by one via readNext().
+Commas and colons are consumed internally, a string followed by a colon is reported as a \c Name.
+
+\ingroup datasources
+*/
+
+static const int bufferSize = 64 * 1024;
+
+JsonStreamReader::JsonStreamReader(QIODevice& device) : m_device(device), m_bufferOffset(device.pos()) {}
+
+JsonStreamReader::TokenType JsonStreamReader::tokenType() const {
+	return m_type;
+}
+
+/*!
+returns the name (for \c Name) or the value (for \c String) of the current token.
+*/
+const QString& JsonStreamReader::string() const {
+	return m_string;
+}
+
+double JsonStreamReader::number() const {
+	return m_number;
+}
+
+bool JsonStreamReader::boolean() const {
+	return m_bool;
+}
+
+bool JsonStreamReader::hasError() const {
+	return m_error;
+}
+
+/*!
+returns the position in the device directly after the current token.
+*/
+qint64 JsonStreamReader::position() const {
+	return m_bufferOffset + m_bufferPos;
+}
+
+/*!
+sets the read position to \c pos, e.g. to a position returned by position() before.
+*/
+bool JsonStreamReader::seek(qint64 pos) {
+	m_buffer.clear();
+	m_bufferPos = 0;
+	m_bufferOffset = pos;
+	m_error = false;
+	m_type = Invalid;
+	return m_device.seek(pos);
+}
+
+/*!
+reads the next token and returns its type.
+*/
+JsonStreamReader::TokenType JsonStreamReader::readNext() {
+	if (m_error)
+		return Invalid;
+
+	char c;
+	do {
+		if (!skipWhiteSpace(c)) {
+			m_type = EndOfDocument;
+			return m_type;
+		}
+		getChar(c);
+	} while (c == ',');
+
+	switch (c) {
+	case '{':
+		m_type = BeginObject;
+		break;
+	case '}':
+		m_type = EndObject;
+		break;
+	case '[':
+		m_type = BeginArray;
+		break;
+	case ']':
+		m_type = EndArray;
+		break;
+	case '"': {
+		if (!readString())
+			return setError();
+		m_type = String;
+		char next;
+		if (skipWhiteSpace(next) && next == ':') {
+			getChar(next);
+			m_type = Name;
+		}
+		break;
+	}
+	case 't':
+		if (!readLiteral("rue"))
+			return setError();
+		m_type = Bool;
+		m_bool = true;
+		break;
+	case 'f':
+		if (!readLiteral("alse"))
+			return setError();
+		m_type = Bool;
+		m_bool = false;
+		break;
+	case 'n':
+		if (!readLiteral("ull"))
+			return setError();
+		m_type = Null;
+		break;
+	default:
+		if (c == '-' || (c >= '0' && c <= '9')) {
+			if (!readNumber(c))
+				return setError();
+			m_type = Number;
+		} else if (position() == 1 && (unsigned char)c == 0xEF) {
+			// UTF-8 byte order mark
+			if (!readLiteral("\xBB\xBF"))
+				return setError();
+			return readNext();
+		} else
+			return setError();
+	}
+
+	return m_type;
+}
+
+/*!
+skips the value starting with the current token, i.e. for objects and arrays
+all tokens up to and including the corresponding end token are read.
+returns \c false on a parse error.
+*/
+bool JsonStreamReader::skipValue() {
+	if (m_type != BeginObject && m_type != BeginArray)
+		return !m_error;
+
+	int depth = 1;
+	while (depth > 0) {
+		switch (readNext()) {
+		case BeginObject:
+		case BeginArray:
+			++depth;
+			break;
+		case EndObject:
+		case EndArray:
+			--depth;
+			break;
+		case Invalid:
+		case EndOfDocument:
+			return false;
+		case Name:
+		case String:
+		case Number:
+		case Bool:
+		case Null:
+			break;
+		}
+	}
+
+	return true;
+}
+
+/*!
+materializes the value starting with the current token.
+This is meant for small parts of the document only, like a single row.
+*/
+QJsonValue JsonStreamReader::readValue() {
+	switch (m_type) {
+	case BeginArray: {
+		QJsonArray array;
+		while (readNext() != EndArray) {
+			if (m_type == Invalid || m_type == EndOfDocument || m_type == Name)
+				return QJsonValue(QJsonValue::Undefined);
+			array.append(readValue());
+		}
+		return array;
+	}
+	case BeginObject: {
+		QJsonObject object;
+		while (readNext() == Name) {
+			const QString key = m_string;
+			readNext();
+			object.insert(key, readValue());
+		}
+		if (m_type != EndObject)
+			return QJsonValue(QJsonValue::Undefined);
+		return object;
+	}
+	case String:
+		return m_string;
+	case Number:
+		return m_number;
+	case Bool:
+		return m_bool;
+	case Null:
+		return QJsonValue(QJsonValue::Null);
+	case Invalid:
+	case EndObject:
+	case EndArray:
+	case Name:
+	case EndOfDocument:
+		break;
+	}
+
+	return QJsonValue(QJsonValue::Undefined);
+}
+
+//##############################################################################
+//#############################  helper functions  #############################
+//##############################################################################
+bool JsonStreamReader::fillBuffer() {
+	m_bufferOffset += m_buffer.size();
+	m_buffer = m_device.read(bufferSize);
+	m_bufferPos = 0;
+	return !m_buffer.isEmpty();
+}
+
+inline bool JsonStreamReader::getChar(char& c) {
+	if (m_bufferPos >= m_buffer.size() && !fillBuffer())
+		return false;
+	c = m_buffer.at(m_bufferPos++);
+	return true;
+}
+
+inline bool JsonStreamReader::peekChar(char& c) {
+	if (m_bufferPos >= m_buffer.size() && !fillBuffer())
+		return false;
+	c = m_buffer.at(m_bufferPos);
+	return true;
+}
+
+/*!
+skips white spaces and returns the next character without consuming it.
+*/
+bool JsonStreamReader::skipWhiteSpace(char& c) {
+	while (peekChar(c)) {
+		if (c != ' ' && c != '\n' && c != '\r' && c != '\t')
+			return true;
+		++m_bufferPos;
+	}
+	return false;
+}
+
+/*!
+reads a string after the opening quote into m_string.
+*/
+bool JsonStreamReader::readString() {
+	m_bytes.clear();
+	char c;
+	while (getChar(c)) {
+		if (c == '"') {
+			m_string = QString::fromUtf8(m_bytes);
+			return true;
+		}
+
+		if (c != '\\') {
+			m_bytes += c;
+			continue;
+		}
+
+		if (!getChar(c))
+			return false;
+		switch (c) {
+		case '"':
+		case '\\':
+		case '/':
+			m_bytes += c;
+			break;
+		case 'b':
+			m_bytes += '\b';
+			break;
+		case 'f':
+			m_bytes += '\f';
+			break;
+		case 'n':
+			m_bytes += '\n';
+			break;
+		case 'r':
+			m_bytes += '\r';
+			break;
+		case 't':
+			m_bytes += '\t';
+			break;
+		case 'u': {
+			QString chars;
+			for (int k = 0; k < 2; ++k) {
+				char hex[4];
+				for (char& h : hex) {
+					if (!getChar(h))
+						return false;
+				}
+				bool ok;
+				const ushort code = QByteArray(hex, 4).toUShort(&ok, 16);
+				if (!ok)
+					return false;
+				chars += QChar(code);
+
+				// a high surrogate is followed by the escaped low surrogate
+				if (!QChar::isHighSurrogate(code))
+					break;
+				if (!readLiteral("\\u"))
+					return false;
+			}
+			m_bytes += chars.toUtf8();
+			break;
+		}
+		default:
+			return false;
+		}
+	}
+
+	return false;
+}
+
+bool JsonStreamReader::readNumber(char first) {
+	m_bytes.clear();
+	m_bytes += first;
+	char c;
+	while (peekChar(c)) {
+		if ((c >= '0' && c <= '9') || c == '.' || c == 'e' || c == 'E' || c == '+' || c == '-') {
+			m_bytes += c;
+			++m_bufferPos;
+		} else
+			break;
+	}
+
+	bool ok;
+	m_number = m_bytes.toDouble(&ok);
+	return ok;
+}
+
+bool JsonStreamReader::readLiteral(const char* rest) {
+	char c;
+	for (; *rest; ++rest) {
+		if (!getChar(c) || c != *rest)
+			return false;
+	}
+	return true;
+}
+
+JsonStreamReader::TokenType JsonStreamReader::setError() {
+	m_error = true;
+	m_type = Invalid;
+	return m_type;
+}
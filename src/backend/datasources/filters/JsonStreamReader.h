@@ -0,0 +1,80 @@
+/***************************************************************************
+    File                 : JsonStreamReader.h
+    Project              : LabPlot
+    Description          : Pull parser for JSON documents read from a QIODevice
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef JSONSTREAMREADER_H
+#define JSONSTREAMREADER_H
+
+#include <QByteArray>
+#include <QJsonValue>
+#include <QString>
+
+class QIODevice;
+
+class JsonStreamReader {
+public:
+	enum TokenType {Invalid, BeginObject, EndObject, BeginArray, EndArray, Name, String, Number, Bool, Null, EndOfDocument};
+
+	explicit JsonStreamReader(QIODevice&);
+
+	TokenType readNext();
+	TokenType tokenType() const;
+	const QString& string() const;
+	double number() const;
+	bool boolean() const;
+	bool hasError() const;
+
+	bool skipValue();
+	QJsonValue readValue();
+
+	qint64 position() const;
+	bool seek(qint64 pos);
+
+private:
+	bool fillBuffer();
+	bool getChar(char&);
+	bool peekChar(char&);
+	bool skipWhiteSpace(char&);
+	bool readString();
+	bool readNumber(char first);
+	bool readLiteral(const char* rest);
+	TokenType setError();
+
+	QIODevice& m_device;
+	QByteArray m_buffer;
+	int m_bufferPos{0};
+	qint64 m_bufferOffset{0};	// position of the buffer in the device
+
+	TokenType m_type{Invalid};
+	QString m_string;
+	QByteArray m_bytes;
+	double m_number{0.};
+	bool m_bool{false};
+	bool m_error{false};
+};
+
+#endif
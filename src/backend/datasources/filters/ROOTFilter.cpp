@@ -35,8 +35,10 @@ Copyright            : (C) 2018 by Stefan Gerlach (stefan.gerlach@uni.kn)
 
 #include <QDebug>
 #include <QFileInfo>
+#include <QRunnable>
 #include <QSet>
 #include <QStack>
+#include <QThreadPool>
 
 #ifdef HAVE_ZIP
 #include <lz4.h>
@@ -45,6 +47,7 @@ Copyright            : (C) 2018 by Stefan Gerlach (stefan.gerlach@uni.kn)
 
 #include <cmath>
 #include <fstream>
+#include <functional>
 #include <limits>
 #include <map>
 #include <string>
@@ -309,24 +312,12 @@ void ROOTFilterPrivate::readDataFromFile(const QString& fileName, AbstractDataSo
 		                                                   headers, QVector<AbstractColumn::ColumnMode>(columns.size(),
 		                                                   AbstractColumn::Numeric));
 
-		int c = 0;
-		for (const auto& l : columns) {
-			unsigned int element = 0;
-			QString lastelement = l.back(), leaf = l.front();
-			bool isArray = false;
-			if (lastelement.at(0) == '[' && lastelement.at(lastelement.size() - 1) == ']') {
-				element = lastelement.mid(1, lastelement.length() - 2).toUInt(&isArray);
-				if (!isArray)
-					element = 0;
-				if (l.count() > 2)
-					leaf = l.at(1);
-			} else if (l.count() > 1)
-				leaf = l.at(1);
-
-			QVector<double>& container = *static_cast<QVector<double>*>(dataContainer[c++]);
-			auto data = readTree(pos, l.first(), leaf, (int)element, last);
+		const auto data = readTree(pos, last);
+		for (int c = 0; c < columns.size(); ++c) {
+			QVector<double>& container = *static_cast<QVector<double>*>(dataContainer[c]);
+			const int size = static_cast<int>(data[c].size());
 			for (int i = first; i <= last; ++i)
-				container[i - first] = data[i];
+				container[i - first] = (i < size) ? data[c][i] : NAN;
 		}
 
 		dataSource->finalizeImport(columnOffset, 0, columns.size() - 1, QString(), importMode);
@@ -459,23 +450,19 @@ QVector<QStringList> ROOTFilterPrivate::previewCurrentObject(const QString& file
 		QVector<QStringList> preview(qMax(last - first + 2, 1));
 		DEBUG("	reading " << preview.size() - 1 << " lines");
 
-		// read data leaf by leaf and set headers
+		// read data of all leaves and set headers
+		const auto data = readTree(pos, last);
+		int c = 0;
 		for (const auto& l : columns) {
-			unsigned int element = 0;
-			QString lastelement = l.back(), leaf = l.front();
+			QString lastelement = l.back();
 			bool isArray = false;
-			if (lastelement.at(0) == '[' && lastelement.at(lastelement.size() - 1) == ']') {
-				element = lastelement.mid(1, lastelement.length() - 2).toUInt(&isArray);
-				if (!isArray)
-					element = 0;
-				if (l.count() > 2)
-					leaf = l.at(1);
-			} else if (l.count() > 1)
-				leaf = l.at(1);
+			if (lastelement.at(0) == '[' && lastelement.at(lastelement.size() - 1) == ']')
+				lastelement.mid(1, lastelement.length() - 2).toUInt(&isArray);
 
-			auto data = readTree(pos, l.first(), leaf, (int)element, last);
+			const int size = static_cast<int>(data[c].size());
 			for (int i = first; i <= last; ++i)
-				preview[i - first] << QString::number(data[i]);
+				preview[i - first] << ((i < size) ? QString::number(data[c][i]) : QString());
+			++c;
 			if (!isArray || l.count() == 2)
 				preview.last() << l.join(isArray ? QString() : QString(':'));
 			else
@@ -530,8 +517,27 @@ std::vector<ROOTData::BinPars> ROOTFilterPrivate::readHistogram(quint64 pos) {
 	return currentROOTData->readHistogram(pos);
 }
 
-std::vector<double> ROOTFilterPrivate::readTree(quint64 pos, const QString& branchName, const QString& leafName, int element, int last) {
-	return currentROOTData->listEntries<double>(pos, branchName.toStdString(), leafName.toStdString(), element, last + 1);
+std::vector<std::vector<double>> ROOTFilterPrivate::readTree(quint64 pos, int last) {
+	std::vector<ROOTData::LeafRequest> leaves;
+	leaves.reserve(columns.size());
+	for (const auto& l : columns) {
+		unsigned int element = 0;
+		QString lastelement = l.back(), leaf = l.front();
+		bool isArray = false;
+		if (lastelement.at(0) == '[' && lastelement.at(lastelement.size() - 1) == ']') {
+			element = lastelement.mid(1, lastelement.length() - 2).toUInt(&isArray);
+			if (!isArray)
+				element = 0;
+			if (l.count() > 2)
+				leaf = l.at(1);
+		} else if (l.count() > 1)
+			leaf = l.at(1);
+
+		leaves.push_back(ROOTData::LeafRequest{l.first().toStdString(), leaf.toStdString(), element});
+	}
+
+	// all leaves are read at once, baskets shared by several leaves are decompressed only once
+	return currentROOTData->listEntries<double>(pos, leaves, last + 1);
 }
 
 
@@ -633,6 +639,17 @@ std::string readObject(char*& buf, char* const buf0, std::map<size_t, std::strin
 	return clname;
 }
 
+/// Task to run a function in a worker thread
+class Task : public QRunnable {
+public:
+	explicit Task(std::function<void()> func) : m_func(std::move(func)) {}
+	void run() override {
+		m_func();
+	}
+private:
+	std::function<void()> m_func;
+};
+
 }
 
 using namespace ROOTDataHelpers;
@@ -1067,7 +1084,13 @@ std::vector<ROOTData::LeafInfo> ROOTData::listLeaves(long int pos) const {
 
 template<class T>
 std::vector<T> ROOTData::listEntries(long int pos, const std::string& branchname, const std::string& leafname, const size_t element, const size_t nentries) const {
-	std::vector<T> entries;
+	auto entries = listEntries<T>(pos, std::vector<LeafRequest>{LeafRequest{branchname, leafname, element}}, nentries);
+	return std::move(entries.front());
+}
+
+template<class T>
+std::vector<std::vector<T>> ROOTData::listEntries(long int pos, const std::vector<LeafRequest>& leaves, const size_t nentries) const {
+	std::vector<std::vector<T>> entries(leaves.size());
 
 	auto it = treekeys.find(pos);
 	if (it == treekeys.end())
@@ -1088,9 +1111,20 @@ std::vector<T> ROOTData::listEntries(long int pos, const std::string& branchname
 		Version(buf); // TNtuple(D)
 	Version(buf); // TTree
 	advanceTo(buf, streamerTTree, std::string(), "fEntries", counts);
-	entries.reserve(std::min(static_cast<size_t>(read<long int>(buf)), nentries)); // reserve space (maximum for number of entries)
+	const size_t maxentries = std::min(static_cast<size_t>(read<long int>(buf)), nentries);
+	for (auto& e : entries)
+		e.reserve(maxentries); // reserve space (maximum for number of entries)
 	advanceTo(buf, streamerTTree, "fEntries", "fBranches", counts);
 
+	// position of a requested leaf inside an entry of the branch
+	struct LeafLayout {
+		int offset;
+		int size;
+		int content;
+		bool sign;
+		ContentType type;
+	};
+
 	// read the list of branches
 	Version(buf); // TObjArray
 	SkipObject(buf);
@@ -1112,6 +1146,12 @@ std::vector<T> ROOTData::listEntries(long int pos, const std::string& branchname
 			const std::string currentbranch = String(buf);
 			String(buf);
 
+			std::vector<size_t> requests;
+			for (size_t r = 0; r < leaves.size(); ++r) {
+				if (leaves[r].branch == currentbranch)
+					requests.push_back(r);
+			}
+
 			advanceTo(buf, streamerTBranch, "TNamed", "fWriteBasket", counts);
 			int fWriteBasket = read<int>(buf);
 			// TODO add reading of nested branches (fBranches)
@@ -1123,48 +1163,58 @@ std::vector<T> ROOTData::listEntries(long int pos, const std::string& branchname
 			String(buf);
 			const size_t nleaves = read<int>(buf);
 			const size_t lowb = read<int>(buf);
-			int leafoffset = 0, leafcount = 0, leafcontent = 0, leafsize = 0;
-			bool leafsign = false;
-            ContentType leaftype = Invalid;
+			int leafcount = 0;
+			std::vector<LeafLayout> layouts(leaves.size(), LeafLayout{0, 0, 0, false, Invalid});
 			for (size_t i = 0; i < nleaves; ++i) {
 				std::string clname = readObject(buf, buf0, tags);
 				Version(buf, count); // TLeaf(D/F/L/I/S/B/O/C/Element)
 				char* nbuf = buf + count;
-				if (currentbranch == branchname) {
+				if (!requests.empty()) {
 					if (i >= lowb && clname.size() >= 5 && clname.compare(0, 5, "TLeaf") == 0) {
 						Version(buf); // TLeaf
 						Version(buf); // TNamed
 						SkipObject(buf);
-						const bool istheleaf = (clname.size() == 6 && leafname == String(buf));
+						const std::string currentleaf = String(buf);
 						String(buf);
 						const int len = read<int>(buf);
 						const int size = read<int>(buf);
-						if (istheleaf) {
-							leafoffset = leafcount;
-							leafsize = size;
-							leaftype = leafType(clname.back());
-						}
+						const int leafoffset = leafcount;
 						leafcount += len * size;
-						if (istheleaf) {
-							leafcontent = leafcount - leafoffset;
+
+						std::vector<size_t> matches;
+						for (size_t r : requests) {
+							if (clname.size() == 6 && leaves[r].leaf == currentleaf)
+								matches.push_back(r);
+						}
+						if (!matches.empty()) {
 							buf += 1;
-							leafsign = !read<bool>(buf);
+							const bool leafsign = !read<bool>(buf);
+							for (size_t r : matches)
+								layouts[r] = LeafLayout{leafoffset, size, leafcount - leafoffset, leafsign, leafType(clname.back())};
 						}
 					}
 				}
 
 				buf = nbuf;
 			}
-			if (leafcontent == 0) {
+
+			// skip leaves which were not found or where the element is out of range
+			std::vector<size_t> valid;
+			for (size_t r : requests) {
+				const LeafLayout& layout = layouts[r];
+				if (layout.content == 0)
+					continue;
+				if (static_cast<int>(leaves[r].element) * layout.size >= layout.content) {
+					qDebug() << "ROOTData: " << leaves[r].leaf.c_str() << " only contains " << layout.content / layout.size << " elements.";
+					continue;
+				}
+				valid.push_back(r);
+			}
+			if (valid.empty()) {
 				buf = nbuf;
 				continue;
 			}
 
-			if (static_cast<int>(element) * leafsize >= leafcontent) {
-				qDebug() << "ROOTData: " << leafname.c_str() << " only contains " << leafcontent / leafsize << " elements.";
-				break;
-			}
-
 			advanceTo(buf, streamerTBranch, "fLeaves", "fBaskets", counts);
 			// fBaskets (probably empty)
 			Version(buf, count); // TObjArray
@@ -1179,23 +1229,44 @@ std::vector<T> ROOTData::listEntries(long int pos, const std::string& branchname
 			}
 			// rewind to the end of fBaskets and look for the fBasketSeek array
 			advanceTo(buf = basketsbuf, streamerTBranch, "fBaskets", "fBasketSeek", counts);
-			auto readf = readType<T>(leaftype, leafsign);
-			for (int i = 0; i < fWriteBasket; ++i) {
-				long int pos = read<long int>(buf);
-				auto it = basketkeys.find(pos);
-				if (it != basketkeys.end()) {
-					std::string basketbuffer = data(it->second);
-					if (!basketbuffer.empty()) {
-						char* bbuf = &basketbuffer[0];
-						char* const bufend = bbuf + basketbuffer.size();
-						while (bbuf + leafcount <= bufend && entries.size() < nentries) {
-							bbuf += leafoffset + leafsize * element;
-							entries.emplace_back(readf(bbuf));
-							bbuf += leafcount - leafsize * (element + 1) - leafoffset;
+			std::vector<long int> basketpos(std::max(fWriteBasket, 0));
+			for (auto& bpos : basketpos)
+				bpos = read<long int>(buf);
+
+			std::vector<T (*)(char*&)> readfs;
+			for (size_t r : valid)
+				readfs.push_back(readType<T>(layouts[r].type, layouts[r].sign));
+
+			// decompress the baskets in batches that fit into the cache and scatter the entries to all requested leaves
+			size_t nread = 0;
+			auto batchbegin = basketpos.cbegin();
+			while (batchbegin != basketpos.cend() && nread < nentries) {
+				auto batchend = batchbegin;
+				size_t batchsize = 0;
+				do {
+					auto key = basketkeys.find(*batchend);
+					if (key != basketkeys.end())
+						batchsize += key->second.count;
+					++batchend;
+				} while (batchend != basketpos.cend() && batchsize < basketCacheCapacity / 2);
+				cacheBaskets(std::vector<long int>(batchbegin, batchend));
+
+				for (; batchbegin != batchend; ++batchbegin) {
+					auto basket = basketData(*batchbegin);
+					if (!basket) {
+						qDebug() << "ROOTData: fBasketSeek(" << batchbegin - basketpos.cbegin() << "): " << *batchbegin << " (not available)";
+						continue;
+					}
+
+					char* bbuf = const_cast<char*>(basket->data());
+					char* const bufend = bbuf + basket->size();
+					for (; bbuf + leafcount <= bufend && nread < nentries; bbuf += leafcount, ++nread) {
+						for (size_t k = 0; k < valid.size(); ++k) {
+							const LeafLayout& layout = layouts[valid[k]];
+							char* lbuf = bbuf + layout.offset + layout.size * leaves[valid[k]].element;
+							entries[valid[k]].emplace_back(readfs[k](lbuf));
 						}
 					}
-				} else {
-					qDebug() << "ROOTData: fBasketSeek(" << i << "): " << pos << " (not available)";
 				}
 			}
 		}
@@ -1303,6 +1374,58 @@ std::string ROOTData::data(const ROOTData::KeyBuffer& buffer, std::ifstream& is)
 	return std::string();
 }
 
+std::shared_ptr<const std::string> ROOTData::basketData(long int pos) const {
+	{
+		std::lock_guard<std::mutex> lock(basketCacheMutex);
+		auto it = basketCacheIndex.find(pos);
+		if (it != basketCacheIndex.end()) {
+			basketCache.splice(basketCache.begin(), basketCache, it->second);
+			return it->second->second;
+		}
+	}
+
+	auto key = basketkeys.find(pos);
+	if (key == basketkeys.end())
+		return std::shared_ptr<const std::string>();
+
+	// decompress without holding the lock, other baskets can be decompressed in parallel
+	auto basket = std::make_shared<const std::string>(data(key->second));
+
+	std::lock_guard<std::mutex> lock(basketCacheMutex);
+	if (basketCacheIndex.find(pos) == basketCacheIndex.end()) {
+		basketCache.emplace_front(pos, basket);
+		basketCacheIndex[pos] = basketCache.begin();
+		basketCacheSize += basket->size();
+		while (basketCacheSize > basketCacheCapacity && basketCache.size() > 1) {
+			basketCacheSize -= basketCache.back().second->size();
+			basketCacheIndex.erase(basketCache.back().first);
+			basketCache.pop_back();
+		}
+	}
+
+	return basket;
+}
+
+void ROOTData::cacheBaskets(const std::vector<long int>& positions) const {
+	std::vector<long int> missing;
+	{
+		std::lock_guard<std::mutex> lock(basketCacheMutex);
+		for (long int pos : positions) {
+			if (basketCacheIndex.find(pos) == basketCacheIndex.end() && basketkeys.find(pos) != basketkeys.end())
+				missing.push_back(pos);
+		}
+	}
+
+	// a single basket is decompressed when accessed
+	if (missing.size() < 2)
+		return;
+
+	QThreadPool pool;
+	for (long int pos : missing)
+		pool.start(new Task([this, pos]() { basketData(pos); }));
+	pool.waitForDone();
+}
+
 void ROOTData::readStreamerInfo(const ROOTData::KeyBuffer& buffer) {
 	std::ifstream is(filename, std::ifstream::binary);
 	std::string datastring = data(buffer, is);
@@ -33,8 +33,10 @@ Copyright            : (C) 2018 Christoph Roick (chrisito@gmx.de)
 #include <QDateTime>
 #include <QVector>
 
+#include <list>
 #include <map>
 #include <memory>
+#include <mutex>
 #include <string>
 #include <vector>
 
@@ -89,6 +91,13 @@ public:
 		size_t elements;
 	};
 
+	/// Leaf and element (if the leaf is an array) to be read from a tree
+	struct LeafRequest {
+		std::string branch;
+		std::string leaf;
+		size_t element;
+	};
+
 	/// Directory structure in a ROOT file where seek positions to the objects inside the file are stored
 	struct Directory {
 		Directory() : parent(0) {}
@@ -142,6 +151,22 @@ public:
 	{
 		return listEntries<T>(pos, branchname, branchname, element, nentries);
 	}
+	/**
+	 * @brief Get entries of several leaves at once
+	 *
+	 * Every basket is read and decompressed only once, the entries of all requested
+	 * leaves of the corresponding branch are extracted from it. The baskets of a branch
+	 * are decompressed in parallel.
+	 *
+	 * @param[in] pos Position of the tree inside the file
+	 * @param[in] leaves Leaves to be read
+	 * @param[in] nentries Maximum number of entries to be read
+	 *
+	 * @return The entries for each of the requested leaves, in the same order as @p leaves
+	 */
+	template<typename T>
+	std::vector<std::vector<T>> listEntries(long int pos, const std::vector<LeafRequest>& leaves,
+	                                        const size_t nentries = std::numeric_limits<size_t>::max()) const;
 
 	/**
 	 * @brief Read histogram from file
@@ -227,6 +252,19 @@ private:
 	std::string data(const KeyBuffer& buffer) const;
 	/// Get buffer from file content at histogram position, uses already opened stream
 	std::string data(const KeyBuffer& buffer, std::ifstream& is) const;
+	/**
+	 * @brief Get the decompressed content of a basket
+	 *
+	 * The baskets are kept in a cache with least recently used eviction,
+	 * repeated reads of the same basket don't access the file again.
+	 *
+	 * @param[in] pos Position of the basket inside the file
+	 *
+	 * @return The content of the basket or a null pointer if there is no basket at @p pos
+	 */
+	std::shared_ptr<const std::string> basketData(long int pos) const;
+	/// Decompress the baskets at the given positions in parallel and put them into the cache
+	void cacheBaskets(const std::vector<long int>& positions) const;
 	/// Load streamer information
 	void readStreamerInfo(const KeyBuffer& buffer);
 	/**
@@ -248,6 +286,14 @@ private:
 	std::map<long int, KeyBuffer> basketkeys;
 
 	std::map<std::string, std::vector<StreamerInfo> > streamerInfo;
+
+	/// Maximal size of the decompressed baskets kept in memory
+	static const size_t basketCacheCapacity = 256 * 1024 * 1024;
+	/// Cached baskets, most recently used first
+	mutable std::list<std::pair<long int, std::shared_ptr<const std::string> > > basketCache;
+	mutable std::map<long int, std::list<std::pair<long int, std::shared_ptr<const std::string> > >::iterator> basketCacheIndex;
+	mutable size_t basketCacheSize = 0;
+	mutable std::mutex basketCacheMutex;
 };
 
 class ROOTFilterPrivate {
@@ -310,8 +356,8 @@ private:
 	bool setFile(const QString& fileName);
 	/// Calls ReadHistogram from ROOTData
 	std::vector<ROOTData::BinPars> readHistogram(quint64 pos);
-	/// Calls listEntries from ROOTData
-	std::vector<double> readTree(quint64 pos, const QString& branchName, const QString& leafName, int element, int last);
+	/// Calls listEntries from ROOTData for all selected columns
+	std::vector<std::vector<double>> readTree(quint64 pos, int last);
 
 	/// Information about currently set ROOT file
     struct {
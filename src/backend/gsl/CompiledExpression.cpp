@@ -0,0 +1,623 @@
+/***************************************************************************
+    File                 : CompiledExpression.cpp
+    Project              : LabPlot
+    Description          : Compiled expression with derivatives w.r.t. its parameters
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "backend/gsl/CompiledExpression.h"
+#include "backend/lib/macros.h"
+
+#include <QVarLengthArray>
+
+#include <cctype>
+#include <cmath>
+#include <cstring>
+
+extern "C" {
+#include <gsl/gsl_math.h>
+#include "backend/gsl/parser.h"
+}
+
+/*!
+  \class CompiledExpression
+  \brief Expression compiled once and evaluated together with its derivatives w.r.t. the parameters.
+
+  The expression is parsed with the same syntax and the same constants and functions as the bison generated
+  parser (see parser.y) into a sequence of instructions in reverse polish notation. The instructions are
+  evaluated without any symbol lookup, the derivatives w.r.t. all parameters are calculated in the same pass
+  via forward mode automatic differentiation. For the most common functions the exact derivative is used,
+  for all other functions the derivative w.r.t. their arguments is calculated numerically, the chain rule
+  is applied exactly.
+
+  Used by the fit of custom models instead of calling the parser for every data point and every parameter.
+  Expressions containing unknown symbols, assignments or several lines are not compiled,
+  the caller has to fall back to the parser in this case.
+
+  \ingroup backend
+*/
+
+/*!
+ * compiles the expression \c expression with the parameters \c parameters and the variable \c variable.
+ * Returns \c false if the expression cannot be compiled.
+ */
+bool CompiledExpression::compile(const QString& expression, const QStringList& parameters, const QString& variable) {
+	m_code.clear();
+	m_stackSize = 0;
+	m_depth = 0;
+	m_parameters = parameters;
+	m_parameterCount = parameters.size();
+	m_variable = variable.toLatin1();
+	m_string = expression.toLatin1();
+	m_pos = 0;
+
+	m_valid = parseSum() && peek() == '\0';
+	if (!m_valid) {
+		DEBUG("CompiledExpression::compile(): cannot compile \"" << expression.toStdString() << "\" at position " << m_pos);
+		m_code.clear();
+	}
+
+	m_string.clear();
+	return m_valid;
+}
+
+bool CompiledExpression::isValid() const {
+	return m_valid;
+}
+
+int CompiledExpression::parameterCount() const {
+	return m_parameterCount;
+}
+
+/*!
+ * returns the next character after white spaces, '\0' at the end of the expression.
+ */
+char CompiledExpression::peek() {
+	while (m_pos < m_string.size() && (m_string.at(m_pos) == ' ' || m_string.at(m_pos) == '\t'))
+		++m_pos;
+	return (m_pos < m_string.size()) ? m_string.at(m_pos) : '\0';
+}
+
+void CompiledExpression::append(OpCode op, int index, double value) {
+	Instruction instruction;
+	instruction.op = op;
+	instruction.index = index;
+	instruction.value = value;
+	m_code << instruction;
+
+	switch (op) {
+	case OpCode::Constant:
+	case OpCode::Variable:
+	case OpCode::Parameter:
+		++m_depth;
+		break;
+	case OpCode::Add:
+	case OpCode::Subtract:
+	case OpCode::Multiply:
+	case OpCode::Divide:
+	case OpCode::Power:
+		--m_depth;
+		break;
+	case OpCode::Negate:
+		break;
+	case OpCode::Call:
+		m_depth += 1 - index;
+		break;
+	}
+	m_stackSize = qMax(m_stackSize, m_depth);
+}
+
+// sum: term (('+' | '-') term)*
+bool CompiledExpression::parseSum() {
+	if (!parseTerm())
+		return false;
+
+	char c;
+	while ((c = peek()) == '+' || c == '-') {
+		++m_pos;
+		if (!parseTerm())
+			return false;
+		append(c == '+' ? OpCode::Add : OpCode::Subtract);
+	}
+	return true;
+}
+
+// term: unary (('*' | '/' | '**') unary)*, "**" has the precedence of '*' like in parser.y
+bool CompiledExpression::parseTerm() {
+	if (!parseUnary())
+		return false;
+
+	char c;
+	while ((c = peek()) == '*' || c == '/') {
+		++m_pos;
+		OpCode op = (c == '*') ? OpCode::Multiply : OpCode::Divide;
+		if (c == '*' && peek() == '*') {
+			++m_pos;
+			op = OpCode::Power;
+		}
+		if (!parseUnary())
+			return false;
+		append(op);
+	}
+	return true;
+}
+
+// unary: '-' unary | power
+bool CompiledExpression::parseUnary() {
+	if (peek() == '-') {
+		++m_pos;
+		if (!parseUnary())
+			return false;
+		append(OpCode::Negate);
+		return true;
+	}
+	return parsePower();
+}
+
+// power: primary ('^' unary)?, right associative
+bool CompiledExpression::parsePower() {
+	if (!parsePrimary())
+		return false;
+
+	if (peek() == '^') {
+		++m_pos;
+		if (!parseUnary())
+			return false;
+		append(OpCode::Power);
+	}
+	return true;
+}
+
+/*!
+ * reads an identifier (starting with a letter or '.', followed by letters, digits, '_' or '.'), like yylex().
+ */
+QByteArray CompiledExpression::identifier() {
+	const int start = m_pos;
+	while (m_pos < m_string.size()) {
+		const char c = m_string.at(m_pos);
+		if (!(isalnum(c) || c == '_' || c == '.'))
+			break;
+		++m_pos;
+	}
+	return m_string.mid(start, m_pos - start);
+}
+
+// primary: number | variable | parameter | constant | function '(' args ')' | '(' sum ')'
+bool CompiledExpression::parsePrimary() {
+	const char c = peek();
+
+	if (c == '(') {
+		++m_pos;
+		if (!parseSum() || peek() != ')')
+			return false;
+		++m_pos;
+		return true;
+	}
+
+	if (isdigit(c)) {
+		const int start = m_pos;
+		while (m_pos < m_string.size() && (isdigit(m_string.at(m_pos)) || m_string.at(m_pos) == '.'))
+			++m_pos;
+		if (m_pos < m_string.size() && (m_string.at(m_pos) == 'e' || m_string.at(m_pos) == 'E')) {
+			int pos = m_pos + 1;
+			if (pos < m_string.size() && (m_string.at(pos) == '+' || m_string.at(pos) == '-'))
+				++pos;
+			if (pos < m_string.size() && isdigit(m_string.at(pos))) {
+				while (pos < m_string.size() && isdigit(m_string.at(pos)))
+					++pos;
+				m_pos = pos;
+			}
+		}
+
+		bool ok;
+		const double value = m_string.mid(start, m_pos - start).toDouble(&ok);	// always uses '.' as decimal point
+		if (!ok)
+			return false;
+		append(OpCode::Constant, 0, value);
+		return true;
+	}
+
+	if (!(isalpha(c) || c == '.'))
+		return false;
+
+	const QByteArray name = identifier();
+
+	//the symbols defined last in the symbol table of the parser are found first:
+	//variables and parameters, then constants, then functions
+	if (peek() != '(') {
+		if (peek() == '=')	// assignments are not supported
+			return false;
+
+		if (name == m_variable) {
+			append(OpCode::Variable);
+			return true;
+		}
+
+		const int index = m_parameters.indexOf(QLatin1String(name));
+		if (index != -1) {
+			append(OpCode::Parameter, index);
+			return true;
+		}
+
+		int found = -1;
+		for (int i = 0; _constants[i].name != nullptr; ++i) {
+			if (name == _constants[i].name)
+				found = i;
+		}
+		if (found == -1)
+			return false;
+
+		append(OpCode::Constant, 0, _constants[found].value);
+		return true;
+	}
+
+	//function call
+	if (name == m_variable || m_parameters.contains(QLatin1String(name)))
+		return false;
+	for (int i = 0; _constants[i].name != nullptr; ++i) {
+		if (name == _constants[i].name)
+			return false;
+	}
+
+	Function function = nullptr;
+	for (int i = 0; _functions[i].name != nullptr; ++i) {
+		if (name == _functions[i].name)
+			function = (Function)_functions[i].fnct;
+	}
+	if (!function)
+		return false;
+
+	++m_pos;	// '('
+	int count = 0;
+	if (peek() != ')') {
+		while (true) {
+			if (!parseSum())
+				return false;
+			++count;
+			if (peek() != ',')
+				break;
+			++m_pos;
+		}
+	}
+	if (peek() != ')' || count > 4)
+		return false;
+	++m_pos;
+
+	append(OpCode::Call, count);
+	Instruction& instruction = m_code.last();
+	instruction.function = function;
+
+	static const struct {
+		const char* name;
+		int count;
+		Derivative derivative;
+	} derivatives[] = {
+		{"exp", 1, Derivative::Exp}, {"log", 1, Derivative::Log}, {"log10", 1, Derivative::Log10},
+		{"log1p", 1, Derivative::Log1p}, {"expm1", 1, Derivative::Expm1}, {"sqrt", 1, Derivative::Sqrt},
+		{"cbrt", 1, Derivative::Cbrt}, {"sin", 1, Derivative::Sin}, {"cos", 1, Derivative::Cos},
+		{"tan", 1, Derivative::Tan}, {"asin", 1, Derivative::Asin}, {"acos", 1, Derivative::Acos},
+		{"atan", 1, Derivative::Atan}, {"sinh", 1, Derivative::Sinh}, {"cosh", 1, Derivative::Cosh},
+		{"tanh", 1, Derivative::Tanh}, {"fabs", 1, Derivative::Fabs}, {"erf", 1, Derivative::Erf},
+		{"erfc", 1, Derivative::Erfc}, {"pow2", 1, Derivative::Pow2}, {"pow3", 1, Derivative::Pow3},
+		{"sec", 1, Derivative::Sec}, {"csc", 1, Derivative::Csc}, {"cot", 1, Derivative::Cot},
+		{"pow", 2, Derivative::Pow}, {"atan2", 2, Derivative::Atan2}, {"hypot", 2, Derivative::Hypot},
+	};
+	for (const auto& d : derivatives) {
+		if (name == d.name && count == d.count) {
+			instruction.derivative = d.derivative;
+			break;
+		}
+	}
+
+	return true;
+}
+
+double CompiledExpression::call(Function function, int count, const double* args) {
+	switch (count) {
+	case 0:
+		return function();
+	case 1:
+		return ((func_t1)function)(args[0]);
+	case 2:
+		return ((func_t2)function)(args[0], args[1]);
+	case 3:
+		return ((func_t3)function)(args[0], args[1], args[2]);
+	default:
+		return ((func_t4)function)(args[0], args[1], args[2], args[3]);
+	}
+}
+
+/*!
+ * returns the partial derivative of the function of \c instruction w.r.t. its argument \c arg
+ * at \c args, \c value is the value of the function at \c args.
+ */
+double CompiledExpression::partial(const Instruction& instruction, const double* args, int arg, double value) {
+	const double a = args[0];
+	switch (instruction.derivative) {
+	case Derivative::Exp:
+		return value;
+	case Derivative::Log:
+		return 1./a;
+	case Derivative::Log10:
+		return 1./(a * M_LN10);
+	case Derivative::Log1p:
+		return 1./(1. + a);
+	case Derivative::Expm1:
+		return value + 1.;
+	case Derivative::Sqrt:
+		return 0.5/value;
+	case Derivative::Cbrt:
+		return 1./(3. * value * value);
+	case Derivative::Sin:
+		return cos(a);
+	case Derivative::Cos:
+		return -sin(a);
+	case Derivative::Tan:
+		return 1. + value * value;
+	case Derivative::Asin:
+		return 1./sqrt(1. - a * a);
+	case Derivative::Acos:
+		return -1./sqrt(1. - a * a);
+	case Derivative::Atan:
+		return 1./(1. + a * a);
+	case Derivative::Sinh:
+		return cosh(a);
+	case Derivative::Cosh:
+		return sinh(a);
+	case Derivative::Tanh:
+		return 1. - value * value;
+	case Derivative::Fabs:
+		return (a > 0) ? 1. : ((a < 0) ? -1. : 0.);
+	case Derivative::Erf:
+		return M_2_SQRTPI * exp(-a * a);
+	case Derivative::Erfc:
+		return -M_2_SQRTPI * exp(-a * a);
+	case Derivative::Pow2:
+		return 2. * a;
+	case Derivative::Pow3:
+		return 3. * a * a;
+	case Derivative::Sec:
+		return value * tan(a);
+	case Derivative::Csc:
+		return -value/tan(a);
+	case Derivative::Cot:
+		return -(1. + value * value);
+	case Derivative::Pow:
+		return (arg == 0) ? args[1] * pow(a, args[1] - 1.) : value * log(a);
+	case Derivative::Atan2:	// atan2(y, x)
+		return ((arg == 0) ? args[1] : -a)/(a * a + args[1] * args[1]);
+	case Derivative::Hypot:
+		return args[arg]/value;
+	case Derivative::Numeric:
+		break;
+	}
+
+	//central difference w.r.t. the argument arg
+	double shifted[4];
+	std::memcpy(shifted, args, instruction.index * sizeof(double));
+	const double h = 6.e-6 * qMax(fabs(args[arg]), 1.);	// ~ cbrt(DBL_EPSILON)
+	shifted[arg] = args[arg] + h;
+	const double plus = call(instruction.function, instruction.index, shifted);
+	shifted[arg] = args[arg] - h;
+	const double minus = call(instruction.function, instruction.index, shifted);
+	return (plus - minus)/(2. * h);
+}
+
+/*!
+ * evaluates the expression at \c x with the parameter values \c parameters.
+ */
+double CompiledExpression::value(double x, const double* parameters) const {
+	if (!m_valid)
+		return NAN;
+
+	QVarLengthArray<double, 32> stack(m_stackSize);
+	int top = -1;
+	for (const auto& instruction : m_code) {
+		switch (instruction.op) {
+		case OpCode::Constant:
+			stack[++top] = instruction.value;
+			break;
+		case OpCode::Variable:
+			stack[++top] = x;
+			break;
+		case OpCode::Parameter:
+			stack[++top] = parameters[instruction.index];
+			break;
+		case OpCode::Add:
+			--top;
+			stack[top] += stack[top + 1];
+			break;
+		case OpCode::Subtract:
+			--top;
+			stack[top] -= stack[top + 1];
+			break;
+		case OpCode::Multiply:
+			--top;
+			stack[top] *= stack[top + 1];
+			break;
+		case OpCode::Divide:
+			--top;
+			stack[top] /= stack[top + 1];
+			break;
+		case OpCode::Negate:
+			stack[top] = -stack[top];
+			break;
+		case OpCode::Power:
+			--top;
+			stack[top] = pow(stack[top], stack[top + 1]);
+			break;
+		case OpCode::Call:
+			top -= instruction.index - 1;
+			stack[top] = call(instruction.function, instruction.index, stack.data() + top);
+			break;
+		}
+	}
+
+	return stack[0];
+}
+
+/*!
+ * evaluates the expression at \c x with the parameter values \c parameters and writes
+ * the derivatives w.r.t. the parameters to \c gradient (parameterCount() values).
+ */
+double CompiledExpression::value(double x, const double* parameters, double* gradient) const {
+	const int np = m_parameterCount;
+	if (!m_valid) {
+		for (int j = 0; j < np; ++j)
+			gradient[j] = NAN;
+		return NAN;
+	}
+
+	//the values and the derivatives of the stack entries, derivatives are only stored for the entries depending on the parameters
+	QVarLengthArray<double, 32> stack(m_stackSize);
+	QVarLengthArray<bool, 32> dependent(m_stackSize);
+	QVarLengthArray<double, 256> derivatives(m_stackSize * np);
+	int top = -1;
+	for (const auto& instruction : m_code) {
+		switch (instruction.op) {
+		case OpCode::Constant:
+			stack[++top] = instruction.value;
+			dependent[top] = false;
+			break;
+		case OpCode::Variable:
+			stack[++top] = x;
+			dependent[top] = false;
+			break;
+		case OpCode::Parameter: {
+			stack[++top] = parameters[instruction.index];
+			dependent[top] = true;
+			double* d = derivatives.data() + top * np;
+			for (int j = 0; j < np; ++j)
+				d[j] = 0.;
+			d[instruction.index] = 1.;
+			break;
+		}
+		case OpCode::Add:
+		case OpCode::Subtract:
+		case OpCode::Multiply:
+		case OpCode::Divide:
+		case OpCode::Power: {
+			--top;
+			const double a = stack[top];
+			const double b = stack[top + 1];
+			const bool da = dependent[top];
+			const bool db = dependent[top + 1];
+			double* ga = derivatives.data() + top * np;
+			const double* gb = derivatives.data() + (top + 1) * np;
+
+			double v, fa = 0., fb = 0.;	// value and the partial derivatives w.r.t. a and b
+			switch (instruction.op) {
+			case OpCode::Add:
+				v = a + b;
+				fa = 1.;
+				fb = 1.;
+				break;
+			case OpCode::Subtract:
+				v = a - b;
+				fa = 1.;
+				fb = -1.;
+				break;
+			case OpCode::Multiply:
+				v = a * b;
+				fa = b;
+				fb = a;
+				break;
+			case OpCode::Divide:
+				v = a / b;
+				fa = 1./b;
+				fb = -v/b;
+				break;
+			default:
+				v = pow(a, b);
+				if (da)
+					fa = b * pow(a, b - 1.);
+				if (db)
+					fb = v * log(a);
+			}
+
+			stack[top] = v;
+			if (da && db) {
+				for (int j = 0; j < np; ++j)
+					ga[j] = fa * ga[j] + fb * gb[j];
+			} else if (da) {
+				for (int j = 0; j < np; ++j)
+					ga[j] *= fa;
+			} else if (db) {
+				for (int j = 0; j < np; ++j)
+					ga[j] = fb * gb[j];
+			}
+			dependent[top] = da || db;
+			break;
+		}
+		case OpCode::Negate:
+			stack[top] = -stack[top];
+			if (dependent[top]) {
+				double* d = derivatives.data() + top * np;
+				for (int j = 0; j < np; ++j)
+					d[j] = -d[j];
+			}
+			break;
+		case OpCode::Call: {
+			const int count = instruction.index;
+			top -= count - 1;
+			const double* args = stack.data() + top;
+			const double v = call(instruction.function, count, args);
+
+			//chain rule, the result is accumulated in the derivatives of the first argument
+			double* d = derivatives.data() + top * np;
+			double partials[4];
+			bool dep = false;
+			for (int k = 0; k < count; ++k) {
+				partials[k] = dependent[top + k] ? partial(instruction, args, k, v) : 0.;
+				dep = dep || dependent[top + k];
+			}
+			if (dep) {
+				for (int j = 0; j < np; ++j) {
+					double sum = 0.;
+					for (int k = 0; k < count; ++k) {
+						if (dependent[top + k])
+							sum += partials[k] * derivatives[(top + k) * np + j];
+					}
+					d[j] = sum;
+				}
+			}
+
+			stack[top] = v;
+			dependent[top] = dep;
+			break;
+		}
+		}
+	}
+
+	if (dependent[0]) {
+		for (int j = 0; j < np; ++j)
+			gradient[j] = derivatives[j];
+	} else {
+		for (int j = 0; j < np; ++j)
+			gradient[j] = 0.;
+	}
+
+	return stack[0];
+}
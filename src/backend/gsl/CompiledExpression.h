@@ -0,0 +1,88 @@
+/***************************************************************************
+    File                 : CompiledExpression.h
+    Project              : LabPlot
+    Description          : Compiled expression with derivatives w.r.t. its parameters
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef COMPILEDEXPRESSION_H
+#define COMPILEDEXPRESSION_H
+
+#include <QByteArray>
+#include <QStringList>
+#include <QVector>
+
+class CompiledExpression {
+public:
+	bool compile(const QString& expression, const QStringList& parameters, const QString& variable = QLatin1String("x"));
+	bool isValid() const;
+	int parameterCount() const;
+
+	double value(double x, const double* parameters) const;
+	double value(double x, const double* parameters, double* gradient) const;
+
+private:
+	typedef double (*Function)();
+
+	enum class OpCode {Constant, Variable, Parameter, Add, Subtract, Multiply, Divide, Negate, Power, Call};
+
+	//functions with known derivatives, the derivatives of all other functions are calculated numerically
+	enum class Derivative {Numeric, Exp, Log, Log10, Log1p, Expm1, Sqrt, Cbrt, Sin, Cos, Tan, Asin, Acos, Atan,
+		Sinh, Cosh, Tanh, Fabs, Erf, Erfc, Pow2, Pow3, Sec, Csc, Cot, Pow, Atan2, Hypot};
+
+	struct Instruction {
+		OpCode op;
+		int index{0};		// parameter index or number of arguments of a function
+		double value{0.};	// value of a constant
+		Function function{nullptr};
+		Derivative derivative{Derivative::Numeric};
+	};
+
+	//recursive descent parser following the grammar in parser.y
+	bool parseSum();
+	bool parseTerm();
+	bool parseUnary();
+	bool parsePower();
+	bool parsePrimary();
+	char peek();
+	QByteArray identifier();
+	void append(OpCode, int index = 0, double value = 0.);
+
+	static double call(Function, int count, const double* args);
+	static double partial(const Instruction&, const double* args, int arg, double value);
+
+	QVector<Instruction> m_code;	// instructions in reverse polish notation
+	int m_stackSize{0};
+	int m_parameterCount{0};
+	bool m_valid{false};
+
+	//state during the compilation
+	QByteArray m_string;
+	int m_pos{0};
+	int m_depth{0};
+	QStringList m_parameters;
+	QByteArray m_variable;
+};
+
+#endif
@@ -0,0 +1,95 @@
+/***************************************************************************
+    File                 : SPSCRingBuffer.h
+    Project              : LabPlot
+    Description          : Lock-free single producer/single consumer ring buffer
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef SPSCRINGBUFFER_H
+#define SPSCRINGBUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <utility>
+#include <vector>
+
+/*!
+ * Fixed size ring buffer for passing elements from exactly one producer thread to exactly one consumer thread
+ * without locking. push() may only be called from the producer thread, pop() only from the consumer thread.
+ * The elements are moved in and out of the buffer, a popped slot is reset to release the memory held by the element.
+ */
+template <typename T>
+class SPSCRingBuffer {
+public:
+	explicit SPSCRingBuffer(size_t capacity) : m_buffer(capacity + 1) {}
+	SPSCRingBuffer(const SPSCRingBuffer&) = delete;
+	SPSCRingBuffer& operator=(const SPSCRingBuffer&) = delete;
+
+	//! returns \c false without modifying \c value if the buffer is full
+	bool push(T&& value) {
+		const size_t head = m_head.load(std::memory_order_relaxed);
+		const size_t next = increment(head);
+		if (next == m_tail.load(std::memory_order_acquire))
+			return false;
+
+		m_buffer[head] = std::move(value);
+		m_head.store(next, std::memory_order_release);
+		return true;
+	}
+
+	//! returns \c false if the buffer is empty
+	bool pop(T& value) {
+		const size_t tail = m_tail.load(std::memory_order_relaxed);
+		if (tail == m_head.load(std::memory_order_acquire))
+			return false;
+
+		value = std::move(m_buffer[tail]);
+		m_buffer[tail] = T();
+		m_tail.store(increment(tail), std::memory_order_release);
+		return true;
+	}
+
+	bool isEmpty() const {
+		return m_tail.load(std::memory_order_acquire) == m_head.load(std::memory_order_acquire);
+	}
+
+	bool isFull() const {
+		return increment(m_head.load(std::memory_order_acquire)) == m_tail.load(std::memory_order_acquire);
+	}
+
+	size_t capacity() const {
+		return m_buffer.size() - 1;
+	}
+
+private:
+	size_t increment(size_t index) const {
+		return (index + 1 == m_buffer.size()) ? 0 : index + 1;
+	}
+
+	std::vector<T> m_buffer;
+	//head and tail are written by different threads, keep them in different cache lines
+	alignas(64) std::atomic<size_t> m_head{0};	//next slot to write, owned by the producer
+	alignas(64) std::atomic<size_t> m_tail{0};	//next slot to read, owned by the consumer
+};
+
+#endif
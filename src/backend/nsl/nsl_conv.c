@@ -31,13 +31,13 @@
 #include <gsl/gsl_cblas.h>
 #include <gsl/gsl_fft_halfcomplex.h>
 #ifdef HAVE_FFTW3
-#include <fftw3.h>
+#include "nsl_fftw.h"
 #endif
 #include "backend/nsl/nsl_stats.h"
 
 const char* nsl_conv_direction_name[] = {i18n("forward (convolution)"), i18n("backward (deconvolution)")};
 const char* nsl_conv_type_name[] = {i18n("linear (zero-padded)"), i18n("circular")};
-const char* nsl_conv_method_name[] = {i18n("auto"), i18n("direct"), i18n("FFT")};
+const char* nsl_conv_method_name[] = {i18n("auto"), i18n("direct"), i18n("FFT"), i18n("overlap-add (FFT)")};
 const char* nsl_conv_norm_name[] = {i18n("none"), i18n("sum"), i18n("Euclidean")};
 const char* nsl_conv_wrap_name[] = {i18n("none"), i18n("maximum"), i18n("center (acausal)")};
 const char* nsl_conv_kernel_name[] = {i18n("sliding average"), i18n("triangular smooth"), i18n("pseudo-Gaussian smooth"), i18n("first derivative"), i18n("smooth first derivative"),
@@ -144,13 +144,71 @@ int nsl_conv_convolution_direction(double s[], size_t n, double r[], size_t m, n
 		return nsl_conv_deconvolution(s, n, r, m, type, normalize, wrap, out);
 }
 
+/* estimated cost of a real FFT of size n in units of multiply-adds of the direct method */
+static double nsl_conv_fft_cost(size_t n) {
+	return NSL_CONV_FFT_COST * (double)n * log2((double)n);
+}
+
+/* FFT size of the overlap-add method for signal size n and response size m <= n */
+static size_t nsl_conv_overlap_add_size(size_t n, size_t m, double *cost) {
+	size_t size, best = 0;
+	double mincost = DBL_MAX;
+	/* power of two at least twice the response and not larger than needed for the whole signal */
+	for (size = 64; size <= NSL_CONV_OVERLAP_ADD_MAXSIZE; size *= 2) {
+		if (size < 2*m)
+			continue;
+		const size_t block = size - m + 1, nblocks = (n + block - 1)/block;
+		/* transform of the response and forward and backward transform of every block */
+		const double c = (2. * nblocks + 1.) * nsl_conv_fft_cost(size);
+		if (c < mincost) {
+			mincost = c;
+			best = size;
+		}
+		if (block >= n)
+			break;
+	}
+
+	if (cost)
+		*cost = mincost;
+	return best;
+}
+
+nsl_conv_method_type nsl_conv_auto_method(size_t n, size_t m, nsl_conv_type_type type) {
+	if (GSL_MAX(n, m) <= NSL_CONV_METHOD_BORDER)
+		return nsl_conv_method_direct;
+
+	const double direct = (double)n * (double)m;
+	/* transform of signal and response and back transform */
+	const double fft = 3. * nsl_conv_fft_cost(type == nsl_conv_type_linear ? n + m - 1 : GSL_MAX(n, m));
+	double overlap_add = DBL_MAX;
+	if (type == nsl_conv_type_linear && nsl_conv_overlap_add_size(GSL_MAX(n, m), GSL_MIN(n, m), &overlap_add) == 0)
+		overlap_add = DBL_MAX;
+
+	if (direct <= fft && direct <= overlap_add)
+		return nsl_conv_method_direct;
+	if (overlap_add < fft)
+		return nsl_conv_method_overlap_add;
+	return nsl_conv_method_fft;
+}
+
 int nsl_conv_convolution(double s[], size_t n, double r[], size_t m, nsl_conv_type_type type, nsl_conv_method_type method, nsl_conv_norm_type normalize, nsl_conv_wrap_type wrap, double out[]) {
-	if (method == nsl_conv_method_direct || (method == nsl_conv_method_auto && GSL_MAX_INT(n, m) <= NSL_CONV_METHOD_BORDER)) {
+	if (method == nsl_conv_method_auto)
+		method = nsl_conv_auto_method(n, m, type);
+
+	switch (method) {
+	case nsl_conv_method_auto:
+	case nsl_conv_method_direct:
 		if (type == nsl_conv_type_linear)
 			return nsl_conv_linear_direct(s, n, r, m, normalize, wrap, out);
 		else if (type == nsl_conv_type_circular)
 			return nsl_conv_circular_direct(s, n, r, m, normalize, wrap, out);
-	} else {
+		break;
+	case nsl_conv_method_overlap_add:
+		if (type == nsl_conv_type_linear)
+			return nsl_conv_linear_overlap_add(s, n, r, m, normalize, wrap, out);
+		/* circular: use FFT method */
+		/* fall through */
+	case nsl_conv_method_fft:
 		return nsl_conv_fft_type(s, n, r, m, nsl_conv_direction_forward, type, normalize, wrap, out);
 	}
 
@@ -162,9 +220,9 @@ int nsl_conv_deconvolution(double s[], size_t n, double r[], size_t m, nsl_conv_
 	return nsl_conv_fft_type(s, n, r, m, nsl_conv_direction_backward, type, normalize, wrap, out);
 }
 
-int nsl_conv_linear_direct(double s[], size_t n, double r[], size_t m, nsl_conv_norm_type normalize, nsl_conv_wrap_type wrap, double out[]) {
-	size_t i, j, size = n + m - 1, wi = 0;
-	double norm = 1;
+/* norm of the response */
+static double nsl_conv_norm(double r[], size_t m, nsl_conv_norm_type normalize) {
+	double norm = 1.;
 	if (normalize == nsl_conv_norm_euclidean) {
 		if ((norm = cblas_dnrm2((int)m, r, 1)) == 0)
 			norm = 1.;
@@ -173,83 +231,225 @@ int nsl_conv_linear_direct(double s[], size_t n, double r[], size_t m, nsl_conv_
 			norm = 1.;
 	}
 
+	return norm;
+}
+
+/* wrap index of the response */
+static size_t nsl_conv_wrap_index(double r[], size_t m, nsl_conv_wrap_type wrap) {
+	size_t wi = 0;
 	if (wrap == nsl_conv_wrap_max)
 		nsl_stats_maximum(r, m, &wi);
 	else if (wrap == nsl_conv_wrap_center)
 		wi = m/2;
 
-	for (j = 0; j < size; j++) {
-		int index;	// can be negative
-		double res = 0;
-		for (i = 0; i < n; i++) {
-			index = (int)(j - i);
-			if (index >= 0 && index < (int)m)
-				res += s[i] * r[index]/norm;
-		}
-		index = (int)(j - wi);
-		if (index < 0)
-			index += (int)size;
-		out[index] = res;
+	return wi;
+}
+
+static void nsl_conv_reverse(double x[], size_t n) {
+	size_t i;
+	for (i = 0; i < n/2; i++) {
+		double tmp = x[i];
+		x[i] = x[n - i - 1];
+		x[n - i - 1] = tmp;
+	}
+}
+
+/* divides the result of size n by norm and wraps it (out[j - wi] = out[j]) in-place */
+static void nsl_conv_wrap_normalize(double out[], size_t n, size_t wi, double norm) {
+	size_t i;
+	if (norm != 1.)
+		for (i = 0; i < n; i++)
+			out[i] /= norm;
+
+	wi %= n;
+	if (wi > 0) {	/* rotate left by wi */
+		nsl_conv_reverse(out, wi);
+		nsl_conv_reverse(out + wi, n - wi);
+		nsl_conv_reverse(out, n);
+	}
+}
+
+/* The products are accumulated row by row into out (out[i+j] += s[i] r[j]).
+ * The inner loop has no reduction and is vectorized by the compiler, the sum of every value is calculated in the same order as before.
+ */
+int nsl_conv_linear_direct(double s[], size_t n, double r[], size_t m, nsl_conv_norm_type normalize, nsl_conv_wrap_type wrap, double out[]) {
+	size_t i, j, size = n + m - 1;
+	const double norm = nsl_conv_norm(r, m, normalize);
+	const size_t wi = nsl_conv_wrap_index(r, m, wrap);
+
+	for (j = 0; j < size; j++)
+		out[j] = 0;
+	for (i = 0; i < n; i++) {
+		const double si = s[i];
+		double *o = out + i;
+		for (j = 0; j < m; j++)
+			o[j] += si * r[j];
 	}
 
+	nsl_conv_wrap_normalize(out, size, wi, norm);
+
 	return 0;
 }
 
 int nsl_conv_circular_direct(double s[], size_t n, double r[], size_t m, nsl_conv_norm_type normalize, nsl_conv_wrap_type wrap, double out[]) {
-	size_t i, j, size = GSL_MAX(n,m), wi = 0;
-	double norm = 1;
-	if (normalize == nsl_conv_norm_euclidean) {
-		if ((norm = cblas_dnrm2((int)m, r, 1)) == 0)
-			norm = 1.;
-	} else if (normalize == nsl_conv_norm_sum) {
-		if ((norm = cblas_dasum((int)m, r, 1)) == 0)
-			norm = 1.;
+	size_t i, j, size = GSL_MAX(n,m);
+	const double norm = nsl_conv_norm(r, m, normalize);
+	const size_t wi = nsl_conv_wrap_index(r, m, wrap);
+
+	for (j = 0; j < size; j++)
+		out[j] = 0;
+	for (i = 0; i < n; i++) {
+		const double si = s[i];
+		/* out[i+j] and out[i+j-size] after wrapping around */
+		const size_t end = GSL_MIN(m, size - i);
+		double *o = out + i;
+		for (j = 0; j < end; j++)
+			o[j] += si * r[j];
+		for (j = end; j < m; j++)	/* i+j >= size here */
+			out[i + j - size] += si * r[j];
 	}
 
-	if (wrap == nsl_conv_wrap_max)
-		nsl_stats_maximum(r, m, &wi);
-	else if (wrap == nsl_conv_wrap_center)
-		wi = m/2;
+	nsl_conv_wrap_normalize(out, size, wi, norm);
+
+	return 0;
+}
+
+#ifndef HAVE_FFTW3
+/* multiplies the halfcomplex arrays x and h of size n (GSL layout), result in x */
+static void nsl_conv_halfcomplex_multiply(double x[], const double h[], size_t n) {
+	size_t i;
+	x[0] *= h[0];
+	for (i = 1; i + 1 < n; i += 2) {
+		const double re = x[i]*h[i] - x[i+1]*h[i+1];
+		const double im = x[i]*h[i+1] + x[i+1]*h[i];
+		x[i] = re;
+		x[i+1] = im;
+	}
+	if (n % 2 == 0)	/* when n is even last value is real */
+		x[n-1] *= h[n-1];
+}
+#endif
+
+/* The signal is split into blocks which are convolved with the response using FFTs of fixed size.
+ * The results of the blocks overlap and are added up. Only the blocks are transformed, not the whole zero-padded signal.
+ */
+int nsl_conv_linear_overlap_add(double s[], size_t n, double r[], size_t m, nsl_conv_norm_type normalize, nsl_conv_wrap_type wrap, double out[]) {
+	size_t i, start, size = n + m - 1;
+	const double norm = nsl_conv_norm(r, m, normalize);
+	const size_t wi = nsl_conv_wrap_index(r, m, wrap);
+
+	/* convolution is commutative: use the shorter array as response */
+	const double *x = s, *h = r;
+	size_t nx = n, nh = m;
+	if (m > n) {
+		x = r;
+		h = s;
+		nx = m;
+		nh = n;
+	}
+
+	const size_t fftsize = nsl_conv_overlap_add_size(nx, nh, NULL);
+	if (fftsize == 0)	/* response too long */
+		return nsl_conv_fft_type(s, n, r, m, nsl_conv_direction_forward, nsl_conv_type_linear, normalize, wrap, out);
+	const size_t block = fftsize - nh + 1;
+
+#ifdef HAVE_FFTW3
+	const size_t bufsize = 2*(fftsize/2+1);
+#else
+	const size_t bufsize = fftsize;
+#endif
+	double *hbuf = (double*)malloc(bufsize*sizeof(double));
+	double *xbuf = (double*)malloc(bufsize*sizeof(double));
+	if (hbuf == NULL || xbuf == NULL) {
+		free(hbuf);
+		free(xbuf);
+		printf("nsl_conv_linear_overlap_add(): ERROR allocating memory!\n");
+		return -1;
+	}
+
+	for (i = 0; i < nh; i++)
+		hbuf[i] = h[i];
+	for (i = nh; i < bufsize; i++)
+		hbuf[i] = 0;
+	for (i = 0; i < size; i++)
+		out[i] = 0;
+
+#ifdef HAVE_FFTW3
+	/* hbuf and xbuf may have a different alignment */
+	nsl_fftw_execute(fftsize, nsl_fftw_r2c, hbuf, hbuf);
+	nsl_fftw_plan_ref *forward = nsl_fftw_plan(fftsize, nsl_fftw_r2c, xbuf, xbuf);
+	nsl_fftw_plan_ref *backward = nsl_fftw_plan(fftsize, nsl_fftw_c2r, xbuf, xbuf);
+	if (forward == NULL || backward == NULL) {
+		nsl_fftw_release(forward);
+		nsl_fftw_release(backward);
+		free(hbuf);
+		free(xbuf);
+		printf("nsl_conv_linear_overlap_add(): ERROR planning the FFT!\n");
+		return -1;
+	}
+#else
+	gsl_fft_real_workspace *work = gsl_fft_real_workspace_alloc(fftsize);
+	gsl_fft_real_wavetable *real = gsl_fft_real_wavetable_alloc(fftsize);
+	gsl_fft_halfcomplex_wavetable *hc = gsl_fft_halfcomplex_wavetable_alloc(fftsize);
+	gsl_fft_real_transform(hbuf, 1, fftsize, real, work);
+#endif
+
+	for (start = 0; start < nx; start += block) {
+		const size_t len = GSL_MIN(block, nx - start);
+		for (i = 0; i < len; i++)
+			xbuf[i] = x[start + i];
+		for (i = len; i < bufsize; i++)
+			xbuf[i] = 0;
+
+#ifdef HAVE_FFTW3
+		fftw_execute_dft_r2c(nsl_fftw_get(forward), xbuf, (fftw_complex*)xbuf);
+		for (i = 0; i < bufsize; i += 2) {
+			double re = xbuf[i]*hbuf[i] - xbuf[i+1]*hbuf[i+1];
+			double im = xbuf[i]*hbuf[i+1] + xbuf[i+1]*hbuf[i];
 
-	for (j = 0; j < size; j++) {
-		int index;	// can be negative
-		double res = 0;
-		for (i = 0; i < n; i++) {
-			index = (int)(j - i);
-			if (index < 0)
-				index += (int)size;
-			if (index < (int)m)
-				res += s[i]*r[index]/norm;
+			xbuf[i] = re;
+			xbuf[i+1] = im;
 		}
-		index = (int)(j - wi);
-		if (index < 0)
-			index += (int)size;
-		out[index] = res;
+		fftw_execute_dft_c2r(nsl_fftw_get(backward), (fftw_complex*)xbuf, xbuf);
+		const double scale = 1./fftsize;
+#else
+		gsl_fft_real_transform(xbuf, 1, fftsize, real, work);
+		nsl_conv_halfcomplex_multiply(xbuf, hbuf, fftsize);
+		gsl_fft_halfcomplex_inverse(xbuf, 1, fftsize, hc, work);
+		const double scale = 1.;
+#endif
+
+		/* add the result of the block (len + nh - 1 values) */
+		double *o = out + start;
+		for (i = 0; i < len + nh - 1; i++)
+			o[i] += scale * xbuf[i];
 	}
 
+#ifdef HAVE_FFTW3
+	nsl_fftw_release(forward);
+	nsl_fftw_release(backward);
+#else
+	gsl_fft_halfcomplex_wavetable_free(hc);
+	gsl_fft_real_wavetable_free(real);
+	gsl_fft_real_workspace_free(work);
+#endif
+	free(xbuf);
+	free(hbuf);
+
+	nsl_conv_wrap_normalize(out, size, wi, norm);
+
 	return 0;
 }
 
 int nsl_conv_fft_type(double s[], size_t n, double r[], size_t m, nsl_conv_direction_type dir, nsl_conv_type_type type, nsl_conv_norm_type normalize, nsl_conv_wrap_type wrap, double out[]) {
-	size_t i, size, wi = 0;
+	size_t i, size, wi;
 	if (type == nsl_conv_type_linear)
 		size = n + m - 1;
 	else	// circular
 		size = GSL_MAX(n, m);
 
-	double norm = 1.;
-	if (normalize == nsl_conv_norm_euclidean) {
-		if ((norm = cblas_dnrm2((int)m, r, 1)) == 0)
-			norm = 1.;
-	} else if (normalize == nsl_conv_norm_sum) {
-		if ((norm = cblas_dasum((int)m, r, 1)) == 0)
-			norm = 1.;
-	}
-
-	if (wrap == nsl_conv_wrap_max)
-		nsl_stats_maximum(r, m, &wi);
-	else if (wrap == nsl_conv_wrap_center)
-		wi = m/2;
+	const double norm = nsl_conv_norm(r, m, normalize);
+	wi = nsl_conv_wrap_index(r, m, wrap);
 
 #ifdef HAVE_FFTW3
 	// already zero-pad here for FFT method and FFTW r2c
@@ -303,13 +503,9 @@ int nsl_conv_fft_type(double s[], size_t n, double r[], size_t m, nsl_conv_direc
 int nsl_conv_fft_FFTW(double s[], double r[], size_t n, nsl_conv_direction_type dir, size_t wi, double out[]) {
 	size_t i;
 	const size_t size = 2*(n/2+1);
-	double* in = (double*)malloc(size*sizeof(double));
-	fftw_plan rpf = fftw_plan_dft_r2c_1d(n, in, (fftw_complex*)in, FFTW_ESTIMATE);
-
-	fftw_execute_dft_r2c(rpf, s, (fftw_complex*)s);
-	fftw_execute_dft_r2c(rpf, r, (fftw_complex*)r);
-	fftw_destroy_plan(rpf);
-	free(in);
+	/* s and r may have a different alignment */
+	nsl_fftw_execute(n, nsl_fftw_r2c, s, s);
+	nsl_fftw_execute(n, nsl_fftw_r2c, r, r);
 
 	// multiply/divide
 	if (dir == nsl_conv_direction_forward) {
@@ -334,17 +530,12 @@ int nsl_conv_fft_FFTW(double s[], double r[], size_t n, nsl_conv_direction_type
 	}
 
 	// back transform
-	double* o = (double*)malloc(size*sizeof(double));
-	fftw_plan rpb = fftw_plan_dft_c2r_1d(n, (fftw_complex*)o, o, FFTW_ESTIMATE);
-
-	fftw_execute_dft_c2r(rpb, (fftw_complex*)s, s);
-	fftw_destroy_plan(rpb);
+	nsl_fftw_execute(n, nsl_fftw_c2r, s, s);
 
 	for (i = 0; i < n; i++) {
 		size_t index = (i + wi) % n;
 		out[i] = s[index]/n;
 	}
-	free(o);
 
 	return 0;
 }
@@ -34,6 +34,10 @@
 /* when to switch from direct to FFT method */
 /* set to zero to use FFT method for any length */
 #define NSL_CONV_METHOD_BORDER 100
+/* estimated cost of a real FFT of size n (NSL_CONV_FFT_COST * n * log2(n)) relative to a multiply-add of the direct method */
+#define NSL_CONV_FFT_COST 2.
+/* maximal FFT size of the overlap-add method */
+#define NSL_CONV_OVERLAP_ADD_MAXSIZE (1 << 20)
 
 #define NSL_CONV_DIRECTION_COUNT 2
 /* forward: convolution, backward: deconvolution */
@@ -45,9 +49,12 @@ extern const char* nsl_conv_direction_name[];
 typedef enum {nsl_conv_type_linear, nsl_conv_type_circular} nsl_conv_type_type;
 extern const char* nsl_conv_type_name[];
 
-#define NSL_CONV_METHOD_COUNT 3
-/* auto: use direct method for small data size (NSL_CONV_METHOD_BORDER) and FFT method otherwise */
-typedef enum {nsl_conv_method_auto, nsl_conv_method_direct, nsl_conv_method_fft} nsl_conv_method_type;
+#define NSL_CONV_METHOD_COUNT 4
+/* auto: use direct method for small data size (NSL_CONV_METHOD_BORDER) and the fastest method
+ * (direct, FFT or overlap-add) estimated from the data sizes otherwise (see nsl_conv_auto_method())
+ * overlap-add: FFT method applied to blocks of the signal (only linear convolution)
+ */
+typedef enum {nsl_conv_method_auto, nsl_conv_method_direct, nsl_conv_method_fft, nsl_conv_method_overlap_add} nsl_conv_method_type;
 extern const char* nsl_conv_method_name[];
 
 #define NSL_CONV_NORM_COUNT 3
@@ -73,6 +80,9 @@ extern const char* nsl_conv_kernel_name[];
 /* standard kernel */
 int nsl_conv_standard_kernel(double k[], size_t n, nsl_conv_kernel_type);
 
+/* method used by nsl_conv_method_auto for signal size n and response size m */
+nsl_conv_method_type nsl_conv_auto_method(size_t n, size_t m, nsl_conv_type_type);
+
 /* calculate convolution/deconvolution
  * of signal s of size n with response r of size m
  */
@@ -87,6 +97,11 @@ int nsl_conv_deconvolution(double s[], size_t n, double r[], size_t m, nsl_conv_
  */
 int nsl_conv_linear_direct(double s[], size_t n, double r[], size_t m, nsl_conv_norm_type normalize, nsl_conv_wrap_type wrap, double out[]);
 int nsl_conv_circular_direct(double s[], size_t n, double r[], size_t m, nsl_conv_norm_type normalize, nsl_conv_wrap_type wrap, double out[]);
+/* linear convolution using the overlap-add method (FFT of blocks of the signal)
+ * needs only memory of the size of the blocks besides out, used for long signals
+ * s and r are untouched
+ */
+int nsl_conv_linear_overlap_add(double s[], size_t n, double r[], size_t m, nsl_conv_norm_type normalize, nsl_conv_wrap_type wrap, double out[]);
 /* linear/circular convolution/deconvolution using FFT method
  * s and r are untouched
  */
@@ -27,20 +27,77 @@
  ***************************************************************************/
 
 #include "nsl_corr.h"
+#include "nsl_conv.h"
 #include "nsl_common.h"
 #include <gsl/gsl_cblas.h>
 #include <gsl/gsl_fft_halfcomplex.h>
 #ifdef HAVE_FFTW3
-#include <fftw3.h>
+#include "nsl_fftw.h"
 #endif
 
 const char* nsl_corr_type_name[] = {i18n("linear (zero-padded)"), i18n("circular")};
 const char* nsl_corr_norm_name[] = {i18n("none"), i18n("biased"), i18n("unbiased"), i18n("coeff")};
 
 int nsl_corr_correlation(double s[], size_t n, double r[], size_t m, nsl_corr_type_type type, nsl_corr_norm_type normalize, double out[]) {
+	/* long signal and short response: the linear correlation is calculated blockwise */
+	if (type == nsl_corr_type_linear && nsl_conv_auto_method(n, m, nsl_conv_type_linear) == nsl_conv_method_overlap_add)
+		return nsl_corr_linear_overlap_add(s, n, r, m, normalize, out);
+
 	return nsl_corr_fft_type(s, n, r, m, type, normalize, out);
 }
 
+/* normalization of the correlation out of size size */
+static void nsl_corr_normalize(double s[], size_t n, double r[], size_t m, nsl_corr_norm_type normalize, double out[], size_t size) {
+	size_t i, N = GSL_MAX(n, m);
+
+	switch (normalize) {
+	case nsl_corr_norm_none:
+		break;
+	case nsl_corr_norm_biased:
+		for (i = 0; i < size; i++)
+			out[i] = out[i]/N;
+		break;
+	case nsl_corr_norm_unbiased:
+		for (i = 0; i < size; i++) {
+			size_t norm = i < size/2 ? i+1 : size - i;
+			out[i] = out[i]/norm;
+		}
+		break;
+	case nsl_corr_norm_coeff: {
+		double snorm = cblas_dnrm2((int)n, s, 1);
+		double rnorm = cblas_dnrm2((int)m, r, 1);
+		for (i = 0; i < size; i++)
+			out[i] = out[i]/snorm/rnorm;
+		break;
+	}
+	}
+}
+
+/* the linear correlation is the linear convolution with the reversed response, shifted to lag -(N-1) */
+int nsl_corr_linear_overlap_add(double s[], size_t n, double r[], size_t m, nsl_corr_norm_type normalize, double out[]) {
+	size_t i, N = GSL_MAX(n, m), size = 2*N - 1, shift = N - m;
+
+	double *rtmp = (double*)malloc(m*sizeof(double));
+	if (rtmp == NULL) {
+		printf("nsl_corr_linear_overlap_add(): ERROR allocating memory for 'rtmp'!\n");
+		return -1;
+	}
+	for (i = 0; i < m; i++)
+		rtmp[i] = r[m - i - 1];
+
+	/* lags not covered by the convolution (n + m - 1 values) */
+	for (i = 0; i < shift; i++)
+		out[i] = 0.;
+	for (i = shift + n + m - 1; i < size; i++)
+		out[i] = 0.;
+	int status = nsl_conv_linear_overlap_add(s, n, rtmp, m, nsl_conv_norm_none, nsl_conv_wrap_none, out + shift);
+	free(rtmp);
+
+	nsl_corr_normalize(s, n, r, m, normalize, out, size);
+
+	return status;
+}
+
 int nsl_corr_fft_type(double s[], size_t n, double r[], size_t m, nsl_corr_type_type type, nsl_corr_norm_type normalize, double out[]) {
 	size_t i, size, N = GSL_MAX(n, m), maxlag = N - 1;
 	if (type == nsl_corr_type_linear)
@@ -100,28 +157,7 @@ int nsl_corr_fft_type(double s[], size_t n, double r[], size_t m, nsl_corr_type_
 	free(stmp);
 	free(rtmp);
 
-	/* normalization */
-	switch (normalize) {
-	case nsl_corr_norm_none:
-		break;
-	case nsl_corr_norm_biased:
-		for (i = 0; i < oldsize; i++)
-			out[i] = out[i]/N;
-		break;
-	case nsl_corr_norm_unbiased:
-		for (i = 0; i < oldsize; i++) {
-			size_t norm = i < oldsize/2 ? i+1 : oldsize - i;
-			out[i] = out[i]/norm;
-		}
-		break;
-	case nsl_corr_norm_coeff: {
-		double snorm = cblas_dnrm2((int)n, s, 1);
-		double rnorm = cblas_dnrm2((int)m, r, 1);
-		for (i = 0; i < oldsize; i++)
-			out[i] = out[i]/snorm/rnorm;
-		break;
-	}
-	}
+	nsl_corr_normalize(s, n, r, m, normalize, out, oldsize);
 
 	// reverse array for circular type
 	if (type == nsl_corr_type_circular) {
@@ -144,12 +180,9 @@ int nsl_corr_fft_FFTW(double s[], double r[], size_t n, double out[]) {
 	if (size <= 0)
 		return -1;
 
-	double* in = (double*)malloc(size*sizeof(double));
-	fftw_plan rpf = fftw_plan_dft_r2c_1d(n, in, (fftw_complex*)in, FFTW_ESTIMATE);
-
-	fftw_execute_dft_r2c(rpf, s, (fftw_complex*)s);
-	fftw_execute_dft_r2c(rpf, r, (fftw_complex*)r);
-	fftw_destroy_plan(rpf);
+	/* s and r may have a different alignment */
+	nsl_fftw_execute(n, nsl_fftw_r2c, s, s);
+	nsl_fftw_execute(n, nsl_fftw_r2c, r, r);
 
 	size_t i;
 
@@ -163,16 +196,11 @@ int nsl_corr_fft_FFTW(double s[], double r[], size_t n, double out[]) {
 	}
 
 	// back transform
-	double* o = (double*)malloc(size*sizeof(double));
-	fftw_plan rpb = fftw_plan_dft_c2r_1d(n, (fftw_complex*)o, o, FFTW_ESTIMATE);
-	fftw_execute_dft_c2r(rpb, (fftw_complex*)s, s);
-	fftw_destroy_plan(rpb);
+	nsl_fftw_execute(n, nsl_fftw_c2r, s, s);
 
 	for (i = 0; i < n; i++)
 		out[i] = s[i]/n;
 
-	free(in);
-	free(o);
 	return 0;
 }
 #endif
@@ -52,6 +52,10 @@ int nsl_corr_correlation(double s[], size_t n, double r[], size_t m, nsl_corr_ty
  * s and r are untouched
  */
 int nsl_corr_fft_type(double s[], size_t n, double r[], size_t m, nsl_corr_type_type, nsl_corr_norm_type normalize, double out[]);
+/* linear correlation using the overlap-add method of the convolution (for long signals)
+ * s and r are untouched
+ */
+int nsl_corr_linear_overlap_add(double s[], size_t n, double r[], size_t m, nsl_corr_norm_type normalize, double out[]);
 /* actual FFT method calculation using zero-padded arrays
  * uses FFTW if available and GSL otherwise
  * s and r are overwritten
@@ -0,0 +1,336 @@
+/***************************************************************************
+    File                 : nsl_fftw.cpp
+    Project              : LabPlot
+    Description          : NSL cache of FFTW plans
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+extern "C" {
+#include "nsl_fftw.h"
+}
+
+#ifdef HAVE_FFTW3
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <tuple>
+#include <type_traits>
+#include <vector>
+
+/* plan shared by the cache and the references handed out, destroyed with the last reference */
+typedef std::shared_ptr<std::remove_pointer<fftw_plan>::type> SharedPlan;
+
+struct nsl_fftw_plan_ref {
+	SharedPlan plan;
+};
+
+namespace {
+
+/* size, kind, in-place, alignment of the input and of the output array */
+typedef std::tuple<size_t, int, bool, int, int> PlanKey;
+
+/* thread-safe cache of the plans. The FFTW planner is not thread-safe, all planner calls and the destruction
+	of the plans are serialized. Executing a plan with the new-array execute functions is thread-safe.
+	The cache keeps the most recently used plans. Evicting or replacing a plan only drops the reference of the cache,
+	the plan is destroyed when the last reference handed out is released.
+	Shared plans must never be dropped with one of the mutexes locked, the destruction locks the planner mutex. */
+class PlanCache {
+public:
+	~PlanCache() {
+		cleanup();
+	}
+
+	SharedPlan plan(size_t n, nsl_fftw_kind kind, double* in, double* out) {
+		const PlanKey key(n, kind, in == out, fftw_alignment_of(in), fftw_alignment_of(out));
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			const auto it = m_plans.find(key);
+			if (it != m_plans.end()) {
+				Entry& entry = it->second;
+				m_lru.splice(m_lru.begin(), m_lru, entry.lru);
+
+				/* only sizes used repeatedly are measured */
+				if (++entry.requests == 2 && m_measure) {
+					m_queue.push_back(key);
+					if (!m_thread.joinable())
+						m_thread = std::thread(&PlanCache::measure, this);
+					m_condition.notify_one();
+				}
+				return entry.plan;
+			}
+		}
+
+		/* FFTW_ESTIMATE doesn't touch the arrays. Measured wisdom of this size is used if available */
+		fftw_plan p;
+		{
+			std::lock_guard<std::mutex> lock(m_plannerMutex);
+			p = create(n, kind, in, out, FFTW_ESTIMATE);
+		}
+		if (!p)
+			return SharedPlan();
+
+		SharedPlan plan = share(p);
+		std::vector<SharedPlan> dropped;	/* released after unlocking */
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			const auto it = m_plans.find(key);
+			if (it != m_plans.end()) {	/* planned by another thread in the meantime */
+				dropped.push_back(plan);
+				plan = it->second.plan;
+			} else {
+				m_lru.push_front(key);
+				Entry entry;
+				entry.plan = plan;
+				entry.lru = m_lru.begin();
+				m_plans.insert(std::make_pair(key, entry));
+				while (m_plans.size() > m_maxPlans) {
+					const auto last = m_plans.find(m_lru.back());
+					dropped.push_back(std::move(last->second.plan));
+					m_plans.erase(last);
+					m_lru.pop_back();
+				}
+			}
+		}
+
+		return plan;
+	}
+
+	void setMeasure(bool measure) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_measure = measure;
+	}
+
+	void setWisdomFile(const char* filename) {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_wisdomFile = filename ? filename : "";
+		}
+
+		if (filename) {
+			std::lock_guard<std::mutex> lock(m_plannerMutex);
+			fftw_import_wisdom_from_filename(filename);
+		}
+	}
+
+	void setThreadsMinSize(size_t n) {
+		m_threadsMinSize = n;
+	}
+
+	void setCacheSize(size_t n) {
+		std::lock_guard<std::mutex> lock(m_mutex);
+		m_maxPlans = std::max(n, (size_t)1);
+	}
+
+	void cleanup() {
+		{
+			std::lock_guard<std::mutex> lock(m_mutex);
+			m_stop = true;
+			m_queue.clear();
+		}
+		m_condition.notify_one();
+		if (m_thread.joinable())
+			m_thread.join();
+
+		std::map<PlanKey, Entry> plans;	/* released after unlocking */
+		{
+			std::lock_guard<std::mutex> plannerLock(m_plannerMutex);
+			std::lock_guard<std::mutex> lock(m_mutex);
+			/* the wisdom of all plans measured in this session is exported once */
+			if (m_wisdomChanged && !m_wisdomFile.empty())
+				fftw_export_wisdom_to_filename(m_wisdomFile.c_str());
+			m_wisdomChanged = false;
+
+			plans.swap(m_plans);
+			m_lru.clear();
+			m_stop = false;
+		}
+	}
+
+private:
+	struct Entry {
+		SharedPlan plan;
+		std::list<PlanKey>::iterator lru;	/* position in the list of recently used plans */
+		int requests{1};
+	};
+
+	/* creates a new plan, the planner mutex has to be locked */
+	fftw_plan create(size_t n, nsl_fftw_kind kind, double* in, double* out, unsigned int flags) {
+#ifdef HAVE_FFTW3_THREADS
+		if (!m_threadsInitialized)
+			m_threadsInitialized = fftw_init_threads();
+		const size_t minSize = m_threadsMinSize;
+		int threads = 1;
+		if (m_threadsInitialized && minSize > 0 && n >= minSize)
+			threads = (int)std::max(std::thread::hardware_concurrency(), 1u);
+		fftw_plan_with_nthreads(threads);
+#endif
+		if (kind == nsl_fftw_r2c)
+			return fftw_plan_dft_r2c_1d((int)n, in, (fftw_complex*)out, flags);
+		return fftw_plan_dft_c2r_1d((int)n, (fftw_complex*)in, out, flags);
+	}
+
+	/* shares the plan p, it is destroyed under the planner mutex once the last reference is dropped */
+	SharedPlan share(fftw_plan p) {
+		return SharedPlan(p, [this](fftw_plan plan) {
+			std::lock_guard<std::mutex> lock(m_plannerMutex);
+			fftw_destroy_plan(plan);
+		});
+	}
+
+	/* replaces the queued plans by measured plans, runs in the planning thread */
+	void measure() {
+		std::unique_lock<std::mutex> lock(m_mutex);
+		while (true) {
+			m_condition.wait(lock, [this] { return m_stop || !m_queue.empty(); });
+			if (m_stop)
+				return;
+
+			const PlanKey key = m_queue.front();
+			m_queue.pop_front();
+			lock.unlock();
+
+			/* FFTW_MEASURE overwrites the arrays, use arrays with the same alignment */
+			const size_t n = std::get<0>(key);
+			const bool inPlace = std::get<2>(key);
+			const size_t bytes = 2*(n/2 + 1)*sizeof(double) + 64;
+			char* inBuffer = (char*)fftw_malloc(bytes);
+			char* outBuffer = inPlace ? inBuffer : (char*)fftw_malloc(bytes);
+			double* in = (double*)(inBuffer + std::get<3>(key));
+			double* out = inPlace ? in : (double*)(outBuffer + std::get<4>(key));
+
+			fftw_plan p;
+			{
+				std::lock_guard<std::mutex> plannerLock(m_plannerMutex);
+				p = create(n, (nsl_fftw_kind)std::get<1>(key), in, out, FFTW_MEASURE);
+			}
+
+			if (!inPlace)
+				fftw_free(outBuffer);
+			fftw_free(inBuffer);
+
+			if (!p) {
+				lock.lock();
+				continue;
+			}
+
+			/* the replaced plan is destroyed once it isn't executed anymore */
+			SharedPlan plan = share(p);
+			lock.lock();
+			m_wisdomChanged = true;
+			auto it = m_plans.find(key);
+			if (it != m_plans.end())
+				it->second.plan.swap(plan);
+			/* else evicted in the meantime */
+			lock.unlock();
+			plan.reset();
+			lock.lock();
+		}
+	}
+
+	std::mutex m_mutex;		/* protects the cache and the settings */
+	std::mutex m_plannerMutex;	/* protects the FFTW planner, locked before the cache mutex */
+	std::condition_variable m_condition;
+	std::map<PlanKey, Entry> m_plans;
+	std::list<PlanKey> m_lru;	/* keys of the cached plans, most recently used first */
+	std::deque<PlanKey> m_queue;	/* plans to measure */
+	std::thread m_thread;
+	size_t m_maxPlans{64};
+	bool m_measure{false};
+	bool m_stop{false};
+	bool m_wisdomChanged{false};
+	std::string m_wisdomFile;
+	std::atomic<size_t> m_threadsMinSize{1 << 18};
+	bool m_threadsInitialized{false};
+};
+
+PlanCache& cache() {
+	static PlanCache planCache;
+	return planCache;
+}
+
+}
+
+extern "C" {
+
+nsl_fftw_plan_ref* nsl_fftw_plan(size_t n, nsl_fftw_kind kind, double* in, double* out) {
+	SharedPlan plan = cache().plan(n, kind, in, out);
+	if (!plan)
+		return nullptr;
+
+	auto* ref = new nsl_fftw_plan_ref;
+	ref->plan = std::move(plan);
+	return ref;
+}
+
+fftw_plan nsl_fftw_get(const nsl_fftw_plan_ref* ref) {
+	return ref->plan.get();
+}
+
+void nsl_fftw_release(nsl_fftw_plan_ref* ref) {
+	delete ref;
+}
+
+int nsl_fftw_execute(size_t n, nsl_fftw_kind kind, double* in, double* out) {
+	nsl_fftw_plan_ref* ref = nsl_fftw_plan(n, kind, in, out);
+	if (!ref)
+		return -1;
+
+	if (kind == nsl_fftw_r2c)
+		fftw_execute_dft_r2c(nsl_fftw_get(ref), in, (fftw_complex*)out);
+	else
+		fftw_execute_dft_c2r(nsl_fftw_get(ref), (fftw_complex*)in, out);
+	nsl_fftw_release(ref);
+
+	return 0;
+}
+
+void nsl_fftw_set_measure(int measure) {
+	cache().setMeasure(measure != 0);
+}
+
+void nsl_fftw_set_wisdom_file(const char* filename) {
+	cache().setWisdomFile(filename);
+}
+
+void nsl_fftw_set_threads_min_size(size_t n) {
+	cache().setThreadsMinSize(n);
+}
+
+void nsl_fftw_set_cache_size(size_t n) {
+	cache().setCacheSize(n);
+}
+
+void nsl_fftw_cleanup(void) {
+	cache().cleanup();
+}
+
+}
+#endif
@@ -0,0 +1,71 @@
+/***************************************************************************
+    File                 : nsl_fftw.h
+    Project              : LabPlot
+    Description          : NSL cache of FFTW plans
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef NSL_FFTW_H
+#define NSL_FFTW_H
+
+#ifdef HAVE_FFTW3
+#include <stdlib.h>
+#include <fftw3.h>
+
+/* kind of the transform: real to complex (forward) or complex to real (backward) */
+typedef enum {nsl_fftw_r2c, nsl_fftw_c2r} nsl_fftw_kind;
+
+/* reference to a cached plan */
+typedef struct nsl_fftw_plan_ref nsl_fftw_plan_ref;
+
+/* returns a reference to the plan of the DFT of size n from in to out (in-place if in == out), NULL if planning failed.
+	The plans are cached for the size, the kind, in-place and the alignment of the arrays and are shared.
+	They are executed with fftw_execute_dft_r2c() or fftw_execute_dft_c2r() on in and out, also in parallel.
+	The arrays are not touched when planning. As usual, the c2r transform destroys its input.
+	The plan stays valid until the reference is released with nsl_fftw_release(), even if the cache evicted it.
+*/
+nsl_fftw_plan_ref* nsl_fftw_plan(size_t n, nsl_fftw_kind kind, double* in, double* out);
+/* the plan of the reference */
+fftw_plan nsl_fftw_get(const nsl_fftw_plan_ref* ref);
+/* releases the reference (NULL is ignored), the plan is destroyed with the last reference if it is not cached anymore */
+void nsl_fftw_release(nsl_fftw_plan_ref* ref);
+/* executes the DFT of size n from in to out with the cached plan, returns -1 if planning failed */
+int nsl_fftw_execute(size_t n, nsl_fftw_kind kind, double* in, double* out);
+
+/* plan sizes requested repeatedly with FFTW_MEASURE in a background thread, the cached plans are replaced
+	by the measured ones (default: off) */
+void nsl_fftw_set_measure(int measure);
+/* imports the wisdom from filename, the wisdom of the measured plans is exported to it in nsl_fftw_cleanup().
+	NULL disables the export */
+void nsl_fftw_set_wisdom_file(const char* filename);
+/* maximal number of cached plans, the least recently used plans are evicted (default: 64) */
+void nsl_fftw_set_cache_size(size_t n);
+/* minimal size of multithreaded transforms, 0 to disable them (only used if FFTW was built with threads) */
+void nsl_fftw_set_threads_min_size(size_t n);
+/* waits for the planning in the background, exports the wisdom and empties the cache.
+	The plans still referenced are destroyed when they are released */
+void nsl_fftw_cleanup(void);
+#endif
+
+#endif /* NSL_FFTW_H */
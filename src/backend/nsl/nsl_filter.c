@@ -33,7 +33,7 @@
 #include <gsl/gsl_fft_real.h>
 #include <gsl/gsl_fft_halfcomplex.h>
 #ifdef HAVE_FFTW3
-#include <fftw3.h>
+#include "nsl_fftw.h"
 #endif
 
 const char* nsl_filter_type_name[] = { i18n("Low pass"), i18n("High pass"), i18n("Band pass"), i18n("Band reject") };
@@ -272,9 +272,7 @@ int nsl_filter_fourier(double data[], size_t n, nsl_filter_type type, nsl_filter
 	/* 1. transform */
 	double* fdata = (double*)malloc(2*n*sizeof(double));	/* contains re0,im0,re1,im1,re2,im2,... */
 #ifdef HAVE_FFTW3
-        fftw_plan plan = fftw_plan_dft_r2c_1d(n, data, (fftw_complex *) fdata, FFTW_ESTIMATE);
-        fftw_execute(plan);
-	fftw_destroy_plan(plan);
+	nsl_fftw_execute(n, nsl_fftw_r2c, data, fdata);
 #else
 	gsl_fft_real_wavetable *real = gsl_fft_real_wavetable_alloc(n);
 	gsl_fft_real_workspace *work = gsl_fft_real_workspace_alloc(n);
@@ -292,9 +290,7 @@ int nsl_filter_fourier(double data[], size_t n, nsl_filter_type type, nsl_filter
 	
 	/* 3. back transform */
 #ifdef HAVE_FFTW3
-        plan = fftw_plan_dft_c2r_1d(n, (fftw_complex *) fdata, data, FFTW_ESTIMATE);
-        fftw_execute(plan);
-	fftw_destroy_plan(plan);
+	nsl_fftw_execute(n, nsl_fftw_c2r, fdata, data);
 	/* normalize*/
 	size_t i;
 	for (i=0; i < n; i++)
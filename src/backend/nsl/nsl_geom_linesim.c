@@ -121,31 +121,119 @@ double nsl_geom_linesim_avg_dist_perpoint(const double xdata[], const double yda
 
 /*********** simplification algorithms *********/
 
-void nsl_geom_linesim_douglas_peucker_step(const double xdata[], const double ydata[], const size_t start, const size_t end, size_t *nout, const double tol, size_t index[]) {
-	/*printf("DP: %d - %d\n", start, end);*/
+/* 4-ary heap (fewer levels and cache misses than a binary heap) of points 0..n-1 ordered by key (ascending or descending if max is set),
+	equal keys by point */
+typedef struct {
+	double key;
+	size_t point;
+} nsl_geom_linesim_heap_entry;
+
+typedef struct {
+	nsl_geom_linesim_heap_entry *data;
+	size_t *pos;	/* position of every point in data */
+	size_t size;
+	int max;
+} nsl_geom_linesim_heap;
+
+static int nsl_geom_linesim_heap_init(nsl_geom_linesim_heap *heap, const size_t n, const int max) {
+	heap->data = (nsl_geom_linesim_heap_entry *)malloc(n * sizeof(nsl_geom_linesim_heap_entry));
+	heap->pos = (size_t *)malloc(n * sizeof(size_t));
+	heap->size = 0;
+	heap->max = max;
+	if (heap->data == NULL || heap->pos == NULL) {
+		free(heap->data);
+		free(heap->pos);
+		return -1;
+	}
+	return 0;
+}
+
+static void nsl_geom_linesim_heap_free(nsl_geom_linesim_heap *heap) {
+	free(heap->data);
+	free(heap->pos);
+}
+
+/* true if entry a comes before entry b */
+static int nsl_geom_linesim_heap_before(const nsl_geom_linesim_heap *heap, const nsl_geom_linesim_heap_entry *a, const nsl_geom_linesim_heap_entry *b) {
+	if (a->key != b->key)
+		return heap->max ? a->key > b->key : a->key < b->key;
+	return a->point < b->point;
+}
+
+static void nsl_geom_linesim_heap_set(nsl_geom_linesim_heap *heap, const size_t i, const nsl_geom_linesim_heap_entry entry) {
+	heap->data[i] = entry;
+	heap->pos[entry.point] = i;
+}
+
+static void nsl_geom_linesim_heap_up(nsl_geom_linesim_heap *heap, size_t i) {
+	const nsl_geom_linesim_heap_entry entry = heap->data[i];
+	while (i > 0 && nsl_geom_linesim_heap_before(heap, &entry, &heap->data[(i-1)/4])) {
+		nsl_geom_linesim_heap_set(heap, i, heap->data[(i-1)/4]);
+		i = (i-1)/4;
+	}
+	nsl_geom_linesim_heap_set(heap, i, entry);
+}
+
+static void nsl_geom_linesim_heap_down(nsl_geom_linesim_heap *heap, size_t i) {
+	const nsl_geom_linesim_heap_entry entry = heap->data[i];
+	size_t first, j, child;
+	while ((first = 4*i + 1) < heap->size) {
+		/* first of the (up to) four children */
+		const size_t last = (first + 4 < heap->size) ? first + 4 : heap->size;
+		child = first;
+		for (j = first + 1; j < last; j++)
+			if (nsl_geom_linesim_heap_before(heap, &heap->data[j], &heap->data[child]))
+				child = j;
+		if (!nsl_geom_linesim_heap_before(heap, &heap->data[child], &entry))
+			break;
+		nsl_geom_linesim_heap_set(heap, i, heap->data[child]);
+		i = child;
+	}
+	nsl_geom_linesim_heap_set(heap, i, entry);
+}
+
+static void nsl_geom_linesim_heap_push(nsl_geom_linesim_heap *heap, const size_t point, const double key) {
+	const nsl_geom_linesim_heap_entry entry = {key, point};
+	nsl_geom_linesim_heap_set(heap, heap->size++, entry);
+	nsl_geom_linesim_heap_up(heap, heap->size - 1);
+}
+
+static size_t nsl_geom_linesim_heap_pop(nsl_geom_linesim_heap *heap) {
+	const size_t point = heap->data[0].point;
+	if (--heap->size > 0) {
+		nsl_geom_linesim_heap_set(heap, 0, heap->data[heap->size]);
+		nsl_geom_linesim_heap_down(heap, 0);
+	}
+	return point;
+}
 
-	size_t i, nkey = start;
-	double maxdist = 0;
-	/* search for key (biggest perp. distance) */
+/* change the key of a point in the heap */
+static void nsl_geom_linesim_heap_update(nsl_geom_linesim_heap *heap, const size_t point, const double key) {
+	const size_t i = heap->pos[point];
+	const nsl_geom_linesim_heap_entry old = heap->data[i];
+	heap->data[i].key = key;
+	if (nsl_geom_linesim_heap_before(heap, &heap->data[i], &old))
+		nsl_geom_linesim_heap_up(heap, i);
+	else
+		nsl_geom_linesim_heap_down(heap, i);
+}
+
+/* key (largest perp. distance) of the edge start -- end (first point if all are on the edge) */
+static size_t nsl_geom_linesim_edge_key(const double xdata[], const double ydata[], const size_t start, const size_t end, double *maxdist) {
+	size_t i, nkey = start + 1;
+	/* same as nsl_geom_point_line_dist() with the length of the edge calculated only once */
+	const double x1 = xdata[start], y1 = ydata[start], dx = xdata[end] - x1, dy = ydata[end] - y1;
+	const double length = nsl_geom_point_point_dist(x1, y1, xdata[end], ydata[end]);
+	*maxdist = 0;
 	for (i = start+1; i < end; i++) {
-		double dist = nsl_geom_point_line_dist(xdata[start], ydata[start], xdata[end], ydata[end], xdata[i], ydata[i]);
-		if (dist > maxdist) {
-			maxdist = dist;
+		double dist = fabs( (xdata[i]-x1)*dy - dx*(ydata[i]-y1) ) / length;
+		if (dist > *maxdist) {
+			*maxdist = dist;
 			nkey = i;
 		}
 	}
-	/*printf("maxdist = %g @ i = %zu\n", maxdist, nkey);*/
-
-	if (maxdist > tol) {
-		/*printf("take %d\n", nkey);*/
-		index[(*nout)++] = nkey;
-		if (nkey-start > 1)
-			nsl_geom_linesim_douglas_peucker_step(xdata, ydata, start, nkey, nout, tol, index);
-		if (end-nkey > 1)
-			nsl_geom_linesim_douglas_peucker_step(xdata, ydata, nkey, end, nout, tol, index);
-	}
 
-	/*printf("nout=%d\n", *nout);*/
+	return nkey;
 }
 
 size_t nsl_geom_linesim_douglas_peucker(const double xdata[], const double ydata[], const size_t n, const double tol, size_t index[]) {
@@ -154,7 +242,37 @@ size_t nsl_geom_linesim_douglas_peucker(const double xdata[], const double ydata
 	/*first point*/
 	index[nout++] = 0;
 
-	nsl_geom_linesim_douglas_peucker_step(xdata, ydata, 0, n-1, &nout, tol, index);
+	/* edges to check (start, end), iterative to avoid a deep recursion */
+	size_t *stack = (size_t *)malloc(n * sizeof(size_t));
+	if (stack == NULL) {
+		printf("nsl_geom_linesim_douglas_peucker(): ERROR allocating memory!\n");
+		return 0;
+	}
+	size_t nstack = 0;
+	if (n > 2) {
+		stack[nstack++] = 0;
+		stack[nstack++] = n-1;
+	}
+	while (nstack > 0) {
+		const size_t end = stack[--nstack], start = stack[--nstack];
+		double maxdist;
+		const size_t nkey = nsl_geom_linesim_edge_key(xdata, ydata, start, end, &maxdist);
+		/*printf("maxdist = %g @ i = %zu\n", maxdist, nkey);*/
+
+		if (maxdist > tol) {
+			index[nout++] = nkey;
+			/* the edges on the stack are disjoint and contain at least one point */
+			if (end-nkey > 1) {
+				stack[nstack++] = nkey;
+				stack[nstack++] = end;
+			}
+			if (nkey-start > 1) {
+				stack[nstack++] = start;
+				stack[nstack++] = nkey;
+			}
+		}
+	}
+	free(stack);
 
 	/* last point */
 	if (index[nout-1] != n-1)
@@ -174,6 +292,7 @@ size_t nsl_geom_linesim_douglas_peucker_auto(const double xdata[], const double
  * Douglas-Peucker variant:
  * The key of all egdes of the current simplified line is calculated and only the
  * largest is added. This is repeated until nout is reached.
+ * The edges are kept in a heap ordered by the distance of their key.
  * */
 double nsl_geom_linesim_douglas_peucker_variant(const double xdata[], const double ydata[], const size_t n, const size_t nout, size_t index[]) {
 	size_t i;
@@ -191,95 +310,51 @@ double nsl_geom_linesim_douglas_peucker_variant(const double xdata[], const doub
 	if (nout <= 2)	/* use only first and last point (perp. dist is zero) */
 		return 0.0;
 
-	double *dist = (double *)malloc(n * sizeof(double));
-	if (dist == NULL) {
-		/* printf("nsl_geom_linesim_douglas_peucker_variant(): ERROR allocating memory for 'dist'!\n"); */
+	/* edges are identified by their start point */
+	size_t *key = (size_t *)malloc(n * sizeof(size_t));	/* key per edge */
+	size_t *end = (size_t *)malloc(n * sizeof(size_t));	/* end point per edge */
+	nsl_geom_linesim_heap heap;	/* edges ordered by max dist */
+	if (key == NULL || end == NULL || nsl_geom_linesim_heap_init(&heap, n, 1) != 0) {
+		/* printf("nsl_geom_linesim_douglas_peucker_variant(): ERROR allocating memory!\n"); */
+		free(key);
+		free(end);
 		return DBL_MAX;
 	}
 
-	double *maxdist = (double *)malloc(nout * sizeof(double));	/* max dist per edge */
-	if (maxdist == NULL) {
-		/* printf("nsl_geom_linesim_douglas_peucker_variant(): ERROR allocating memory for 'maxdist'!\n"); */
-		free(dist);
-		return DBL_MAX;
-	}
-
-	for (i = 0; i < n; i++) {	/* initialize  dist */
-		dist[i] = nsl_geom_point_line_dist(xdata[0], ydata[0], xdata[n-1], ydata[n-1], xdata[i], ydata[i]);
-		/* printf("nsl_geom_linesim_douglas_peucker_variant(): %zu dist = %g\n", i, dist[i]); */
-	}
-	for (i = 0; i < nout; i++)
-		maxdist[i] = 0;
+	double maxdist;
+	end[0] = n-1;
+	key[0] = nsl_geom_linesim_edge_key(xdata, ydata, 0, n-1, &maxdist);
+	nsl_geom_linesim_heap_push(&heap, 0, maxdist);
 
 	double newmaxdist = 0;
 	do {
-		/* printf("nsl_geom_linesim_douglas_peucker_variant(): NEXT ITERATION\n"); */
-		size_t key = 0;
-
-		/* find edge of maximum */
-		size_t maxindex;
-		nsl_stats_maximum(maxdist, ncount, &maxindex);
-		/* printf("nsl_geom_linesim_douglas_peucker_variant(): found edge with max dist at index %zu\n", maxindex); */
-		/*newmaxdist = nsl_stats_maximum(dist, n, &key);*/
-		newmaxdist = 0;
-		for (i = index[maxindex]+1; i < index[maxindex+1]; i++) {
-			/* printf("nsl_geom_linesim_douglas_peucker_variant(): iterate i=%zu\n", i); */
-			if (dist[i] > newmaxdist) {
-				newmaxdist = dist[i];
-				key = i;
-			}
-		}
-
-		/* printf("nsl_geom_linesim_douglas_peucker_variant(): found key %zu (dist = %g)\n", key, newmaxdist); */
-		ncount++;
-		dist[key] = 0;
-
-		/* find index of previous key */
-		size_t previndex = 0;
-		while (index[previndex+1] < key)
-			previndex++;
-		/* printf("nsl_geom_linesim_douglas_peucker_variant(): previndex = %zu (update keys %zu - %zu)\n", previndex, index[previndex], index[previndex+1]); */
-
-		size_t v;
-		/* printf("nsl_geom_linesim_douglas_peucker_variant(): ncount = %zu, previndex = %zu\n", ncount, previndex); */
-		/* update dist[]. no update on last key */
+		/* edge of maximum */
+		newmaxdist = heap.data[0].key;
+		const size_t start = nsl_geom_linesim_heap_pop(&heap);
+		const size_t k = key[start];
+		/* printf("nsl_geom_linesim_douglas_peucker_variant(): found key %zu (dist = %g)\n", k, newmaxdist); */
+		index[ncount++] = k;
+
+		/* split the edge. no update on last key */
 		if (ncount < nout) {
-			/* shift maxdist */
-			for (v = ncount; v > previndex; v--)
-				maxdist[v] = maxdist[v-1];
-
-			double tmpmax = 0;
-			for (v = index[previndex]+1; v < key; v++) {
-				/* printf("nsl_geom_linesim_douglas_peucker_variant(): %zu in %zu - %zu", v, index[previndex], key); */
-				dist[v] = nsl_geom_point_line_dist(xdata[index[previndex]], ydata[index[previndex]], xdata[key], ydata[key],
-					xdata[v], ydata[v]);
-				if (dist[v] > tmpmax)
-					tmpmax = dist[v];
-
-				/* printf(" dist = %g\n", dist[v]); */
+			end[k] = end[start];
+			end[start] = k;
+			if (k - start > 1) {
+				key[start] = nsl_geom_linesim_edge_key(xdata, ydata, start, k, &maxdist);
+				nsl_geom_linesim_heap_push(&heap, start, maxdist);
 			}
-			maxdist[previndex] = tmpmax;
-
-			tmpmax = 0;
-			for (v = key+1; v < index[previndex+1]; v++) {
-				/* printf("nsl_geom_linesim_douglas_peucker_variant(): %zu in %zu - %zu", v, key, index[previndex+1]); */
-				dist[v] = nsl_geom_point_line_dist(xdata[key], ydata[key], xdata[index[previndex+1]], ydata[index[previndex+1]],
-					xdata[v], ydata[v]);
-				if (dist[v] > tmpmax)
-					tmpmax = dist[v];
-				/* printf(" dist = %g\n", dist[v]); */
+			if (end[k] - k > 1) {
+				key[k] = nsl_geom_linesim_edge_key(xdata, ydata, k, end[k], &maxdist);
+				nsl_geom_linesim_heap_push(&heap, k, maxdist);
 			}
-			maxdist[previndex+1] = tmpmax;
 		}
-
-		/* put into index array */
-		for (v = ncount; v > previndex+1; v--)
-			index[v] = index[v-1];
-		index[previndex+1] = key;
 	} while (ncount < nout);
 
-	free(maxdist);
-	free(dist);
+	nsl_sort_size_t(index, ncount);
+
+	nsl_geom_linesim_heap_free(&heap);
+	free(end);
+	free(key);
 
 	return newmaxdist;
 }
@@ -446,82 +521,70 @@ size_t nsl_geom_linesim_interp_auto(const double xdata[], const double ydata[],
 	return nsl_geom_linesim_interp(xdata, ydata, n, tol, index);
 }
 
+/* The points are kept in a heap ordered by their area and their neighbors in a doubly linked list */
 size_t nsl_geom_linesim_visvalingam_whyatt(const double xdata[], const double ydata[], const size_t n, const double tol, size_t index[]) {
 	if (n < 3)	/* we need at least three points */
 		return 0;
 
 	size_t i, nout = n;
-	double *area = (double *) malloc((n-2)*sizeof(double));	/* area associated with every point */
-	if (area == NULL) {
+	double *area = (double *) malloc(n*sizeof(double));	/* area associated with every point */
+	size_t *prev = (size_t *) malloc(n*sizeof(size_t));	/* previous remaining point */
+	size_t *next = (size_t *) malloc(n*sizeof(size_t));	/* next remaining point */
+	nsl_geom_linesim_heap heap;	/* points ordered by area */
+	if (area == NULL || prev == NULL || next == NULL || nsl_geom_linesim_heap_init(&heap, n, 0) != 0) {
 		printf("nsl_geom_linesim_visvalingam_whyatt(): ERROR allocating memory!\n");
+		free(area);
+		free(prev);
+		free(next);
 		return 0;
 	}
-	for (i = 0; i < n; i++)
-		index[i] = i;
-	for (i = 1; i < n-1; i++)
-		area[i-1] = nsl_geom_three_point_area(xdata[i-1], ydata[i-1], xdata[i], ydata[i], xdata[i+1], ydata[i+1]);
-
-	size_t minindex;
-	while ( nsl_stats_minimum(area, n-2, &minindex) < tol && nout > 2) {
-	/* double minarea;
-	while ( (minarea = nsl_stats_minimum(area, n-2, &minindex)) < tol && nout > 2) { */
-		/*for (i=0; i < n-2; i++)
-			if (area[i]<DBL_MAX)
-				printf("area[%zu] = %g\n", i, area[i]);
-		*/
-		/* remove point minindex */
-		/*printf("removing point %zu (minindex = %zu, minarea = %g) nout=%zu\n", minindex+1, minindex, minarea, nout-1);*/
-		index[minindex+1] = 0;
-		area[minindex] = DBL_MAX;
+	for (i = 0; i < n; i++) {
+		prev[i] = i - 1;
+		next[i] = i + 1;
+	}
+	area[0] = area[n-1] = DBL_MAX;
+	for (i = 1; i < n-1; i++) {
+		area[i] = nsl_geom_three_point_area(xdata[i-1], ydata[i-1], xdata[i], ydata[i], xdata[i+1], ydata[i+1]);
+		nsl_geom_linesim_heap_push(&heap, i, area[i]);
+	}
+
+	while (heap.size > 0 && heap.data[0].key < tol && nout > 2) {
+		/* remove point with minimum area */
+		const size_t point = nsl_geom_linesim_heap_pop(&heap);
+		const size_t before = prev[point], after = next[point];
+		/*printf("removing point %zu (area = %g) nout=%zu\n", point, area[point], nout-1);*/
+		next[before] = after;
+		prev[after] = before;
+
+		/* update area of neighbor points (take largest value of new and old area) */
 		double tmparea;
-		/* update area of neigbor points */
-		size_t before = minindex, after = minindex+2;	/* find index before and after */
-		while (index[before] == 0 && before > 0)
-			before--;
-		while (after < n+1 && index[after] == 0)
-			after++;
-		if (minindex > 0) {	/*before */
-			if (before > 0) {
-				size_t beforebefore=before-1;
-				while (index[beforebefore] == 0 && beforebefore > 0)
-					beforebefore--;
-				/*printf("recalculate area[%zu] from %zu %zu %zu\n", before-1, beforebefore, before, after);*/
-				tmparea = nsl_geom_three_point_area(xdata[beforebefore], ydata[beforebefore], xdata[before], ydata[before], xdata[after], ydata[after]);
-				if (tmparea > area[before-1])	/* take largest value of new and old area */
-					area[before-1] = tmparea;
+		if (before > 0) {
+			tmparea = nsl_geom_three_point_area(xdata[prev[before]], ydata[prev[before]], xdata[before], ydata[before], xdata[after], ydata[after]);
+			if (tmparea > area[before]) {
+				area[before] = tmparea;
+				nsl_geom_linesim_heap_update(&heap, before, tmparea);
 			}
 		}
-		if (minindex < n-3) {	/* after */
-			if (after < n-1) {
-				size_t afterafter = after+1;
-				while (afterafter < n-1 && index[afterafter] == 0)
-					afterafter++;
-				/*printf("recalculate area[%zu] from %zu %zu %zu\n",after-1, before, after, afterafter);*/
-				tmparea = nsl_geom_three_point_area(xdata[before], ydata[before], xdata[after], ydata[after], xdata[afterafter], ydata[afterafter]);
-				if (tmparea > area[after-1])	/* take largest value of new and old area */
-					area[after-1] = tmparea;
+		if (after < n-1) {
+			tmparea = nsl_geom_three_point_area(xdata[before], ydata[before], xdata[after], ydata[after], xdata[next[after]], ydata[next[after]]);
+			if (tmparea > area[after]) {
+				area[after] = tmparea;
+				nsl_geom_linesim_heap_update(&heap, after, tmparea);
 			}
 		}
 		nout--;
-	};
-
-	/*for(i=0;i<n;i++)
-		printf("INDEX = %d\n", index[i]);
-	*/
-
-	/* condens index */
-	i = 1;
-	size_t newi = 1;
-	while (newi < n-1) {
-		while (index[newi] == 0)
-			newi++;
-		index[i++] = index[newi++];
-	};
+	}
 
-	/*for(i=0;i<nout;i++)
-		printf("INDEX2 = %d\n", index[i]);
-	*/
+	/* remaining points */
+	size_t point = 0;
+	for (i = 0; i < nout; i++) {
+		index[i] = point;
+		point = next[point];
+	}
 
+	nsl_geom_linesim_heap_free(&heap);
+	free(next);
+	free(prev);
 	free(area);
 	return nout;
 }
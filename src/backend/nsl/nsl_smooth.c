@@ -34,14 +34,14 @@
 #include <gsl/gsl_linalg.h>
 #include <gsl/gsl_blas.h>
 #include <gsl/gsl_sf_gamma.h>   /* gsl_sf_choose */
+#include <gsl/gsl_sort.h>
 
 const char* nsl_smooth_type_name[] = { i18n("moving average (central)"), i18n("moving average (lagged)"), i18n("percentile"), i18n("Savitzky-Golay") };
 const char* nsl_smooth_pad_mode_name[] = { i18n("none"), i18n("interpolating"), i18n("mirror"), i18n("nearest"), i18n("constant"), i18n("periodic") };
 const char* nsl_smooth_weight_type_name[] = { i18n("uniform (rectangular)"), i18n("triangular"), i18n("binomial"), i18n("parabolic (Epanechnikov)"),
 		i18n("quartic (biweight)"), i18n("triweight"), i18n("tricube"), i18n("cosine")  };
-double nsl_smooth_pad_constant_lvalue = 0.0, nsl_smooth_pad_constant_rvalue = 0.0;
 
-int nsl_smooth_moving_average(double *data, size_t n, size_t points, nsl_smooth_weight_type weight, nsl_smooth_pad_mode mode) {
+int nsl_smooth_moving_average(double *data, size_t n, size_t points, nsl_smooth_weight_type weight, nsl_smooth_pad_mode mode, double lvalue, double rvalue) {
 	if (n == 0 || points == 0)
 		return -1;
 
@@ -144,9 +144,9 @@ int nsl_smooth_moving_average(double *data, size_t n, size_t points, nsl_smooth_
 				break;
 			case nsl_smooth_pad_constant:
 				if (index < 0)
-					result[i] += w[j]*nsl_smooth_pad_constant_lvalue;
+					result[i] += w[j]*lvalue;
 				else if (index > (int)n - 1)
-					result[i] += w[j]*nsl_smooth_pad_constant_rvalue;
+					result[i] += w[j]*rvalue;
 				else
 					result[i] += w[j]*data[index];
 				break;
@@ -170,7 +170,7 @@ int nsl_smooth_moving_average(double *data, size_t n, size_t points, nsl_smooth_
 	return 0;
 }
 
-int nsl_smooth_moving_average_lagged(double *data, size_t n, size_t points, nsl_smooth_weight_type weight, nsl_smooth_pad_mode mode) {
+int nsl_smooth_moving_average_lagged(double *data, size_t n, size_t points, nsl_smooth_weight_type weight, nsl_smooth_pad_mode mode, double lvalue) {
 	if (n == 0 || points == 0)
 		return -1;
 
@@ -276,7 +276,7 @@ int nsl_smooth_moving_average_lagged(double *data, size_t n, size_t points, nsl_
 				break;
 			case nsl_smooth_pad_constant:
 				if (index < 0)
-					result[i] += w[j]*nsl_smooth_pad_constant_lvalue;
+					result[i] += w[j]*lvalue;
 				else
 					result[i] += w[j]*data[index];
 
@@ -300,13 +300,93 @@ int nsl_smooth_moving_average_lagged(double *data, size_t n, size_t points, nsl_
 	return 0;
 }
 
-int nsl_smooth_percentile(double *data, size_t n, size_t points, double percentile, nsl_smooth_pad_mode mode) {
+/* index of the value at position index of the padded data: 0..n-1 data, n left and n+1 right constant value */
+static size_t nsl_smooth_pad_index(int index, size_t n, nsl_smooth_pad_mode mode) {
+	switch (mode) {
+	case nsl_smooth_pad_none:
+		break;
+	case nsl_smooth_pad_mirror:
+		index = abs(index);
+		return (size_t)GSL_MIN(index, 2*((int)n-1)-index);
+	case nsl_smooth_pad_interp:	/* not implemented, use nearest */
+	case nsl_smooth_pad_nearest:
+		return (size_t)GSL_MIN((int)n-1, GSL_MAX(0, index));
+	case nsl_smooth_pad_constant:
+		if (index < 0)
+			return n;
+		else if (index > (int)n-1)
+			return n+1;
+		break;
+	case nsl_smooth_pad_periodic:
+		if (index < 0)
+			index = index + (int)n;
+		else if (index > (int)n-1)
+			index = index - (int)n;
+		break;
+	}
+
+	return (size_t)index;
+}
+
+/* Fenwick tree counting the values of the window per rank, rank r is stored at position r+1 */
+static void nsl_smooth_rank_add(long *tree, size_t size, size_t rank, long count) {
+	size_t pos;
+	for (pos = rank + 1; pos <= size; pos += pos & (~pos + 1))
+		tree[pos] += count;
+}
+
+/* rank of the k-th smallest value (k = 0, 1, ...) of the window */
+static size_t nsl_smooth_rank_kth(const long *tree, size_t size, size_t step, size_t k) {
+	size_t pos = 0;
+	long rest = (long)k;
+	for (; step > 0; step >>= 1) {
+		if (pos + step <= size && tree[pos + step] <= rest) {
+			pos += step;
+			rest -= tree[pos];
+		}
+	}
+	return pos;
+}
+
+/* The windows are not sorted. The values are sorted once and the window is kept as a Fenwick tree of the counts
+	of the ranks of its values, sliding the window and finding the k-th smallest value is O(log n) */
+int nsl_smooth_percentile(double *data, size_t n, size_t points, double percentile, nsl_smooth_pad_mode mode, double lvalue, double rvalue) {
 	if (n == 0 || points == 0)
 		return -1;
 
-	size_t i, j;
+	/* all values of the padded data: data and the constant values */
+	const size_t size = (mode == nsl_smooth_pad_constant) ? n + 2 : n;
+	double *values = (double *)malloc(size * sizeof(double));
+	size_t *order = (size_t *)malloc(size * sizeof(size_t));
+	size_t *rank = (size_t *)malloc(size * sizeof(size_t));
+	long *tree = (long *)calloc(size + 1, sizeof(long));
 	double *result = (double *)malloc(n * sizeof(double));
+	if (!values || !order || !rank || !tree || !result) {
+		free(values);
+		free(order);
+		free(rank);
+		free(tree);
+		free(result);
+		return -1;
+	}
 
+	size_t i;
+	for (i = 0; i < n; i++)
+		values[i] = data[i];
+	if (mode == nsl_smooth_pad_constant) {
+		values[n] = lvalue;
+		values[n+1] = rvalue;
+	}
+	gsl_sort_index(order, values, 1, size);
+	for (i = 0; i < size; i++)
+		rank[order[i]] = i;
+
+	size_t step = 1;
+	while (2 * step <= size)
+		step *= 2;
+
+	/* current window [lo, hi] of positions in the padded data */
+	int lo = 0, hi = -1;
 	for (i = 0; i < n; i++) {
 		size_t np = points;
 		size_t half = (points-1)/2;
@@ -315,53 +395,40 @@ int nsl_smooth_percentile(double *data, size_t n, size_t points, double percenti
 			np = 2*half+1;
 		}
 
-		double *values = (double *)malloc(np*sizeof(double));
-		for (j = 0; j < np; j++) {
-			int index = (int)(i-half+j);
-			switch(mode) {
-			case nsl_smooth_pad_none:
-				/*printf(" %d",index);*/
-				values[j] = data[index];
-				break;
-			case nsl_smooth_pad_interp:
-				printf("not implemented yet\n");
-				break;
-			case nsl_smooth_pad_mirror:
-				index=abs(index);
-				/*printf(" %d",GSL_MIN(index,2*(n-1)-index));*/
-				values[j] = data[GSL_MIN(index, 2*((int)n-1)-index)];
-				break;
-			case nsl_smooth_pad_nearest:
-				/*printf(" %d",GSL_MIN(n-1,GSL_MAX(0,index)));*/
-				values[j] = data[GSL_MIN((int)n-1, GSL_MAX(0, index))];
-				break;
-			case nsl_smooth_pad_constant:
-				if (index < 0)
-					values[j] = nsl_smooth_pad_constant_lvalue;
-				else if (index > (int)n-1)
-					values[j] = nsl_smooth_pad_constant_rvalue;
-				else
-					values[j] = data[index];
-				break;
-			case nsl_smooth_pad_periodic:
-				if (index < 0)
-					index = index + (int)n;
-				else if (index > (int)n-1)
-					index = index - (int)n;
-				/*printf(" %d",index);*/
-				values[j] = data[index];
-				break;
-			}
+		/* both ends of the window only move forward */
+		const int first = (int)(i-half), last = (int)(i-half+np-1);
+		if (hi < lo || first > hi) {	/* no overlap with the previous window */
+			for (; lo <= hi; lo++)
+				nsl_smooth_rank_add(tree, size, rank[nsl_smooth_pad_index(lo, n, mode)], -1);
+			lo = first;
+			hi = first - 1;
 		}
-		/*puts("");*/
-
-		/*using type 4 as default */
-		result[i] = nsl_stats_quantile(values, 1, np, percentile, nsl_stats_quantile_type4);
-		free(values);
+		for (; hi < last; hi++)
+			nsl_smooth_rank_add(tree, size, rank[nsl_smooth_pad_index(hi + 1, n, mode)], 1);
+		for (; lo < first; lo++)
+			nsl_smooth_rank_add(tree, size, rank[nsl_smooth_pad_index(lo, n, mode)], -1);
+
+		/* quantile of the sorted window (type 4 as in nsl_stats_quantile_sorted()) */
+#define KTH(k) values[order[nsl_smooth_rank_kth(tree, size, step, k)]]
+		if (percentile < 1./np)
+			result[i] = KTH(0);
+		else if (percentile == 1.0)
+			result[i] = KTH(np-1);
+		else {
+			size_t k = (size_t)floor(np*percentile);
+			const double lower = KTH(k-1);
+			result[i] = lower + (np*percentile-k)*(KTH(GSL_MIN(k, np-1)) - lower);
+		}
+#undef KTH
 	}
 
 	for (i = 0; i < n; i++)
 		data[i] = result[i];
+
+	free(values);
+	free(order);
+	free(rank);
+	free(tree);
 	free(result);
 
 	return 0;
@@ -414,12 +481,7 @@ int nsl_smooth_savgol_coeff(size_t points, int order, gsl_matrix *h) {
 	return error;
 }
 
-void nsl_smooth_pad_constant_set(double lvalue, double rvalue) {
-	nsl_smooth_pad_constant_lvalue = lvalue;
-	nsl_smooth_pad_constant_rvalue = rvalue;
-}
-
-int nsl_smooth_savgol(double *data, size_t n, size_t points, int order, nsl_smooth_pad_mode mode) {
+int nsl_smooth_savgol(double *data, size_t n, size_t points, int order, nsl_smooth_pad_mode mode, double lvalue, double rvalue) {
 	size_t i, k;
 	int error = 0;
 	size_t half = (points-1)/2;	/* n//2 */
@@ -480,7 +542,7 @@ int nsl_smooth_savgol(double *data, size_t n, size_t points, int order, nsl_smoo
 					break;
 				case nsl_smooth_pad_constant:
 					if (k<half-i)
-						result[i] += gsl_matrix_get(h, half, k) * nsl_smooth_pad_constant_lvalue;
+						result[i] += gsl_matrix_get(h, half, k) * lvalue;
 					else
 						result[i] += gsl_matrix_get(h, half, k) * data[i-half+k];
 					break;
@@ -533,7 +595,7 @@ int nsl_smooth_savgol(double *data, size_t n, size_t points, int order, nsl_smoo
 					if (k < n-i+half)
 						result[i] += gsl_matrix_get(h, half, k) * data[i-half+k];
 					else
-						result[i] += gsl_matrix_get(h, half, k) * nsl_smooth_pad_constant_rvalue;
+						result[i] += gsl_matrix_get(h, half, k) * rvalue;
 					break;
 				case nsl_smooth_pad_periodic:
 					result[i] += gsl_matrix_get(h, half, k) * data[(i-half+k) % n];
@@ -553,5 +615,5 @@ int nsl_smooth_savgol(double *data, size_t n, size_t points, int order, nsl_smoo
 }
 
 int nsl_smooth_savgol_default( double *data, size_t n, size_t points, int order) {
-	return nsl_smooth_savgol(data, n, points, order, nsl_smooth_pad_constant);
+	return nsl_smooth_savgol(data, n, points, order, nsl_smooth_pad_constant, 0., 0.);
 }
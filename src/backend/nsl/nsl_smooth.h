@@ -57,19 +57,17 @@ typedef enum {nsl_smooth_weight_uniform, nsl_smooth_weight_triangular, nsl_smoot
 extern const char* nsl_smooth_weight_type_name[];
 /*TODO: IIR: exponential, Gaussian, see nsl_sf_kernel */
 
-/* values used for constant padding */
-extern double nsl_smooth_pad_constant_lvalue, nsl_smooth_pad_constant_rvalue;
-
 /********* Smoothing algorithms **********/
+/* lvalue and rvalue are the values used for constant padding on the left and right side */
 
 /* Moving average */
-int nsl_smooth_moving_average(double *data, size_t n, size_t points, nsl_smooth_weight_type weight, nsl_smooth_pad_mode mode);
+int nsl_smooth_moving_average(double *data, size_t n, size_t points, nsl_smooth_weight_type weight, nsl_smooth_pad_mode mode, double lvalue, double rvalue);
 
 /* Lagged moving average */
-int nsl_smooth_moving_average_lagged(double *data, size_t n, size_t points, nsl_smooth_weight_type weight, nsl_smooth_pad_mode mode);
+int nsl_smooth_moving_average_lagged(double *data, size_t n, size_t points, nsl_smooth_weight_type weight, nsl_smooth_pad_mode mode, double lvalue);
 
-/* Percentile filter */
-int nsl_smooth_percentile(double *data, size_t n, size_t points, double percentile, nsl_smooth_pad_mode mode);
+/* Percentile filter (running quantile of type 4 using a sliding window, O(n log n)) */
+int nsl_smooth_percentile(double *data, size_t n, size_t points, double percentile, nsl_smooth_pad_mode mode, double lvalue, double rvalue);
 
 /* Savitzky-Golay coefficients */
 /**
@@ -88,9 +86,6 @@ int nsl_smooth_percentile(double *data, size_t n, size_t points, double percenti
  */
 int nsl_smooth_savgol_coeff(size_t points, int order, gsl_matrix *h);
 
-/* set values for constant padding */
-void nsl_smooth_pad_constant_set(double lvalue, double rvalue);
-
 /* Savitzky-Golay smoothing */
 /**
  * \brief Savitzky-Golay smoothing of (uniformly distributed) data.
@@ -100,7 +95,7 @@ void nsl_smooth_pad_constant_set(double lvalue, double rvalue);
  * operation can be implemented as a convolution. This is considerably more efficient than a more
  * generic method able to handle non-uniform input data.
  */
-int nsl_smooth_savgol(double *data, size_t n, size_t points, int order, nsl_smooth_pad_mode mode);
+int nsl_smooth_savgol(double *data, size_t n, size_t points, int order, nsl_smooth_pad_mode mode, double lvalue, double rvalue);
 
 /* Savitzky-Golay default smoothing (interp) */
 int nsl_smooth_savgol_default(double *data, size_t n, size_t points, int order);
@@ -1676,6 +1676,35 @@ void CartesianPlot::dataChanged() {
 	}
 }
 
+/*!
+	called by the PlotUpdateScheduler when the data of the curves \c curves was changed.
+	Recalculates only these curves and autoscales the plot once for all of them.
+*/
+void CartesianPlot::curvesDataChanged(const QVector<XYCurve*>& curves) {
+	if (project() && project()->isLoading())
+		return;
+
+	for (auto* curve : curves)
+		curve->recalcLogicalPoints();
+
+	Q_D(CartesianPlot);
+	d->curvesXMinMaxIsDirty = true;
+	d->curvesYMinMaxIsDirty = true;
+	bool updated = false;
+	if (d->autoScaleX && d->autoScaleY)
+		updated = scaleAuto();
+	else if (d->autoScaleX)
+		updated = scaleAutoX();
+	else if (d->autoScaleY)
+		updated = scaleAutoY();
+
+	//the curves were already retransformed if the plot ranges were changed
+	if (!updated) {
+		for (auto* curve : curves)
+			curve->retransform();
+	}
+}
+
 /*!
 	called when in one of the curves the x-data was changed.
 	Autoscales the coordinate system and the x-axes, when "auto-scale" is active.
@@ -105,6 +105,7 @@ public:
 	MouseMode mouseMode() const;
 	void navigate(NavigationOperation);
 	void setSuppressDataChangedSignal(bool);
+	void curvesDataChanged(const QVector<XYCurve*>&);
 	const QList<QColor>& themeColorPalette() const;
 	void processDropEvent(QDropEvent*) override;
 	bool isPanningActive() const;
@@ -0,0 +1,163 @@
+/***************************************************************************
+    File                 : PlotUpdateScheduler.cpp
+    Project              : LabPlot
+    Description          : Coalesces the updates of the plots showing live data
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "backend/worksheet/plots/cartesian/PlotUpdateScheduler.h"
+#include "backend/worksheet/plots/cartesian/CartesianPlot.h"
+#include "backend/worksheet/plots/cartesian/XYCurve.h"
+#include "backend/core/column/Column.h"
+#include "backend/lib/trace.h"
+
+#include <KConfigGroup>
+#include <KSharedConfig>
+
+/*!
+  \class PlotUpdateScheduler
+  \brief Coalesces the updates of the curves and plots caused by new live data.
+
+  The live data sources notify their columns about new data via setChanged(). The curves using
+  these columns don't recalculate their points immediately but are marked as dirty, and all dirty
+  curves are recalculated and repainted in the next frame. The plots are autoscaled once per frame,
+  independent of the number and of the update intervals of the live data sources feeding them.
+  The frame rate is limited to the value configured in the worksheet settings.
+
+  Other consumers of live data, like LiveDataJoin, are notified via the signal dataChanged().
+
+  \ingroup worksheet
+*/
+
+PlotUpdateScheduler* PlotUpdateScheduler::instance() {
+	static PlotUpdateScheduler scheduler;
+	return &scheduler;
+}
+
+PlotUpdateScheduler::PlotUpdateScheduler() {
+	m_timer.setSingleShot(true);
+	connect(&m_timer, &QTimer::timeout, this, &PlotUpdateScheduler::update);
+
+	const KConfigGroup group = KSharedConfig::openConfig()->group(QLatin1String("Settings_Worksheet"));
+	setMaxFrameRate(group.readEntry(QLatin1String("MaxFrameRate"), 30));
+}
+
+/*!
+ * sets the maximal number of plot updates per second.
+ */
+void PlotUpdateScheduler::setMaxFrameRate(int fps) {
+	m_frameInterval = 1000 / qMax(fps, 1);
+}
+
+int PlotUpdateScheduler::maxFrameRate() const {
+	return 1000 / qMax(m_frameInterval, 1);
+}
+
+/*!
+ * notifies the columns \c columns about the changes of their data. The curves and plots
+ * using these columns are not updated immediately but in the next frame.
+ * The signal dataChanged() is emitted afterwards.
+ */
+void PlotUpdateScheduler::setChanged(const QVector<Column*>& columns) {
+	QVector<CartesianPlot*> plots;
+	for (auto* column : columns)
+		column->addUsedInPlots(plots);
+
+	//suppress the updates of the plots triggered by the curves
+	for (auto* plot : plots)
+		plot->setSuppressDataChangedSignal(true);
+
+	m_deferring = true;
+	for (auto* column : columns)
+		column->setChanged();
+	m_deferring = false;
+
+	for (auto* plot : plots)
+		plot->setSuppressDataChangedSignal(false);
+
+	emit dataChanged(columns);
+}
+
+/*!
+ * called by the curve \c curve when its data was changed. Returns \c true if the update
+ * of the curve is postponed to the next frame, \c false if the curve has to be updated now.
+ */
+bool PlotUpdateScheduler::scheduleUpdate(XYCurve* curve) {
+	if (!m_deferring)
+		return false;
+
+	if (!m_curves.contains(curve))
+		m_curves << curve;
+
+	if (!m_timer.isActive()) {
+		const qint64 elapsed = m_lastFrame.isValid() ? m_lastFrame.elapsed() : m_frameInterval;
+		m_timer.start(qMax(0, m_frameInterval - (int)qMin(elapsed, (qint64)m_frameInterval)));
+	}
+
+	return true;
+}
+
+/*!
+ * returns \c true while the columns passed to setChanged() are notified about their new data.
+ * The live data sources only append rows to the columns or remove the first rows via Column::evictRows(),
+ * the analysis curves use this to process the new rows only.
+ */
+bool PlotUpdateScheduler::isUpdating() const {
+	return m_deferring;
+}
+
+/*!
+ * recalculates all curves marked as dirty since the last frame and updates their plots.
+ */
+void PlotUpdateScheduler::update() {
+	PERFTRACE("PlotUpdateScheduler::update()");
+	m_lastFrame.start();
+
+	const auto dirtyCurves = m_curves;
+	m_curves.clear();
+
+	//group the curves by their plots
+	QVector<CartesianPlot*> plots;
+	QVector<QVector<XYCurve*>> plotCurves;
+	for (const auto& curve : dirtyCurves) {
+		if (!curve)
+			continue;
+
+		auto* plot = dynamic_cast<CartesianPlot*>(curve->parentAspect());
+		if (!plot) {
+			curve->recalcLogicalPoints();
+			continue;
+		}
+
+		const int index = plots.indexOf(plot);
+		if (index == -1) {
+			plots << plot;
+			plotCurves << (QVector<XYCurve*>() << curve);
+		} else
+			plotCurves[index] << curve;
+	}
+
+	for (int i = 0; i < plots.size(); ++i)
+		plots.at(i)->curvesDataChanged(plotCurves.at(i));
+}
@@ -0,0 +1,68 @@
+/***************************************************************************
+    File                 : PlotUpdateScheduler.h
+    Project              : LabPlot
+    Description          : Coalesces the updates of the plots showing live data
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef PLOTUPDATESCHEDULER_H
+#define PLOTUPDATESCHEDULER_H
+
+#include <QElapsedTimer>
+#include <QPointer>
+#include <QTimer>
+#include <QVector>
+
+class Column;
+class XYCurve;
+
+class PlotUpdateScheduler : public QObject {
+	Q_OBJECT
+
+public:
+	static PlotUpdateScheduler* instance();
+
+	void setChanged(const QVector<Column*>&);
+	bool scheduleUpdate(XYCurve*);
+	bool isUpdating() const;
+
+	void setMaxFrameRate(int);
+	int maxFrameRate() const;
+
+signals:
+	void dataChanged(const QVector<Column*>&);
+
+private:
+	PlotUpdateScheduler();
+
+	QTimer m_timer;
+	QElapsedTimer m_lastFrame;
+	int m_frameInterval{33};	//min. time between two updates in ms
+	bool m_deferring{false};
+	QVector<QPointer<XYCurve>> m_curves;	//curves to be updated in the next frame
+
+private slots:
+	void update();
+};
+
+#endif
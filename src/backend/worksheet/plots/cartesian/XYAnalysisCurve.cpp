@@ -31,16 +31,36 @@
   \class XYAnalysisCurve
   \brief Base class for all analysis curves
 
+  If the asynchronous recalculation is enabled (see setAsyncRecalculation()), the results are calculated
+  in a worker thread on a copy of the source data. The results are written to the result columns in
+  the GUI thread once the calculation is finished. A running recalculation can be canceled, it's
+  discarded and restarted if the source data is changed in the meantime.
+
+  In the incremental mode (see setIncrementalRecalculation()) the results are kept up to date with the
+  source data. Rows appended to the source columns by live data sources are processed without recalculating
+  the results of the previous rows, if the analysis allows it. All other changes of the source data cause
+  a full recalculation.
+
   \ingroup worksheet
 */
 
 #include "XYAnalysisCurve.h"
 #include "XYAnalysisCurvePrivate.h"
+#include "PlotUpdateScheduler.h"
 #include "backend/core/column/Column.h"
 #include "backend/lib/commandtemplates.h"
 #include "backend/lib/macros.h"
 
 #include <KLocalizedString>
+#include <QFutureWatcher>
+#include <QSemaphore>
+#include <QThreadPool>
+#include <QTimer>
+#include <QtConcurrentRun>
+
+#include <cmath>
+
+static bool asyncRecalc = false;
 
 XYAnalysisCurve::XYAnalysisCurve(const QString& name, AspectType type)
 	: XYCurve(name, new XYAnalysisCurvePrivate(this), type) {
@@ -64,10 +84,28 @@ void XYAnalysisCurve::init() {
 	d->symbolsStyle = Symbol::NoSymbols;
 }
 
+/*!
+ * enables or disables the recalculation of the analysis curves in a worker thread.
+ * Disabled by default, the curves are recalculated synchronously then.
+ */
+void XYAnalysisCurve::setAsyncRecalculation(bool async) {
+	asyncRecalc = async;
+}
+
+bool XYAnalysisCurve::asyncRecalculation() {
+	return asyncRecalc;
+}
+
 //##############################################################################
 //##########################  getter methods  ##################################
 //##############################################################################
+bool XYAnalysisCurve::isRecalculating() const {
+	Q_D(const XYAnalysisCurve);
+	return d->job != nullptr;
+}
+
 BASIC_SHARED_D_READER_IMPL(XYAnalysisCurve, XYAnalysisCurve::DataSourceType, dataSourceType, dataSourceType)
+BASIC_SHARED_D_READER_IMPL(XYAnalysisCurve, bool, incrementalRecalculation, incrementalRecalculation)
 BASIC_SHARED_D_READER_IMPL(XYAnalysisCurve, const XYCurve*, dataSourceCurve, dataSourceCurve)
 const QString& XYAnalysisCurve::dataSourceCurvePath() const {
 	return d_ptr->dataSourceCurvePath;
@@ -90,6 +128,20 @@ void XYAnalysisCurve::setDataSourceType(DataSourceType type) {
 		exec(new XYAnalysisCurveSetDataSourceTypeCmd(d, type, ki18n("%1: data source type changed")));
 }
 
+STD_SETTER_CMD_IMPL_S(XYAnalysisCurve, SetIncrementalRecalculation, bool, incrementalRecalculation)
+/*!
+ * enables or disables the incremental mode: the results are recalculated on every change of the source data,
+ * for the rows appended to the source columns by live data sources only the new rows are processed.
+ * If the live data source keeps only the last N values (sliding window), rows are removed on every update
+ * and the curve is recalculated completely, see XYAnalysisCurvePrivate::appendedRows().
+ * Disabled by default, the curve is recalculated on request only.
+ */
+void XYAnalysisCurve::setIncrementalRecalculation(bool incremental) {
+	Q_D(XYAnalysisCurve);
+	if (incremental != d->incrementalRecalculation)
+		exec(new XYAnalysisCurveSetIncrementalRecalculationCmd(d, incremental, ki18n("%1: incremental recalculation changed")));
+}
+
 STD_SETTER_CMD_IMPL_F_S(XYAnalysisCurve, SetDataSourceCurve, const XYCurve*, dataSourceCurve, retransform)
 void XYAnalysisCurve::setDataSourceCurve(const XYCurve* curve) {
 	Q_D(XYAnalysisCurve);
@@ -187,8 +239,39 @@ void XYAnalysisCurve::setY2DataColumnPath(const QString& path) {
 //##############################################################################
 void XYAnalysisCurve::handleSourceDataChanged() {
 	Q_D(XYAnalysisCurve);
+
+	if (d->incrementalRecalculation) {
+		//new live data, only the appended rows are processed.
+		//The results of a running recalculation are extended with the new rows once they're available.
+		if (PlotUpdateScheduler::instance()->isUpdating() && (d->job || d->recalculateIncrementally()))
+			return;
+
+		//the new rows are processed once their values are available
+		if (!d->job && d->emptyRowsAppended())
+			return;
+	}
+
 	d->sourceDataChangedSinceLastRecalc = true;
 	emit sourceDataChanged();
+
+	//the running recalculation uses outdated data. It's not restarted, for fast changing live data
+	//it would never finish. The recalculation is repeated once with the current data after it has finished.
+	if (d->job) {
+		d->recalculationPending = true;
+		return;
+	}
+
+	//in the incremental mode the results are always kept up to date
+	if (d->incrementalRecalculation)
+		recalculate();
+}
+
+/*!
+ * cancels the running recalculation, the previous results are kept.
+ */
+void XYAnalysisCurve::cancelRecalculation() {
+	Q_D(XYAnalysisCurve);
+	d->cancelJob();
 }
 
 void XYAnalysisCurve::xDataColumnAboutToBeRemoved(const AbstractAspect* aspect) {
@@ -240,6 +323,231 @@ XYAnalysisCurvePrivate::XYAnalysisCurvePrivate(XYAnalysisCurve* owner) : XYCurve
 //when the parent aspect is removed
 XYAnalysisCurvePrivate::~XYAnalysisCurvePrivate() = default;
 
+/*!
+ * runs \c compute on the data of the job \c job and \c publish afterwards to write the results of the job to the curve.
+ * If the asynchronous recalculation is enabled and \c async is \c true, \c compute is called in a worker thread
+ * and must not access the curve, \c publish is always called in the GUI thread.
+ * A running recalculation is superseded by the new one, its results are discarded.
+ * Changes of the source data during an asynchronous recalculation are handled by one more recalculation
+ * once the running one has finished, see XYAnalysisCurve::handleSourceDataChanged().
+ */
+void XYAnalysisCurvePrivate::runJob(const std::shared_ptr<XYAnalysisJob>& job, const std::function<void(XYAnalysisJob&)>& compute,
+				const std::function<void(XYAnalysisJob&)>& publish, bool async) {
+	cancelJob();
+	emit q->recalculationStarted();
+
+	if (!async || !XYAnalysisCurve::asyncRecalculation()) {
+		compute(*job);
+		publish(*job);
+		sourceDataChangedSinceLastRecalc = false;
+		emit q->recalculationFinished();
+		return;
+	}
+
+	this->job = job;
+	auto* watcher = new QFutureWatcher<void>(q);
+	auto* timer = new QTimer(watcher);
+	QObject::connect(timer, &QTimer::timeout, q, [this, job]() {
+		emit q->recalculationProgress(job->progress);
+	});
+	QObject::connect(watcher, &QFutureWatcher<void>::finished, q, [this, job, publish, watcher]() {
+		watcher->deleteLater();
+		if (job != this->job)	// canceled or superseded by a newer recalculation
+			return;
+
+		this->job.reset();
+		publish(*job);
+		const bool pending = recalculationPending;
+		recalculationPending = false;
+		sourceDataChangedSinceLastRecalc = pending;
+		emit q->recalculationFinished();
+
+		//process the rows appended to the source data during the recalculation,
+		//recalculate completely if this is not possible and the source data was changed
+		if (incrementalRecalculation && recalculateIncrementally())
+			return;
+		if (pending)
+			q->recalculate();
+	});
+	//stop the computation if the curve is deleted
+	QObject::connect(watcher, &QObject::destroyed, [job]() {
+		job->canceled = true;
+	});
+
+	timer->start(100);
+	watcher->setFuture(QtConcurrent::run([job, compute]() {
+		compute(*job);
+	}));
+}
+
+/*!
+ * cancels the running recalculation, its results are discarded.
+ */
+void XYAnalysisCurvePrivate::cancelJob() {
+	recalculationPending = false;
+	if (!job)
+		return;
+
+	job->canceled = true;
+	job.reset();
+	emit q->recalculationFinished();
+}
+
+/*!
+ * extends the results by the results for the rows appended to the source data since the last recalculation.
+ * Returns \c false if this is not possible, the curve has to be recalculated completely then.
+ * Not supported by default.
+ */
+bool XYAnalysisCurvePrivate::recalculateIncrementally() {
+	return false;
+}
+
+/*!
+ * determines the columns with the source data, either the spreadsheet columns or the columns of the source curve.
+ */
+void XYAnalysisCurvePrivate::sourceColumns(const AbstractColumn*& x, const AbstractColumn*& y) const {
+	if (dataSourceType == XYAnalysisCurve::DataSourceSpreadsheet) {
+		x = xDataColumn;
+		y = yDataColumn;
+	} else if (dataSourceCurve) {
+		x = dataSourceCurve->xColumn();
+		y = dataSourceCurve->yColumn();
+	} else {
+		x = nullptr;
+		y = nullptr;
+	}
+}
+
+/*!
+ * returns the current state of the source columns \c x and \c y, to be stored in \c processedSource
+ * once the results for all their rows are available.
+ */
+XYAnalysisSource XYAnalysisCurvePrivate::currentSource(const AbstractColumn* x, const AbstractColumn* y) {
+	XYAnalysisSource source;
+	if (!x || !y)
+		return source;
+
+	source.xColumn = x;
+	source.yColumn = y;
+	source.xRows = x->rowCount();
+	source.yRows = y->rowCount();
+	source.rows = qMin(source.xRows, source.yRows);
+	const auto* column = dynamic_cast<const Column*>(x);
+	if (column)
+		source.xEvictedRows = column->evictedRows();
+	column = dynamic_cast<const Column*>(y);
+	if (column)
+		source.yEvictedRows = column->evictedRows();
+	if (source.rows > 0) {
+		source.lastX = x->valueAt(source.rows - 1);
+		source.lastY = y->valueAt(source.rows - 1);
+	}
+
+	return source;
+}
+
+static bool sameValue(double a, double b) {
+	return a == b || (std::isnan(a) && std::isnan(b));
+}
+
+/*!
+ * returns \c true if the source data \c source only differs from the processed source data by the appended rows.
+ * The rows in the middle of the columns are not checked, they're expected to be unchanged while appending live data.
+ *
+ * Rows removed at the beginning of the columns are not supported. This is always the case for live data sources
+ * keeping only the last N values. The results of the removed rows would have to be dropped and the first results
+ * recalculated with the padding at the new beginning (smoothing) or relative to the new first point (integration).
+ * The curve is recalculated completely instead, which is bounded by the N values kept.
+ */
+bool XYAnalysisCurvePrivate::appendedRows(const XYAnalysisSource& source) const {
+	if (!processedSource.xColumn || source.xColumn != processedSource.xColumn || source.yColumn != processedSource.yColumn)
+		return false;
+
+	//removed rows shift all rows of the columns. Sliding windows end up here on every update, see above.
+	if (source.xEvictedRows != processedSource.xEvictedRows || source.yEvictedRows != processedSource.yEvictedRows
+			|| source.rows < processedSource.rows)
+		return false;
+
+	if (processedSource.rows == 0)
+		return true;
+
+	const int row = processedSource.rows - 1;
+	return sameValue(source.xColumn->valueAt(row), processedSource.lastX)
+		&& sameValue(source.yColumn->valueAt(row), processedSource.lastY);
+}
+
+/*!
+ * returns \c true if only empty rows were appended to the source columns since the last recalculation.
+ * The live data sources append the rows first and write the new values to them afterwards.
+ */
+bool XYAnalysisCurvePrivate::emptyRowsAppended() const {
+	const AbstractColumn* x = nullptr;
+	const AbstractColumn* y = nullptr;
+	sourceColumns(x, y);
+	const XYAnalysisSource source = currentSource(x, y);
+	if (!appendedRows(source) || (source.xRows <= processedSource.xRows && source.yRows <= processedSource.yRows))
+		return false;
+
+	for (int row = processedSource.xRows; row < source.xRows; ++row)
+		if (!std::isnan(x->valueAt(row)))
+			return false;
+	for (int row = processedSource.yRows; row < source.yRows; ++row)
+		if (!std::isnan(y->valueAt(row)))
+			return false;
+
+	return true;
+}
+
+// evaluates a block of rows in a thread of the pool used by XYAnalysisCurvePrivate::evaluateRanges()
+class XYAnalysisRangeTask : public QRunnable {
+public:
+	XYAnalysisRangeTask(size_t begin, size_t end, const std::function<void(size_t, size_t)>& evaluate, QSemaphore* done) :
+		m_begin(begin),
+		m_end(end),
+		m_evaluate(evaluate),
+		m_done(done)
+		{};
+
+	void run() override {
+		m_evaluate(m_begin, m_end);
+		m_done->release();
+	}
+
+private:
+	size_t m_begin;
+	size_t m_end;
+	const std::function<void(size_t, size_t)>& m_evaluate;
+	QSemaphore* m_done;
+};
+
+/*!
+ * calls \c evaluate(begin, end) for contiguous blocks of the \c n rows, in parallel if \c parallel is \c true.
+ * Blocks have at least \c minBlockSize rows, small calculations are done in the calling thread only.
+ * Every row is calculated independently of the other rows, so the results don't depend on the number of threads.
+ */
+void XYAnalysisCurvePrivate::evaluateRanges(size_t n, bool parallel, const std::function<void(size_t, size_t)>& evaluate,
+		size_t minBlockSize) {
+	// separate pool, the recalculations themselves run in threads of the global pool
+	static QThreadPool pool;
+
+	const size_t threads = parallel ? (size_t)qMax(pool.maxThreadCount(), 1) : 1;
+	const size_t blockSize = qMax(qMax(minBlockSize, (size_t)1), (n + threads - 1)/threads);
+	if (!parallel || n <= blockSize) {
+		evaluate(0, n);
+		return;
+	}
+
+	// the first block is evaluated in the calling thread
+	QSemaphore done;
+	int tasks = 0;
+	for (size_t begin = blockSize; begin < n; begin += blockSize) {
+		pool.start(new XYAnalysisRangeTask(begin, qMin(begin + blockSize, n), evaluate, &done));
+		++tasks;
+	}
+	evaluate(0, blockSize);
+	done.acquire(tasks);
+}
+
 //##############################################################################
 //##################  Serialization/Deserialization  ###########################
 //##############################################################################
@@ -261,6 +569,10 @@ void XYAnalysisCurve::save(QXmlStreamWriter* writer) const {
 	WRITE_COLUMN(d->y2DataColumn, y2DataColumn);
 	writer->writeEndElement();
 
+	writer->writeStartElement("recalculation");
+	writer->writeAttribute( "incremental", QString::number(d->incrementalRecalculation) );
+	writer->writeEndElement();
+
 	writer->writeEndElement(); //"xyAnalysisCurve"
 }
 
@@ -290,6 +602,9 @@ bool XYAnalysisCurve::load(XmlStreamReader* reader, bool preview) {
 			READ_COLUMN(xDataColumn);
 			READ_COLUMN(yDataColumn);
 			READ_COLUMN(y2DataColumn);
+		} else if (reader->name() == "recalculation") {
+			attribs = reader->attributes();
+			READ_INT_VALUE("incremental", incrementalRecalculation, bool);
 		}
 	}
 
@@ -44,10 +44,14 @@ public:
 	~XYAnalysisCurve() override;
 
 	virtual void recalculate() = 0;
+	bool isRecalculating() const;
+	static void setAsyncRecalculation(bool);
+	static bool asyncRecalculation();
 	void save(QXmlStreamWriter*) const override;
 	bool load(XmlStreamReader*, bool preview) override;
 
 	BASIC_D_ACCESSOR_DECL(DataSourceType, dataSourceType, DataSourceType)
+	BASIC_D_ACCESSOR_DECL(bool, incrementalRecalculation, IncrementalRecalculation)
 	POINTER_D_ACCESSOR_DECL(const XYCurve, dataSourceCurve, DataSourceCurve)
 	const QString& dataSourceCurvePath() const;
 
@@ -69,6 +73,7 @@ private:
 
 public slots:
 	void handleSourceDataChanged();
+	void cancelRecalculation();
 private slots:
 	void xDataColumnAboutToBeRemoved(const AbstractAspect*);
 	void yDataColumnAboutToBeRemoved(const AbstractAspect*);
@@ -80,10 +85,14 @@ private slots:
 signals:
 	void sourceDataChanged(); //emitted when the source data used in the analysis curves was changed to enable the recalculation in the dock widgets
 	void dataSourceTypeChanged(XYAnalysisCurve::DataSourceType);
+	void incrementalRecalculationChanged(bool);
 	void dataSourceCurveChanged(const XYCurve*);
 	void xDataColumnChanged(const AbstractColumn*);
 	void yDataColumnChanged(const AbstractColumn*);
 	void y2DataColumnChanged(const AbstractColumn*);
+	void recalculationStarted();
+	void recalculationProgress(int);	//progress of an asynchronous recalculation in percent
+	void recalculationFinished();	//emitted when the results of the recalculation are available or the recalculation was canceled
 };
 
 #endif
@@ -31,15 +31,65 @@
 
 #include "backend/worksheet/plots/cartesian/XYCurvePrivate.h"
 
+#include <atomic>
+#include <functional>
+#include <memory>
+
 class XYAnalysisCurve;
 class Column;
 class AbstractColumn;
 
+/*!
+ * state of a recalculation of an analysis curve, shared between the curve and the worker thread.
+ * The computation only works on the data stored in the job, it doesn't access the curve.
+ */
+class XYAnalysisJob {
+public:
+	bool isCanceled() const { return canceled; }
+	void setProgress(int percent) { progress = percent; }
+
+	QVector<double> x;	//<! copy of the source x-data, replaced by the x-values of the result
+	QVector<double> y;	//<! copy of the source y-data, replaced by the y-values of the result
+	QVector<double> y2;	//<! copy of the optional second source y-data
+	int status{0};
+
+	std::atomic<bool> canceled{false};
+	std::atomic<int> progress{0};	//<! progress in percent
+};
+
+/*!
+ * rows of the source columns processed in the last recalculation, used to determine the rows appended since then.
+ */
+struct XYAnalysisSource {
+	const AbstractColumn* xColumn{nullptr};	//<! nullptr if the results don't correspond to the source data
+	const AbstractColumn* yColumn{nullptr};
+	int rows{0};	//<! number of processed rows
+	int xRows{0};	//<! number of rows of the x-column
+	int yRows{0};	//<! number of rows of the y-column
+	qint64 xEvictedRows{0};
+	qint64 yEvictedRows{0};
+	double lastX{0.};	//<! values of the last processed row
+	double lastY{0.};
+};
+
 class XYAnalysisCurvePrivate : public XYCurvePrivate {
 public:
 	explicit XYAnalysisCurvePrivate(XYAnalysisCurve*);
 	~XYAnalysisCurvePrivate() override;
 
+	void runJob(const std::shared_ptr<XYAnalysisJob>&, const std::function<void(XYAnalysisJob&)>& compute,
+				const std::function<void(XYAnalysisJob&)>& publish, bool async = true);
+	void cancelJob();
+
+	virtual bool recalculateIncrementally();
+	void sourceColumns(const AbstractColumn*& x, const AbstractColumn*& y) const;
+	static XYAnalysisSource currentSource(const AbstractColumn* x, const AbstractColumn* y);
+	bool appendedRows(const XYAnalysisSource&) const;
+	bool emptyRowsAppended() const;
+
+	static void evaluateRanges(size_t n, bool parallel, const std::function<void(size_t, size_t)>& evaluate,
+				size_t minBlockSize = 4096);
+
 	XYAnalysisCurve::DataSourceType dataSourceType{XYAnalysisCurve::DataSourceSpreadsheet};
 	const XYCurve* dataSourceCurve{nullptr};
 
@@ -55,6 +105,11 @@ public:
 	QVector<double>* xVector{nullptr};
 	QVector<double>* yVector{nullptr};
 
+	std::shared_ptr<XYAnalysisJob> job; //<! running recalculation, nullptr if there is none
+	bool recalculationPending{false}; //<! the source data was changed during the running recalculation
+	bool incrementalRecalculation{false};
+	XYAnalysisSource processedSource; //<! source data the current results were calculated from
+
 	XYAnalysisCurve* const q;
 };
 
@@ -105,6 +105,9 @@ void XYConvolutionCurvePrivate::recalculate() {
 	QElapsedTimer timer;
 	timer.start();
 
+	//a running recalculation is superseded by this one
+	cancelJob();
+
 	//create convolution result columns if not available yet, clear them otherwise
 	if (!xColumn) {
 		xColumn = new Column("x", AbstractColumn::Numeric);
@@ -211,10 +214,6 @@ void XYConvolutionCurvePrivate::recalculate() {
 		return;
 	}
 
-	double* xdata = xdataVector.data();
-	double* ydata = ydataVector.data();
-	double* y2data = y2dataVector.data();
-
 	// convolution settings
 	const double samplingInterval = convolutionData.samplingInterval;
 	const nsl_conv_direction_type direction = convolutionData.direction;
@@ -222,6 +221,7 @@ void XYConvolutionCurvePrivate::recalculate() {
 	const nsl_conv_method_type method = convolutionData.method;
 	const nsl_conv_norm_type norm = convolutionData.normalize;
 	const nsl_conv_wrap_type wrap = convolutionData.wrap;
+	const bool hasX = (tmpXDataColumn != nullptr);
 
 	DEBUG("signal n = " << n << ", response m = " << m);
 	DEBUG("sampling interval = " << samplingInterval);
@@ -231,49 +231,58 @@ void XYConvolutionCurvePrivate::recalculate() {
 	DEBUG("norm = " << nsl_conv_norm_name[norm]);
 	DEBUG("wrap = " << nsl_conv_wrap_name[wrap]);
 
-///////////////////////////////////////////////////////////
-	size_t np;
-	if (type == nsl_conv_type_linear)
-		np = n + m - 1;
-	else
-		np = GSL_MAX(n, m);
+	auto job = std::make_shared<XYAnalysisJob>();
+	job->x.swap(xdataVector);
+	job->y.swap(ydataVector);
+	job->y2.swap(y2dataVector);
 
-	double* out = (double*)malloc(np * sizeof(double));
-	int status = nsl_conv_convolution_direction(ydata, n, y2data, m, direction, type, method, norm, wrap, out);
-
-	if (direction == nsl_conv_direction_backward)
+	runJob(job, [=](XYAnalysisJob& job) {
+///////////////////////////////////////////////////////////
+		size_t np;
 		if (type == nsl_conv_type_linear)
-			np = abs((int)(n - m)) + 1;
-
-	xVector->resize((int)np);
-	yVector->resize((int)np);
-	// take given x-axis values or use index
-	if (tmpXDataColumn != nullptr) {
-		int size = GSL_MIN(xdataVector.size(), (int)np);
-		memcpy(xVector->data(), xdata, size * sizeof(double));
-		double sampleInterval = (xVector->data()[size-1] - xVector->data()[0])/(xdataVector.size()-1);
-		DEBUG("xdata size = " << xdataVector.size() << ", np = " << np << ", sample interval = " << sampleInterval);
-		for (int i = size; i < (int)np; i++)	// fill missing values
-			xVector->data()[i] = xVector->data()[size-1] + (i-size+1) * sampleInterval;
-	} else {	// fill with index (starting with 0)
-		for (size_t i = 0; i < np; i++)
-			xVector->data()[i] = i * samplingInterval;
-	}
+			np = n + m - 1;
+		else
+			np = GSL_MAX(n, m);
+
+		QVector<double> out((int)np);
+		job.status = nsl_conv_convolution_direction(job.y.data(), n, job.y2.data(), m, direction, type, method, norm, wrap, out.data());
+
+		if (direction == nsl_conv_direction_backward)
+			if (type == nsl_conv_type_linear)
+				np = abs((int)(n - m)) + 1;
+		out.resize((int)np);
+
+		// take given x-axis values or use index
+		QVector<double> x((int)np);
+		if (hasX) {
+			int size = GSL_MIN(job.x.size(), (int)np);
+			memcpy(x.data(), job.x.constData(), size * sizeof(double));
+			double sampleInterval = (x.at(size-1) - x.at(0))/(job.x.size()-1);
+			DEBUG("xdata size = " << job.x.size() << ", np = " << np << ", sample interval = " << sampleInterval);
+			for (int i = size; i < (int)np; i++)	// fill missing values
+				x[i] = x.at(size-1) + (i-size+1) * sampleInterval;
+		} else {	// fill with index (starting with 0)
+			for (size_t i = 0; i < np; i++)
+				x[(int)i] = i * samplingInterval;
+		}
 
-	memcpy(yVector->data(), out, np * sizeof(double));
-	free(out);
+		job.x.swap(x);
+		job.y.swap(out);
 ///////////////////////////////////////////////////////////
+	}, [=](XYAnalysisJob& job) {
+		*xVector = job.x;
+		*yVector = job.y;
 
-	//write the result
-	convolutionResult.available = true;
-	convolutionResult.valid = true;
-	convolutionResult.status = QString::number(status);
-	convolutionResult.elapsedTime = timer.elapsed();
+		//write the result
+		convolutionResult.available = true;
+		convolutionResult.valid = true;
+		convolutionResult.status = QString::number(job.status);
+		convolutionResult.elapsedTime = timer.elapsed();
 
-	//redraw the curve
-	recalcLogicalPoints();
-	emit q->dataChanged();
-	sourceDataChangedSinceLastRecalc = false;
+		//redraw the curve
+		recalcLogicalPoints();
+		emit q->dataChanged();
+	});
 }
 
 //##############################################################################
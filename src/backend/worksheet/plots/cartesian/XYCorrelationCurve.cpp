@@ -106,6 +106,9 @@ void XYCorrelationCurvePrivate::recalculate() {
 	QElapsedTimer timer;
 	timer.start();
 
+	//a running recalculation is superseded by this one
+	cancelJob();
+
 	//create correlation result columns if not available yet, clear them otherwise
 	if (!xColumn) {
 		xColumn = new Column("x", AbstractColumn::Numeric);
@@ -202,61 +205,66 @@ void XYCorrelationCurvePrivate::recalculate() {
 		return;
 	}
 
-	double* xdata = xdataVector.data();
-	double* ydata = ydataVector.data();
-	double* y2data = y2dataVector.data();
-
 	// correlation settings
 	const double samplingInterval = correlationData.samplingInterval;
 	const nsl_corr_type_type type = correlationData.type;
 	const nsl_corr_norm_type norm = correlationData.normalize;
+	const bool hasX = (tmpXDataColumn != nullptr);
 
 	DEBUG("signal_1 n = " << n << ", signal_2 n = " << m);
 	DEBUG("sampling interval = " << samplingInterval);
 	DEBUG("type = " << nsl_corr_type_name[type]);
 	DEBUG("norm = " << nsl_corr_norm_name[norm]);
 
+	auto job = std::make_shared<XYAnalysisJob>();
+	job->x.swap(xdataVector);
+	job->y.swap(ydataVector);
+	job->y2.swap(y2dataVector);
+
+	runJob(job, [=](XYAnalysisJob& job) {
 ///////////////////////////////////////////////////////////
-	size_t np = GSL_MAX(n, m);
-	if (type == nsl_corr_type_linear)
-		np = 2 * np - 1;
-
-	double* out = (double*)malloc(np * sizeof(double));
-	int status = nsl_corr_correlation(ydata, n, y2data, m, type, norm, out);
-
-	xVector->resize((int)np);
-	yVector->resize((int)np);
-	// take given x-axis values or use index
-	if (tmpXDataColumn != nullptr) {
-		int size = GSL_MIN(xdataVector.size(), (int)np);
-		memcpy(xVector->data(), xdata, size * sizeof(double));
-		double sampleInterval = (xVector->data()[size-1] - xVector->data()[0])/(xdataVector.size()-1);
-		DEBUG("xdata size = " << xdataVector.size() << ", np = " << np << ", sample interval = " << sampleInterval);
-		for (int i = size; i < (int)np; i++)	// fill missing values
-			xVector->data()[i] = xVector->data()[size-1] + (i-size+1) * sampleInterval;
-	} else {	// fill with index (starting with 0)
+		size_t np = GSL_MAX(n, m);
 		if (type == nsl_corr_type_linear)
-			for (size_t i = 0; i < np; i++)
-				xVector->data()[i] = (int)(i-np/2) * samplingInterval;
-		else
-			for (size_t i = 0; i < np; i++)
-				xVector->data()[i] = (int)i * samplingInterval;
-	}
+			np = 2 * np - 1;
+
+		QVector<double> out((int)np);
+		job.status = nsl_corr_correlation(job.y.data(), n, job.y2.data(), m, type, norm, out.data());
+
+		// take given x-axis values or use index
+		QVector<double> x((int)np);
+		if (hasX) {
+			int size = GSL_MIN(job.x.size(), (int)np);
+			memcpy(x.data(), job.x.constData(), size * sizeof(double));
+			double sampleInterval = (x.at(size-1) - x.at(0))/(job.x.size()-1);
+			DEBUG("xdata size = " << job.x.size() << ", np = " << np << ", sample interval = " << sampleInterval);
+			for (int i = size; i < (int)np; i++)	// fill missing values
+				x[i] = x.at(size-1) + (i-size+1) * sampleInterval;
+		} else {	// fill with index (starting with 0)
+			if (type == nsl_corr_type_linear)
+				for (size_t i = 0; i < np; i++)
+					x[(int)i] = (int)(i-np/2) * samplingInterval;
+			else
+				for (size_t i = 0; i < np; i++)
+					x[(int)i] = (int)i * samplingInterval;
+		}
 
-	memcpy(yVector->data(), out, np * sizeof(double));
-	free(out);
+		job.x.swap(x);
+		job.y.swap(out);
 ///////////////////////////////////////////////////////////
+	}, [=](XYAnalysisJob& job) {
+		*xVector = job.x;
+		*yVector = job.y;
 
-	//write the result
-	correlationResult.available = true;
-	correlationResult.valid = true;
-	correlationResult.status = QString::number(status);
-	correlationResult.elapsedTime = timer.elapsed();
+		//write the result
+		correlationResult.available = true;
+		correlationResult.valid = true;
+		correlationResult.status = QString::number(job.status);
+		correlationResult.elapsedTime = timer.elapsed();
 
-	//redraw the curve
-	recalcLogicalPoints();
-	emit q->dataChanged();
-	sourceDataChangedSinceLastRecalc = false;
+		//redraw the curve
+		recalcLogicalPoints();
+		emit q->dataChanged();
+	});
 }
 
 //##############################################################################
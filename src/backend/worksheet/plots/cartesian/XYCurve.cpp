@@ -37,8 +37,10 @@
 #include "XYCurve.h"
 #include "XYCurvePrivate.h"
 #include "backend/core/column/Column.h"
+#include "backend/core/column/ColumnHistory.h"
 #include "backend/worksheet/plots/cartesian/CartesianCoordinateSystem.h"
 #include "backend/worksheet/plots/cartesian/CartesianPlot.h"
+#include "backend/worksheet/plots/cartesian/PlotUpdateScheduler.h"
 #include "backend/lib/commandtemplates.h"
 #include "backend/core/Project.h"
 #include "backend/spreadsheet/Spreadsheet.h"
@@ -718,6 +720,10 @@ void XYCurve::retransform() {
 }
 
 void XYCurve::recalcLogicalPoints() {
+	//new live data, the curve is recalculated in the next frame
+	if (PlotUpdateScheduler::instance()->scheduleUpdate(this))
+		return;
+
 	Q_D(XYCurve);
 	d->recalcLogicalPoints();
 }
@@ -1064,6 +1070,34 @@ void XYCurvePrivate::recalcLogicalPoints() {
 	AbstractColumn::ColumnMode yColMode = yColumn->columnMode();
 	QPointF tempPoint;
 
+	//live data: the values moved from the columns to the on-disk history are shown via their min/max summary
+	const auto* xCol = dynamic_cast<const Column*>(xColumn);
+	const auto* yCol = dynamic_cast<const Column*>(yColumn);
+	const ColumnHistory* xHistory = xCol ? xCol->history() : nullptr;
+	const ColumnHistory* yHistory = yCol ? yCol->history() : nullptr;
+	if (xHistory && yHistory && xHistory->rowCount() > 0 && xHistory->rowCount() == yHistory->rowCount()) {
+		const int historyBins = 2000;	//enough for the resolution of the screen
+		const auto xBins = xHistory->summary(historyBins);
+		const auto yBins = yHistory->summary(historyBins);
+		for (int i = 0; i < qMin(xBins.size(), yBins.size()); ++i) {
+			const auto& xBin = xBins.at(i);
+			const auto& yBin = yBins.at(i);
+			if (std::isnan(xBin.first) || std::isnan(xBin.last) || yBin.min > yBin.max) {
+				if (!connectedPointsLogical.empty())
+					connectedPointsLogical[connectedPointsLogical.size()-1] = false;
+				continue;
+			}
+
+			//the history has no row in the columns, -1 is used as the index
+			symbolPointsLogical.append(QPointF(xBin.first, yBin.min));
+			symbolPointsLogical.append(QPointF(xBin.last, yBin.max));
+			connectedPointsLogical.push_back(true);
+			connectedPointsLogical.push_back(true);
+			validPointsIndicesLogical.push_back(-1);
+			validPointsIndicesLogical.push_back(-1);
+		}
+	}
+
 	//take over only valid and non masked points.
 	for (int row = 0; row < xColumn->rowCount(); row++) {
 		if ( xColumn->isValid(row) && yColumn->isValid(row)
@@ -2128,11 +2162,41 @@ QDateTime XYCurve::yDateTime(double x, bool &valueFound) const {
 }
 
 bool XYCurve::minMaxY(int indexMin, int indexMax, double& yMin, double& yMax, bool includeErrorBars) const {
-	return minMax(yColumn(), xColumn(), yErrorType(), yErrorPlusColumn(), yErrorMinusColumn(), indexMin, indexMax, yMin, yMax, includeErrorBars);
+	bool rc = minMax(yColumn(), xColumn(), yErrorType(), yErrorPlusColumn(), yErrorMinusColumn(), indexMin, indexMax, yMin, yMax, includeErrorBars);
+	if (indexMin == 0)
+		rc = minMaxHistory(yColumn(), xColumn(), rc, yMin, yMax) || rc;
+	return rc;
 }
 
 bool XYCurve::minMaxX(int indexMin, int indexMax, double& xMin, double& xMax, bool includeErrorBars) const {
-	return minMax(xColumn(), yColumn(), xErrorType(), xErrorPlusColumn(), xErrorMinusColumn(), indexMin, indexMax, xMin, xMax, includeErrorBars);
+	bool rc = minMax(xColumn(), yColumn(), xErrorType(), xErrorPlusColumn(), xErrorMinusColumn(), indexMin, indexMax, xMin, xMax, includeErrorBars);
+	if (indexMin == 0)
+		rc = minMaxHistory(xColumn(), yColumn(), rc, xMin, xMax) || rc;
+	return rc;
+}
+
+/*!
+ * extends \p min and \p max by the range of the values moved from \p column1 to its on-disk history.
+ * The history is only taken into account if \p column2 has a history of the same size, like in recalcLogicalPoints().
+ * If \p valid is \c false, \p min and \p max are not initialized yet and are set to the range of the history.
+ * Returns \c true if the range was extended.
+ */
+bool XYCurve::minMaxHistory(const AbstractColumn* column1, const AbstractColumn* column2, bool valid, double& min, double& max) const {
+	const auto* col1 = dynamic_cast<const Column*>(column1);
+	const auto* col2 = dynamic_cast<const Column*>(column2);
+	if (!col1 || !col2 || !col1->history() || !col2->history())
+		return false;
+
+	const ColumnHistory* history = col1->history();
+	if (history->rowCount() == 0 || history->rowCount() != col2->history()->rowCount()
+		|| history->minimum() > history->maximum())
+		return false;
+
+	if (!valid || history->minimum() < min)
+		min = history->minimum();
+	if (!valid || history->maximum() > max)
+		max = history->maximum();
+	return true;
 }
 
 /*!
@@ -2469,6 +2533,8 @@ void XYCurvePrivate::updateErrorBars() {
 
 		const QPointF& point = symbolPointsLogical.at(i);
 		int index = validPointsIndicesLogical.at(i);
+		if (index < 0)	//summary of the history, no error values available
+			continue;
 
 		//error bars for x
 		if (xErrorType != XYCurve::NoError) {
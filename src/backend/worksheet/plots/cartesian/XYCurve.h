@@ -79,6 +79,7 @@ public:
 	bool minMax(const AbstractColumn *column1, const AbstractColumn *column2, const ErrorType errorType, const AbstractColumn *errorPlusColumn, const AbstractColumn *errorMinusColumn, int indexMin, int indexMax, double& yMin, double& yMax, bool includeErrorBars) const;
 	bool minMaxX(int indexMin, int indexMax, double& yMin, double& yMax, bool includeErrorBars = true) const;
 	bool minMaxY(int indexMin, int indexMax, double& yMin, double& yMax, bool includeErrorBars = true) const;
+	bool minMaxHistory(const AbstractColumn* column1, const AbstractColumn* column2, bool valid, double& min, double& max) const;
 	bool activateCurve(QPointF mouseScenePos, double maxDist = -1);
 	void setHover(bool on);
 
@@ -102,6 +102,9 @@ XYDifferentiationCurvePrivate::XYDifferentiationCurvePrivate(XYDifferentiationCu
 //when the parent aspect is removed
 XYDifferentiationCurvePrivate::~XYDifferentiationCurvePrivate() = default;
 
+//number of points larger than the number of points used in all finite differences
+static const int stencilSize = 8;
+
 // ...
 // see XYFitCurvePrivate
 void XYDifferentiationCurvePrivate::recalculate() {
@@ -131,19 +134,12 @@ void XYDifferentiationCurvePrivate::recalculate() {
 
 	// clear the previous result
 	differentiationResult = XYDifferentiationCurve::DifferentiationResult();
+	processedSource = XYAnalysisSource();
 
 	//determine the data source columns
 	const AbstractColumn* tmpXDataColumn = nullptr;
 	const AbstractColumn* tmpYDataColumn = nullptr;
-	if (dataSourceType == XYAnalysisCurve::DataSourceSpreadsheet) {
-		//spreadsheet columns as data source
-		tmpXDataColumn = xDataColumn;
-		tmpYDataColumn = yDataColumn;
-	} else {
-		//curve columns as data source
-		tmpXDataColumn = dataSourceCurve->xColumn();
-		tmpYDataColumn = dataSourceCurve->yColumn();
-	}
+	sourceColumns(tmpXDataColumn, tmpYDataColumn);
 
 	if (!tmpXDataColumn || !tmpYDataColumn) {
 		emit q->dataChanged();
@@ -154,30 +150,8 @@ void XYDifferentiationCurvePrivate::recalculate() {
 	//copy all valid data point for the differentiation to temporary vectors
 	QVector<double> xdataVector;
 	QVector<double> ydataVector;
-
-	double xmin;
-	double xmax;
-	if (differentiationData.autoRange) {
-		xmin = tmpXDataColumn->minimum();
-		xmax = tmpXDataColumn->maximum();
-	} else {
-		xmin = differentiationData.xRange.first();
-		xmax = differentiationData.xRange.last();
-	}
-
-	int rowCount = qMin(tmpXDataColumn->rowCount(), tmpYDataColumn->rowCount());
-	for (int row = 0; row < rowCount; ++row) {
-		//only copy those data where _all_ values (for x and y, if given) are valid
-		if (std::isnan(tmpXDataColumn->valueAt(row)) || std::isnan(tmpYDataColumn->valueAt(row))
-			|| tmpXDataColumn->isMasked(row) || tmpYDataColumn->isMasked(row))
-			continue;
-
-		// only when inside given range
-		if (tmpXDataColumn->valueAt(row) >= xmin && tmpXDataColumn->valueAt(row) <= xmax) {
-			xdataVector.append(tmpXDataColumn->valueAt(row));
-			ydataVector.append(tmpYDataColumn->valueAt(row));
-		}
-	}
+	const XYAnalysisSource source = currentSource(tmpXDataColumn, tmpYDataColumn);
+	copyData(tmpXDataColumn, tmpYDataColumn, 0, source.rows, xdataVector, ydataVector);
 
 	//number of data points to differentiate
 	const size_t n = (size_t)xdataVector.size();
@@ -191,20 +165,124 @@ void XYDifferentiationCurvePrivate::recalculate() {
 		return;
 	}
 
+	DEBUG(nsl_diff_deriv_order_name[differentiationData.derivOrder] << "derivative");
+	DEBUG("accuracy order:" << differentiationData.accOrder);
+
+	//the points are differentiated in place
+	const int tailSize = qMin((int)n, 2 * stencilSize);
+	tailX = xdataVector.mid((int)n - tailSize, tailSize);
+	tailY = ydataVector.mid((int)n - tailSize, tailSize);
 	double* xdata = xdataVector.data();
 	double* ydata = ydataVector.data();
 
-	// differentiation settings
-	const nsl_diff_deriv_order_type derivOrder = differentiationData.derivOrder;
-	const int accOrder = differentiationData.accOrder;
-
-	DEBUG(nsl_diff_deriv_order_name[derivOrder] << "derivative");
-	DEBUG("accuracy order:" << accOrder);
+///////////////////////////////////////////////////////////
+	const int status = differentiate(xdata, ydata, n);
 
+	xVector->resize((int)n);
+	yVector->resize((int)n);
+	memcpy(xVector->data(), xdata, n * sizeof(double));
+	memcpy(yVector->data(), ydata, n * sizeof(double));
 ///////////////////////////////////////////////////////////
+
+	//write the result
+	differentiationResult.available = true;
+	differentiationResult.valid = true;
+	differentiationResult.status = QString::number(status);
+	differentiationResult.elapsedTime = timer.elapsed();
+	processedSource = source;
+
+	//redraw the curve
+	recalcLogicalPoints();
+	emit q->dataChanged();
+	sourceDataChangedSinceLastRecalc = false;
+}
+
+/*!
+ * differentiates the points at the end again together with the rows appended to the source columns.
+ * The finite differences only use the neighboring points, the derivatives of the previous points are not changed.
+ */
+bool XYDifferentiationCurvePrivate::recalculateIncrementally() {
+	const AbstractColumn* tmpXDataColumn = nullptr;
+	const AbstractColumn* tmpYDataColumn = nullptr;
+	sourceColumns(tmpXDataColumn, tmpYDataColumn);
+	const XYAnalysisSource source = currentSource(tmpXDataColumn, tmpYDataColumn);
+	if (!differentiationResult.valid || !appendedRows(source))
+		return false;
+
+	QElapsedTimer timer;
+	timer.start();
+
+	QVector<double> xdataVector;
+	QVector<double> ydataVector;
+	copyData(tmpXDataColumn, tmpYDataColumn, processedSource.rows, source.rows, xdataVector, ydataVector);
+	processedSource = source;
+	if (xdataVector.isEmpty())
+		return true;
+
+	//the points before the first point to be differentiated again are only used in its finite differences
+	const int n = yVector->size();
+	const int first = qMax(n - stencilSize, 0);
+	const int start = qMax(first - stencilSize, 0);
+	if (n - start > tailX.size())
+		return false;
+
+	QVector<double> xdata = tailX.mid(tailX.size() - (n - start));
+	QVector<double> ydata = tailY.mid(tailY.size() - (n - start));
+	xdata << xdataVector;
+	ydata << ydataVector;
+	const int size = xdata.size();
+	const int tailSize = qMin(size, 2 * stencilSize);
+	tailX = xdata.mid(size - tailSize, tailSize);
+	tailY = ydata.mid(size - tailSize, tailSize);
+
+	const int status = differentiate(xdata.data(), ydata.data(), (size_t)size);
+
+	yVector->resize(first);
+	for (int i = first - start; i < size; ++i)
+		yVector->append(ydata.at(i));
+	*xVector << xdataVector;
+
+	differentiationResult.status = QString::number(status);
+	differentiationResult.elapsedTime = timer.elapsed();
+
+	recalcLogicalPoints();
+	emit q->dataChanged();
+	return true;
+}
+
+/*!
+ * copies all valid data points in the rows \c first to \c last - 1 of the columns \c x and \c y to \c xdata and \c ydata.
+ */
+void XYDifferentiationCurvePrivate::copyData(const AbstractColumn* x, const AbstractColumn* y, int first, int last,
+		QVector<double>& xdata, QVector<double>& ydata) const {
+	//all data points are inside the automatic range
+	const bool autoRange = differentiationData.autoRange;
+	const double xmin = differentiationData.xRange.first();
+	const double xmax = differentiationData.xRange.last();
+
+	for (int row = first; row < last; ++row) {
+		//only copy those data where _all_ values (for x and y, if given) are valid
+		const double xValue = x->valueAt(row);
+		const double yValue = y->valueAt(row);
+		if (std::isnan(xValue) || std::isnan(yValue) || x->isMasked(row) || y->isMasked(row))
+			continue;
+
+		// only when inside given range
+		if (autoRange || (xValue >= xmin && xValue <= xmax)) {
+			xdata.append(xValue);
+			ydata.append(yValue);
+		}
+	}
+}
+
+/*!
+ * differentiates the \c n points in place with the current settings.
+ */
+int XYDifferentiationCurvePrivate::differentiate(double* xdata, double* ydata, size_t n) const {
+	const int accOrder = differentiationData.accOrder;
 	int status = 0;
 
-	switch (derivOrder) {
+	switch (differentiationData.derivOrder) {
 	case nsl_diff_deriv_order_first:
 		status = nsl_diff_first_deriv(xdata, ydata, n, accOrder);
 		break;
@@ -225,22 +303,7 @@ void XYDifferentiationCurvePrivate::recalculate() {
 		break;
 	}
 
-	xVector->resize((int)n);
-	yVector->resize((int)n);
-	memcpy(xVector->data(), xdata, n * sizeof(double));
-	memcpy(yVector->data(), ydata, n * sizeof(double));
-///////////////////////////////////////////////////////////
-
-	//write the result
-	differentiationResult.available = true;
-	differentiationResult.valid = true;
-	differentiationResult.status = QString::number(status);
-	differentiationResult.elapsedTime = timer.elapsed();
-
-	//redraw the curve
-	recalcLogicalPoints();
-	emit q->dataChanged();
-	sourceDataChangedSinceLastRecalc = false;
+	return status;
 }
 
 //##############################################################################
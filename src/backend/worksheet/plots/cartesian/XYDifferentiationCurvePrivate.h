@@ -42,10 +42,17 @@ public:
 	~XYDifferentiationCurvePrivate() override;
 
 	void recalculate();
+	bool recalculateIncrementally() override;
+	void copyData(const AbstractColumn* x, const AbstractColumn* y, int first, int last, QVector<double>& xdata, QVector<double>& ydata) const;
+	int differentiate(double* xdata, double* ydata, size_t n) const;
 
 	XYDifferentiationCurve::DifferentiationData differentiationData;
 	XYDifferentiationCurve::DifferentiationResult differentiationResult;
 
+	//last source data points, used to differentiate the points at the end again in the incremental mode
+	QVector<double> tailX;
+	QVector<double> tailY;
+
 	XYDifferentiationCurve* const q;
 };
 
@@ -41,7 +41,10 @@
 #include "backend/core/column/Column.h"
 #include "backend/lib/commandtemplates.h"
 #include "backend/lib/macros.h"
+#include "backend/lib/trace.h"
+#include "backend/spreadsheet/Spreadsheet.h"
 #include "backend/gsl/errors.h"
+#include "backend/gsl/CompiledExpression.h"
 #include "backend/gsl/ExpressionParser.h"
 
 extern "C" {
@@ -57,9 +60,12 @@ extern "C" {
 }
 
 #include <QElapsedTimer>
+#include <QVarLengthArray>
 #include <QIcon>
 #include <QThreadPool>
 
+#include <functional>
+
 XYFitCurve::XYFitCurve(const QString& name)
 	: XYAnalysisCurve(name, new XYFitCurvePrivate(this), AspectType::XYFitCurve) {
 }
@@ -733,6 +739,8 @@ struct data {
 	double* paramMin;	// lower parameter limits
 	double* paramMax;	// upper parameter limits
 	bool* paramFixed;	// parameter fixed?
+	const CompiledExpression* model;	// compiled model with the derivatives w.r.t. the parameters, nullptr if not compiled
+	bool parallel;	// evaluate the rows in parallel (not used when several fits are running in parallel)
 };
 
 /*!
@@ -753,51 +761,65 @@ int func_f(const gsl_vector* paramValues, void* params, gsl_vector* f) {
 	QStringList* paramNames = ((struct data*)params)->paramNames;
 	double *min = ((struct data*)params)->paramMin;
 	double *max = ((struct data*)params)->paramMax;
+	const CompiledExpression* model = ((struct data*)params)->model;
 
 	// set current values of the parameters
+	QVarLengthArray<double, 16> p(paramNames->size());
 	for (int i = 0; i < paramNames->size(); i++) {
 		double v = gsl_vector_get(paramValues, (size_t)i);
 		// bound values if limits are set
+		p[i] = nsl_fit_map_bound(v, min[i], max[i]);
+		if (model)
+			continue;
 		QByteArray paramnameba = paramNames->at(i).toLatin1();
-		assign_variable(paramnameba.constData(), nsl_fit_map_bound(v, min[i], max[i]));
+		assign_variable(paramnameba.constData(), p[i]);
 		QDEBUG("Parameter"<<i<<" (\" "<<paramnameba.constData()<<"\")"<<'['<<min[i]<<','<<max[i]
-			<<"] free/bound:"<<QString::number(v, 'g', 15)<<' '<<QString::number(nsl_fit_map_bound(v, min[i], max[i]), 'g', 15));
+			<<"] free/bound:"<<QString::number(v, 'g', 15)<<' '<<QString::number(p[i], 'g', 15));
 	}
 
-	for (size_t i = 0; i < n; i++) {
-		if (std::isnan(x[i]) || std::isnan(y[i]))
-			continue;
-
-		// checks for allowed values of x for different models
-		// TODO: more to check
-		if (modelCategory == nsl_fit_model_distribution && modelType == nsl_sf_stats_lognormal) {
-			if (x[i] < 0)
-				x[i] = 0;
-		}
-
-		assign_variable("x", x[i]);
-		//DEBUG("evaluate function \"" << func << "\" @ x = " << x[i] << ":");
-		double Yi = parse(func);
-		//DEBUG("	f(x["<< i <<"]) = " << Yi);
+	// the compiled model is evaluated in parallel, the parser is not thread-safe
+	bool parseError = false;
+	XYAnalysisCurvePrivate::evaluateRanges(n, model && ((struct data*)params)->parallel, [&](size_t begin, size_t end) {
+		for (size_t i = begin; i < end; i++) {
+			if (std::isnan(x[i]) || std::isnan(y[i]))
+				continue;
+
+			// checks for allowed values of x for different models
+			// TODO: more to check
+			if (modelCategory == nsl_fit_model_distribution && modelType == nsl_sf_stats_lognormal) {
+				if (x[i] < 0)
+					x[i] = 0;
+			}
 
-		if (parse_errors() > 0)
-			return GSL_EINVAL;
+			double Yi;
+			if (model)
+				Yi = model->value(x[i], p.constData());
+			else {
+				assign_variable("x", x[i]);
+				//DEBUG("evaluate function \"" << func << "\" @ x = " << x[i] << ":");
+				Yi = parse(func);
+				//DEBUG("	f(x["<< i <<"]) = " << Yi);
+
+				if (parse_errors() > 0) {
+					parseError = true;
+					return;
+				}
+			}
 
-		gsl_vector_set(f, i, sqrt(weight[i]) * (Yi - y[i]));
-	}
+			gsl_vector_set(f, i, sqrt(weight[i]) * (Yi - y[i]));
+		}
+	});
 
-	return GSL_SUCCESS;
+	return parseError ? GSL_EINVAL : GSL_SUCCESS;
 }
 
 /*!
- * calculates the matrix elements of Jacobian matrix
+ * calculates the rows \c begin to \c end - 1 of the Jacobian matrix
  * \param paramValues current parameter values
  * \param params
  * \param J Jacobian matrix
  * */
-int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
-	//DEBUG("func_df");
-	const size_t n = ((struct data*)params)->n;
+static void func_df_rows(const gsl_vector* paramValues, void* params, gsl_matrix* J, size_t begin, size_t end) {
 	double* xVector = ((struct data*)params)->x;
 	double* weight = ((struct data*)params)->weight;
 	nsl_fit_model_category modelCategory = ((struct data*)params)->modelCategory;
@@ -818,7 +840,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 	case nsl_fit_model_basic:
 		switch (modelType) {
 		case nsl_fit_model_polynomial:	// Y(x) = c0 + c1*x + ... + cn*x^n
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 				for (unsigned int j = 0; j < (unsigned int)paramNames->size(); ++j) {
 					if (fixed[j])
@@ -832,7 +854,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			if (degree == 1) {
 				const double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 				const double b = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
-				for (size_t i = 0; i < n; i++) {
+				for (size_t i = begin; i < end; i++) {
 					x = xVector[i];
 
 					for (int j = 0; j < 2; j++) {
@@ -845,7 +867,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			} else if (degree == 2) {
 				const double b = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 				const double c = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
-				for (size_t i = 0; i < n; i++) {
+				for (size_t i = begin; i < end; i++) {
 					x = xVector[i];
 
 					for (int j = 0; j < 3; j++) {
@@ -861,7 +883,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			double *p = new double[2*degree];
 			for (unsigned int i = 0; i < 2*degree; i++)
 				p[i] = nsl_fit_map_bound(gsl_vector_get(paramValues, i), min[i], max[i]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 2*degree; j++) {
@@ -878,7 +900,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		case nsl_fit_model_inverse_exponential: {	// Y(x) = a*(1-exp(b*x))+c
 			const double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			const double b = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 3; j++) {
@@ -901,7 +923,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 				a[i] = nsl_fit_map_bound(gsl_vector_get(paramValues, 2*i), min[2*i], max[2*i]);
 				b[i] = nsl_fit_map_bound(gsl_vector_get(paramValues, 2*i+1), min[2*i+1], max[2*i+1]);
 			}
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 				double wd = 0; //first derivative with respect to the w parameter
 				for (unsigned int j = 1; j < degree; ++j) {
@@ -933,7 +955,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		case nsl_fit_model_lorentz:
 		case nsl_fit_model_sech:
 		case nsl_fit_model_logistic:
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < degree; ++j) {
@@ -971,7 +993,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			}
 			break;
 		case nsl_fit_model_voigt:
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < degree; ++j) {
@@ -991,7 +1013,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			}
 			break;
 		case nsl_fit_model_pseudovoigt1:
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < degree; ++j) {
@@ -1017,7 +1039,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		const double mu = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 		const double s = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
 
-		for (size_t i = 0; i < n; i++) {
+		for (size_t i = begin; i < end; i++) {
 			x = xVector[i];
 
 			for (unsigned int j = 0; j < 3; j++) {
@@ -1069,7 +1091,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			const double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			const double s = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			const double mu = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 3; j++) {
@@ -1118,7 +1140,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			const double s = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			const double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
 			const double mu = nsl_fit_map_bound(gsl_vector_get(paramValues, 3), min[3], max[3]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 4; j++) {
@@ -1135,7 +1157,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			const double s = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			const double b = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
 			const double mu = nsl_fit_map_bound(gsl_vector_get(paramValues, 3), min[3], max[3]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 4; j++) {
@@ -1150,7 +1172,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		case nsl_sf_stats_rayleigh: {
 			const double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			const double s = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 2; j++) {
@@ -1166,7 +1188,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			const double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			const double k = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			const double t = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 3; j++) {
@@ -1182,7 +1204,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			const double A = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			const double b = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			const double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 3; j++) {
@@ -1197,7 +1219,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		case nsl_sf_stats_chi_squared: {
 			const double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			const double nu = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 2; j++) {
@@ -1212,7 +1234,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		case nsl_sf_stats_tdist: {
 			const double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			const double nu = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 2; j++) {
@@ -1228,7 +1250,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			const double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			const double n1 = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			const double n2 = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 3; j++) {
@@ -1245,7 +1267,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			const double A = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			const double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			const double b = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 3; j++) {
@@ -1270,7 +1292,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			const double k = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			const double l = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
 			const double mu = nsl_fit_map_bound(gsl_vector_get(paramValues, 3), min[3], max[3]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 4; j++) {
@@ -1291,7 +1313,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			const double s = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			const double mu = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
 			const double b = nsl_fit_map_bound(gsl_vector_get(paramValues, 3), min[3], max[3]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 4; j++) {
@@ -1308,7 +1330,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			const double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			const double b = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
 			const double mu = nsl_fit_map_bound(gsl_vector_get(paramValues, 3), min[3], max[3]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 4; j++) {
@@ -1323,7 +1345,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		case nsl_sf_stats_poisson: {
 			const double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			const double l = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 2; j++) {
@@ -1338,7 +1360,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		case nsl_sf_stats_maxwell_boltzmann: {	// Y(x) = a*sqrt(2/pi) * x^2/s^3 * exp(-(x/s)^2/2)
 			const double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			const double s = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 2; j++) {
@@ -1355,7 +1377,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			const double g = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			const double s = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
 			const double mu = nsl_fit_map_bound(gsl_vector_get(paramValues, 3), min[3], max[3]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 4; j++) {
@@ -1369,7 +1391,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		}
 		case nsl_sf_stats_landau: {
 			// const double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 				if (fixed[0])
 					gsl_matrix_set(J, (size_t)i, 0, 0.);
@@ -1384,7 +1406,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			const double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			const double p = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			const double N = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 3; j++) {
@@ -1411,7 +1433,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		case nsl_sf_stats_logarithmic: {
 			const double a = nsl_fit_map_bound(gsl_vector_get(paramValues, 0), min[0], max[0]);
 			const double p = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 2; j++) {
@@ -1436,7 +1458,7 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			const double n1 = nsl_fit_map_bound(gsl_vector_get(paramValues, 1), min[1], max[1]);
 			const double n2 = nsl_fit_map_bound(gsl_vector_get(paramValues, 2), min[2], max[2]);
 			const double t = nsl_fit_map_bound(gsl_vector_get(paramValues, 3), min[3], max[3]);
-			for (size_t i = 0; i < n; i++) {
+			for (size_t i = begin; i < end; i++) {
 				x = xVector[i];
 
 				for (unsigned int j = 0; j < 4; j++) {
@@ -1456,12 +1478,30 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 		}
 		break;
 	case nsl_fit_model_custom:
+		const unsigned int np = paramNames->size();
+		const CompiledExpression* model = ((struct data*)params)->model;
+		if (model) {
+			// exact derivatives of the compiled model, all parameters in one pass per data point
+			QVarLengthArray<double, 16> p(np);
+			QVarLengthArray<double, 16> gradient(np);
+			for (unsigned int j = 0; j < np; j++)
+				p[j] = nsl_fit_map_bound(gsl_vector_get(paramValues, j), min[j], max[j]);
+
+			for (size_t i = begin; i < end; i++) {
+				model->value(xVector[i], p.constData(), gradient.data());
+				const double w = sqrt(weight[i]);
+				double* row = gsl_matrix_ptr(J, i, 0);
+				for (unsigned int j = 0; j < np; j++)
+					row[j] = fixed[j] ? 0. : w * gradient[j];
+			}
+			break;
+		}
+
 		QByteArray funcba = ((struct data*)params)->func->toLatin1();
 		const char* func = funcba.data();
 		QByteArray nameba;
 		double value;
-		const unsigned int np = paramNames->size();
-		for (size_t i = 0; i < n; i++) {
+		for (size_t i = begin; i < end; i++) {
 			x = xVector[i];
 			assign_variable("x", x);
 
@@ -1498,179 +1538,158 @@ int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
 			}
 		}
 	}
+}
+
+/*!
+ * calculates the matrix elements of Jacobian matrix
+ * \param paramValues current parameter values
+ * \param params
+ * \param J Jacobian matrix
+ * */
+int func_df(const gsl_vector* paramValues, void* params, gsl_matrix* J) {
+	//DEBUG("func_df");
+	const size_t n = ((struct data*)params)->n;
+	// the parser used for custom models that are not compiled is not thread-safe
+	const bool parallel = ((struct data*)params)->parallel
+		&& (((struct data*)params)->model || ((struct data*)params)->modelCategory != nsl_fit_model_custom);
+
+	XYAnalysisCurvePrivate::evaluateRanges(n, parallel, [=](size_t begin, size_t end) {
+		func_df_rows(paramValues, params, J, begin, end);
+	});
 
 	return GSL_SUCCESS;
 }
 
 int func_fdf(const gsl_vector* x, void* params, gsl_vector* f, gsl_matrix* J) {
 	//DEBUG("func_fdf");
-	func_f(x, params, f);
-	func_df(x, params, J);
+	const CompiledExpression* model = ((struct data*)params)->model;
+	if (!model || ((struct data*)params)->modelCategory != nsl_fit_model_custom) {
+		func_f(x, params, f);
+		func_df(x, params, J);
+		return GSL_SUCCESS;
+	}
+
+	// residuals and Jacobian of the compiled custom model in one pass
+	const size_t n = ((struct data*)params)->n;
+	double* xVector = ((struct data*)params)->x;
+	double* y = ((struct data*)params)->y;
+	double* weight = ((struct data*)params)->weight;
+	double *min = ((struct data*)params)->paramMin;
+	double *max = ((struct data*)params)->paramMax;
+	bool *fixed = ((struct data*)params)->paramFixed;
+	const unsigned int np = ((struct data*)params)->paramNames->size();
+
+	QVarLengthArray<double, 16> p(np);
+	for (unsigned int j = 0; j < np; j++)
+		p[j] = nsl_fit_map_bound(gsl_vector_get(x, j), min[j], max[j]);
+
+	XYAnalysisCurvePrivate::evaluateRanges(n, ((struct data*)params)->parallel, [&](size_t begin, size_t end) {
+		QVarLengthArray<double, 16> gradient(np);
+		for (size_t i = begin; i < end; i++) {
+			const double Yi = model->value(xVector[i], p.constData(), gradient.data());
+			const double w = sqrt(weight[i]);
+			if (!std::isnan(xVector[i]) && !std::isnan(y[i]))
+				gsl_vector_set(f, i, w * (Yi - y[i]));
+			double* row = gsl_matrix_ptr(J, i, 0);
+			for (unsigned int j = 0; j < np; j++)
+				row[j] = fixed[j] ? 0. : w * gradient[j];
+		}
+	});
 
 	return GSL_SUCCESS;
 }
 
-/* prepare the fit result columns */
-void XYFitCurvePrivate::prepareResultColumns() {
-	//create fit result columns if not available yet, clear them otherwise
-	if (!xColumn) {	// all columns are treated together
-		xColumn = new Column("x", AbstractColumn::Numeric);
-		yColumn = new Column("y", AbstractColumn::Numeric);
-		residualsColumn = new Column("residuals", AbstractColumn::Numeric);
-		xVector = static_cast<QVector<double>* >(xColumn->data());
-		yVector = static_cast<QVector<double>* >(yColumn->data());
-		residualsVector = static_cast<QVector<double>* >(residualsColumn->data());
+// settings and results of a fit running in a worker thread
+struct FitState {
+	XYFitCurve::FitData fitData;
+	XYFitCurve::FitResult fitResult;
+	CompiledExpression model;
+	bool compiled{false};
+	bool parallel{true};	// evaluate the rows of the residuals and of the Jacobian in parallel
+	QVector<double> xerror;
+	QVector<double> yerror;
+	QVector<double> residuals;	// residuals of the fitted data points
+};
 
-		xColumn->setHidden(true);
-		q->addChild(xColumn);
+// solver and matrices of a fit, reused for consecutive fits with the same number of data points and parameters
+struct FitWorkspace {
+	~FitWorkspace() {
+		free();
+	}
 
-		yColumn->setHidden(true);
-		q->addChild(yColumn);
+	void reserve(size_t n, size_t np) {
+		if (solver && n == this->n && np == this->np)
+			return;
 
-		q->addChild(residualsColumn);
+		free();
+		solver = gsl_multifit_fdfsolver_alloc(gsl_multifit_fdfsolver_lmsder, n, np);
+		covar = gsl_matrix_alloc(np, np);
+#if GSL_MAJOR_VERSION >= 2
+		J = gsl_matrix_alloc(n, np);
+#endif
+		this->n = n;
+		this->np = np;
+	}
 
-		q->setUndoAware(false);
-		q->setXColumn(xColumn);
-		q->setYColumn(yColumn);
-		q->setUndoAware(true);
-	} else {
-		xVector->clear();
-		yVector->clear();
-		residualsVector->clear();
+	void free() {
+		if (solver)
+			gsl_multifit_fdfsolver_free(solver);
+		if (covar)
+			gsl_matrix_free(covar);
+		if (J)
+			gsl_matrix_free(J);
+		solver = nullptr;
+		covar = nullptr;
+		J = nullptr;
 	}
-}
 
-void XYFitCurvePrivate::recalculate() {
-	DEBUG("XYFitCurvePrivate::recalculate()");
+	gsl_multifit_fdfsolver* solver{nullptr};	// Levenberg-Marquardt robust solver
+	gsl_matrix* covar{nullptr};
+	gsl_matrix* J{nullptr};	// Jacobian, not part of the solver anymore in GSL >= 2
+	size_t n{0};
+	size_t np{0};
+};
 
-	QElapsedTimer timer;
-	timer.start();
+/*!
+ * writes out the current state of the solver \c s to the solver output of \c fitResult
+ */
+static void writeSolverState(gsl_multifit_fdfsolver* s, const XYFitCurve::FitData& fitData, XYFitCurve::FitResult& fitResult) {
+	QString state;
 
-	// prepare source data columns
-	const AbstractColumn* tmpXDataColumn = nullptr;
-	const AbstractColumn* tmpYDataColumn = nullptr;
-	if (dataSourceType == XYAnalysisCurve::DataSourceSpreadsheet) {
-		DEBUG("	spreadsheet columns as data source");
-		tmpXDataColumn = xDataColumn;
-		tmpYDataColumn = yDataColumn;
-	} else {
-		DEBUG("	curve columns as data source");
-		tmpXDataColumn = dataSourceCurve->xColumn();
-		tmpYDataColumn = dataSourceCurve->yColumn();
+	//current parameter values, semicolon separated
+	const double* min = fitData.paramLowerLimits.data();
+	const double* max = fitData.paramUpperLimits.data();
+	for (int i = 0; i < fitData.paramNames.size(); ++i) {
+		const double x = gsl_vector_get(s->x, i);
+		// map parameter if bounded
+		state += QString::number(nsl_fit_map_bound(x, min[i], max[i])) + '\t';
 	}
 
-	// clear the previous result
-	fitResult = XYFitCurve::FitResult();
-
-	if (!tmpXDataColumn || !tmpYDataColumn) {
-		DEBUG("ERROR: Preparing source data columns failed!");
-		emit q->dataChanged();
-		sourceDataChangedSinceLastRecalc = false;
-		return;
-	}
+	//current value of the chi2-function
+	state += QString::number(gsl_pow_2(gsl_blas_dnrm2(s->f)));
+	state += ';';
+	DEBUG("	chi = " << gsl_pow_2(gsl_blas_dnrm2(s->f)));
 
-	prepareResultColumns();
+	fitResult.solverOutput += state;
+}
 
-	//fit settings
+/*!
+ * runs the fit of the data in \c job with the settings in \c state and writes the results to \c state.
+ * Called in a worker thread, it only works on the copies of the data and of the settings.
+ * The solver in \c workspace is reused if it has the required size.
+ */
+static void runFit(XYAnalysisJob& job, FitState& state, FitWorkspace& workspace) {
+	XYFitCurve::FitData& fitData = state.fitData;
+	XYFitCurve::FitResult& fitResult = state.fitResult;
+	QVector<double>& xerrorVector = state.xerror;
+	QVector<double>& yerrorVector = state.yerror;
+	const size_t n = job.x.size();
 	const unsigned int maxIters = fitData.maxIterations;	//maximal number of iterations
 	const double delta = fitData.eps;		//fit tolerance
 	const unsigned int np = fitData.paramNames.size(); //number of fit parameters
-	if (np == 0) {
-		fitResult.available = true;
-		fitResult.valid = false;
-		fitResult.status = i18n("Model has no parameters.");
-		emit q->dataChanged();
-		sourceDataChangedSinceLastRecalc = false;
-		return;
-	}
-
-	if (yErrorColumn) {
-		if (yErrorColumn->rowCount() < tmpXDataColumn->rowCount()) {
-			fitResult.available = true;
-			fitResult.valid = false;
-			fitResult.status = i18n("Not sufficient weight data points provided.");
-			emit q->dataChanged();
-			sourceDataChangedSinceLastRecalc = false;
-			return;
-		}
-	}
-
-	//copy all valid data point for the fit to temporary vectors
-	QVector<double> xdataVector;
-	QVector<double> ydataVector;
-	QVector<double> xerrorVector;
-	QVector<double> yerrorVector;
-	double xmin, xmax;
-	if (fitData.autoRange) {
-		xmin = tmpXDataColumn->minimum();
-		xmax = tmpXDataColumn->maximum();
-	} else {
-		xmin = fitData.fitRange.first();
-		xmax = fitData.fitRange.last();
-	}
-	DEBUG("fit range = " << xmin << " .. " << xmax);
-
-	int rowCount = qMin(tmpXDataColumn->rowCount(), tmpYDataColumn->rowCount());
-	for (int row = 0; row < rowCount; ++row) {
-		//only copy those data where _all_ values (for x and y and errors, if given) are valid
-		if (std::isnan(tmpXDataColumn->valueAt(row)) || std::isnan(tmpYDataColumn->valueAt(row))
-			|| tmpXDataColumn->isMasked(row) || tmpYDataColumn->isMasked(row))
-			continue;
-
-		// only when inside given range
-		if (tmpXDataColumn->valueAt(row) >= xmin && tmpXDataColumn->valueAt(row) <= xmax) {
-			if ((!xErrorColumn && !yErrorColumn) || !fitData.useDataErrors) {	// x-y
-				xdataVector.append(tmpXDataColumn->valueAt(row));
-				ydataVector.append(tmpYDataColumn->valueAt(row));
-			} else if (!xErrorColumn && yErrorColumn) {	// x-y-dy
-				if (!std::isnan(yErrorColumn->valueAt(row))) {
-					xdataVector.append(tmpXDataColumn->valueAt(row));
-					ydataVector.append(tmpYDataColumn->valueAt(row));
-					yerrorVector.append(yErrorColumn->valueAt(row));
-				}
-			} else if (xErrorColumn && yErrorColumn) {	// x-y-dx-dy
-				if (!std::isnan(xErrorColumn->valueAt(row)) && !std::isnan(yErrorColumn->valueAt(row))) {
-					xdataVector.append(tmpXDataColumn->valueAt(row));
-					ydataVector.append(tmpYDataColumn->valueAt(row));
-					xerrorVector.append(xErrorColumn->valueAt(row));
-					yerrorVector.append(yErrorColumn->valueAt(row));
-				}
-			}
-		}
-
-	}
-	//number of data points to fit
-	const size_t n = xdataVector.size();
-	DEBUG("number of data points: " << n);
-	if (n == 0) {
-		fitResult.available = true;
-		fitResult.valid = false;
-		fitResult.status = i18n("No data points available.");
-		emit q->dataChanged();
-		sourceDataChangedSinceLastRecalc = false;
-		return;
-	}
-
-	if (n < np) {
-		fitResult.available = true;
-		fitResult.valid = false;
-		fitResult.status = i18n("The number of data points (%1) must be greater than or equal to the number of parameters (%2).", n, np);
-		emit q->dataChanged();
-		sourceDataChangedSinceLastRecalc = false;
-		return;
-	}
-
-	if (fitData.model.simplified().isEmpty()) {
-		fitResult.available = true;
-		fitResult.valid = false;
-		fitResult.status = i18n("Fit model not specified.");
-		emit q->dataChanged();
-		sourceDataChangedSinceLastRecalc = false;
-		return;
-	}
 
-	double* xdata = xdataVector.data();
-	double* ydata = ydataVector.data();
+	double* xdata = job.x.data();
+	double* ydata = job.y.data();
 	double* xerror = xerrorVector.data();	// size may be 0
 	double* yerror = yerrorVector.data();	// size may be 0
 	DEBUG("x error vector size: " << xerrorVector.size());
@@ -1725,7 +1744,8 @@ void XYFitCurvePrivate::recalculate() {
 	//function to fit
 	gsl_multifit_function_fdf f;
 	DEBUG("model = " << fitData.model.toStdString());
-	struct data params = {n, xdata, ydata, weight, fitData.modelCategory, fitData.modelType, fitData.degree, &fitData.model, &fitData.paramNames, fitData.paramLowerLimits.data(), fitData.paramUpperLimits.data(), fitData.paramFixed.data()};
+	// the model is compiled once, the fit functions evaluate it without parsing
+	struct data params = {n, xdata, ydata, weight, fitData.modelCategory, fitData.modelType, fitData.degree, &fitData.model, &fitData.paramNames, fitData.paramLowerLimits.data(), fitData.paramUpperLimits.data(), fitData.paramFixed.data(), state.compiled ? &state.model : nullptr, state.parallel};
 	f.f = &func_f;
 	f.df = &func_df;
 	f.fdf = &func_fdf;
@@ -1734,8 +1754,8 @@ void XYFitCurvePrivate::recalculate() {
 	f.params = &params;
 
 	DEBUG("initialize the derivative solver (using Levenberg-Marquardt robust solver)");
-	const gsl_multifit_fdfsolver_type* T = gsl_multifit_fdfsolver_lmsder;
-	gsl_multifit_fdfsolver* s = gsl_multifit_fdfsolver_alloc(T, n, np);
+	workspace.reserve(n, np);
+	gsl_multifit_fdfsolver* s = workspace.solver;
 
 	DEBUG("set start values");
 	double* x_init = fitData.paramStartValues.data();
@@ -1755,10 +1775,13 @@ void XYFitCurvePrivate::recalculate() {
 	int status;
 	unsigned int iter = 0;
 	fitResult.solverOutput.clear();
-	writeSolverState(s);
+	writeSolverState(s, fitData, fitResult);
 	do {
 		iter++;
 		DEBUG("	iter " << iter);
+		if (job.isCanceled())
+			break;
+		job.setProgress((int)(100.*iter/maxIters));
 
 		// update weights for Y-depending weights (using function values from residuals)
 		if (fitData.yWeightsType == nsl_fit_weight_statistical_fit) {
@@ -1772,7 +1795,7 @@ void XYFitCurvePrivate::recalculate() {
 		DEBUG("	run fdfsolver_iterate");
 		status = gsl_multifit_fdfsolver_iterate(s);
 		DEBUG("	fdfsolver_iterate DONE");
-		writeSolverState(s);
+		writeSolverState(s, fitData, fitResult);
 		if (status) {
 			DEBUG("iter " << iter << ", status = " << gsl_strerror(status));
 			break;
@@ -1781,6 +1804,11 @@ void XYFitCurvePrivate::recalculate() {
 		DEBUG("	iter " << iter << ", test status = " << status);
 	} while (status == GSL_CONTINUE && iter < maxIters);
 
+	if (job.isCanceled()) {
+		delete[] weight;
+		return;
+	}
+
 	// second run for x-error fitting
 	if (xerrorVector.size() > 0) {
 		DEBUG("Rerun fit with x errors");
@@ -1866,7 +1894,9 @@ void XYFitCurvePrivate::recalculate() {
 
 			do {	// fit
 				iter++;
-				writeSolverState(s);
+				if (job.isCanceled())
+					break;
+				writeSolverState(s, fitData, fitResult);
 				status = gsl_multifit_fdfsolver_iterate(s);
 				//printf ("status = %s\n", gsl_strerror (status));
 				if (status) {
@@ -1890,10 +1920,10 @@ void XYFitCurvePrivate::recalculate() {
 
 	//get the covariance matrix
 	//TODO: scale the Jacobian when limits are used before constructing the covar matrix?
-	gsl_matrix* covar = gsl_matrix_alloc(np, np);
+	gsl_matrix* covar = workspace.covar;
 #if GSL_MAJOR_VERSION >= 2
 	// the Jacobian is not part of the solver anymore
-	gsl_matrix *J = gsl_matrix_alloc(s->fdf->n, s->fdf->p);
+	gsl_matrix* J = workspace.J;
 	gsl_multifit_fdfsolver_jac(s, J);
 	gsl_multifit_covar(J, 0.0, covar);
 #else
@@ -1963,40 +1993,451 @@ void XYFitCurvePrivate::recalculate() {
 		fitResult.tdist_marginValues[i] = nsl_stats_tdist_margin(0.05, fitResult.dof, fitResult.errorValues.at(i));
 	}
 
-	// fill residuals vector. To get residuals on the correct x values, fill the rest with zeros.
-	residualsVector->resize(tmpXDataColumn->rowCount());
-	if (fitData.autoRange) {	// evaluate full range of residuals
-		xVector->resize(tmpXDataColumn->rowCount());
-		for (int i = 0; i < tmpXDataColumn->rowCount(); i++)
-			(*xVector)[i] = tmpXDataColumn->valueAt(i);
-		ExpressionParser* parser = ExpressionParser::getInstance();
-		bool rc = parser->evaluateCartesian(fitData.model, xVector, residualsVector,
-							fitData.paramNames, fitResult.paramValues);
-		for (int i = 0; i < tmpXDataColumn->rowCount(); i++)
-			(*residualsVector)[i] = tmpYDataColumn->valueAt(i) - (*residualsVector)[i];
-		if (!rc)
-			residualsVector->clear();
-	} else {	// only selected range
-		size_t j = 0;
-		for (int i = 0; i < tmpXDataColumn->rowCount(); i++) {
-			if (tmpXDataColumn->valueAt(i) >= xmin && tmpXDataColumn->valueAt(i) <= xmax)
-				residualsVector->data()[i] = - gsl_vector_get(s->f, j++);
-			else	// outside range
-				residualsVector->data()[i] = 0;
+	// residuals of the fitted data points
+	state.residuals.resize(n);
+	for (size_t i = 0; i < n; i++)
+		state.residuals[i] = - gsl_vector_get(s->f, i);
+}
+
+/*!
+ * copies the valid data points in the fit range of every column in \c yColumns versus \c xColumn for fitBatch().
+ * The columns are only accessed here, the fits can run in a worker thread.
+ */
+XYFitCurve::BatchData XYFitCurve::batchData(const FitData& fitData, const AbstractColumn* xColumn,
+		const QVector<const AbstractColumn*>& yColumns) {
+	const int count = yColumns.size();
+	BatchData data;
+	data.x.resize(count);
+	data.y.resize(count);
+	if (!xColumn)
+		return data;
+
+	double xmin, xmax;
+	if (fitData.autoRange) {
+		xmin = xColumn->minimum();
+		xmax = xColumn->maximum();
+	} else {
+		xmin = fitData.fitRange.first();
+		xmax = fitData.fitRange.last();
+	}
+
+	for (int c = 0; c < count; ++c) {
+		const AbstractColumn* yColumn = yColumns.at(c);
+		const int rowCount = qMin(xColumn->rowCount(), yColumn->rowCount());
+		for (int row = 0; row < rowCount; ++row) {
+			const double x = xColumn->valueAt(row);
+			const double y = yColumn->valueAt(row);
+			if (std::isnan(x) || std::isnan(y) || xColumn->isMasked(row) || yColumn->isMasked(row))
+				continue;
+
+			if (x >= xmin && x <= xmax) {
+				data.x[c].append(x);
+				data.y[c].append(y);
+			}
 		}
 	}
-	residualsColumn->setChanged();
 
-	//free resources
-	gsl_multifit_fdfsolver_free(s);
-	gsl_matrix_free(covar);
+	return data;
+}
+
+/*!
+ * fits the model in \c fitData to the data points of every column in \c data (see batchData()).
+ * If the model can be compiled, the columns are fitted in parallel worker threads, every thread reuses its solver.
+ * If \c warmStart is \c true, the results of the previous column are used as start values. The columns are chained
+ * in fixed blocks of columns independent of the number of threads, so the results are the same on every machine.
+ * Error columns are not used.
+ * The fit stops after the current columns if \c canceled is set, the results of the columns not fitted are not available.
+ * \c fitted is incremented for every fitted column.
+ * Returns the results in the order of the columns.
+ */
+QVector<XYFitCurve::FitResult> XYFitCurve::fitBatch(const FitData& fitData, const BatchData& data, bool warmStart,
+		const std::atomic<bool>* canceled, std::atomic<int>* fitted) {
+	PERFTRACE("XYFitCurve::fitBatch()");
+	const int count = data.y.size();
+	QVector<FitResult> results(count);
+	if (count == 0)
+		return results;
+
+	QString error;
+	const int np = fitData.paramNames.size();
+	if (np == 0)
+		error = i18n("Model has no parameters.");
+	else if (fitData.model.simplified().isEmpty())
+		error = i18n("Fit model not specified.");
+	if (!error.isEmpty()) {
+		for (auto& result : results) {
+			result.available = true;
+			result.status = error;
+		}
+		return results;
+	}
+
+	FitState prototype;
+	prototype.fitData = fitData;
+	prototype.fitData.useDataErrors = false;
+	prototype.parallel = false;	// the columns are fitted in parallel
+	prototype.compiled = prototype.model.compile(fitData.model, fitData.paramNames);
+	DEBUG("model compiled: " << prototype.compiled);
+
+	// the warm start chains the columns of a block
+	const size_t chainSize = 16;
+	const size_t chains = ((size_t)count + chainSize - 1)/chainSize;
+
+	FitResult* resultData = results.data();
+	const QVector<double>* xs = data.x.constData();
+	const QVector<double>* ys = data.y.constData();
+	const std::function<void(size_t, size_t)> fitColumns = [&](size_t beginChain, size_t endChain) {
+		FitWorkspace workspace;
+		FitState state = prototype;
+		const size_t end = qMin(endChain * chainSize, (size_t)count);
+		const FitResult* previous = nullptr;
+		for (size_t c = beginChain * chainSize; c < end; ++c) {
+			if (canceled && *canceled)
+				return;
+			if (c % chainSize == 0)
+				previous = nullptr;
+
+			FitResult& result = resultData[c];
+			const int n = xs[c].size();
+			if (n == 0 || n < np) {
+				result.available = true;
+				result.status = (n == 0) ? i18n("No data points available.")
+					: i18n("The number of data points (%1) must be greater than or equal to the number of parameters (%2).", n, np);
+				previous = nullptr;
+				if (fitted)
+					++*fitted;
+				continue;
+			}
+
+			QElapsedTimer timer;
+			timer.start();
+			state.fitData.paramStartValues = (warmStart && previous) ? previous->paramValues : fitData.paramStartValues;
+			state.fitResult = FitResult();
+			XYAnalysisJob job;
+			job.x = xs[c];
+			job.y = ys[c];
+			runFit(job, state, workspace);
+
+			result = state.fitResult;
+			result.elapsedTime = timer.elapsed();
+			previous = result.valid ? &result : nullptr;
+			if (fitted)
+				++*fitted;
+		}
+	};
+
+	// models that can't be compiled are evaluated with the parser, which is not thread-safe
+	XYAnalysisCurvePrivate::evaluateRanges(chains, prototype.compiled, fitColumns, 1);
+
+	return results;
+}
+
+/*!
+ * fits the model in \c fitData to the values of every column in \c yColumns versus the values of \c xColumn,
+ * see fitBatch() above.
+ */
+QVector<XYFitCurve::FitResult> XYFitCurve::fitBatch(const FitData& fitData, const AbstractColumn* xColumn,
+		const QVector<const AbstractColumn*>& yColumns, bool warmStart) {
+	if (!xColumn)
+		return QVector<FitResult>(yColumns.size());
+
+	return fitBatch(fitData, batchData(fitData, xColumn, yColumns), warmStart);
+}
+
+/*!
+ * writes the results \c results of the batch fit of the columns \c yColumns with the settings \c fitData
+ * to \c spreadsheet, one row per fitted column. The spreadsheet contains the name of the column, the values
+ * and the errors of all parameters and the goodness of the fit.
+ */
+void XYFitCurve::writeBatchResults(Spreadsheet* spreadsheet, const FitData& fitData,
+		const QVector<const AbstractColumn*>& yColumns, const QVector<FitResult>& results) {
+	const int count = results.size();
+	const int np = fitData.paramNames.size();
+	const QStringList& paramNames = (fitData.paramNamesUtf8.size() == np) ? fitData.paramNamesUtf8 : fitData.paramNames;
+
+	QVector<QString> names(count);
+	QVector<QString> status(count);
+	QVector<int> iterations(count);
+	QVector<QVector<double>> values(2 * np + 7, QVector<double>(count, NAN));
+	for (int i = 0; i < count; ++i) {
+		const FitResult& result = results.at(i);
+		names[i] = (i < yColumns.size()) ? yColumns.at(i)->name() : QString();
+		status[i] = result.status;
+		iterations[i] = result.iterations;
+		if (!result.valid)
+			continue;
+
+		for (int j = 0; j < np; ++j) {
+			values[2 * j][i] = result.paramValues.at(j);
+			values[2 * j + 1][i] = result.errorValues.at(j);
+		}
+		values[2 * np][i] = result.sse;
+		values[2 * np + 1][i] = result.rms;
+		values[2 * np + 2][i] = result.rmse;
+		values[2 * np + 3][i] = result.rsquare;
+		values[2 * np + 4][i] = result.rsquareAdj;
+		values[2 * np + 5][i] = result.aic;
+		values[2 * np + 6][i] = result.bic;
+	}
+
+	QStringList valueNames;
+	for (const auto& name : paramNames)
+		valueNames << name << i18n("%1 error", name);
+	valueNames << i18n("sum of squared residuals") << i18n("reduced chi^2") << i18n("root mean square error")
+		<< i18n("R^2") << i18n("adj. R^2") << i18n("AIC") << i18n("BIC");
+
+	spreadsheet->setColumnCount(values.size() + 3);
+	spreadsheet->setRowCount(count);
+
+	Column* column = spreadsheet->column(0);
+	column->setName(i18n("column"));
+	column->setColumnMode(AbstractColumn::Text);
+	column->setPlotDesignation(AbstractColumn::X);
+	column->replaceTexts(0, names);
+
+	for (int i = 0; i < values.size(); ++i) {
+		column = spreadsheet->column(i + 1);
+		column->setName(valueNames.at(i));
+		column->setColumnMode(AbstractColumn::Numeric);
+		column->setPlotDesignation(i < 2 * np && i % 2 == 1 ? AbstractColumn::YError : AbstractColumn::Y);
+		column->replaceValues(0, values.at(i));
+	}
+
+	column = spreadsheet->column(values.size() + 1);
+	column->setName(i18n("iterations"));
+	column->setColumnMode(AbstractColumn::Integer);
+	column->setPlotDesignation(AbstractColumn::NoDesignation);
+	column->replaceInteger(0, iterations);
+
+	column = spreadsheet->column(values.size() + 2);
+	column->setName(i18n("status"));
+	column->setColumnMode(AbstractColumn::Text);
+	column->setPlotDesignation(AbstractColumn::NoDesignation);
+	column->replaceTexts(0, status);
+}
+
+/* prepare the fit result columns */
+void XYFitCurvePrivate::prepareResultColumns() {
+	//create fit result columns if not available yet, clear them otherwise
+	if (!xColumn) {	// all columns are treated together
+		xColumn = new Column("x", AbstractColumn::Numeric);
+		yColumn = new Column("y", AbstractColumn::Numeric);
+		residualsColumn = new Column("residuals", AbstractColumn::Numeric);
+		xVector = static_cast<QVector<double>* >(xColumn->data());
+		yVector = static_cast<QVector<double>* >(yColumn->data());
+		residualsVector = static_cast<QVector<double>* >(residualsColumn->data());
+
+		xColumn->setHidden(true);
+		q->addChild(xColumn);
 
-	//calculate the fit function (vectors)
-	evaluate();
-	fitResult.elapsedTime = timer.elapsed();
+		yColumn->setHidden(true);
+		q->addChild(yColumn);
 
-	sourceDataChangedSinceLastRecalc = false;
-	DEBUG("XYFitCurvePrivate::recalculate() DONE");
+		q->addChild(residualsColumn);
+
+		q->setUndoAware(false);
+		q->setXColumn(xColumn);
+		q->setYColumn(yColumn);
+		q->setUndoAware(true);
+	} else {
+		xVector->clear();
+		yVector->clear();
+		residualsVector->clear();
+	}
+}
+
+void XYFitCurvePrivate::recalculate() {
+	DEBUG("XYFitCurvePrivate::recalculate()");
+
+	QElapsedTimer timer;
+	timer.start();
+
+	//a running recalculation is superseded by this one
+	cancelJob();
+
+	// prepare source data columns
+	const AbstractColumn* tmpXDataColumn = nullptr;
+	const AbstractColumn* tmpYDataColumn = nullptr;
+	if (dataSourceType == XYAnalysisCurve::DataSourceSpreadsheet) {
+		DEBUG("	spreadsheet columns as data source");
+		tmpXDataColumn = xDataColumn;
+		tmpYDataColumn = yDataColumn;
+	} else {
+		DEBUG("	curve columns as data source");
+		tmpXDataColumn = dataSourceCurve->xColumn();
+		tmpYDataColumn = dataSourceCurve->yColumn();
+	}
+
+	// clear the previous result
+	fitResult = XYFitCurve::FitResult();
+
+	if (!tmpXDataColumn || !tmpYDataColumn) {
+		DEBUG("ERROR: Preparing source data columns failed!");
+		emit q->dataChanged();
+		sourceDataChangedSinceLastRecalc = false;
+		return;
+	}
+
+	prepareResultColumns();
+
+	//fit settings
+	const unsigned int np = fitData.paramNames.size(); //number of fit parameters
+	if (np == 0) {
+		fitResult.available = true;
+		fitResult.valid = false;
+		fitResult.status = i18n("Model has no parameters.");
+		emit q->dataChanged();
+		sourceDataChangedSinceLastRecalc = false;
+		return;
+	}
+
+	if (yErrorColumn) {
+		if (yErrorColumn->rowCount() < tmpXDataColumn->rowCount()) {
+			fitResult.available = true;
+			fitResult.valid = false;
+			fitResult.status = i18n("Not sufficient weight data points provided.");
+			emit q->dataChanged();
+			sourceDataChangedSinceLastRecalc = false;
+			return;
+		}
+	}
+
+	//copy all valid data point for the fit to temporary vectors
+	QVector<double> xdataVector;
+	QVector<double> ydataVector;
+	QVector<double> xerrorVector;
+	QVector<double> yerrorVector;
+	double xmin, xmax;
+	if (fitData.autoRange) {
+		xmin = tmpXDataColumn->minimum();
+		xmax = tmpXDataColumn->maximum();
+	} else {
+		xmin = fitData.fitRange.first();
+		xmax = fitData.fitRange.last();
+	}
+	DEBUG("fit range = " << xmin << " .. " << xmax);
+
+	int rowCount = qMin(tmpXDataColumn->rowCount(), tmpYDataColumn->rowCount());
+	for (int row = 0; row < rowCount; ++row) {
+		//only copy those data where _all_ values (for x and y and errors, if given) are valid
+		if (std::isnan(tmpXDataColumn->valueAt(row)) || std::isnan(tmpYDataColumn->valueAt(row))
+			|| tmpXDataColumn->isMasked(row) || tmpYDataColumn->isMasked(row))
+			continue;
+
+		// only when inside given range
+		if (tmpXDataColumn->valueAt(row) >= xmin && tmpXDataColumn->valueAt(row) <= xmax) {
+			if ((!xErrorColumn && !yErrorColumn) || !fitData.useDataErrors) {	// x-y
+				xdataVector.append(tmpXDataColumn->valueAt(row));
+				ydataVector.append(tmpYDataColumn->valueAt(row));
+			} else if (!xErrorColumn && yErrorColumn) {	// x-y-dy
+				if (!std::isnan(yErrorColumn->valueAt(row))) {
+					xdataVector.append(tmpXDataColumn->valueAt(row));
+					ydataVector.append(tmpYDataColumn->valueAt(row));
+					yerrorVector.append(yErrorColumn->valueAt(row));
+				}
+			} else if (xErrorColumn && yErrorColumn) {	// x-y-dx-dy
+				if (!std::isnan(xErrorColumn->valueAt(row)) && !std::isnan(yErrorColumn->valueAt(row))) {
+					xdataVector.append(tmpXDataColumn->valueAt(row));
+					ydataVector.append(tmpYDataColumn->valueAt(row));
+					xerrorVector.append(xErrorColumn->valueAt(row));
+					yerrorVector.append(yErrorColumn->valueAt(row));
+				}
+			}
+		}
+
+	}
+	//number of data points to fit
+	const size_t n = xdataVector.size();
+	DEBUG("number of data points: " << n);
+	if (n == 0) {
+		fitResult.available = true;
+		fitResult.valid = false;
+		fitResult.status = i18n("No data points available.");
+		emit q->dataChanged();
+		sourceDataChangedSinceLastRecalc = false;
+		return;
+	}
+
+	if (n < np) {
+		fitResult.available = true;
+		fitResult.valid = false;
+		fitResult.status = i18n("The number of data points (%1) must be greater than or equal to the number of parameters (%2).", n, np);
+		emit q->dataChanged();
+		sourceDataChangedSinceLastRecalc = false;
+		return;
+	}
+
+	if (fitData.model.simplified().isEmpty()) {
+		fitResult.available = true;
+		fitResult.valid = false;
+		fitResult.status = i18n("Fit model not specified.");
+		emit q->dataChanged();
+		sourceDataChangedSinceLastRecalc = false;
+		return;
+	}
+
+	// the fit runs on copies of the data and of the fit settings
+	auto job = std::make_shared<XYAnalysisJob>();
+	job->x.swap(xdataVector);
+	job->y.swap(ydataVector);
+	auto state = std::make_shared<FitState>();
+	state->fitData = fitData;
+	state->xerror.swap(xerrorVector);
+	state->yerror.swap(yerrorVector);
+	state->compiled = state->model.compile(fitData.model, fitData.paramNames);
+	DEBUG("model compiled: " << state->compiled);
+
+	// custom models that can't be compiled are evaluated with the parser, which is not thread-safe
+	runJob(job, [state](XYAnalysisJob& job) {
+		FitWorkspace workspace;
+		runFit(job, *state, workspace);
+	}, [=](XYAnalysisJob&) {
+		fitResult = state->fitResult;
+		// use results as start values if desired
+		if (fitData.useResults)
+			fitData.paramStartValues = state->fitResult.paramValues;
+
+		// fill residuals vector. To get residuals on the correct x values, fill the rest with zeros.
+		const AbstractColumn* tmpXDataColumn = nullptr;
+		const AbstractColumn* tmpYDataColumn = nullptr;
+		if (dataSourceType == XYAnalysisCurve::DataSourceSpreadsheet) {
+			tmpXDataColumn = xDataColumn;
+			tmpYDataColumn = yDataColumn;
+		} else if (dataSourceCurve) {
+			tmpXDataColumn = dataSourceCurve->xColumn();
+			tmpYDataColumn = dataSourceCurve->yColumn();
+		}
+
+		if (tmpXDataColumn && tmpYDataColumn) {
+			residualsVector->resize(tmpXDataColumn->rowCount());
+			if (fitData.autoRange) {	// evaluate full range of residuals
+				xVector->resize(tmpXDataColumn->rowCount());
+				for (int i = 0; i < tmpXDataColumn->rowCount(); i++)
+					(*xVector)[i] = tmpXDataColumn->valueAt(i);
+				ExpressionParser* parser = ExpressionParser::getInstance();
+				bool rc = parser->evaluateCartesian(fitData.model, xVector, residualsVector,
+									fitData.paramNames, fitResult.paramValues);
+				for (int i = 0; i < tmpXDataColumn->rowCount(); i++)
+					(*residualsVector)[i] = tmpYDataColumn->valueAt(i) - (*residualsVector)[i];
+				if (!rc)
+					residualsVector->clear();
+			} else {	// only selected range
+				int j = 0;
+				for (int i = 0; i < tmpXDataColumn->rowCount(); i++) {
+					if (tmpXDataColumn->valueAt(i) >= xmin && tmpXDataColumn->valueAt(i) <= xmax && j < state->residuals.size())
+						residualsVector->data()[i] = state->residuals.at(j++);
+					else	// outside range
+						residualsVector->data()[i] = 0;
+				}
+			}
+			residualsColumn->setChanged();
+		}
+
+		//calculate the fit function (vectors)
+		evaluate();
+		fitResult.elapsedTime = timer.elapsed();
+		DEBUG("XYFitCurvePrivate::recalculate() DONE");
+	}, state->compiled);
 }
 
 /* evaluate fit function */
@@ -2067,30 +2508,6 @@ void XYFitCurvePrivate::evaluate(bool preview) {
 	emit q->dataChanged();
 }
 
-/*!
- * writes out the current state of the solver \c s
- */
-void XYFitCurvePrivate::writeSolverState(gsl_multifit_fdfsolver* s) {
-	QString state;
-
-	//current parameter values, semicolon separated
-	double* min = fitData.paramLowerLimits.data();
-	double* max = fitData.paramUpperLimits.data();
-	for (int i = 0; i < fitData.paramNames.size(); ++i) {
-		const double x = gsl_vector_get(s->x, i);
-		// map parameter if bounded
-		state += QString::number(nsl_fit_map_bound(x, min[i], max[i])) + '\t';
-	}
-
-	//current value of the chi2-function
-	state += QString::number(gsl_pow_2(gsl_blas_dnrm2(s->f)));
-	state += ';';
-	DEBUG("	chi = " << gsl_pow_2(gsl_blas_dnrm2(s->f)));
-
-	fitResult.solverOutput += state;
-}
-
-
 //##############################################################################
 //##################  Serialization/Deserialization  ###########################
 //##############################################################################
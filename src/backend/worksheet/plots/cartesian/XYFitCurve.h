@@ -37,7 +37,10 @@ extern "C" {
 #include "backend/nsl/nsl_fit.h"
 }
 
+#include <atomic>
+
 class XYFitCurvePrivate;
+class Spreadsheet;
 
 class XYFitCurve : public XYAnalysisCurve {
 	Q_OBJECT
@@ -115,6 +118,16 @@ public:
 	static void initFitData(XYFitCurve::FitData&);
 	void initStartValues(const XYCurve*);
 	static void initStartValues(XYFitCurve::FitData&, const XYCurve*);
+	struct BatchData {	// valid data points in the fit range of the columns of a batch fit
+		QVector<QVector<double>> x;
+		QVector<QVector<double>> y;
+	};
+
+	static BatchData batchData(const FitData&, const AbstractColumn* xColumn, const QVector<const AbstractColumn*>& yColumns);
+	static QVector<FitResult> fitBatch(const FitData&, const BatchData&, bool warmStart = false,
+			const std::atomic<bool>* canceled = nullptr, std::atomic<int>* fitted = nullptr);
+	static QVector<FitResult> fitBatch(const FitData&, const AbstractColumn* xColumn, const QVector<const AbstractColumn*>& yColumns, bool warmStart = false);
+	static void writeBatchResults(Spreadsheet*, const FitData&, const QVector<const AbstractColumn*>& yColumns, const QVector<FitResult>&);
 
 	QIcon icon() const override;
 	void save(QXmlStreamWriter*) const override;
@@ -63,7 +63,6 @@ public:
 
 private:
 	void prepareResultColumns();
-	void writeSolverState(gsl_multifit_fdfsolver*);
 };
 
 #endif
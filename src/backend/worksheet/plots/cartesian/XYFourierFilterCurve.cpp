@@ -113,6 +113,9 @@ void XYFourierFilterCurvePrivate::recalculate() {
 	QElapsedTimer timer;
 	timer.start();
 
+	//a running recalculation is superseded by this one
+	cancelJob();
+
 	//create filter result columns if not available yet, clear them otherwise
 	if (!xColumn) {
 		xColumn = new Column("x", AbstractColumn::Numeric);
@@ -199,10 +202,6 @@ void XYFourierFilterCurvePrivate::recalculate() {
 		return;
 	}
 
-	//double* xdata = xdataVector.data();
-	double* ydata = ydataVector.data();
-
-
 	// filter settings
 	const nsl_filter_type type = filterData.type;
 	const nsl_filter_form form = filterData.form;
@@ -248,25 +247,28 @@ void XYFourierFilterCurvePrivate::recalculate() {
 	DEBUG("cut off @" << cutindex << cutindex2);
 	DEBUG("bandwidth =" << bandwidth);
 
-	// run filter
-	int status = nsl_filter_fourier(ydata, n, type, form, order, cutindex, bandwidth);
+	auto job = std::make_shared<XYAnalysisJob>();
+	job->x.swap(xdataVector);
+	job->y.swap(ydataVector);
 
-	xVector->resize((int)n);
-	yVector->resize((int)n);
-	memcpy(xVector->data(), xdataVector.data(), n*sizeof(double));
-	memcpy(yVector->data(), ydata, n*sizeof(double));
+	runJob(job, [=](XYAnalysisJob& job) {
+		// run filter
+		job.status = nsl_filter_fourier(job.y.data(), n, type, form, order, cutindex, bandwidth);
+	}, [=](XYAnalysisJob& job) {
+		*xVector = job.x;
+		*yVector = job.y;
 ///////////////////////////////////////////////////////////
 
-	//write the result
-	filterResult.available = true;
-	filterResult.valid = true;
-	filterResult.status = gslErrorToString(status);
-	filterResult.elapsedTime = timer.elapsed();
+		//write the result
+		filterResult.available = true;
+		filterResult.valid = true;
+		filterResult.status = gslErrorToString(job.status);
+		filterResult.elapsedTime = timer.elapsed();
 
-	//redraw the curve
-	recalcLogicalPoints();
-	emit q->dataChanged();
-	sourceDataChangedSinceLastRecalc = false;
+		//redraw the curve
+		recalcLogicalPoints();
+		emit q->dataChanged();
+	});
 }
 
 //##############################################################################
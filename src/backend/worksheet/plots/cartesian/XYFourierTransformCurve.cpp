@@ -52,6 +52,8 @@ extern "C" {
 #include <QThreadPool>
 #include <QDebug>	// qWarning()
 
+#include <algorithm>	// std::reverse
+
 XYFourierTransformCurve::XYFourierTransformCurve(const QString& name)
 	: XYAnalysisCurve(name, new XYFourierTransformCurvePrivate(this), AspectType::XYFourierTransformCurve) {
 }
@@ -109,6 +111,9 @@ void XYFourierTransformCurvePrivate::recalculate() {
 	QElapsedTimer timer;
 	timer.start();
 
+	//a running recalculation is superseded by this one
+	cancelJob();
+
 	//create transform result columns if not available yet, clear them otherwise
 	if (!xColumn) {
 		xColumn = new Column("x", AbstractColumn::Numeric);
@@ -132,6 +137,7 @@ void XYFourierTransformCurvePrivate::recalculate() {
 
 	// clear the previous result
 	transformResult = XYFourierTransformCurve::TransformResult();
+	processedSource = XYAnalysisSource();
 
 	if (!xDataColumn || !yDataColumn) {
 		recalcLogicalPoints();
@@ -143,21 +149,41 @@ void XYFourierTransformCurvePrivate::recalculate() {
 	//copy all valid data point for the transform to temporary vectors
 	QVector<double> xdataVector;
 	QVector<double> ydataVector;
-	const double xmin = transformData.xRange.first();
-	const double xmax = transformData.xRange.last();
-
-	int rowCount = qMin(xDataColumn->rowCount(), yDataColumn->rowCount());
-	for (int row = 0; row < rowCount; ++row) {
-		// only copy those data where _all_ values (for x and y, if given) are valid
-		if (std::isnan(xDataColumn->valueAt(row)) || std::isnan(yDataColumn->valueAt(row))
-				|| xDataColumn->isMasked(row) || yDataColumn->isMasked(row))
-			continue;
+	double xmin = transformData.xRange.first();
+	double xmax = transformData.xRange.last();
+
+	const XYAnalysisSource source = currentSource(xDataColumn, yDataColumn);
+	const int rowCount = source.rows;
+	if (transformData.sliding) {
+		//short-time transform: only the last frame of the data is transformed, independent of the x range
+		const int frameSize = (int)transformData.frameSize;
+		for (int row = rowCount - 1; row >= 0 && xdataVector.size() < frameSize; --row) {
+			if (std::isnan(xDataColumn->valueAt(row)) || std::isnan(yDataColumn->valueAt(row))
+					|| xDataColumn->isMasked(row) || yDataColumn->isMasked(row))
+				continue;
 
-		// only when inside given range
-		if (xDataColumn->valueAt(row) >= xmin && xDataColumn->valueAt(row) <= xmax) {
 			xdataVector.append(xDataColumn->valueAt(row));
 			ydataVector.append(yDataColumn->valueAt(row));
 		}
+		std::reverse(xdataVector.begin(), xdataVector.end());
+		std::reverse(ydataVector.begin(), ydataVector.end());
+		if (!xdataVector.isEmpty()) {
+			xmin = xdataVector.constFirst();
+			xmax = xdataVector.constLast();
+		}
+	} else {
+		for (int row = 0; row < rowCount; ++row) {
+			// only copy those data where _all_ values (for x and y, if given) are valid
+			if (std::isnan(xDataColumn->valueAt(row)) || std::isnan(yDataColumn->valueAt(row))
+					|| xDataColumn->isMasked(row) || yDataColumn->isMasked(row))
+				continue;
+
+			// only when inside given range
+			if (xDataColumn->valueAt(row) >= xmin && xDataColumn->valueAt(row) <= xmax) {
+				xdataVector.append(xDataColumn->valueAt(row));
+				ydataVector.append(yDataColumn->valueAt(row));
+			}
+		}
 	}
 
 	//number of data points to transform
@@ -172,9 +198,6 @@ void XYFourierTransformCurvePrivate::recalculate() {
 		return;
 	}
 
-	double* xdata = xdataVector.data();
-	double* ydata = ydataVector.data();
-
 	// transform settings
 	const nsl_sf_window_type windowType = transformData.windowType;
 	const nsl_dft_result_type type = transformData.type;
@@ -188,75 +211,97 @@ void XYFourierTransformCurvePrivate::recalculate() {
 	DEBUG("scale:" << nsl_dft_xscale_name[xScale]);
 	DEBUG("two sided:" << twoSided);
 	DEBUG("shifted:" << shifted);
-#ifndef NDEBUG
-	QDebug out = qDebug();
-	for (unsigned int i = 0; i < n; i++)
-		out<<ydata[i];
-#endif
+
+	auto job = std::make_shared<XYAnalysisJob>();
+	job->x.swap(xdataVector);
+	job->y.swap(ydataVector);
+
+	runJob(job, [=](XYAnalysisJob& job) {
+		double* xdata = job.x.data();
+		double* ydata = job.y.data();
 
 ///////////////////////////////////////////////////////////
-	// transform with window
-	int status = nsl_dft_transform_window(ydata, 1, n, twoSided, type, windowType);
-
-	unsigned int N = n;
-	if (twoSided == false)
-		N = n/2;
-
-	switch (xScale) {
-	case nsl_dft_xscale_frequency:
-		for (unsigned int i = 0; i < N; i++) {
-			if (i >= n/2 && shifted)
-				xdata[i] = (n-1)/(xmax-xmin)*(i/(double)n-1.);
-			else
-				xdata[i] = (n-1)*i/(xmax-xmin)/n;
-		}
-		break;
-	case nsl_dft_xscale_index:
-		for (unsigned int i = 0; i < N; i++) {
-			if (i >= n/2 && shifted)
-				xdata[i] = (int)i-(int) N;
-			else
-				xdata[i] = i;
-		}
-		break;
-	case nsl_dft_xscale_period: {
-			double f0 = (n-1)/(xmax-xmin)/n;
+		// transform with window
+		job.status = nsl_dft_transform_window(ydata, 1, n, twoSided, type, windowType);
+		if (job.isCanceled())
+			return;
+		job.setProgress(50);
+
+		unsigned int N = n;
+		if (twoSided == false)
+			N = n/2;
+
+		switch (xScale) {
+		case nsl_dft_xscale_frequency:
+			for (unsigned int i = 0; i < N; i++) {
+				if (i >= n/2 && shifted)
+					xdata[i] = (n-1)/(xmax-xmin)*(i/(double)n-1.);
+				else
+					xdata[i] = (n-1)*i/(xmax-xmin)/n;
+			}
+			break;
+		case nsl_dft_xscale_index:
 			for (unsigned int i = 0; i < N; i++) {
-				double f = (n-1)*i/(xmax-xmin)/n;
-				xdata[i] = 1/(f+f0);
+				if (i >= n/2 && shifted)
+					xdata[i] = (int)i-(int) N;
+				else
+					xdata[i] = i;
 			}
 			break;
+		case nsl_dft_xscale_period: {
+				double f0 = (n-1)/(xmax-xmin)/n;
+				for (unsigned int i = 0; i < N; i++) {
+					double f = (n-1)*i/(xmax-xmin)/n;
+					xdata[i] = 1/(f+f0);
+				}
+				break;
+			}
 		}
-	}
-#ifndef NDEBUG
-	out = qDebug();
-	for (unsigned int i = 0; i < N; i++)
-		out << ydata[i] << '(' << xdata[i] << ')';
-#endif
-
-	xVector->resize((int)N);
-	yVector->resize((int)N);
-	if (shifted) {
-		memcpy(xVector->data(), &xdata[n/2], n/2*sizeof(double));
-		memcpy(&xVector->data()[n/2], xdata, n/2*sizeof(double));
-		memcpy(yVector->data(), &ydata[n/2], n/2*sizeof(double));
-		memcpy(&yVector->data()[n/2], ydata, n/2*sizeof(double));
-	} else {
-		memcpy(xVector->data(), xdata, N*sizeof(double));
-		memcpy(yVector->data(), ydata, N*sizeof(double));
-	}
+
+		QVector<double> x(N), y(N);
+		if (shifted) {
+			memcpy(x.data(), &xdata[n/2], n/2*sizeof(double));
+			memcpy(&x.data()[n/2], xdata, n/2*sizeof(double));
+			memcpy(y.data(), &ydata[n/2], n/2*sizeof(double));
+			memcpy(&y.data()[n/2], ydata, n/2*sizeof(double));
+		} else {
+			memcpy(x.data(), xdata, N*sizeof(double));
+			memcpy(y.data(), ydata, N*sizeof(double));
+		}
+		job.x.swap(x);
+		job.y.swap(y);
 ///////////////////////////////////////////////////////////
+	}, [=](XYAnalysisJob& job) {
+		*xVector = job.x;
+		*yVector = job.y;
+		processedSource = source;
 
-	//write the result
-	transformResult.available = true;
-	transformResult.valid = true;
-	transformResult.status = gslErrorToString(status);
-	transformResult.elapsedTime = timer.elapsed();
+		//write the result
+		transformResult.available = true;
+		transformResult.valid = true;
+		transformResult.status = gslErrorToString(job.status);
+		transformResult.elapsedTime = timer.elapsed();
 
-	//redraw the curve
-	recalcLogicalPoints();
-	emit q->dataChanged();
-	sourceDataChangedSinceLastRecalc = false;
+		//redraw the curve
+		recalcLogicalPoints();
+		emit q->dataChanged();
+	});
+}
+
+/*!
+ * the transform can't be extended by new data points. For the short-time transform
+ * only the last frame is transformed again, independent of the length of the source data.
+ */
+bool XYFourierTransformCurvePrivate::recalculateIncrementally() {
+	if (!transformData.sliding)
+		return false;
+
+	const XYAnalysisSource source = currentSource(xDataColumn, yDataColumn);
+	if (source.rows == processedSource.rows && appendedRows(source))	//no new data
+		return true;
+
+	recalculate();
+	return true;
 }
 
 //##############################################################################
@@ -282,6 +327,8 @@ void XYFourierTransformCurve::save(QXmlStreamWriter* writer) const {
 	writer->writeAttribute( "shifted", QString::number(d->transformData.shifted) );
 	writer->writeAttribute( "xScale", QString::number(d->transformData.xScale) );
 	writer->writeAttribute( "windowType", QString::number(d->transformData.windowType) );
+	writer->writeAttribute( "sliding", QString::number(d->transformData.sliding) );
+	writer->writeAttribute( "frameSize", QString::number(d->transformData.frameSize) );
 	writer->writeEndElement();// transformData
 
 	//transform results (generated columns)
@@ -329,6 +376,13 @@ bool XYFourierTransformCurve::load(XmlStreamReader* reader, bool preview) {
 			READ_INT_VALUE("shifted", transformData.shifted, bool);
 			READ_INT_VALUE("xScale", transformData.xScale, nsl_dft_xscale);
 			READ_INT_VALUE("windowType", transformData.windowType, nsl_sf_window_type);
+			//not available in older projects
+			str = attribs.value("sliding").toString();
+			if (!str.isEmpty())
+				d->transformData.sliding = str.toInt();
+			str = attribs.value("frameSize").toString();
+			if (!str.isEmpty())
+				d->transformData.frameSize = str.toULong();
 		} else if (!preview && reader->name() == "transformResult") {
 			attribs = reader->attributes();
 			READ_INT_VALUE("available", transformResult.available, int);
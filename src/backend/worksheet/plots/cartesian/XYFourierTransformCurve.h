@@ -52,6 +52,8 @@ public:
 		nsl_sf_window_type windowType{nsl_sf_window_uniform};
 		bool autoRange{true};		// use all data?
 		QVector<double> xRange;		// x range for transform
+		bool sliding{false};		// transform the last frame of the data only (short-time transform)?
+		size_t frameSize{1024};		// number of points in the frame
 	};
 	struct TransformResult {
 		TransformResult() {};
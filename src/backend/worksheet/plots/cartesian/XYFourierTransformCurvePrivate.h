@@ -41,6 +41,7 @@ public:
 	explicit XYFourierTransformCurvePrivate(XYFourierTransformCurve*);
 	~XYFourierTransformCurvePrivate() override;
 	void recalculate();
+	bool recalculateIncrementally() override;
 
 	XYFourierTransformCurve::TransformData transformData;
 	XYFourierTransformCurve::TransformResult transformResult;
@@ -130,19 +130,12 @@ void XYIntegrationCurvePrivate::recalculate() {
 
 	// clear the previous result
 	integrationResult = XYIntegrationCurve::IntegrationResult();
+	processedSource = XYAnalysisSource();
 
 	//determine the data source columns
 	const AbstractColumn* tmpXDataColumn = nullptr;
 	const AbstractColumn* tmpYDataColumn = nullptr;
-	if (dataSourceType == XYAnalysisCurve::DataSourceSpreadsheet) {
-		//spreadsheet columns as data source
-		tmpXDataColumn = xDataColumn;
-		tmpYDataColumn = yDataColumn;
-	} else {
-		//curve columns as data source
-		tmpXDataColumn = dataSourceCurve->xColumn();
-		tmpYDataColumn = dataSourceCurve->yColumn();
-	}
+	sourceColumns(tmpXDataColumn, tmpYDataColumn);
 
 	if (!tmpXDataColumn || !tmpYDataColumn) {
 		recalcLogicalPoints();
@@ -154,30 +147,8 @@ void XYIntegrationCurvePrivate::recalculate() {
 	//copy all valid data point for the integration to temporary vectors
 	QVector<double> xdataVector;
 	QVector<double> ydataVector;
-
-	double xmin;
-	double xmax;
-	if (integrationData.autoRange) {
-		xmin = tmpXDataColumn->minimum();
-		xmax = tmpXDataColumn->maximum();
-	} else {
-		xmin = integrationData.xRange.first();
-		xmax = integrationData.xRange.last();
-	}
-
-	int rowCount = qMin(tmpXDataColumn->rowCount(), tmpYDataColumn->rowCount());
-	for (int row = 0; row < rowCount; ++row) {
-		//only copy those data where _all_ values (for x and y, if given) are valid
-		if (std::isnan(tmpXDataColumn->valueAt(row)) || std::isnan(tmpYDataColumn->valueAt(row))
-			|| tmpXDataColumn->isMasked(row) || tmpYDataColumn->isMasked(row))
-			continue;
-
-		// only when inside given range
-		if (tmpXDataColumn->valueAt(row) >= xmin && tmpXDataColumn->valueAt(row) <= xmax) {
-			xdataVector.append(tmpXDataColumn->valueAt(row));
-			ydataVector.append(tmpYDataColumn->valueAt(row));
-		}
-	}
+	const XYAnalysisSource source = currentSource(tmpXDataColumn, tmpYDataColumn);
+	copyData(tmpXDataColumn, tmpYDataColumn, 0, source.rows, xdataVector, ydataVector);
 
 	const size_t n = (size_t)xdataVector.size();	// number of data points to integrate
 	if (n < 2) {
@@ -190,34 +161,17 @@ void XYIntegrationCurvePrivate::recalculate() {
 		return;
 	}
 
+	DEBUG("method:"<<nsl_int_method_name[integrationData.method]);
+	DEBUG("absolute area:"<<integrationData.absolute);
+
+	//the points are integrated in place
+	setTail(xdataVector, ydataVector, (int)n, 0);
 	double* xdata = xdataVector.data();
 	double* ydata = ydataVector.data();
 
-	// integration settings
-	const nsl_int_method_type method = integrationData.method;
-	const bool absolute = integrationData.absolute;
-
-	DEBUG("method:"<<nsl_int_method_name[method]);
-	DEBUG("absolute area:"<<absolute);
-
 ///////////////////////////////////////////////////////////
 	int status = 0;
-	size_t np = n;
-
-	switch (method) {
-	case nsl_int_method_rectangle:
-		status = nsl_int_rectangle(xdata, ydata, n, absolute);
-		break;
-	case nsl_int_method_trapezoid:
-		status = nsl_int_trapezoid(xdata, ydata, n, absolute);
-		break;
-	case nsl_int_method_simpson:
-		np = nsl_int_simpson(xdata, ydata, n, absolute);
-		break;
-	case nsl_int_method_simpson_3_8:
-		np = nsl_int_simpson_3_8(xdata, ydata, n, absolute);
-		break;
-	}
+	const size_t np = integrate(xdata, ydata, n, status);
 
 	xVector->resize((int)np);
 	yVector->resize((int)np);
@@ -231,6 +185,8 @@ void XYIntegrationCurvePrivate::recalculate() {
 	integrationResult.status = QString::number(status);
 	integrationResult.elapsedTime = timer.elapsed();
 	integrationResult.value = ydata[np-1];
+	if (np > 0)
+		processedSource = source;
 
 	//redraw the curve
 	recalcLogicalPoints();
@@ -238,6 +194,125 @@ void XYIntegrationCurvePrivate::recalculate() {
 	sourceDataChangedSinceLastRecalc = false;
 }
 
+/*!
+ * continues the integration with the rows appended to the source columns, starting at the last complete group of points.
+ */
+bool XYIntegrationCurvePrivate::recalculateIncrementally() {
+	const AbstractColumn* tmpXDataColumn = nullptr;
+	const AbstractColumn* tmpYDataColumn = nullptr;
+	sourceColumns(tmpXDataColumn, tmpYDataColumn);
+	const XYAnalysisSource source = currentSource(tmpXDataColumn, tmpYDataColumn);
+	if (!integrationResult.valid || tailX.isEmpty() || !appendedRows(source))
+		return false;
+
+	QElapsedTimer timer;
+	timer.start();
+
+	QVector<double> xdataVector = tailX;
+	QVector<double> ydataVector = tailY;
+	copyData(tmpXDataColumn, tmpYDataColumn, processedSource.rows, source.rows, xdataVector, ydataVector);
+	processedSource = source;
+	const size_t n = (size_t)xdataVector.size();
+	if (n == (size_t)tailX.size())	//no new valid points
+		return true;
+
+	const int index = tailIndex;
+	setTail(xdataVector, ydataVector, (int)n, index);
+	double* xdata = xdataVector.data();
+	double* ydata = ydataVector.data();
+	int status = 0;
+	const size_t np = integrate(xdata, ydata, n, status);
+	if (np == 0)
+		return false;
+
+	//replace the results after the start of the tail, the first result is the integral up to the tail
+	const double offset = yVector->at(index);
+	xVector->resize(index + 1);
+	yVector->resize(index + 1);
+	for (size_t i = 1; i < np; ++i) {
+		xVector->append(xdata[i]);
+		yVector->append(offset + ydata[i]);
+	}
+
+	integrationResult.status = QString::number(status);
+	integrationResult.elapsedTime = timer.elapsed();
+	integrationResult.value = yVector->last();
+
+	recalcLogicalPoints();
+	emit q->dataChanged();
+	return true;
+}
+
+/*!
+ * copies all valid data points in the rows \c first to \c last - 1 of the columns \c x and \c y to \c xdata and \c ydata.
+ */
+void XYIntegrationCurvePrivate::copyData(const AbstractColumn* x, const AbstractColumn* y, int first, int last,
+		QVector<double>& xdata, QVector<double>& ydata) const {
+	//all data points are inside the automatic range
+	const bool autoRange = integrationData.autoRange;
+	const double xmin = integrationData.xRange.first();
+	const double xmax = integrationData.xRange.last();
+
+	for (int row = first; row < last; ++row) {
+		//only copy those data where _all_ values (for x and y, if given) are valid
+		const double xValue = x->valueAt(row);
+		const double yValue = y->valueAt(row);
+		if (std::isnan(xValue) || std::isnan(yValue) || x->isMasked(row) || y->isMasked(row))
+			continue;
+
+		// only when inside given range
+		if (autoRange || (xValue >= xmin && xValue <= xmax)) {
+			xdata.append(xValue);
+			ydata.append(yValue);
+		}
+	}
+}
+
+/*!
+ * integrates the \c n points in place with the current method and returns the number of resulting points.
+ */
+size_t XYIntegrationCurvePrivate::integrate(double* xdata, double* ydata, size_t n, int& status) const {
+	const bool absolute = integrationData.absolute;
+	size_t np = n;
+
+	switch (integrationData.method) {
+	case nsl_int_method_rectangle:
+		status = nsl_int_rectangle(xdata, ydata, n, absolute);
+		break;
+	case nsl_int_method_trapezoid:
+		status = nsl_int_trapezoid(xdata, ydata, n, absolute);
+		break;
+	case nsl_int_method_simpson:
+		np = nsl_int_simpson(xdata, ydata, n, absolute);
+		break;
+	case nsl_int_method_simpson_3_8:
+		np = nsl_int_simpson_3_8(xdata, ydata, n, absolute);
+		break;
+	}
+
+	return np;
+}
+
+/*!
+ * stores the source data points to continue the integration of the \c n points \c xdata and \c ydata with,
+ * \c index is the index of the result of the first point.
+ * The tail starts one group before the end of the complete groups of points,
+ * so that the Simpson rules always have enough points for the next integration.
+ */
+void XYIntegrationCurvePrivate::setTail(const QVector<double>& xdata, const QVector<double>& ydata, int n, int index) {
+	int group = 1;	//number of intervals integrated in one step
+	if (integrationData.method == nsl_int_method_simpson)
+		group = 2;
+	else if (integrationData.method == nsl_int_method_simpson_3_8)
+		group = 3;
+
+	const int groups = (n - 1)/group;
+	const int first = group * qMax(groups - 1, 0);
+	tailX = xdata.mid(first, n - first);
+	tailY = ydata.mid(first, n - first);
+	tailIndex = index + first/group;
+}
+
 //##############################################################################
 //##################  Serialization/Deserialization  ###########################
 //##############################################################################
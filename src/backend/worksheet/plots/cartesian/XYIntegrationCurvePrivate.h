@@ -41,10 +41,20 @@ public:
 	~XYIntegrationCurvePrivate() override;
 
 	void recalculate();
+	bool recalculateIncrementally() override;
+	void copyData(const AbstractColumn* x, const AbstractColumn* y, int first, int last, QVector<double>& xdata, QVector<double>& ydata) const;
+	size_t integrate(double* xdata, double* ydata, size_t n, int& status) const;
+	void setTail(const QVector<double>& xdata, const QVector<double>& ydata, int n, int index);
 
 	XYIntegrationCurve::IntegrationData integrationData;
 	XYIntegrationCurve::IntegrationResult integrationResult;
 
+	//source data points since the start of the last complete group of points integrated with one step of the method,
+	//the integration is continued from here in the incremental mode
+	QVector<double> tailX;
+	QVector<double> tailY;
+	int tailIndex{0};	//<! index of the first tail point in the results
+
 	XYIntegrationCurve* const q;
 };
 
@@ -43,6 +43,7 @@
 #include "backend/gsl/errors.h"
 
 extern "C" {
+#include <gsl/gsl_errno.h>
 #include <gsl/gsl_interp.h>
 #include <gsl/gsl_spline.h>
 #include "backend/nsl/nsl_diff.h"
@@ -53,6 +54,8 @@ extern "C" {
 #include <QThreadPool>
 #include <QIcon>
 
+#include <numeric>
+
 XYInterpolationCurve::XYInterpolationCurve(const QString& name)
 	: XYAnalysisCurve(name, new XYInterpolationCurvePrivate(this), AspectType::XYInterpolationCurve) {
 }
@@ -110,6 +113,9 @@ void XYInterpolationCurvePrivate::recalculate() {
 	QElapsedTimer timer;
 	timer.start();
 
+	//a running recalculation is superseded by this one
+	cancelJob();
+
 	//create interpolation result columns if not available yet, clear them otherwise
 	if (!xColumn) {
 		xColumn = new Column("x", AbstractColumn::Numeric);
@@ -179,16 +185,20 @@ void XYInterpolationCurvePrivate::recalculate() {
 		xmax = interpolationData.xRange.last();
 	}
 
-	for (int row = 0; row < tmpXDataColumn->rowCount(); ++row) {
+	const int rowCount = tmpXDataColumn->rowCount();
+	xdataVector.reserve(rowCount);
+	ydataVector.reserve(rowCount);
+	for (int row = 0; row < rowCount; ++row) {
 		//only copy those data where _all_ values (for x and y, if given) are valid
-		if (!std::isnan(tmpXDataColumn->valueAt(row)) && !std::isnan(tmpYDataColumn->valueAt(row))
-		        && !tmpXDataColumn->isMasked(row) && !tmpYDataColumn->isMasked(row)) {
+		const double xValue = tmpXDataColumn->valueAt(row);
+		const double yValue = tmpYDataColumn->valueAt(row);
+		if (std::isnan(xValue) || std::isnan(yValue) || tmpXDataColumn->isMasked(row) || tmpYDataColumn->isMasked(row))
+			continue;
 
-			// only when inside given range
-			if (tmpXDataColumn->valueAt(row) >= xmin && tmpXDataColumn->valueAt(row) <= xmax) {
-				xdataVector.append(tmpXDataColumn->valueAt(row));
-				ydataVector.append(tmpYDataColumn->valueAt(row));
-			}
+		// only when inside given range
+		if (xValue >= xmin && xValue <= xmax) {
+			xdataVector.append(xValue);
+			ydataVector.append(yValue);
 		}
 	}
 
@@ -204,88 +214,214 @@ void XYInterpolationCurvePrivate::recalculate() {
 		return;
 	}
 
-	double* xdata = xdataVector.data();
-	double* ydata = ydataVector.data();
-
 	// interpolation settings
+	const XYInterpolationCurve::InterpolationData interpData = interpolationData;
 	const nsl_interp_type type = interpolationData.type;
-	const nsl_interp_pch_variant variant = interpolationData.variant;
-	const double tension = interpolationData.tension;
-	const double continuity = interpolationData.continuity;
-	const double bias = interpolationData.bias;
 	const nsl_interp_evaluate evaluate = interpolationData.evaluate;
 	const size_t npoints = interpolationData.npoints;
 
 	DEBUG("type:"<<nsl_interp_type_name[type]);
-	DEBUG("cubic Hermite variant:"<<nsl_interp_pch_variant_name[variant]<<tension<<continuity<<bias);
+	DEBUG("cubic Hermite variant:"<<nsl_interp_pch_variant_name[interpolationData.variant]<<interpolationData.tension
+		<<interpolationData.continuity<<interpolationData.bias);
 	DEBUG("evaluate:"<<nsl_interp_evaluate_name[evaluate]);
 	DEBUG("npoints ="<<npoints);
 
+	//the interpolant is only calculated again if the source data or the type were changed.
+	//an interpolant that is not thread-safe might still be evaluated by a canceled job, every job gets its own one then
+	if (!interpolant || !interpolant->isThreadSafe() || !interpolant->matches(type, xdataVector, ydataVector))
+		interpolant = std::make_shared<XYInterpolant>(type, xdataVector, ydataVector);
+	const std::shared_ptr<XYInterpolant> interp = interpolant;
+
+	auto job = std::make_shared<XYAnalysisJob>();
+	runJob(job, [=](XYAnalysisJob& job) {
+///////////////////////////////////////////////////////////
+		const int status = interp->init();
+
+		QVector<double> xResult((int)npoints), yResult((int)npoints);
+		double* xResultData = xResult.data();
+		double* yResultData = yResult.data();
+		XYAnalysisCurvePrivate::evaluateRanges(npoints, interp->isThreadSafe(), [&](size_t begin, size_t end) {
+			interp->evaluate(interpData, xmin, xmax, begin, end, xResultData, yResultData, job);
+		});
+
+		// calculate "evaluate" option for own types
+		if (type == nsl_interp_type_cosine || type == nsl_interp_type_exponential || type == nsl_interp_type_pch || type == nsl_interp_type_rational) {
+			switch (evaluate) {
+			case nsl_interp_evaluate_function:
+				break;
+			case nsl_interp_evaluate_derivative:
+				nsl_diff_first_deriv_second_order(xResultData, yResultData, npoints);
+				break;
+			case nsl_interp_evaluate_second_derivative:
+				nsl_diff_second_deriv_second_order(xResultData, yResultData, npoints);
+				break;
+			case nsl_interp_evaluate_integral:
+				nsl_int_trapezoid(xResultData, yResultData, npoints, 0);
+				break;
+			}
+		} else if (evaluate == nsl_interp_evaluate_integral) {
+			//sum up the integrals between the points, in the same order for any number of threads
+			std::partial_sum(yResultData, yResultData + npoints, yResultData);
+		}
+
+		// check values
+		for (int i = 0; i < (int)npoints; i++) {
+			if (yResultData[i] > std::numeric_limits<double>::max())
+				yResultData[i] = std::numeric_limits<double>::max();
+			else if (yResultData[i] < std::numeric_limits<double>::lowest())
+				yResultData[i] = std::numeric_limits<double>::lowest();
+		}
+
+		job.x.swap(xResult);
+		job.y.swap(yResult);
+		job.status = status;
+
 ///////////////////////////////////////////////////////////
-	int status = 0;
-
-	gsl_interp_accel *acc = gsl_interp_accel_alloc();
-	gsl_spline *spline = nullptr;
-	switch (type) {
-	case nsl_interp_type_linear:
-		spline = gsl_spline_alloc(gsl_interp_linear, n);
-		status = gsl_spline_init(spline, xdata, ydata, n);
-		break;
-	case nsl_interp_type_polynomial:
-		spline = gsl_spline_alloc(gsl_interp_polynomial, n);
-		status = gsl_spline_init(spline, xdata, ydata, n);
-		break;
-	case nsl_interp_type_cspline:
-		spline = gsl_spline_alloc(gsl_interp_cspline, n);
-		status = gsl_spline_init(spline, xdata, ydata, n);
-		break;
-	case nsl_interp_type_cspline_periodic:
-		spline = gsl_spline_alloc(gsl_interp_cspline_periodic, n);
-		status = gsl_spline_init(spline, xdata, ydata, n);
-		break;
-	case nsl_interp_type_akima:
-		spline = gsl_spline_alloc(gsl_interp_akima, n);
-		status = gsl_spline_init(spline, xdata, ydata, n);
-		break;
-	case nsl_interp_type_akima_periodic:
-		spline = gsl_spline_alloc(gsl_interp_akima_periodic, n);
-		status = gsl_spline_init(spline, xdata, ydata, n);
-		break;
-	case nsl_interp_type_steffen:
+	}, [=](XYAnalysisJob& job) {
+		*xVector = job.x;
+		*yVector = job.y;
+
+		//write the result
+		interpolationResult.available = true;
+		interpolationResult.valid = true;
+		interpolationResult.status = gslErrorToString(job.status);
+		interpolationResult.elapsedTime = timer.elapsed();
+
+		//redraw the curve
+		recalcLogicalPoints();
+		emit q->dataChanged();
+	});
+}
+
+//##############################################################################
+//############################  interpolant  ###################################
+//##############################################################################
+XYInterpolant::XYInterpolant(nsl_interp_type type, const QVector<double>& x, const QVector<double>& y) :
+	m_type(type), m_x(x), m_y(y) {
+}
+
+XYInterpolant::~XYInterpolant() {
+	if (m_spline)
+		gsl_spline_free(m_spline);
+}
+
+/*!
+ * returns \c true if this is the interpolant of type \c type of the data points \c x and \c y.
+ */
+bool XYInterpolant::matches(nsl_interp_type type, const QVector<double>& x, const QVector<double>& y) const {
+	return type == m_type && x == m_x && y == m_y;
+}
+
+/*!
+ * initializes the GSL spline when called for the first time, returns the GSL status of the initialization.
+ * Can be called by several recalculations at the same time.
+ */
+int XYInterpolant::init() {
+	std::call_once(m_initialized, [this]() {
+		const gsl_interp_type* type = nullptr;
+		switch (m_type) {
+		case nsl_interp_type_linear:
+			type = gsl_interp_linear;
+			break;
+		case nsl_interp_type_polynomial:
+			type = gsl_interp_polynomial;
+			break;
+		case nsl_interp_type_cspline:
+			type = gsl_interp_cspline;
+			break;
+		case nsl_interp_type_cspline_periodic:
+			type = gsl_interp_cspline_periodic;
+			break;
+		case nsl_interp_type_akima:
+			type = gsl_interp_akima;
+			break;
+		case nsl_interp_type_akima_periodic:
+			type = gsl_interp_akima_periodic;
+			break;
+		case nsl_interp_type_steffen:
 #if GSL_MAJOR_VERSION >= 2
-		spline = gsl_spline_alloc(gsl_interp_steffen, n);
-		status = gsl_spline_init(spline, xdata, ydata, n);
+			type = gsl_interp_steffen;
 #endif
-		break;
-	case nsl_interp_type_cosine:
-	case nsl_interp_type_pch:
-	case nsl_interp_type_rational:
-	case nsl_interp_type_exponential:
-		break;
+			break;
+		case nsl_interp_type_cosine:
+		case nsl_interp_type_pch:
+		case nsl_interp_type_rational:
+		case nsl_interp_type_exponential:
+			break;
+		}
+		if (!type)
+			return;
+
+		const size_t n = (size_t)m_x.size();
+		m_spline = gsl_spline_alloc(type, n);
+		if (m_spline)
+			m_status = gsl_spline_init(m_spline, m_x.constData(), m_y.constData(), n);
+		else
+			m_status = GSL_EINVAL;	// not enough points for this type
+	});
+
+	return m_status;
+}
+
+/*!
+ * the GSL polynomial interpolation uses a workspace stored in the spline for the derivatives and the integral,
+ * all other types can be evaluated by several threads at the same time.
+ */
+bool XYInterpolant::isThreadSafe() const {
+	return m_type != nsl_interp_type_polynomial;
+}
+
+/*!
+ * evaluates the points \c begin to \c end - 1 of the \c npoints equidistant points in [\c xmin, \c xmax]
+ * and writes them to \c xResult and \c yResult. The derivatives and the integral of the own interpolation types
+ * are calculated from all points afterwards.
+ * The points are increasing, so the interval of the data containing the point is only moved forward
+ * instead of searching it for every point. For the integral of the GSL types the integral from the previous point
+ * (from \c xmin for the first point) is written, the caller sums them up.
+ */
+void XYInterpolant::evaluate(const XYInterpolationCurve::InterpolationData& data, double xmin, double xmax, size_t begin, size_t end,
+		double* xResult, double* yResult, XYAnalysisJob& job) const {
+	const size_t n = (size_t)m_x.size();
+	const size_t npoints = data.npoints;
+	const double* xdata = m_x.constData();
+	const double* ydata = m_y.constData();
+	const double tension = data.tension;
+	const double continuity = data.continuity;
+	const double bias = data.bias;
+
+	// find index a,b for interval [x[a],x[b]] around the first point using bisection
+	size_t a = 0, b = n-1;
+	const double xbegin = xmin + begin*(xmax-xmin)/(npoints-1);
+	while (b-a > 1) {
+		const size_t j = (a+b)/2;
+		if (xdata[j] > xbegin)
+			b = j;
+		else
+			a = j;
 	}
 
-	xVector->resize((int)npoints);
-	yVector->resize((int)npoints);
-	for (unsigned int i = 0; i < npoints; i++) {
-		size_t a = 0, b = n-1;
-
-		double x = xmin + i*(xmax-xmin)/(npoints-1);
-		(*xVector)[(int)i] = x;
-
-		// find index a,b for interval [x[a],x[b]] around x[i] using bisection
-		if (type == nsl_interp_type_cosine || type == nsl_interp_type_exponential || type == nsl_interp_type_pch) {
-			while (b-a > 1) {
-				unsigned int j = floor((a+b)/2.);
-				if (xdata[j] > x)
-					b = j;
-				else
-					a = j;
-			}
+	gsl_interp_accel* acc = gsl_interp_accel_alloc();
+	double xprevious = (begin == 0) ? xmin : xmin + (begin-1)*(xmax-xmin)/(npoints-1);
+	for (size_t i = begin; i < end; i++) {
+		if ((i - begin) % 65536 == 0) {
+			if (job.isCanceled())
+				break;
+			if (begin == 0)	// the first block is evaluated in the calling thread
+				job.setProgress((int)(100.*i/end));
+		}
+
+		const double x = xmin + i*(xmax-xmin)/(npoints-1);
+		xResult[i] = x;
+
+		// move the interval forward to the point
+		while (b < n-1 && xdata[b] <= x) {
+			a = b;
+			b++;
 		}
 
 		// evaluate interpolation
 		double t;
-		switch (type) {
+		switch (m_type) {
 		case nsl_interp_type_linear:
 		case nsl_interp_type_polynomial:
 		case nsl_interp_type_cspline:
@@ -293,36 +429,42 @@ void XYInterpolationCurvePrivate::recalculate() {
 		case nsl_interp_type_akima:
 		case nsl_interp_type_akima_periodic:
 		case nsl_interp_type_steffen:
-			switch (evaluate) {
+			if (!m_spline) {
+				yResult[i] = NAN;
+				break;
+			}
+			acc->cache = a;	// no search in the accelerator
+			switch (data.evaluate) {
 			case nsl_interp_evaluate_function:
-				(*yVector)[(int)i] = gsl_spline_eval(spline, x, acc);
+				yResult[i] = gsl_spline_eval(m_spline, x, acc);
 				break;
 			case nsl_interp_evaluate_derivative:
-				(*yVector)[(int)i] = gsl_spline_eval_deriv(spline, x, acc);
+				yResult[i] = gsl_spline_eval_deriv(m_spline, x, acc);
 				break;
 			case nsl_interp_evaluate_second_derivative:
-				(*yVector)[(int)i] = gsl_spline_eval_deriv2(spline, x, acc);
+				yResult[i] = gsl_spline_eval_deriv2(m_spline, x, acc);
 				break;
 			case nsl_interp_evaluate_integral:
-				(*yVector)[(int)i] = gsl_spline_eval_integ(spline, xmin, x, acc);
+				yResult[i] = gsl_spline_eval_integ(m_spline, xprevious, x, acc);
+				xprevious = x;
 				break;
 			}
 			break;
 		case nsl_interp_type_cosine:
 			t = (x-xdata[a])/(xdata[b]-xdata[a]);
 			t = (1.-cos(M_PI*t))/2.;
-			(*yVector)[(int)i] =  ydata[a] + t*(ydata[b]-ydata[a]);
+			yResult[i] =  ydata[a] + t*(ydata[b]-ydata[a]);
 			break;
 		case nsl_interp_type_exponential:
 			t = (x-xdata[a])/(xdata[b]-xdata[a]);
-			(*yVector)[(int)i] = ydata[a]*pow(ydata[b]/ydata[a],t);
+			yResult[i] = ydata[a]*pow(ydata[b]/ydata[a],t);
 			break;
 		case nsl_interp_type_pch: {
 				t = (x-xdata[a])/(xdata[b]-xdata[a]);
 				double t2 = t*t, t3 = t2*t;
 				double h1 = 2.*t3-3.*t2+1, h2 = -2.*t3+3.*t2, h3 = t3-2*t2+t, h4 = t3-t2;
 				double m1 = 0.,m2 = 0.;
-				switch (variant) {
+				switch (data.variant) {
 				case nsl_interp_pch_variant_finite_difference:
 					if (a == 0)
 						m1 = (ydata[b]-ydata[a])/(xdata[b]-xdata[a]);
@@ -376,59 +518,19 @@ void XYInterpolationCurvePrivate::recalculate() {
 				}
 
 				// Hermite polynomial
-				(*yVector)[(int)i] = ydata[a]*h1+ydata[b]*h2+(xdata[b]-xdata[a])*(m1*h3+m2*h4);
+				yResult[i] = ydata[a]*h1+ydata[b]*h2+(xdata[b]-xdata[a])*(m1*h3+m2*h4);
 			}
 			break;
 		case nsl_interp_type_rational: {
 				double v,dv;
-				nsl_interp_ratint(xdata, ydata, (int)n, x, &v, &dv);
-				(*yVector)[(int)i] = v;
+				nsl_interp_ratint(const_cast<double*>(xdata), const_cast<double*>(ydata), (int)n, x, &v, &dv);
+				yResult[i] = v;
 				//TODO: use error dv
 				break;
 			}
 		}
 	}
-
-	// calculate "evaluate" option for own types
-	if (type == nsl_interp_type_cosine || type == nsl_interp_type_exponential || type == nsl_interp_type_pch || type == nsl_interp_type_rational) {
-		switch (evaluate) {
-		case nsl_interp_evaluate_function:
-			break;
-		case nsl_interp_evaluate_derivative:
-			nsl_diff_first_deriv_second_order(xVector->data(), yVector->data(), npoints);
-			break;
-		case nsl_interp_evaluate_second_derivative:
-			nsl_diff_second_deriv_second_order(xVector->data(), yVector->data(), npoints);
-			break;
-		case nsl_interp_evaluate_integral:
-			nsl_int_trapezoid(xVector->data(), yVector->data(), npoints, 0);
-			break;
-		}
-	}
-
-	// check values
-	for (int i = 0; i < (int)npoints; i++) {
-		if ((*yVector)[i] > std::numeric_limits<double>::max())
-			(*yVector)[i] = std::numeric_limits<double>::max();
-		else if ((*yVector)[i] < std::numeric_limits<double>::lowest())
-			(*yVector)[i] = std::numeric_limits<double>::lowest();
-	}
-
-	gsl_spline_free(spline);
 	gsl_interp_accel_free(acc);
-
-///////////////////////////////////////////////////////////
-
-	//write the result
-	interpolationResult.available = true;
-	interpolationResult.valid = true;
-	interpolationResult.status = gslErrorToString(status);
-	interpolationResult.elapsedTime = timer.elapsed();
-
-	//redraw the curve
-	recalcLogicalPoints();
-	emit q->dataChanged();
-	sourceDataChangedSinceLastRecalc = false;
 }
 
 //##############################################################################
@@ -33,9 +33,40 @@
 #include "backend/worksheet/plots/cartesian/XYAnalysisCurvePrivate.h"
 #include "backend/worksheet/plots/cartesian/XYInterpolationCurve.h"
 
+extern "C" {
+#include <gsl/gsl_spline.h>
+}
+
+#include <mutex>
+
 class XYInterpolationCurve;
 class Column;
 
+/*!
+ * interpolant of the source data points. The curve keeps it as long as the source data and the type of the
+ * interpolation don't change, the GSL splines are only initialized once then. Blocks of points can be evaluated
+ * in parallel if isThreadSafe() returns \c true, otherwise the interpolant is not shared between recalculations.
+ */
+class XYInterpolant {
+public:
+	XYInterpolant(nsl_interp_type, const QVector<double>& x, const QVector<double>& y);
+	~XYInterpolant();
+
+	bool matches(nsl_interp_type, const QVector<double>& x, const QVector<double>& y) const;
+	int init();
+	bool isThreadSafe() const;
+	void evaluate(const XYInterpolationCurve::InterpolationData&, double xmin, double xmax, size_t begin, size_t end,
+			double* xResult, double* yResult, XYAnalysisJob&) const;
+
+private:
+	const nsl_interp_type m_type;
+	const QVector<double> m_x;
+	const QVector<double> m_y;
+	gsl_spline* m_spline{nullptr};
+	int m_status{0};
+	std::once_flag m_initialized;
+};
+
 class XYInterpolationCurvePrivate : public XYAnalysisCurvePrivate {
 public:
 	explicit XYInterpolationCurvePrivate(XYInterpolationCurve*);
@@ -45,6 +76,7 @@ public:
 
 	XYInterpolationCurve::InterpolationData interpolationData;
 	XYInterpolationCurve::InterpolationResult interpolationResult;
+	std::shared_ptr<XYInterpolant> interpolant;	//<! interpolant of the source data of the last recalculation
 
 	XYInterpolationCurve* const q;
 };
@@ -104,10 +104,51 @@ XYSmoothCurvePrivate::XYSmoothCurvePrivate(XYSmoothCurve* owner) : XYAnalysisCur
 //when the parent aspect is removed
 XYSmoothCurvePrivate::~XYSmoothCurvePrivate() = default;
 
+/*!
+ * smooths the \c n values \c ydata in place with the settings \c data.
+ */
+static int smooth(const XYSmoothCurve::SmoothData& data, double* ydata, size_t n) {
+	int status = 0;
+
+	switch (data.type) {
+	case nsl_smooth_type_moving_average:
+		status = nsl_smooth_moving_average(ydata, n, data.points, data.weight, data.mode, data.lvalue, data.rvalue);
+		break;
+	case nsl_smooth_type_moving_average_lagged:
+		status = nsl_smooth_moving_average_lagged(ydata, n, data.points, data.weight, data.mode, data.lvalue);
+		break;
+	case nsl_smooth_type_percentile:
+		status = nsl_smooth_percentile(ydata, n, data.points, data.percentile, data.mode, data.lvalue, data.rvalue);
+		break;
+	case nsl_smooth_type_savitzky_golay:
+		status = nsl_smooth_savgol(ydata, n, data.points, data.order, data.mode, data.lvalue, data.rvalue);
+		break;
+	}
+
+	return status;
+}
+
+/*!
+ * determines the number of values before (\c left) and after (\c right) a value the smoothed value depends on.
+ */
+static void smoothWindow(const XYSmoothCurve::SmoothData& data, int& left, int& right) {
+	const int points = qMax((int)data.points, 1);
+	if (data.type == nsl_smooth_type_moving_average_lagged) {
+		left = points - 1;
+		right = 0;
+	} else {
+		left = (points - 1)/2;
+		right = points - 1 - left;
+	}
+}
+
 void XYSmoothCurvePrivate::recalculate() {
 	QElapsedTimer timer;
 	timer.start();
 
+	//a running recalculation is superseded by this one
+	cancelJob();
+
 	//create smooth result columns if not available yet, clear them otherwise
 	if (!xColumn) {
 		xColumn = new Column("x", AbstractColumn::Numeric);
@@ -131,19 +172,12 @@ void XYSmoothCurvePrivate::recalculate() {
 
 	// clear the previous result
 	smoothResult = XYSmoothCurve::SmoothResult();
+	processedSource = XYAnalysisSource();
 
 	//determine the data source columns
 	const AbstractColumn* tmpXDataColumn = nullptr;
 	const AbstractColumn* tmpYDataColumn = nullptr;
-	if (dataSourceType == XYAnalysisCurve::DataSourceSpreadsheet) {
-		//spreadsheet columns as data source
-		tmpXDataColumn = xDataColumn;
-		tmpYDataColumn = yDataColumn;
-	} else {
-		//curve columns as data source
-		tmpXDataColumn = dataSourceCurve->xColumn();
-		tmpYDataColumn = dataSourceCurve->yColumn();
-	}
+	sourceColumns(tmpXDataColumn, tmpYDataColumn);
 
 	if (!tmpXDataColumn || !tmpYDataColumn) {
 		emit q->dataChanged();
@@ -165,29 +199,8 @@ void XYSmoothCurvePrivate::recalculate() {
 	//copy all valid data point for the smooth to temporary vectors
 	QVector<double> xdataVector;
 	QVector<double> ydataVector;
-
-	double xmin;
-	double xmax;
-	if (smoothData.autoRange) {
-		xmin = tmpXDataColumn->minimum();
-		xmax = tmpXDataColumn->maximum();
-	} else {
-		xmin = smoothData.xRange.first();
-		xmax = smoothData.xRange.last();
-	}
-
-	for (int row = 0; row<tmpXDataColumn->rowCount(); ++row) {
-		//only copy those data where _all_ values (for x and y, if given) are valid
-		if (!std::isnan(tmpXDataColumn->valueAt(row)) && !std::isnan(tmpYDataColumn->valueAt(row))
-			&& !tmpXDataColumn->isMasked(row) && !tmpYDataColumn->isMasked(row)) {
-
-			// only when inside given range
-			if (tmpXDataColumn->valueAt(row) >= xmin && tmpXDataColumn->valueAt(row) <= xmax) {
-				xdataVector.append(tmpXDataColumn->valueAt(row));
-				ydataVector.append(tmpYDataColumn->valueAt(row));
-			}
-		}
-	}
+	const XYAnalysisSource source = currentSource(tmpXDataColumn, tmpYDataColumn);
+	copyData(tmpXDataColumn, tmpYDataColumn, 0, source.rows, xdataVector, ydataVector);
 
 	//number of data points to smooth
 	const size_t n = (size_t)xdataVector.size();
@@ -201,63 +214,127 @@ void XYSmoothCurvePrivate::recalculate() {
 		return;
 	}
 
-	double* xdata = xdataVector.data();
-	double* ydata = ydataVector.data();
-
 	// smooth settings
-	const nsl_smooth_type type = smoothData.type;
-	const size_t points = smoothData.points;
-	const nsl_smooth_weight_type weight = smoothData.weight;
-	const double percentile = smoothData.percentile;
-	const int order = smoothData.order;
-	const nsl_smooth_pad_mode mode = smoothData.mode;
-	const double lvalue = smoothData.lvalue;
-	const double rvalue = smoothData.rvalue;
-
-	DEBUG("type:"<<nsl_smooth_type_name[type]);
-	DEBUG("points ="<<points);
-	DEBUG("weight:"<<nsl_smooth_weight_type_name[weight]);
-	DEBUG("percentile ="<<percentile);
-	DEBUG("order ="<<order);
-	DEBUG("mode ="<<nsl_smooth_pad_mode_name[mode]);
-	DEBUG("const. values ="<<lvalue<<rvalue);
-
+	const XYSmoothCurve::SmoothData data = smoothData;
+
+	DEBUG("type:"<<nsl_smooth_type_name[data.type]);
+	DEBUG("points ="<<data.points);
+	DEBUG("weight:"<<nsl_smooth_weight_type_name[data.weight]);
+	DEBUG("percentile ="<<data.percentile);
+	DEBUG("order ="<<data.order);
+	DEBUG("mode ="<<nsl_smooth_pad_mode_name[data.mode]);
+	DEBUG("const. values ="<<data.lvalue<<data.rvalue);
+
+	//source values needed to smooth the values at the end again in the incremental mode
+	int left, right;
+	smoothWindow(data, left, right);
+	const int tailSize = qMin((int)n, left + right);
+	const QVector<double> tail = ydataVector.mid((int)n - tailSize, tailSize);
+
+	auto job = std::make_shared<XYAnalysisJob>();
+	job->x.swap(xdataVector);
+	job->y.swap(ydataVector);
+
+	runJob(job, [=](XYAnalysisJob& job) {
 ///////////////////////////////////////////////////////////
-	int status = 0;
+		job.status = smooth(data, job.y.data(), n);
+///////////////////////////////////////////////////////////
+	}, [=](XYAnalysisJob& job) {
+		*xVector = job.x;
+		*yVector = job.y;
+		tailY = tail;
+		processedSource = source;
 
-	switch (type) {
-	case nsl_smooth_type_moving_average:
-		status = nsl_smooth_moving_average(ydata, n, points, weight, mode);
-		break;
-	case nsl_smooth_type_moving_average_lagged:
-		status = nsl_smooth_moving_average_lagged(ydata, n, points, weight, mode);
-		break;
-	case nsl_smooth_type_percentile:
-		status = nsl_smooth_percentile(ydata, n, points, percentile, mode);
-		break;
-	case nsl_smooth_type_savitzky_golay:
-		if (mode == nsl_smooth_pad_constant)
-			nsl_smooth_pad_constant_set(lvalue, rvalue);
-		status = nsl_smooth_savgol(ydata, n, points, order, mode);
-		break;
-	}
+		//write the result
+		smoothResult.available = true;
+		smoothResult.valid = true;
+		smoothResult.status = QString::number(job.status);
+		smoothResult.elapsedTime = timer.elapsed();
 
-	xVector->resize((int)n);
-	yVector->resize((int)n);
-	memcpy(xVector->data(), xdata, n*sizeof(double));
-	memcpy(yVector->data(), ydata, n*sizeof(double));
-///////////////////////////////////////////////////////////
+		//redraw the curve
+		recalcLogicalPoints();
+		emit q->dataChanged();
+	});
+}
+
+/*!
+ * smooths the values for the rows appended to the source columns. Only the values at the end,
+ * whose window reaches the new values, are smoothed again.
+ */
+bool XYSmoothCurvePrivate::recalculateIncrementally() {
+	const AbstractColumn* tmpXDataColumn = nullptr;
+	const AbstractColumn* tmpYDataColumn = nullptr;
+	sourceColumns(tmpXDataColumn, tmpYDataColumn);
+	const XYAnalysisSource source = currentSource(tmpXDataColumn, tmpYDataColumn);
+
+	//the periodic padding uses the first values to smooth the last ones
+	if (!smoothResult.valid || smoothData.mode == nsl_smooth_pad_periodic || !appendedRows(source)
+			|| tmpXDataColumn->rowCount() != tmpYDataColumn->rowCount())
+		return false;
+
+	QElapsedTimer timer;
+	timer.start();
+
+	QVector<double> xdataVector;
+	QVector<double> ydataVector;
+	copyData(tmpXDataColumn, tmpYDataColumn, processedSource.rows, source.rows, xdataVector, ydataVector);
+	processedSource = source;
+	if (xdataVector.isEmpty())
+		return true;
+
+	//smooth the tail of the source values again, the values before the first value
+	//to be recalculated are only used as its window
+	int left, right;
+	smoothWindow(smoothData, left, right);
+	const int n = yVector->size();
+	const int first = qMax(n - right, 0);	//first smoothed value depending on the new values
+	const int start = qMax(first - left, 0);
+	if (n - start > tailY.size())
+		return false;
+
+	QVector<double> data = tailY.mid(tailY.size() - (n - start));
+	data << ydataVector;
+	const int tailSize = qMin(data.size(), left + right);
+	tailY = data.mid(data.size() - tailSize, tailSize);
+
+	const int status = smooth(smoothData, data.data(), (size_t)data.size());
+
+	yVector->resize(first);
+	for (int i = first - start; i < data.size(); ++i)
+		yVector->append(data.at(i));
+	*xVector << xdataVector;
 
-	//write the result
-	smoothResult.available = true;
-	smoothResult.valid = true;
 	smoothResult.status = QString::number(status);
 	smoothResult.elapsedTime = timer.elapsed();
 
-	//redraw the curve
 	recalcLogicalPoints();
 	emit q->dataChanged();
-	sourceDataChangedSinceLastRecalc = false;
+	return true;
+}
+
+/*!
+ * copies all valid data points in the rows \c first to \c last - 1 of the columns \c x and \c y to \c xdata and \c ydata.
+ */
+void XYSmoothCurvePrivate::copyData(const AbstractColumn* x, const AbstractColumn* y, int first, int last,
+		QVector<double>& xdata, QVector<double>& ydata) const {
+	//all data points are inside the automatic range
+	const bool autoRange = smoothData.autoRange;
+	const double xmin = smoothData.xRange.first();
+	const double xmax = smoothData.xRange.last();
+
+	for (int row = first; row < last; ++row) {
+		//only copy those data where _all_ values (for x and y, if given) are valid
+		const double xValue = x->valueAt(row);
+		const double yValue = y->valueAt(row);
+		if (std::isnan(xValue) || std::isnan(yValue) || x->isMasked(row) || y->isMasked(row))
+			continue;
+
+		// only when inside given range
+		if (autoRange || (xValue >= xmin && xValue <= xmax)) {
+			xdata.append(xValue);
+			ydata.append(yValue);
+		}
+	}
 }
 
 //##############################################################################
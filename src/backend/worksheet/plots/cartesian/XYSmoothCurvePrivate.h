@@ -42,9 +42,12 @@ public:
 	~XYSmoothCurvePrivate() override;
 
 	void recalculate();
+	bool recalculateIncrementally() override;
+	void copyData(const AbstractColumn* x, const AbstractColumn* y, int first, int last, QVector<double>& xdata, QVector<double>& ydata) const;
 
 	XYSmoothCurve::SmoothData smoothData;
 	XYSmoothCurve::SmoothResult smoothResult;
+	QVector<double> tailY;	//<! last source values within the window of the last smoothed value, used in the incremental mode
 
 	XYSmoothCurve* const q;
 };
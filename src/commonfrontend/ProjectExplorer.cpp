@@ -31,6 +31,9 @@
 #include "backend/core/AspectTreeModel.h"
 #include "backend/core/AbstractPart.h"
 #include "backend/core/Project.h"
+#include "backend/core/column/Column.h"
+#include "backend/datasources/LiveDataJoin.h"
+#include "backend/datasources/LiveDataRollup.h"
 #include "backend/lib/XmlStreamReader.h"
 #include "backend/worksheet/plots/cartesian/CartesianPlot.h"
 #include "commonfrontend/core/PartMdiView.h"
@@ -133,6 +136,12 @@ void ProjectExplorer::createActions() {
 	deleteSelectedTreeAction = new QAction(QIcon::fromTheme("edit-delete"), i18n("Delete Selected"), this);
 	connect(deleteSelectedTreeAction, &QAction::triggered, this, &ProjectExplorer::deleteSelected);
 
+	joinSelectedAction = new QAction(QIcon::fromTheme("labplot-spreadsheet"), i18n("Join on Timestamps"), this);
+	connect(joinSelectedAction, &QAction::triggered, this, &ProjectExplorer::joinSelected);
+
+	rollupSelectedAction = new QAction(QIcon::fromTheme("labplot-spreadsheet"), i18n("Aggregate in Time Windows"), this);
+	connect(rollupSelectedAction, &QAction::triggered, this, &ProjectExplorer::rollupSelected);
+
 	toggleFilterAction = new QAction(QIcon::fromTheme(QLatin1String("view-filter")), i18n("Hide Search/Filter Options"), this);
 	connect(toggleFilterAction, &QAction::triggered, this, &ProjectExplorer::toggleFilterWidgets);
 
@@ -157,9 +166,26 @@ void ProjectExplorer::contextMenuEvent(QContextMenuEvent *event) {
 
 	const QModelIndexList& items = m_treeView->selectionModel()->selectedIndexes();
 	QMenu* menu = nullptr;
+	//the numeric columns of live data can be aggregated in time windows
+	bool liveColumns = !items.isEmpty();
+	for (int i = 0; i < items.size()/4; ++i) {
+		const auto* column = dynamic_cast<Column*>(static_cast<AbstractAspect*>(items.at(i*4).internalPointer()));
+		const auto* parent = column ? column->parentAspect() : nullptr;
+		if (!parent || !(parent->inherits(AspectType::LiveDataSource) || parent->inherits(AspectType::MQTTTopic)
+			|| parent->inherits(AspectType::LiveDataJoin))
+			|| !(column->columnMode() == AbstractColumn::Numeric || column->columnMode() == AbstractColumn::Integer)) {
+			liveColumns = false;
+			break;
+		}
+	}
+
 	if (items.size()/4 == 1) {
 		auto* aspect = static_cast<AbstractAspect*>(index.internalPointer());
 		menu = aspect->createContextMenu();
+		if (menu && liveColumns) {
+			menu->addSeparator();
+			menu->addAction(rollupSelectedAction);
+		}
 	} else {
 		menu = new QMenu();
 
@@ -172,6 +198,23 @@ void ProjectExplorer::contextMenuEvent(QContextMenuEvent *event) {
 			menu->addAction(expandSelectedTreeAction);
 			menu->addAction(collapseSelectedTreeAction);
 			menu->addSeparator();
+
+			//several (live) data sources can be joined on their timestamps
+			bool spreadsheets = true;
+			for (int i = 0; i < items.size()/4; ++i) {
+				if (!dynamic_cast<Spreadsheet*>(static_cast<AbstractAspect*>(items.at(i*4).internalPointer()))) {
+					spreadsheets = false;
+					break;
+				}
+			}
+			if (spreadsheets) {
+				menu->addAction(joinSelectedAction);
+				menu->addSeparator();
+			} else if (liveColumns) {
+				menu->addAction(rollupSelectedAction);
+				menu->addSeparator();
+			}
+
 			menu->addAction(deleteSelectedTreeAction);
 			menu->addSeparator();
 		} else {
@@ -682,6 +725,36 @@ void ProjectExplorer::deleteSelected() {
 	m_project->endMacro();
 }
 
+/*!
+ * creates a new LiveDataJoin joining the selected spreadsheets and live data sources on their timestamps.
+ */
+void ProjectExplorer::joinSelected() {
+	const QModelIndexList items = m_treeView->selectionModel()->selectedIndexes();
+	auto* join = new LiveDataJoin(i18n("Join"));
+	for (int i = 0; i < items.size()/4; ++i) {
+		auto* spreadsheet = dynamic_cast<Spreadsheet*>(static_cast<AbstractAspect*>(items.at(i*4).internalPointer()));
+		if (spreadsheet)
+			join->addSource(spreadsheet);
+	}
+	m_project->addChild(join);
+}
+
+/*!
+ * creates a new LiveDataRollup for every selected live data column, aggregating its values in time windows.
+ */
+void ProjectExplorer::rollupSelected() {
+	const QModelIndexList items = m_treeView->selectionModel()->selectedIndexes();
+	for (int i = 0; i < items.size()/4; ++i) {
+		auto* column = dynamic_cast<Column*>(static_cast<AbstractAspect*>(items.at(i*4).internalPointer()));
+		if (!column)
+			continue;
+
+		auto* rollup = new LiveDataRollup(i18n("%1 Rollup", column->name()));
+		rollup->setSourceColumn(column);
+		m_project->addChild(rollup);
+	}
+}
+
 //##############################################################################
 //##################  Serialization/Deserialization  ###########################
 //##############################################################################
@@ -78,6 +78,8 @@ private:
 	QAction* collapseTreeAction;
 	QAction* collapseSelectedTreeAction;
 	QAction* deleteSelectedTreeAction;
+	QAction* joinSelectedAction;
+	QAction* rollupSelectedAction;
 	QAction* toggleFilterAction;
 	QAction* showAllColumnsAction;
 	QList<QAction*> list_showColumnActions;
@@ -101,6 +103,8 @@ private slots:
 	void expandSelected();
 	void collapseSelected();
 	void deleteSelected();
+	void joinSelected();
+	void rollupSelected();
 
 	void navigateTo(const QString& path);
 	void currentChanged(const QModelIndex& current, const QModelIndex& previous);
@@ -47,6 +47,7 @@
 #include "backend/note/Note.h"
 #include "backend/lib/macros.h"
 #include "backend/worksheet/plots/cartesian/CartesianPlot.h"
+#include "backend/worksheet/plots/cartesian/XYAnalysisCurve.h"
 
 #ifdef HAVE_MQTT
 #include "backend/datasources/MQTTClient.h"
@@ -92,6 +93,8 @@
 #include <QStatusBar>
 #include <QTemporaryFile>
 #include <QTimeLine>
+#include <QDir>
+#include <QStandardPaths>
 
 #include <KActionCollection>
 #include <KConfigGroup>
@@ -106,6 +109,12 @@
 #include <KColorScheme>
 #include <KColorSchemeManager>
 
+#ifdef HAVE_FFTW3
+extern "C" {
+#include "backend/nsl/nsl_fftw.h"
+}
+#endif
+
 #ifdef HAVE_CANTOR_LIBS
 #include <cantor/backend.h>
 #include <KConfigDialog>
@@ -128,6 +137,17 @@
 MainWin::MainWin(QWidget *parent, const QString& filename)
 	: KXmlGuiWindow(parent) {
 
+	//don't block the GUI during long running analysis calculations
+	XYAnalysisCurve::setAsyncRecalculation(true);
+
+#ifdef HAVE_FFTW3
+	//measure the FFT plans in the background and keep the results for the next sessions
+	const QString dataPath = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+	QDir().mkpath(dataPath);
+	nsl_fftw_set_wisdom_file(QFile::encodeName(dataPath + QLatin1String("/fftw_wisdom")).constData());
+	nsl_fftw_set_measure(1);
+#endif
+
 	initGUI(filename);
 	setAcceptDrops(true);
 
@@ -1267,7 +1287,7 @@ bool MainWin::saveProjectAs() {
 	KConfigGroup conf(KSharedConfig::openConfig(), "MainWin");
 	const QString& dir = conf.readEntry("LastOpenDir", "");
 	QString path  = QFileDialog::getSaveFileName(this, i18n("Save Project As"), dir,
-	                i18n("LabPlot Projects (*.lml *.lml.gz *.lml.bz2 *.lml.xz *.LML *.LML.GZ *.LML.BZ2 *.LML.XZ)"));
+	                i18n("LabPlot Projects (*.lml *.lml.gz *.lml.bz2 *.lml.xz *.lmlz *.LML *.LML.GZ *.LML.BZ2 *.LML.XZ *.LMLZ)"));
 
 	if (path.isEmpty())// "Cancel" was clicked
 		return false;
@@ -1303,27 +1323,35 @@ bool MainWin::save(const QString& fileName) {
 
 	// use file ending to find out how to compress file
 	QIODevice* file;
+	// .lmlz is a zip archive with the binary column data, written by the project itself
+	if (Project::isArchive(fileName))
+		file = nullptr;
 	// if ending is .lml, do gzip compression anyway
-	if (fileName.endsWith(QLatin1String(".lml")))
+	else if (fileName.endsWith(QLatin1String(".lml")))
 		file = new KCompressionDevice(tempFileName, KCompressionDevice::GZip);
 	else
 		file = new KFilterDev(tempFileName);
 
-	if (file == nullptr)
-		file = new QFile(tempFileName);
-
-	bool ok;
-	if (file->open(QIODevice::WriteOnly)) {
+	bool opened;
+	if (file)
+		opened = file->open(QIODevice::WriteOnly);
+	else {
 		m_project->setFileName(fileName);
+		opened = m_project->saveArchive(centralWidget()->grab(), tempFileName);
+	}
 
-		QPixmap thumbnail = centralWidget()->grab();
-
-		QXmlStreamWriter writer(file);
-		m_project->setFileName(fileName);
-		m_project->save(thumbnail, &writer);
+	bool ok;
+	if (opened) {
+		if (file) {
+			QPixmap thumbnail = centralWidget()->grab();
+
+			QXmlStreamWriter writer(file);
+			m_project->setFileName(fileName);
+			m_project->save(thumbnail, &writer);
+			file->close();
+		}
 		m_project->undoStack()->clear();
 		m_project->setChanged(false);
-		file->close();
 
 		// target file must not exist
 		if (QFile::exists(fileName))
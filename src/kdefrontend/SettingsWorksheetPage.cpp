@@ -28,6 +28,7 @@
 
 #include "SettingsWorksheetPage.h"
 #include "tools/TeXRenderer.h"
+#include "backend/worksheet/plots/cartesian/PlotUpdateScheduler.h"
 #include "kdefrontend/widgets/ThemesComboBox.h"
 
 #include <KLocalizedString>
@@ -62,6 +63,7 @@ SettingsWorksheetPage::SettingsWorksheetPage(QWidget* parent) : SettingsPage(par
 	connect(m_cbThemes, SIGNAL(currentThemeChanged(QString)), this, SLOT(changed()) );
 	connect(ui.chkPresenterModeInteractive, SIGNAL(stateChanged(int)), this, SLOT(changed()) );
 	connect(ui.chkDoubleBuffering, SIGNAL(stateChanged(int)), this, SLOT(changed()) );
+	connect(ui.sbMaxFrameRate, SIGNAL(valueChanged(int)), this, SLOT(changed()) );
 	connect(ui.cbTexEngine, SIGNAL(currentIndexChanged(int)), this, SLOT(changed()) );
 	connect(ui.cbTexEngine, SIGNAL(currentIndexChanged(int)), this, SLOT(checkTeX(int)) );
 
@@ -73,6 +75,8 @@ void SettingsWorksheetPage::applySettings() {
 	group.writeEntry(QLatin1String("Theme"), m_cbThemes->currentText());
 	group.writeEntry(QLatin1String("PresenterModeInteractive"), ui.chkPresenterModeInteractive->isChecked());
 	group.writeEntry(QLatin1String("DoubleBuffering"), ui.chkDoubleBuffering->isChecked());
+	group.writeEntry(QLatin1String("MaxFrameRate"), ui.sbMaxFrameRate->value());
+	PlotUpdateScheduler::instance()->setMaxFrameRate(ui.sbMaxFrameRate->value());
 	group.writeEntry(QLatin1String("LaTeXEngine"), ui.cbTexEngine->itemData(ui.cbTexEngine->currentIndex()));
 }
 
@@ -85,6 +89,7 @@ void SettingsWorksheetPage::loadSettings() {
 	m_cbThemes->setItemText(0, group.readEntry(QLatin1String("Theme"), ""));
 	ui.chkPresenterModeInteractive->setChecked(group.readEntry(QLatin1String("PresenterModeInteractive"), false));
 	ui.chkDoubleBuffering->setChecked(group.readEntry(QLatin1String("DoubleBuffering"), true));
+	ui.sbMaxFrameRate->setValue(group.readEntry(QLatin1String("MaxFrameRate"), 30));
 
 	QString engine = group.readEntry(QLatin1String("LaTeXEngine"), "");
 	int index = -1;
@@ -29,6 +29,8 @@
 #include "BinaryOptionsWidget.h"
 #include "backend/datasources/filters/BinaryFilter.h"
 
+#include <QRegExp>
+
 #include <KSharedConfig>
 #include <KConfigGroup>
 
@@ -75,6 +77,28 @@ void BinaryOptionsWidget::applyFilterSettings(BinaryFilter* filter) const {
 	filter->setSkipBytes(ui.sbSkipBytes->value());
 	filter->setSkipStartBytes(ui.sbSkipStartBytes->value());
 	filter->setCreateIndexEnabled( ui.chbCreateIndex->isChecked() );
+	filter->setRecordLayout(recordLayout());
+	filter->setTimestampField(ui.sbTimestampField->value() - 1);
+	filter->setFramesEnabled(ui.chbFrames->isChecked());
+}
+
+/*!
+	returns the data types of the record layout specified by their short names (int8, ..., real64).
+	Unknown names are ignored.
+*/
+QVector<BinaryFilter::DataType> BinaryOptionsWidget::recordLayout() const {
+	QStringList names;
+	for (const auto& type : BinaryFilter::dataTypes())
+		names << type.section(QLatin1Char(' '), 0, 0);
+
+	QVector<BinaryFilter::DataType> layout;
+	for (const auto& field : ui.leRecordLayout->text().split(QRegExp(QLatin1String("[,;\\s]+")), QString::SkipEmptyParts)) {
+		const int index = names.indexOf(field.toLower());
+		if (index != -1)
+			layout << static_cast<BinaryFilter::DataType>(index);
+	}
+
+	return layout;
 }
 
 void BinaryOptionsWidget::loadSettings() const {
@@ -86,6 +110,9 @@ void BinaryOptionsWidget::loadSettings() const {
 	ui.sbSkipStartBytes->setValue(conf.readEntry("SkipStartBytes", 0));
 	ui.sbSkipBytes->setValue(conf.readEntry("SkipBytes", 0));
 	ui.chbCreateIndex->setChecked(conf.readEntry("CreateIndex", false));
+	ui.leRecordLayout->setText(conf.readEntry("RecordLayout", QString()));
+	ui.sbTimestampField->setValue(conf.readEntry("TimestampField", 0));
+	ui.chbFrames->setChecked(conf.readEntry("Frames", true));
 }
 
 void BinaryOptionsWidget::saveSettings() {
@@ -97,4 +124,7 @@ void BinaryOptionsWidget::saveSettings() {
 	conf.writeEntry("SkipStartBytes", ui.sbSkipStartBytes->value());
 	conf.writeEntry("SkipBytes", ui.sbSkipBytes->value());
 	conf.writeEntry("CreateIndex", ui.chbCreateIndex->isChecked());
+	conf.writeEntry("RecordLayout", ui.leRecordLayout->text());
+	conf.writeEntry("TimestampField", ui.sbTimestampField->value());
+	conf.writeEntry("Frames", ui.chbFrames->isChecked());
 }
@@ -30,8 +30,7 @@
 #define BINARYOPTIONSWIDGET_H
 
 #include "ui_binaryoptionswidget.h"
-
-class BinaryFilter;
+#include "backend/datasources/filters/BinaryFilter.h"
 
 class BinaryOptionsWidget : public QWidget {
     Q_OBJECT
@@ -43,6 +42,8 @@ public:
 	void saveSettings();
 
 private:
+	QVector<BinaryFilter::DataType> recordLayout() const;
+
 	Ui::BinaryOptionsWidget ui;
 };
 
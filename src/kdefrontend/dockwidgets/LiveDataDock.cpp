@@ -62,6 +62,7 @@ LiveDataDock::LiveDataDock(QWidget* parent) : BaseDock(parent)
 	connect(ui.sbUpdateInterval, static_cast<void (QSpinBox::*) (int)>(&QSpinBox::valueChanged), this, &LiveDataDock::updateIntervalChanged);
 
 	connect(ui.sbKeepNValues, static_cast<void (QSpinBox::*) (int)>(&QSpinBox::valueChanged), this, &LiveDataDock::keepNValuesChanged);
+	connect(ui.chbHistory, &QCheckBox::toggled, this, &LiveDataDock::historyChanged);
 	connect(ui.sbSampleSize, static_cast<void (QSpinBox::*) (int)>(&QSpinBox::valueChanged), this, &LiveDataDock::sampleSizeChanged);
 	connect(ui.cbUpdateType, static_cast<void (QComboBox::*) (int)>(&QComboBox::currentIndexChanged), this, &LiveDataDock::updateTypeChanged);
 	connect(ui.cbReadingType, static_cast<void (QComboBox::*) (int)>(&QComboBox::currentIndexChanged), this, &LiveDataDock::readingTypeChanged);
@@ -131,6 +132,8 @@ void LiveDataDock::setMQTTClient(MQTTClient* const client) {
 
 	ui.sbKeepNValues->setValue(client->keepNValues());
 	ui.sbKeepNValues->setEnabled(true);
+	ui.chbHistory->setChecked(client->historyEnabled());
+	ui.chbHistory->setEnabled(client->keepNValues() > 0);
 
 	if (client->readingType() == MQTTClient::TillEnd) {
 		ui.lSampleSize->hide();
@@ -305,6 +308,8 @@ void LiveDataDock::setLiveDataSource(LiveDataSource* const source) {
 	}
 
 	ui.sbKeepNValues->setValue(source->keepNValues());
+	ui.chbHistory->setChecked(source->historyEnabled());
+	ui.chbHistory->setEnabled(source->keepNValues() > 0);
 
 	// disable "whole file" when having no file (i.e. socket or port)
 	auto* model = qobject_cast<const QStandardItemModel*>(ui.cbReadingType->model());
@@ -510,6 +515,8 @@ void LiveDataDock::updateIntervalChanged(int updateInterval) {
  * \param keepNValues
  */
 void LiveDataDock::keepNValuesChanged(const int keepNValues) {
+	ui.chbHistory->setEnabled(keepNValues > 0);
+
 	if (m_liveDataSource)
 		m_liveDataSource->setKeepNValues(keepNValues);
 #ifdef HAVE_MQTT
@@ -518,6 +525,19 @@ void LiveDataDock::keepNValuesChanged(const int keepNValues) {
 #endif
 }
 
+/*!
+ * \brief Modifies whether the values not kept in memory are moved to the on-disk history
+ * \param enabled
+ */
+void LiveDataDock::historyChanged(bool enabled) {
+	if (m_liveDataSource)
+		m_liveDataSource->setHistoryEnabled(enabled);
+#ifdef HAVE_MQTT
+	else if (m_mqttClient)
+		m_mqttClient->setHistoryEnabled(enabled);
+#endif
+}
+
 /*!
  * \brief Pauses the reading of the live data source
  */
@@ -74,6 +74,7 @@ private slots:
 	void sampleSizeChanged(int);
 	void updateIntervalChanged(int);
 	void keepNValuesChanged(int);
+	void historyChanged(bool);
 
 	void updateNow();
 	void pauseContinueReading();
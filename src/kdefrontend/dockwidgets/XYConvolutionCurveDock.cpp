@@ -206,6 +206,9 @@ void XYConvolutionCurveDock::initGeneralTab() {
 	connect(m_convolutionCurve, SIGNAL(y2DataColumnChanged(const AbstractColumn*)), this, SLOT(curveY2DataColumnChanged(const AbstractColumn*)));
 	connect(m_convolutionCurve, SIGNAL(convolutionDataChanged(XYConvolutionCurve::ConvolutionData)), this, SLOT(curveConvolutionDataChanged(XYConvolutionCurve::ConvolutionData)));
 	connect(m_convolutionCurve, SIGNAL(sourceDataChanged()), this, SLOT(enableRecalculate()));
+	connect(m_convolutionCurve, SIGNAL(recalculationStarted()), this, SLOT(curveRecalculationStarted()));
+	connect(m_convolutionCurve, SIGNAL(recalculationProgress(int)), this, SLOT(curveRecalculationProgress(int)));
+	connect(m_convolutionCurve, SIGNAL(recalculationFinished()), this, SLOT(curveRecalculationFinished()));
 }
 
 void XYConvolutionCurveDock::setModel() {
@@ -515,11 +518,24 @@ void XYConvolutionCurveDock::wrapChanged() {
 }
 
 void XYConvolutionCurveDock::recalculateClicked() {
+	//the button cancels a running recalculation
+	if (m_convolutionCurve->isRecalculating()) {
+		for (auto* curve : m_curvesList)
+			dynamic_cast<XYConvolutionCurve*>(curve)->cancelRecalculation();
+		return;
+	}
+
 	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
 	for (auto* curve : m_curvesList)
 		dynamic_cast<XYConvolutionCurve*>(curve)->setConvolutionData(m_convolutionData);
 
+	//the result is shown when the recalculation in the background is finished
+	if (m_convolutionCurve->isRecalculating()) {
+		QApplication::restoreOverrideCursor();
+		return;
+	}
+
 	uiGeneralTab.pbRecalculate->setEnabled(false);
 	if (m_convolutionData.direction == nsl_conv_direction_forward)
 		emit info(i18n("Convolution status: %1", m_convolutionCurve->convolutionResult().status));
@@ -663,6 +679,25 @@ void XYConvolutionCurveDock::curveConvolutionDataChanged(const XYConvolutionCurv
 	m_initializing = false;
 }
 
+void XYConvolutionCurveDock::curveRecalculationStarted() {
+	uiGeneralTab.pbRecalculate->setText(i18n("Cancel"));
+	uiGeneralTab.pbRecalculate->setEnabled(true);
+}
+
+void XYConvolutionCurveDock::curveRecalculationProgress(int progress) {
+	emit info(i18n("Convolution: %1 %", progress));
+}
+
+void XYConvolutionCurveDock::curveRecalculationFinished() {
+	uiGeneralTab.pbRecalculate->setText(i18n("Recalculate"));
+	uiGeneralTab.pbRecalculate->setEnabled(m_convolutionCurve->isSourceDataChangedSinceLastRecalc());
+	this->showConvolutionResult();
+	if (m_convolutionData.direction == nsl_conv_direction_forward)
+		emit info(i18n("Convolution status: %1", m_convolutionCurve->convolutionResult().status));
+	else
+		emit info(i18n("Deconvolution status: %1", m_convolutionCurve->convolutionResult().status));
+}
+
 void XYConvolutionCurveDock::dataChanged() {
 	this->enableRecalculate();
 }
@@ -90,6 +90,9 @@ private slots:
 	void curveYDataColumnChanged(const AbstractColumn*);
 	void curveY2DataColumnChanged(const AbstractColumn*);
 	void curveConvolutionDataChanged(const XYConvolutionCurve::ConvolutionData&);
+	void curveRecalculationStarted();
+	void curveRecalculationProgress(int);
+	void curveRecalculationFinished();
 	void dataChanged();
 };
 
@@ -189,6 +189,9 @@ void XYCorrelationCurveDock::initGeneralTab() {
 	connect(m_correlationCurve, SIGNAL(y2DataColumnChanged(const AbstractColumn*)), this, SLOT(curveY2DataColumnChanged(const AbstractColumn*)));
 	connect(m_correlationCurve, SIGNAL(correlationDataChanged(XYCorrelationCurve::CorrelationData)), this, SLOT(curveCorrelationDataChanged(XYCorrelationCurve::CorrelationData)));
 	connect(m_correlationCurve, SIGNAL(sourceDataChanged()), this, SLOT(enableRecalculate()));
+	connect(m_correlationCurve, SIGNAL(recalculationStarted()), this, SLOT(curveRecalculationStarted()));
+	connect(m_correlationCurve, SIGNAL(recalculationProgress(int)), this, SLOT(curveRecalculationProgress(int)));
+	connect(m_correlationCurve, SIGNAL(recalculationFinished()), this, SLOT(curveRecalculationFinished()));
 }
 
 void XYCorrelationCurveDock::setModel() {
@@ -406,11 +409,24 @@ void XYCorrelationCurveDock::normChanged() {
 }
 
 void XYCorrelationCurveDock::recalculateClicked() {
+	//the button cancels a running recalculation
+	if (m_correlationCurve->isRecalculating()) {
+		for (auto* curve : m_curvesList)
+			dynamic_cast<XYCorrelationCurve*>(curve)->cancelRecalculation();
+		return;
+	}
+
 	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
 	for (auto* curve : m_curvesList)
 		dynamic_cast<XYCorrelationCurve*>(curve)->setCorrelationData(m_correlationData);
 
+	//the result is shown when the recalculation in the background is finished
+	if (m_correlationCurve->isRecalculating()) {
+		QApplication::restoreOverrideCursor();
+		return;
+	}
+
 	uiGeneralTab.pbRecalculate->setEnabled(false);
 	emit info(i18n("Correlation status: %1", m_correlationCurve->correlationResult().status));
 	QApplication::restoreOverrideCursor();
@@ -544,6 +560,22 @@ void XYCorrelationCurveDock::curveCorrelationDataChanged(const XYCorrelationCurv
 	m_initializing = false;
 }
 
+void XYCorrelationCurveDock::curveRecalculationStarted() {
+	uiGeneralTab.pbRecalculate->setText(i18n("Cancel"));
+	uiGeneralTab.pbRecalculate->setEnabled(true);
+}
+
+void XYCorrelationCurveDock::curveRecalculationProgress(int progress) {
+	emit info(i18n("Correlation: %1 %", progress));
+}
+
+void XYCorrelationCurveDock::curveRecalculationFinished() {
+	uiGeneralTab.pbRecalculate->setText(i18n("Recalculate"));
+	uiGeneralTab.pbRecalculate->setEnabled(m_correlationCurve->isSourceDataChangedSinceLastRecalc());
+	this->showCorrelationResult();
+	emit info(i18n("Correlation status: %1", m_correlationCurve->correlationResult().status));
+}
+
 void XYCorrelationCurveDock::dataChanged() {
 	this->enableRecalculate();
 }
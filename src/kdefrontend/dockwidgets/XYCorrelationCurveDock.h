@@ -86,6 +86,9 @@ private slots:
 	void curveYDataColumnChanged(const AbstractColumn*);
 	void curveY2DataColumnChanged(const AbstractColumn*);
 	void curveCorrelationDataChanged(const XYCorrelationCurve::CorrelationData&);
+	void curveRecalculationStarted();
+	void curveRecalculationProgress(int);
+	void curveRecalculationFinished();
 	void dataChanged();
 };
 
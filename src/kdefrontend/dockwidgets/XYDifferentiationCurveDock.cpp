@@ -107,6 +107,7 @@ void XYDifferentiationCurveDock::setupGeneral() {
 	connect( uiGeneralTab.sbMax, SIGNAL(valueChanged(double)), this, SLOT(xRangeMaxChanged()) );
 	connect( uiGeneralTab.cbDerivOrder, SIGNAL(currentIndexChanged(int)), this, SLOT(derivOrderChanged()) );
 	connect( uiGeneralTab.sbAccOrder, SIGNAL(valueChanged(int)), this, SLOT(accOrderChanged()) );
+	connect( uiGeneralTab.chkIncremental, SIGNAL(clicked(bool)), this, SLOT(incrementalRecalculationChanged(bool)) );
 	connect( uiGeneralTab.pbRecalculate, SIGNAL(clicked()), this, SLOT(recalculateClicked()) );
 
 	connect( cbDataSourceCurve, SIGNAL(currentModelIndexChanged(QModelIndex)), this, SLOT(dataSourceCurveChanged(QModelIndex)) );
@@ -160,6 +161,7 @@ void XYDifferentiationCurveDock::initGeneralTab() {
 
 	this->showDifferentiationResult();
 
+	uiGeneralTab.chkIncremental->setChecked(m_differentiationCurve->incrementalRecalculation());
 	uiGeneralTab.chkVisible->setChecked( m_curve->isVisible() );
 
 	//Slots
@@ -169,6 +171,7 @@ void XYDifferentiationCurveDock::initGeneralTab() {
 	connect(m_differentiationCurve, SIGNAL(xDataColumnChanged(const AbstractColumn*)), this, SLOT(curveXDataColumnChanged(const AbstractColumn*)));
 	connect(m_differentiationCurve, SIGNAL(yDataColumnChanged(const AbstractColumn*)), this, SLOT(curveYDataColumnChanged(const AbstractColumn*)));
 	connect(m_differentiationCurve, SIGNAL(differentiationDataChanged(XYDifferentiationCurve::DifferentiationData)), this, SLOT(curveDifferentiationDataChanged(XYDifferentiationCurve::DifferentiationData)));
+	connect(m_differentiationCurve, SIGNAL(incrementalRecalculationChanged(bool)), this, SLOT(curveIncrementalRecalculationChanged(bool)));
 	connect(m_differentiationCurve, SIGNAL(sourceDataChanged()), this, SLOT(enableRecalculate()));
 }
 
@@ -465,6 +468,14 @@ void XYDifferentiationCurveDock::accOrderChanged() {
 	uiGeneralTab.pbRecalculate->setEnabled(true);
 }
 
+void XYDifferentiationCurveDock::incrementalRecalculationChanged(bool incremental) {
+	if (m_initializing)
+		return;
+
+	for (auto* curve : m_curvesList)
+		dynamic_cast<XYDifferentiationCurve*>(curve)->setIncrementalRecalculation(incremental);
+}
+
 void XYDifferentiationCurveDock::recalculateClicked() {
 	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
@@ -584,6 +595,12 @@ void XYDifferentiationCurveDock::curveDifferentiationDataChanged(const XYDiffere
 	m_initializing = false;
 }
 
+void XYDifferentiationCurveDock::curveIncrementalRecalculationChanged(bool incremental) {
+	m_initializing = true;
+	uiGeneralTab.chkIncremental->setChecked(incremental);
+	m_initializing = false;
+}
+
 void XYDifferentiationCurveDock::dataChanged() {
 	this->enableRecalculate();
 }
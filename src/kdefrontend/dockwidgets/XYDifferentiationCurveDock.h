@@ -73,6 +73,7 @@ private slots:
 	void derivOrderChanged();
 	void accOrderChanged();
 
+	void incrementalRecalculationChanged(bool);
 	void recalculateClicked();
 	void enableRecalculate() const;
 
@@ -84,6 +85,7 @@ private slots:
 	void curveXDataColumnChanged(const AbstractColumn*);
 	void curveYDataColumnChanged(const AbstractColumn*);
 	void curveDifferentiationDataChanged(const XYDifferentiationCurve::DifferentiationData&);
+	void curveIncrementalRecalculationChanged(bool);
 	void dataChanged();
 };
 
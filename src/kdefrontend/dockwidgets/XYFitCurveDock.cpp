@@ -32,12 +32,16 @@
 #include "backend/core/Project.h"
 #include "backend/lib/macros.h"
 #include "backend/gsl/ExpressionParser.h"
+#include "backend/spreadsheet/Spreadsheet.h"
 #include "backend/worksheet/plots/cartesian/CartesianPlot.h"
 #include "commonfrontend/widgets/TreeViewComboBox.h"
 #include "kdefrontend/widgets/ConstantsWidget.h"
 #include "kdefrontend/widgets/FunctionsWidget.h"
 #include "kdefrontend/widgets/FitOptionsWidget.h"
 #include "kdefrontend/widgets/FitParametersWidget.h"
+#include "kdefrontend/spreadsheet/BatchFitDialog.h"
+
+#include <KMessageBox>
 
 #include <QMenu>
 #include <QWidgetAction>
@@ -201,6 +205,7 @@ void XYFitCurveDock::setupGeneral() {
 	connect(uiGeneralTab.tbFunctions, SIGNAL(clicked()), this, SLOT(showFunctions()));
 	connect(uiGeneralTab.pbOptions, SIGNAL(clicked()), this, SLOT(showOptions()));
 	connect(uiGeneralTab.pbRecalculate, SIGNAL(clicked()), this, SLOT(recalculateClicked()));
+	connect(uiGeneralTab.pbFitColumns, &QPushButton::clicked, this, &XYFitCurveDock::fitColumnsClicked);
 	connect(uiGeneralTab.lData, &QPushButton::clicked, this, &XYFitCurveDock::showDataOptions);
 	connect(uiGeneralTab.lFit, &QPushButton::clicked, this, &XYFitCurveDock::showFitOptions);
 	connect(uiGeneralTab.lParameters, &QPushButton::clicked, this, &XYFitCurveDock::showParameters);
@@ -285,6 +290,9 @@ void XYFitCurveDock::initGeneralTab() {
 	connect(m_fitCurve, SIGNAL(yErrorColumnChanged(const AbstractColumn*)), this, SLOT(curveYErrorColumnChanged(const AbstractColumn*)));
 	connect(m_fitCurve, SIGNAL(fitDataChanged(XYFitCurve::FitData)), this, SLOT(curveFitDataChanged(XYFitCurve::FitData)));
 	connect(m_fitCurve, SIGNAL(sourceDataChanged()), this, SLOT(enableRecalculate()));
+	connect(m_fitCurve, SIGNAL(recalculationStarted()), this, SLOT(curveRecalculationStarted()));
+	connect(m_fitCurve, SIGNAL(recalculationProgress(int)), this, SLOT(curveRecalculationProgress(int)));
+	connect(m_fitCurve, SIGNAL(recalculationFinished()), this, SLOT(curveRecalculationFinished()));
 
 	connect(fitParametersWidget, &FitParametersWidget::parametersChanged, this, &XYFitCurveDock::parametersChanged);
 	connect(fitParametersWidget, &FitParametersWidget::parametersValid, this, &XYFitCurveDock::parametersValid);
@@ -959,6 +967,14 @@ void XYFitCurveDock::setPlotXRange() {
 
 void XYFitCurveDock::recalculateClicked() {
 	DEBUG("XYFitCurveDock::recalculateClicked()");
+	//the button cancels a running fit
+	if (m_fitCurve->isRecalculating()) {
+		m_fitRequested = false;
+		for (XYCurve* curve: m_curvesList)
+			dynamic_cast<XYFitCurve*>(curve)->cancelRecalculation();
+		return;
+	}
+
 	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 	m_fitData.degree = uiGeneralTab.sbDegree->value();
 	if (m_fitData.modelCategory == nsl_fit_model_custom)
@@ -967,22 +983,37 @@ void XYFitCurveDock::recalculateClicked() {
 	for (XYCurve* curve: m_curvesList)
 		dynamic_cast<XYFitCurve*>(curve)->setFitData(m_fitData);
 
+	//the result is shown in curveRecalculationFinished()
+	m_fitRequested = true;
 	m_fitCurve->recalculate();
-	setPlotXRange();
+	if (m_fitRequested && !m_fitCurve->isRecalculating())
+		curveRecalculationFinished();	//the fit was not started because of invalid settings or data
+	QApplication::restoreOverrideCursor();
+	DEBUG("XYFitCurveDock::recalculateClicked() DONE");
+}
 
-	//update fitParametersWidget
-	if (m_fitData.useResults) {
-		for (int i = 0; i < m_fitData.paramNames.size(); i++)
-			m_fitData.paramStartValues[i] = m_fitCurve->fitResult().paramValues[i];
-		fitParametersWidget->setFitData(&m_fitData);
+/*!
+ * fits the current model to several columns of the spreadsheet containing the x-data column.
+ */
+void XYFitCurveDock::fitColumnsClicked() {
+	const AbstractColumn* xColumn = nullptr;
+	if (m_fitCurve->dataSourceType() == XYAnalysisCurve::DataSourceSpreadsheet)
+		xColumn = m_fitCurve->xDataColumn();
+	else if (m_fitCurve->dataSourceCurve())
+		xColumn = m_fitCurve->dataSourceCurve()->xColumn();
+
+	auto* spreadsheet = xColumn ? dynamic_cast<Spreadsheet*>(xColumn->parentAspect()) : nullptr;
+	if (!spreadsheet) {
+		KMessageBox::sorry(this, i18n("The x-data of the fit has to be a column of a spreadsheet."), i18n("Fit Columns"));
+		return;
 	}
 
-	this->showFitResult();
+	m_fitData.degree = uiGeneralTab.sbDegree->value();
+	if (m_fitData.modelCategory == nsl_fit_model_custom)
+		updateParameterList();
 
-	uiGeneralTab.pbRecalculate->setEnabled(false);
-	emit info(i18n("Fit status: %1", m_fitCurve->fitResult().status));
-	QApplication::restoreOverrideCursor();
-	DEBUG("XYFitCurveDock::recalculateClicked() DONE");
+	auto* dlg = new BatchFitDialog(spreadsheet, xColumn, m_fitData, this);
+	dlg->exec();
 }
 
 void XYFitCurveDock::expressionChanged() {
@@ -1380,6 +1411,38 @@ void XYFitCurveDock::curveFitDataChanged(const XYFitCurve::FitData& fitData) {
 	m_initializing = false;
 }
 
+void XYFitCurveDock::curveRecalculationStarted() {
+	uiGeneralTab.pbRecalculate->setText(i18n("Cancel"));
+	uiGeneralTab.pbRecalculate->setEnabled(true);
+}
+
+void XYFitCurveDock::curveRecalculationProgress(int progress) {
+	emit info(i18n("Fit: %1 %", progress));
+}
+
+void XYFitCurveDock::curveRecalculationFinished() {
+	uiGeneralTab.pbRecalculate->setText(i18n("Recalculate"));
+	if (!m_fitRequested) {
+		enableRecalculate();
+		return;
+	}
+	m_fitRequested = false;
+
+	setPlotXRange();
+
+	//update fitParametersWidget
+	if (m_fitData.useResults && m_fitCurve->fitResult().valid) {
+		for (int i = 0; i < m_fitData.paramNames.size(); i++)
+			m_fitData.paramStartValues[i] = m_fitCurve->fitResult().paramValues[i];
+		fitParametersWidget->setFitData(&m_fitData);
+	}
+
+	this->showFitResult();
+
+	uiGeneralTab.pbRecalculate->setEnabled(false);
+	emit info(i18n("Fit status: %1", m_fitCurve->fitResult().status));
+}
+
 void XYFitCurveDock::dataChanged() {
 	this->enableRecalculate();
 }
@@ -63,6 +63,7 @@ private:
 	QList<double> parameters;
 	QList<double> parameterValues;
 	bool m_parametersValid{true};
+	bool m_fitRequested{false};	//fit started via the recalculate button, its result is shown when finished
 
 protected:
 	void setModel() override;
@@ -97,6 +98,7 @@ private slots:
 	void insertConstant(const QString&) const;
 	void setPlotXRange();
 	void recalculateClicked();
+	void fitColumnsClicked();
 	void updateModelEquation();
 	void expressionChanged();
 	void enableRecalculate();
@@ -116,6 +118,9 @@ private slots:
 	void curveXErrorColumnChanged(const AbstractColumn*);
 	void curveYErrorColumnChanged(const AbstractColumn*);
 	void curveFitDataChanged(const XYFitCurve::FitData&);
+	void curveRecalculationStarted();
+	void curveRecalculationProgress(int);
+	void curveRecalculationFinished();
 	void dataChanged();
 };
 
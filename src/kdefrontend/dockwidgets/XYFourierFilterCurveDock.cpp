@@ -184,6 +184,9 @@ void XYFourierFilterCurveDock::initGeneralTab() {
 	connect(m_filterCurve, SIGNAL(yDataColumnChanged(const AbstractColumn*)), this, SLOT(curveYDataColumnChanged(const AbstractColumn*)));
 	connect(m_filterCurve, SIGNAL(filterDataChanged(XYFourierFilterCurve::FilterData)), this, SLOT(curveFilterDataChanged(XYFourierFilterCurve::FilterData)));
 	connect(m_filterCurve, SIGNAL(sourceDataChanged()), this, SLOT(enableRecalculate()));
+	connect(m_filterCurve, SIGNAL(recalculationStarted()), this, SLOT(curveRecalculationStarted()));
+	connect(m_filterCurve, SIGNAL(recalculationProgress(int)), this, SLOT(curveRecalculationProgress(int)));
+	connect(m_filterCurve, SIGNAL(recalculationFinished()), this, SLOT(curveRecalculationFinished()));
 }
 
 void XYFourierFilterCurveDock::setModel() {
@@ -569,6 +572,13 @@ void XYFourierFilterCurveDock::unit2Changed() {
 }
 
 void XYFourierFilterCurveDock::recalculateClicked() {
+	//the button cancels a running recalculation
+	if (m_filterCurve->isRecalculating()) {
+		for (auto* curve : m_curvesList)
+			dynamic_cast<XYFourierFilterCurve*>(curve)->cancelRecalculation();
+		return;
+	}
+
 	m_filterData.cutoff = uiGeneralTab.sbCutoff->value();
 	m_filterData.cutoff2 = uiGeneralTab.sbCutoff2->value();
 
@@ -583,6 +593,12 @@ void XYFourierFilterCurveDock::recalculateClicked() {
 	for (auto* curve : m_curvesList)
 		dynamic_cast<XYFourierFilterCurve*>(curve)->setFilterData(m_filterData);
 
+	//the result is shown when the recalculation in the background is finished
+	if (m_filterCurve->isRecalculating()) {
+		QApplication::restoreOverrideCursor();
+		return;
+	}
+
 	uiGeneralTab.pbRecalculate->setEnabled(false);
 	emit info(i18n("Fourier-Filter status: %1", m_filterCurve->filterResult().status));
 	QApplication::restoreOverrideCursor();
@@ -693,6 +709,22 @@ void XYFourierFilterCurveDock::curveFilterDataChanged(const XYFourierFilterCurve
 	m_initializing = false;
 }
 
+void XYFourierFilterCurveDock::curveRecalculationStarted() {
+	uiGeneralTab.pbRecalculate->setText(i18n("Cancel"));
+	uiGeneralTab.pbRecalculate->setEnabled(true);
+}
+
+void XYFourierFilterCurveDock::curveRecalculationProgress(int progress) {
+	emit info(i18n("Fourier-Filter: %1 %", progress));
+}
+
+void XYFourierFilterCurveDock::curveRecalculationFinished() {
+	uiGeneralTab.pbRecalculate->setText(i18n("Recalculate"));
+	uiGeneralTab.pbRecalculate->setEnabled(m_filterCurve->isSourceDataChangedSinceLastRecalc());
+	this->showFilterResult();
+	emit info(i18n("Fourier-Filter status: %1", m_filterCurve->filterResult().status));
+}
+
 void XYFourierFilterCurveDock::dataChanged() {
 	this->enableRecalculate();
 }
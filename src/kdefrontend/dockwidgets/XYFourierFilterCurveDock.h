@@ -85,6 +85,9 @@ private slots:
 	void curveXDataColumnChanged(const AbstractColumn*);
 	void curveYDataColumnChanged(const AbstractColumn*);
 	void curveFilterDataChanged(const XYFourierFilterCurve::FilterData&);
+	void curveRecalculationStarted();
+	void curveRecalculationProgress(int);
+	void curveRecalculationFinished();
 	void dataChanged();
 };
 
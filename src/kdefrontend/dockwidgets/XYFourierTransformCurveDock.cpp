@@ -101,8 +101,11 @@ void XYFourierTransformCurveDock::setupGeneral() {
 	connect( uiGeneralTab.cbTwoSided, SIGNAL(stateChanged(int)), this, SLOT(twoSidedChanged()) );
 	connect( uiGeneralTab.cbShifted, SIGNAL(stateChanged(int)), this, SLOT(shiftedChanged()) );
 	connect( uiGeneralTab.cbXScale, SIGNAL(currentIndexChanged(int)), this, SLOT(xScaleChanged()) );
+	connect( uiGeneralTab.cbSliding, SIGNAL(stateChanged(int)), this, SLOT(slidingChanged()) );
+	connect( uiGeneralTab.sbFrameSize, SIGNAL(valueChanged(int)), this, SLOT(frameSizeChanged()) );
 
 //	connect( uiGeneralTab.pbOptions, SIGNAL(clicked()), this, SLOT(showOptions()) );
+	connect( uiGeneralTab.chkIncremental, SIGNAL(clicked(bool)), this, SLOT(incrementalRecalculationChanged(bool)) );
 	connect( uiGeneralTab.pbRecalculate, SIGNAL(clicked()), this, SLOT(recalculateClicked()) );
 }
 
@@ -150,11 +153,15 @@ void XYFourierTransformCurveDock::initGeneralTab() {
 	this->shiftedChanged();
 	uiGeneralTab.cbXScale->setCurrentIndex(m_transformData.xScale);
 	this->xScaleChanged();
+	uiGeneralTab.sbFrameSize->setValue((int)m_transformData.frameSize);
+	uiGeneralTab.cbSliding->setChecked(m_transformData.sliding);
+	this->slidingChanged();	// enable/disable the frame size
 	this->showTransformResult();
 
 	//enable the "recalculate"-button if the source data was changed since the last transform
 	uiGeneralTab.pbRecalculate->setEnabled(m_transformCurve->isSourceDataChangedSinceLastRecalc());
 
+	uiGeneralTab.chkIncremental->setChecked(m_transformCurve->incrementalRecalculation());
 	uiGeneralTab.chkVisible->setChecked( m_curve->isVisible() );
 
 	//Slots
@@ -162,7 +169,11 @@ void XYFourierTransformCurveDock::initGeneralTab() {
 	connect(m_transformCurve, SIGNAL(xDataColumnChanged(const AbstractColumn*)), this, SLOT(curveXDataColumnChanged(const AbstractColumn*)));
 	connect(m_transformCurve, SIGNAL(yDataColumnChanged(const AbstractColumn*)), this, SLOT(curveYDataColumnChanged(const AbstractColumn*)));
 	connect(m_transformCurve, SIGNAL(transformDataChanged(XYFourierTransformCurve::TransformData)), this, SLOT(curveTransformDataChanged(XYFourierTransformCurve::TransformData)));
+	connect(m_transformCurve, SIGNAL(incrementalRecalculationChanged(bool)), this, SLOT(curveIncrementalRecalculationChanged(bool)));
 	connect(m_transformCurve, SIGNAL(sourceDataChangedSinceLastTransform()), this, SLOT(enableRecalculate()));
+	connect(m_transformCurve, SIGNAL(recalculationStarted()), this, SLOT(curveRecalculationStarted()));
+	connect(m_transformCurve, SIGNAL(recalculationProgress(int)), this, SLOT(curveRecalculationProgress(int)));
+	connect(m_transformCurve, SIGNAL(recalculationFinished()), this, SLOT(curveRecalculationFinished()));
 }
 
 void XYFourierTransformCurveDock::setModel() {
@@ -313,12 +324,48 @@ void XYFourierTransformCurveDock::xScaleChanged() {
 	enableRecalculate();
 }
 
+void XYFourierTransformCurveDock::slidingChanged() {
+	bool sliding = uiGeneralTab.cbSliding->isChecked();
+	m_transformData.sliding = sliding;
+
+	uiGeneralTab.lFrameSize->setEnabled(sliding);
+	uiGeneralTab.sbFrameSize->setEnabled(sliding);
+
+	enableRecalculate();
+}
+
+void XYFourierTransformCurveDock::frameSizeChanged() {
+	m_transformData.frameSize = (size_t)uiGeneralTab.sbFrameSize->value();
+
+	enableRecalculate();
+}
+
+void XYFourierTransformCurveDock::incrementalRecalculationChanged(bool incremental) {
+	if (m_initializing)
+		return;
+
+	for (auto* curve : m_curvesList)
+		dynamic_cast<XYFourierTransformCurve*>(curve)->setIncrementalRecalculation(incremental);
+}
+
 void XYFourierTransformCurveDock::recalculateClicked() {
+	//the button cancels a running recalculation
+	if (m_transformCurve->isRecalculating()) {
+		for (auto* curve : m_curvesList)
+			dynamic_cast<XYFourierTransformCurve*>(curve)->cancelRecalculation();
+		return;
+	}
 
 	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 	for (auto* curve : m_curvesList)
 		dynamic_cast<XYFourierTransformCurve*>(curve)->setTransformData(m_transformData);
 
+	//the result is shown when the recalculation in the background is finished
+	if (m_transformCurve->isRecalculating()) {
+		QApplication::restoreOverrideCursor();
+		return;
+	}
+
 	uiGeneralTab.pbRecalculate->setEnabled(false);
 	emit info(i18n("Fourier transformation status: %1", m_transformCurve->transformResult().status));
 	QApplication::restoreOverrideCursor();
@@ -404,11 +451,36 @@ void XYFourierTransformCurveDock::curveTransformDataChanged(const XYFourierTrans
 	m_transformData = transformData;
 	uiGeneralTab.cbType->setCurrentIndex(m_transformData.type);
 	this->typeChanged();
+	uiGeneralTab.sbFrameSize->setValue((int)m_transformData.frameSize);
+	uiGeneralTab.cbSliding->setChecked(m_transformData.sliding);
+	this->slidingChanged();
 
 	this->showTransformResult();
 	m_initializing = false;
 }
 
+void XYFourierTransformCurveDock::curveRecalculationStarted() {
+	uiGeneralTab.pbRecalculate->setText(i18n("Cancel"));
+	uiGeneralTab.pbRecalculate->setEnabled(true);
+}
+
+void XYFourierTransformCurveDock::curveRecalculationProgress(int progress) {
+	emit info(i18n("Fourier transformation: %1 %", progress));
+}
+
+void XYFourierTransformCurveDock::curveRecalculationFinished() {
+	uiGeneralTab.pbRecalculate->setText(i18n("Recalculate"));
+	uiGeneralTab.pbRecalculate->setEnabled(m_transformCurve->isSourceDataChangedSinceLastRecalc());
+	this->showTransformResult();
+	emit info(i18n("Fourier transformation status: %1", m_transformCurve->transformResult().status));
+}
+
+void XYFourierTransformCurveDock::curveIncrementalRecalculationChanged(bool incremental) {
+	m_initializing = true;
+	uiGeneralTab.chkIncremental->setChecked(incremental);
+	m_initializing = false;
+}
+
 void XYFourierTransformCurveDock::dataChanged() {
 	this->enableRecalculate();
 }
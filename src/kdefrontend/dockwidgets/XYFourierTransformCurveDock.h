@@ -70,8 +70,11 @@ private slots:
 	void twoSidedChanged();
 	void shiftedChanged();
 	void xScaleChanged();
+	void slidingChanged();
+	void frameSizeChanged();
 
 //	void showOptions();
+	void incrementalRecalculationChanged(bool);
 	void recalculateClicked();
 
 	void enableRecalculate() const;
@@ -82,6 +85,10 @@ private slots:
 	void curveXDataColumnChanged(const AbstractColumn*);
 	void curveYDataColumnChanged(const AbstractColumn*);
 	void curveTransformDataChanged(const XYFourierTransformCurve::TransformData&);
+	void curveIncrementalRecalculationChanged(bool);
+	void curveRecalculationStarted();
+	void curveRecalculationProgress(int);
+	void curveRecalculationFinished();
 	void dataChanged();
 };
 
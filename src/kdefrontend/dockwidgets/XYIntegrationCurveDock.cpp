@@ -108,6 +108,7 @@ void XYIntegrationCurveDock::setupGeneral() {
 	connect( uiGeneralTab.sbMax, SIGNAL(valueChanged(double)), this, SLOT(xRangeMaxChanged()) );
 	connect( uiGeneralTab.cbMethod, SIGNAL(currentIndexChanged(int)), this, SLOT(methodChanged()) );
 	connect( uiGeneralTab.cbAbsolute, SIGNAL(clicked(bool)), this, SLOT(absoluteChanged()) );
+	connect( uiGeneralTab.chkIncremental, SIGNAL(clicked(bool)), this, SLOT(incrementalRecalculationChanged(bool)) );
 	connect( uiGeneralTab.pbRecalculate, SIGNAL(clicked()), this, SLOT(recalculateClicked()) );
 
 	connect( cbDataSourceCurve, SIGNAL(currentModelIndexChanged(QModelIndex)), this, SLOT(dataSourceCurveChanged(QModelIndex)) );
@@ -161,6 +162,7 @@ void XYIntegrationCurveDock::initGeneralTab() {
 
 	this->showIntegrationResult();
 
+	uiGeneralTab.chkIncremental->setChecked(m_integrationCurve->incrementalRecalculation());
 	uiGeneralTab.chkVisible->setChecked( m_curve->isVisible() );
 
 	//Slots
@@ -170,6 +172,7 @@ void XYIntegrationCurveDock::initGeneralTab() {
 	connect(m_integrationCurve, SIGNAL(xDataColumnChanged(const AbstractColumn*)), this, SLOT(curveXDataColumnChanged(const AbstractColumn*)));
 	connect(m_integrationCurve, SIGNAL(yDataColumnChanged(const AbstractColumn*)), this, SLOT(curveYDataColumnChanged(const AbstractColumn*)));
 	connect(m_integrationCurve, SIGNAL(integrationDataChanged(XYIntegrationCurve::IntegrationData)), this, SLOT(curveIntegrationDataChanged(XYIntegrationCurve::IntegrationData)));
+	connect(m_integrationCurve, SIGNAL(incrementalRecalculationChanged(bool)), this, SLOT(curveIncrementalRecalculationChanged(bool)));
 	connect(m_integrationCurve, SIGNAL(sourceDataChanged()), this, SLOT(enableRecalculate()));
 }
 
@@ -383,6 +386,14 @@ void XYIntegrationCurveDock::absoluteChanged() {
 	uiGeneralTab.pbRecalculate->setEnabled(true);
 }
 
+void XYIntegrationCurveDock::incrementalRecalculationChanged(bool incremental) {
+	if (m_initializing)
+		return;
+
+	for (auto* curve : m_curvesList)
+		dynamic_cast<XYIntegrationCurve*>(curve)->setIncrementalRecalculation(incremental);
+}
+
 void XYIntegrationCurveDock::recalculateClicked() {
 	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
@@ -502,6 +513,12 @@ void XYIntegrationCurveDock::curveIntegrationDataChanged(const XYIntegrationCurv
 	m_initializing = false;
 }
 
+void XYIntegrationCurveDock::curveIncrementalRecalculationChanged(bool incremental) {
+	m_initializing = true;
+	uiGeneralTab.chkIncremental->setChecked(incremental);
+	m_initializing = false;
+}
+
 void XYIntegrationCurveDock::dataChanged() {
 	this->enableRecalculate();
 }
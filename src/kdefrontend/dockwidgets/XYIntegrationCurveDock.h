@@ -72,6 +72,7 @@ private slots:
 	void methodChanged();
 	void absoluteChanged();
 
+	void incrementalRecalculationChanged(bool);
 	void recalculateClicked();
 	void enableRecalculate() const;
 
@@ -83,6 +84,7 @@ private slots:
 	void curveXDataColumnChanged(const AbstractColumn*);
 	void curveYDataColumnChanged(const AbstractColumn*);
 	void curveIntegrationDataChanged(const XYIntegrationCurve::IntegrationData&);
+	void curveIncrementalRecalculationChanged(bool);
 	void dataChanged();
 };
 
@@ -206,6 +206,9 @@ void XYInterpolationCurveDock::initGeneralTab() {
 	connect(m_interpolationCurve, SIGNAL(yDataColumnChanged(const AbstractColumn*)), this, SLOT(curveYDataColumnChanged(const AbstractColumn*)));
 	connect(m_interpolationCurve, SIGNAL(interpolationDataChanged(XYInterpolationCurve::InterpolationData)), this, SLOT(curveInterpolationDataChanged(XYInterpolationCurve::InterpolationData)));
 	connect(m_interpolationCurve, SIGNAL(sourceDataChanged()), this, SLOT(enableRecalculate()));
+	connect(m_interpolationCurve, SIGNAL(recalculationStarted()), this, SLOT(curveRecalculationStarted()));
+	connect(m_interpolationCurve, SIGNAL(recalculationProgress(int)), this, SLOT(curveRecalculationProgress(int)));
+	connect(m_interpolationCurve, SIGNAL(recalculationFinished()), this, SLOT(curveRecalculationFinished()));
 }
 
 void XYInterpolationCurveDock::setModel() {
@@ -613,11 +616,24 @@ void XYInterpolationCurveDock::numberOfPointsChanged() {
 }
 
 void XYInterpolationCurveDock::recalculateClicked() {
+	//the button cancels a running recalculation
+	if (m_interpolationCurve->isRecalculating()) {
+		for (auto* curve : m_curvesList)
+			dynamic_cast<XYInterpolationCurve*>(curve)->cancelRecalculation();
+		return;
+	}
+
 	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
 	for (XYCurve* curve: m_curvesList)
 		dynamic_cast<XYInterpolationCurve*>(curve)->setInterpolationData(m_interpolationData);
 
+	//the result is shown when the recalculation in the background is finished
+	if (m_interpolationCurve->isRecalculating()) {
+		QApplication::restoreOverrideCursor();
+		return;
+	}
+
 	uiGeneralTab.pbRecalculate->setEnabled(false);
 	emit info(i18n("Interpolation status: %1", m_interpolationCurve->interpolationResult().status));
 	QApplication::restoreOverrideCursor();
@@ -729,6 +745,22 @@ void XYInterpolationCurveDock::curveInterpolationDataChanged(const XYInterpolati
 	m_initializing = false;
 }
 
+void XYInterpolationCurveDock::curveRecalculationStarted() {
+	uiGeneralTab.pbRecalculate->setText(i18n("Cancel"));
+	uiGeneralTab.pbRecalculate->setEnabled(true);
+}
+
+void XYInterpolationCurveDock::curveRecalculationProgress(int progress) {
+	emit info(i18n("Interpolation: %1 %", progress));
+}
+
+void XYInterpolationCurveDock::curveRecalculationFinished() {
+	uiGeneralTab.pbRecalculate->setText(i18n("Recalculate"));
+	uiGeneralTab.pbRecalculate->setEnabled(m_interpolationCurve->isSourceDataChangedSinceLastRecalc());
+	this->showInterpolationResult();
+	emit info(i18n("Interpolation status: %1", m_interpolationCurve->interpolationResult().status));
+}
+
 void XYInterpolationCurveDock::dataChanged() {
 	this->enableRecalculate();
 }
@@ -119,6 +119,7 @@ void XYSmoothCurveDock::setupGeneral() {
 	connect( uiGeneralTab.cbMode, SIGNAL(currentIndexChanged(int)), this, SLOT(modeChanged()) );
 	connect( uiGeneralTab.sbLeftValue, SIGNAL(valueChanged(double)), this, SLOT(valueChanged()) );
 	connect( uiGeneralTab.sbRightValue, SIGNAL(valueChanged(double)), this, SLOT(valueChanged()) );
+	connect( uiGeneralTab.chkIncremental, SIGNAL(clicked(bool)), this, SLOT(incrementalRecalculationChanged(bool)) );
 	connect( uiGeneralTab.pbRecalculate, SIGNAL(clicked()), this, SLOT(recalculateClicked()) );
 
 	connect( cbDataSourceCurve, SIGNAL(currentModelIndexChanged(QModelIndex)), this, SLOT(dataSourceCurveChanged(QModelIndex)) );
@@ -180,6 +181,7 @@ void XYSmoothCurveDock::initGeneralTab() {
 	valueChanged();
 	this->showSmoothResult();
 
+	uiGeneralTab.chkIncremental->setChecked(m_smoothCurve->incrementalRecalculation());
 	uiGeneralTab.chkVisible->setChecked( m_curve->isVisible() );
 
 	//Slots
@@ -189,7 +191,11 @@ void XYSmoothCurveDock::initGeneralTab() {
 	connect(m_smoothCurve, SIGNAL(xDataColumnChanged(const AbstractColumn*)), this, SLOT(curveXDataColumnChanged(const AbstractColumn*)));
 	connect(m_smoothCurve, SIGNAL(yDataColumnChanged(const AbstractColumn*)), this, SLOT(curveYDataColumnChanged(const AbstractColumn*)));
 	connect(m_smoothCurve, SIGNAL(smoothDataChanged(XYSmoothCurve::SmoothData)), this, SLOT(curveSmoothDataChanged(XYSmoothCurve::SmoothData)));
+	connect(m_smoothCurve, SIGNAL(incrementalRecalculationChanged(bool)), this, SLOT(curveIncrementalRecalculationChanged(bool)));
 	connect(m_smoothCurve, SIGNAL(sourceDataChanged()), this, SLOT(enableRecalculate()));
+	connect(m_smoothCurve, SIGNAL(recalculationStarted()), this, SLOT(curveRecalculationStarted()));
+	connect(m_smoothCurve, SIGNAL(recalculationProgress(int)), this, SLOT(curveRecalculationProgress(int)));
+	connect(m_smoothCurve, SIGNAL(recalculationFinished()), this, SLOT(curveRecalculationFinished()));
 }
 
 void XYSmoothCurveDock::setModel() {
@@ -473,12 +479,33 @@ void XYSmoothCurveDock::valueChanged() {
 	enableRecalculate();
 }
 
+void XYSmoothCurveDock::incrementalRecalculationChanged(bool incremental) {
+	if (m_initializing)
+		return;
+
+	for (auto* curve : m_curvesList)
+		dynamic_cast<XYSmoothCurve*>(curve)->setIncrementalRecalculation(incremental);
+}
+
 void XYSmoothCurveDock::recalculateClicked() {
+	//the button cancels a running recalculation
+	if (m_smoothCurve->isRecalculating()) {
+		for (auto* curve : m_curvesList)
+			dynamic_cast<XYSmoothCurve*>(curve)->cancelRecalculation();
+		return;
+	}
+
 	QApplication::setOverrideCursor(QCursor(Qt::WaitCursor));
 
 	for (auto* curve : m_curvesList)
 		dynamic_cast<XYSmoothCurve*>(curve)->setSmoothData(m_smoothData);
 
+	//the result is shown when the recalculation in the background is finished
+	if (m_smoothCurve->isRecalculating()) {
+		QApplication::restoreOverrideCursor();
+		return;
+	}
+
 	uiGeneralTab.pbRecalculate->setEnabled(false);
 	emit info(i18n("Smoothing status: %1", m_smoothCurve->smoothResult().status));
 	QApplication::restoreOverrideCursor();
@@ -589,6 +616,28 @@ void XYSmoothCurveDock::curveSmoothDataChanged(const XYSmoothCurve::SmoothData&
 	m_initializing = false;
 }
 
+void XYSmoothCurveDock::curveRecalculationStarted() {
+	uiGeneralTab.pbRecalculate->setText(i18n("Cancel"));
+	uiGeneralTab.pbRecalculate->setEnabled(true);
+}
+
+void XYSmoothCurveDock::curveRecalculationProgress(int progress) {
+	emit info(i18n("Smoothing: %1 %", progress));
+}
+
+void XYSmoothCurveDock::curveRecalculationFinished() {
+	uiGeneralTab.pbRecalculate->setText(i18n("Recalculate"));
+	uiGeneralTab.pbRecalculate->setEnabled(m_smoothCurve->isSourceDataChangedSinceLastRecalc());
+	this->showSmoothResult();
+	emit info(i18n("Smoothing status: %1", m_smoothCurve->smoothResult().status));
+}
+
+void XYSmoothCurveDock::curveIncrementalRecalculationChanged(bool incremental) {
+	m_initializing = true;
+	uiGeneralTab.chkIncremental->setChecked(incremental);
+	m_initializing = false;
+}
+
 void XYSmoothCurveDock::dataChanged() {
 	this->enableRecalculate();
 }
@@ -76,6 +76,7 @@ private slots:
 	void modeChanged();
 	void valueChanged();
 
+	void incrementalRecalculationChanged(bool);
 	void recalculateClicked();
 	void enableRecalculate() const;
 
@@ -87,6 +88,10 @@ private slots:
 	void curveXDataColumnChanged(const AbstractColumn*);
 	void curveYDataColumnChanged(const AbstractColumn*);
 	void curveSmoothDataChanged(const XYSmoothCurve::SmoothData&);
+	void curveIncrementalRecalculationChanged(bool);
+	void curveRecalculationStarted();
+	void curveRecalculationProgress(int);
+	void curveRecalculationFinished();
 	void dataChanged();
 
 };
@@ -0,0 +1,167 @@
+/***************************************************************************
+    File                 : BatchFitDialog.cpp
+    Project              : LabPlot
+    Description          : Dialog for fitting one model to several columns
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "BatchFitDialog.h"
+#include "backend/core/column/Column.h"
+#include "backend/spreadsheet/Spreadsheet.h"
+
+#include <QCheckBox>
+#include <QDialogButtonBox>
+#include <QLabel>
+#include <QListWidget>
+#include <QProgressDialog>
+#include <QPushButton>
+#include <QTimer>
+#include <QVBoxLayout>
+#include <QWindow>
+#include <QtConcurrentRun>
+
+#include <KLocalizedString>
+#include <KSharedConfig>
+#include <KWindowConfig>
+
+/*!
+	\class BatchFitDialog
+	\brief Dialog for fitting the model of a fit curve to several columns of a spreadsheet versus the same x-column.
+
+	The columns are fitted in worker threads, the fit can be canceled in the progress dialog.
+	The results of all fits are written to a new spreadsheet.
+
+	\ingroup kdefrontend
+ */
+BatchFitDialog::BatchFitDialog(Spreadsheet* spreadsheet, const AbstractColumn* xColumn, const XYFitCurve::FitData& fitData, QWidget* parent)
+	: QDialog(parent),
+	m_spreadsheet(spreadsheet),
+	m_xColumn(xColumn),
+	m_fitData(fitData),
+	m_lwColumns(new QListWidget),
+	m_chkWarmStart(new QCheckBox(i18n("Use the results of the previous column as start values"))) {
+
+	setWindowTitle(i18nc("@title:window", "Fit Columns"));
+	setWindowIcon(QIcon::fromTheme("labplot-xy-fit-curve"));
+	setAttribute(Qt::WA_DeleteOnClose);
+
+	//all numeric columns except of the x-column can be fitted
+	for (auto* column : spreadsheet->children<Column>()) {
+		if (column == xColumn || !column->isNumeric())
+			continue;
+
+		auto* item = new QListWidgetItem(column->name(), m_lwColumns);
+		item->setFlags(item->flags() | Qt::ItemIsUserCheckable);
+		item->setCheckState(Qt::Checked);
+		m_columns << column;
+	}
+
+	m_chkWarmStart->setToolTip(i18n("Start the fit of a column with the parameter values of the previous column, faster for similar data"));
+
+	auto* btnBox = new QDialogButtonBox(QDialogButtonBox::Ok | QDialogButtonBox::Cancel);
+	btnBox->button(QDialogButtonBox::Ok)->setText(i18n("&Fit"));
+	btnBox->button(QDialogButtonBox::Ok)->setEnabled(!m_columns.isEmpty());
+	connect(btnBox, &QDialogButtonBox::accepted, this, &BatchFitDialog::fit);
+	connect(btnBox, &QDialogButtonBox::rejected, this, &BatchFitDialog::reject);
+	connect(&m_watcher, &QFutureWatcher<QVector<XYFitCurve::FitResult>>::finished, this, &BatchFitDialog::fitFinished);
+
+	auto* layout = new QVBoxLayout;
+	layout->addWidget(new QLabel(i18n("Columns to fit versus \"%1\":", xColumn->name())));
+	layout->addWidget(m_lwColumns);
+	layout->addWidget(m_chkWarmStart);
+	layout->addWidget(btnBox);
+	setLayout(layout);
+
+	//restore saved settings if available
+	create(); // ensure there's a window created
+	KConfigGroup conf(KSharedConfig::openConfig(), "BatchFitDialog");
+	m_chkWarmStart->setChecked(conf.readEntry("WarmStart", false));
+	if (conf.exists()) {
+		KWindowConfig::restoreWindowSize(windowHandle(), conf);
+		resize(windowHandle()->size()); // workaround for QTBUG-40584
+	} else
+		resize(QSize(300, 0).expandedTo(minimumSize()));
+}
+
+BatchFitDialog::~BatchFitDialog() {
+	//the running fit uses the flags of the dialog
+	m_canceled = true;
+	m_watcher.waitForFinished();
+
+	KConfigGroup conf(KSharedConfig::openConfig(), "BatchFitDialog");
+	conf.writeEntry("WarmStart", m_chkWarmStart->isChecked());
+	KWindowConfig::saveWindowSize(windowHandle(), conf);
+}
+
+void BatchFitDialog::fit() {
+	if (m_watcher.isRunning())
+		return;
+
+	m_fitColumns.clear();
+	for (int i = 0; i < m_columns.size(); ++i) {
+		if (m_lwColumns->item(i)->checkState() == Qt::Checked)
+			m_fitColumns << m_columns.at(i);
+	}
+
+	//the data is copied here, the columns are not accessed in the worker threads
+	const XYFitCurve::FitData fitData = m_fitData;
+	const XYFitCurve::BatchData data = XYFitCurve::batchData(fitData, m_xColumn, m_fitColumns);
+	const bool warmStart = m_chkWarmStart->isChecked();
+	m_canceled = false;
+	m_fitted = 0;
+
+	m_progressDialog = new QProgressDialog(i18n("Fitting %1 columns...", m_fitColumns.size()), i18n("Cancel"), 0, m_fitColumns.size(), this);
+	m_progressDialog->setWindowModality(Qt::WindowModal);
+	m_progressDialog->setMinimumDuration(0);
+	connect(m_progressDialog, &QProgressDialog::canceled, this, [this]() { m_canceled = true; });
+
+	auto* progressDialog = m_progressDialog;
+	auto* timer = new QTimer(progressDialog);
+	connect(timer, &QTimer::timeout, progressDialog, [this, progressDialog]() { progressDialog->setValue(m_fitted); });
+	timer->start(100);
+
+	std::atomic<bool>* canceled = &m_canceled;
+	std::atomic<int>* fitted = &m_fitted;
+	m_watcher.setFuture(QtConcurrent::run([fitData, data, warmStart, canceled, fitted]() {
+		return XYFitCurve::fitBatch(fitData, data, warmStart, canceled, fitted);
+	}));
+}
+
+/*!
+ * writes the results of the finished batch fit to a new spreadsheet. Nothing is written if the fit was canceled.
+ */
+void BatchFitDialog::fitFinished() {
+	//closing the progress dialog would cancel the fit
+	m_progressDialog->deleteLater();
+	m_progressDialog = nullptr;
+	if (m_canceled)
+		return;
+
+	auto* spreadsheet = new Spreadsheet(i18n("Fit results of %1", m_spreadsheet->name()));
+	XYFitCurve::writeBatchResults(spreadsheet, m_fitData, m_fitColumns, m_watcher.result());
+	m_spreadsheet->parentAspect()->addChild(spreadsheet);
+
+	accept();
+}
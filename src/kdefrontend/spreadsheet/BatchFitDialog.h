@@ -0,0 +1,69 @@
+/***************************************************************************
+    File                 : BatchFitDialog.h
+    Project              : LabPlot
+    Description          : Dialog for fitting one model to several columns
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+
+ ***************************************************************************/
+
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+#ifndef BATCHFITDIALOG_H
+#define BATCHFITDIALOG_H
+
+#include "backend/worksheet/plots/cartesian/XYFitCurve.h"
+
+#include <QDialog>
+#include <QFutureWatcher>
+
+#include <atomic>
+
+class Spreadsheet;
+class QCheckBox;
+class QListWidget;
+class QProgressDialog;
+
+class BatchFitDialog : public QDialog {
+	Q_OBJECT
+
+public:
+	BatchFitDialog(Spreadsheet*, const AbstractColumn* xColumn, const XYFitCurve::FitData&, QWidget* parent = nullptr);
+	~BatchFitDialog() override;
+
+private:
+	Spreadsheet* m_spreadsheet;
+	const AbstractColumn* m_xColumn;
+	XYFitCurve::FitData m_fitData;
+	QVector<const AbstractColumn*> m_columns;
+	QListWidget* m_lwColumns;
+	QCheckBox* m_chkWarmStart;
+	QVector<const AbstractColumn*> m_fitColumns;	//columns of the running batch fit
+	QFutureWatcher<QVector<XYFitCurve::FitResult>> m_watcher;
+	QProgressDialog* m_progressDialog{nullptr};
+	std::atomic<bool> m_canceled{false};
+	std::atomic<int> m_fitted{0};
+
+private slots:
+	void fit();
+	void fitFinished();
+};
+
+#endif
@@ -29,6 +29,8 @@
 #include "backend/core/column/Column.h"
 #include "backend/worksheet/plots/cartesian/XYConvolutionCurve.h"
 
+#include <QSignalSpy>
+
 //##############################################################################
 
 void ConvolutionTest::testLinear() {
@@ -1499,6 +1501,229 @@ void ConvolutionTest::testCircularDeconv_norm() {
 	QCOMPARE(resultYDataColumn->valueAt(3), 4.);
 }
 
+//##############################################################################
+//#####################  asynchronous recalculation  ###########################
+//##############################################################################
+
+void ConvolutionTest::testAsync() {
+	// data
+	QVector<int> xData = {1,2,3,4};
+	QVector<double> yData = {1.,2.,3.,4.};
+	QVector<double> y2Data = {0,1.,.5};
+
+	//data source columns
+	Column xDataColumn("x", AbstractColumn::Integer);
+	xDataColumn.replaceInteger(0, xData);
+
+	Column yDataColumn("y", AbstractColumn::Numeric);
+	yDataColumn.replaceValues(0, yData);
+
+	Column y2DataColumn("y2", AbstractColumn::Numeric);
+	y2DataColumn.replaceValues(0, y2Data);
+
+	XYAnalysisCurve::setAsyncRecalculation(true);
+	XYConvolutionCurve convolutionCurve("convolution");
+	convolutionCurve.setXDataColumn(&xDataColumn);
+	convolutionCurve.setYDataColumn(&yDataColumn);
+	convolutionCurve.setY2DataColumn(&y2DataColumn);
+
+	//perform the convolution in the background
+	QSignalSpy finishedSpy(&convolutionCurve, SIGNAL(recalculationFinished()));
+	convolutionCurve.recalculate();
+	QCOMPARE(convolutionCurve.isRecalculating(), true);
+	QVERIFY(finishedSpy.wait(5000));
+	XYAnalysisCurve::setAsyncRecalculation(false);
+
+	//check the results
+	QCOMPARE(convolutionCurve.isRecalculating(), false);
+	const XYConvolutionCurve::ConvolutionResult& convolutionResult = convolutionCurve.convolutionResult();
+	QCOMPARE(convolutionResult.available, true);
+	QCOMPARE(convolutionResult.valid, true);
+
+	const AbstractColumn* resultYDataColumn = convolutionCurve.yColumn();
+	QCOMPARE(resultYDataColumn->rowCount(), 6);
+	FuzzyCompare(resultYDataColumn->valueAt(0), 0., 1.e-15);
+	QCOMPARE(resultYDataColumn->valueAt(1), 1.);
+	QCOMPARE(resultYDataColumn->valueAt(2), 2.5);
+	QCOMPARE(resultYDataColumn->valueAt(3), 4.);
+	QCOMPARE(resultYDataColumn->valueAt(4), 5.5);
+	QCOMPARE(resultYDataColumn->valueAt(5), 2.);
+}
+
+void ConvolutionTest::testAsyncCancel() {
+	// data
+	QVector<double> yData;
+	for (int i = 0;  i < 100000; i++)
+		yData.append(i % 100);
+	QVector<double> y2Data = {0,1.,.5};
+
+	//data source columns
+	Column yDataColumn("y", AbstractColumn::Numeric);
+	yDataColumn.replaceValues(0, yData);
+
+	Column y2DataColumn("y2", AbstractColumn::Numeric);
+	y2DataColumn.replaceValues(0, y2Data);
+
+	XYAnalysisCurve::setAsyncRecalculation(true);
+	XYConvolutionCurve convolutionCurve("convolution");
+	convolutionCurve.setYDataColumn(&yDataColumn);
+	convolutionCurve.setY2DataColumn(&y2DataColumn);
+
+	QSignalSpy startedSpy(&convolutionCurve, SIGNAL(recalculationStarted()));
+	QSignalSpy finishedSpy(&convolutionCurve, SIGNAL(recalculationFinished()));
+	convolutionCurve.recalculate();
+	convolutionCurve.cancelRecalculation();
+	XYAnalysisCurve::setAsyncRecalculation(false);
+
+	//the canceled calculation doesn't provide any result, also not after it has finished in the background
+	QCOMPARE(convolutionCurve.isRecalculating(), false);
+	QCOMPARE(startedSpy.count(), 1);
+	QCOMPARE(finishedSpy.count(), 1);
+	QTest::qWait(500);
+	QCOMPARE(finishedSpy.count(), 1);
+	QCOMPARE(convolutionCurve.convolutionResult().available, false);
+	QCOMPARE(convolutionCurve.xColumn()->rowCount(), 0);
+}
+
+void ConvolutionTest::testAsyncSourceChange() {
+	// data
+	QVector<double> yData;
+	for (int i = 0;  i < 100000; i++)
+		yData.append(i % 100);
+	QVector<double> y2Data = {0,1.,.5};
+
+	//data source columns
+	Column yDataColumn("y", AbstractColumn::Numeric);
+	yDataColumn.replaceValues(0, yData);
+
+	Column y2DataColumn("y2", AbstractColumn::Numeric);
+	y2DataColumn.replaceValues(0, y2Data);
+
+	XYAnalysisCurve::setAsyncRecalculation(true);
+	XYConvolutionCurve convolutionCurve("convolution");
+	convolutionCurve.setYDataColumn(&yDataColumn);
+	convolutionCurve.setY2DataColumn(&y2DataColumn);
+
+	QSignalSpy startedSpy(&convolutionCurve, SIGNAL(recalculationStarted()));
+	QSignalSpy finishedSpy(&convolutionCurve, SIGNAL(recalculationFinished()));
+	convolutionCurve.recalculate();
+	QCOMPARE(convolutionCurve.isRecalculating(), true);
+
+	//the changes of the source data don't restart the running recalculation,
+	//it is repeated once with the current data after it has finished
+	yDataColumn.setValueAt(0, 10.);
+	yDataColumn.setValueAt(1, 20.);
+	QCOMPARE(startedSpy.count(), 1);
+	QVERIFY(finishedSpy.wait(5000));
+	QCOMPARE(startedSpy.count(), 2);
+	QCOMPARE(convolutionCurve.isRecalculating(), true);
+	QVERIFY(finishedSpy.wait(5000));
+	XYAnalysisCurve::setAsyncRecalculation(false);
+
+	QCOMPARE(startedSpy.count(), 2);
+	QCOMPARE(convolutionCurve.isRecalculating(), false);
+	QCOMPARE(convolutionCurve.isSourceDataChangedSinceLastRecalc(), false);
+
+	//the results correspond to the current data
+	const AbstractColumn* resultYDataColumn = convolutionCurve.yColumn();
+	const double value1 = resultYDataColumn->valueAt(1);
+	const double value2 = resultYDataColumn->valueAt(2);
+	convolutionCurve.recalculate();
+	QCOMPARE(resultYDataColumn->valueAt(1), value1);
+	QCOMPARE(resultYDataColumn->valueAt(2), value2);
+}
+
+//##############################################################################
+//#################  methods
+//##############################################################################
+
+void ConvolutionTest::testLinear_methods() {
+	// data
+	QVector<double> yData, y2Data;
+	const int N = 20000, M = 301;
+	for (int i = 0; i < N; i++)
+		yData.append(sin(i/50.) + (i % 7)/10.);
+	for (int i = 0; i < M; i++)
+		y2Data.append(exp(-(i - M/2.)*(i - M/2.)/1000.));
+
+	//data source columns
+	Column yDataColumn("y", AbstractColumn::Numeric);
+	yDataColumn.replaceValues(0, yData);
+
+	Column y2DataColumn("y2", AbstractColumn::Numeric);
+	y2DataColumn.replaceValues(0, y2Data);
+
+	XYConvolutionCurve convolutionCurve("convolution");
+	convolutionCurve.setYDataColumn(&yDataColumn);
+	convolutionCurve.setY2DataColumn(&y2DataColumn);
+
+	// the direct method as reference
+	XYConvolutionCurve::ConvolutionData convolutionData = convolutionCurve.convolutionData();
+	convolutionData.method = nsl_conv_method_direct;
+	convolutionData.normalize = nsl_conv_norm_sum;
+	convolutionData.wrap = nsl_conv_wrap_center;
+	convolutionCurve.setConvolutionData(convolutionData);
+	QCOMPARE(convolutionCurve.convolutionResult().valid, true);
+
+	const AbstractColumn* resultYDataColumn = convolutionCurve.yColumn();
+	QCOMPARE(resultYDataColumn->rowCount(), N + M - 1);
+	QVector<double> reference;
+	for (int i = 0; i < N + M - 1; i++)
+		reference.append(resultYDataColumn->valueAt(i));
+
+	QCOMPARE(nsl_conv_auto_method(N, M, nsl_conv_type_linear), nsl_conv_method_overlap_add);
+	for (auto method : {nsl_conv_method_fft, nsl_conv_method_overlap_add, nsl_conv_method_auto}) {
+		convolutionData.method = method;
+		convolutionCurve.setConvolutionData(convolutionData);
+		QCOMPARE(convolutionCurve.convolutionResult().valid, true);
+
+		resultYDataColumn = convolutionCurve.yColumn();
+		QCOMPARE(resultYDataColumn->rowCount(), N + M - 1);
+		for (int i = 0; i < N + M - 1; i++)
+			QVERIFY(fabs(resultYDataColumn->valueAt(i) - reference.at(i)) < 1.e-12);
+	}
+}
+
+void ConvolutionTest::testPerformance_overlapAdd() {
+	// data
+	QVector<double> yData, y2Data;
+#ifdef HAVE_FFTW3
+	const int N = 1e7;
+#else	// GSL is much slower
+	const int N = 5e5;
+#endif
+	const int M = 4096;
+	for (int i = 0;  i < N; i++)
+		yData.append(i % 100);
+	for (int i = 0;  i < M; i++)
+		y2Data.append(1.);
+
+	//data source columns
+	Column yDataColumn("y", AbstractColumn::Numeric);
+	yDataColumn.replaceValues(0, yData);
+
+	Column y2DataColumn("y2", AbstractColumn::Numeric);
+	y2DataColumn.replaceValues(0, y2Data);
+
+	XYConvolutionCurve convolutionCurve("convolution");
+	convolutionCurve.setYDataColumn(&yDataColumn);
+	convolutionCurve.setY2DataColumn(&y2DataColumn);
+
+	//prepare and perform the convolution (overlap-add method)
+	XYConvolutionCurve::ConvolutionData convolutionData = convolutionCurve.convolutionData();
+	QBENCHMARK {
+		// triggers recalculate()
+		convolutionCurve.setConvolutionData(convolutionData);
+	}
+
+	//check the results
+	QCOMPARE(convolutionCurve.convolutionResult().valid, true);
+	const AbstractColumn* resultYDataColumn = convolutionCurve.yColumn();
+	QCOMPARE(resultYDataColumn->rowCount(), N + M - 1);
+	// sum of the 4096 values up to N/2: 40 periods of 0..99 and 5..99, 0
+	FuzzyCompare(resultYDataColumn->valueAt(N/2), 40*4950 + 4940, 1.e-10);
+}
+
 void ConvolutionTest::testPerformance() {
 	// data
 	QVector<double> yData;
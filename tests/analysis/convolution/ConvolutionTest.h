@@ -69,6 +69,15 @@ private slots:
 	void testCircularDeconv2();
 	void testCircularDeconv_norm();
 
+	// asynchronous recalculation
+	void testAsync();
+	void testAsyncCancel();
+	void testAsyncSourceChange();
+
+	// methods
+	void testLinear_methods();
+
 	void testPerformance();
+	void testPerformance_overlapAdd();
 };
 #endif
@@ -29,6 +29,10 @@
 #include "backend/core/column/Column.h"
 #include "backend/worksheet/plots/cartesian/XYCorrelationCurve.h"
 
+extern "C" {
+#include "backend/nsl/nsl_corr.h"
+}
+
 //##############################################################################
 
 void CorrelationTest::testLinear() {
@@ -929,6 +933,44 @@ void CorrelationTest::testCircular2_samplingInterval() {
 	QCOMPARE(resultYDataColumn->valueAt(2), 3.5);
 }
 
+// long signal and short response: calculated with the overlap-add method
+void CorrelationTest::testLinear_overlapAdd() {
+	// data
+	QVector<double> yData, y2Data;
+	const int N = 20000, M = 200;
+	for (int i = 0; i < N; i++)
+		yData.append(sin(i/50.) + (i % 7)/10.);
+	for (int i = 0; i < M; i++)
+		y2Data.append(sin(i/50.));
+
+	//data source columns
+	Column yDataColumn("y", AbstractColumn::Numeric);
+	yDataColumn.replaceValues(0, yData);
+
+	Column y2DataColumn("y2", AbstractColumn::Numeric);
+	y2DataColumn.replaceValues(0, y2Data);
+
+	XYCorrelationCurve correlationCurve("correlation");
+	correlationCurve.setYDataColumn(&yDataColumn);
+	correlationCurve.setY2DataColumn(&y2DataColumn);
+
+	// FFT of the whole zero-padded signal as reference
+	QVector<double> reference(2*N - 1);
+	nsl_corr_fft_type(yData.data(), N, y2Data.data(), M, nsl_corr_type_linear, nsl_corr_norm_coeff, reference.data());
+
+	//perform the correlation
+	XYCorrelationCurve::CorrelationData correlationData = correlationCurve.correlationData();
+	correlationData.normalize = nsl_corr_norm_coeff;
+	correlationCurve.setCorrelationData(correlationData);
+
+	//check the results
+	QCOMPARE(correlationCurve.correlationResult().valid, true);
+	const AbstractColumn* resultYDataColumn = correlationCurve.yColumn();
+	QCOMPARE(resultYDataColumn->rowCount(), 2*N - 1);
+	for (int i = 0; i < 2*N - 1; i++)
+		QVERIFY(fabs(resultYDataColumn->valueAt(i) - reference.at(i)) < 1.e-12);
+}
+
 void CorrelationTest::testPerformance() {
 	// data
 	QVector<double> yData, y2Data;
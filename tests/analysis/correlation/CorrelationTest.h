@@ -59,6 +59,8 @@ private slots:
 	void testCircular_samplingInterval();
 	void testCircular2_samplingInterval();
 
+	void testLinear_overlapAdd();
+
 	void testPerformance();
 };
 #endif
@@ -28,9 +28,12 @@
 
 #include "FitTest.h"
 #include "backend/core/column/Column.h"
+#include "backend/spreadsheet/Spreadsheet.h"
 #include "backend/worksheet/plots/cartesian/XYFitCurve.h"
+#include "backend/gsl/CompiledExpression.h"
 
 extern "C" {
+#include "backend/gsl/parser.h"
 #include "backend/nsl/nsl_sf_stats.h"
 #include "backend/nsl/nsl_stats.h"
 }
@@ -2832,4 +2835,303 @@ void FitTest::testNonLinear_yerror_zero_bug408535() {
 	FuzzyCompare(fitResult.rsquareAdj, 0.999724193304893, 1.e-9);
 }
 
+//##############################################################################
+//#########################  Fits of large data sets  ##########################
+//##############################################################################
+// the residuals and the Jacobian of large data sets are calculated in parallel,
+// the built-in and the compiled custom model have to find the same exact parameters
+void FitTest::testNonLinearGaussianLarge() {
+	const int n = 200000;
+	const double a = 2., s = 1.5, mu = 3.;
+	QVector<double> xData(n), yData(n);
+	for (int i = 0; i < n; ++i) {
+		xData[i] = -10. + 26.*i/(n - 1);
+		yData[i] = a/sqrt(2.*M_PI)/s * exp(-gsl_pow_2((xData[i] - mu)/s)/2.);
+	}
+
+	//data source columns
+	Column xDataColumn("x", AbstractColumn::Numeric);
+	xDataColumn.replaceValues(0, xData);
+
+	Column yDataColumn("y", AbstractColumn::Numeric);
+	yDataColumn.replaceValues(0, yData);
+
+	QVector<double> paramValues[2];
+	for (int k = 0; k < 2; ++k) {
+		XYFitCurve fitCurve("fit");
+		fitCurve.setXDataColumn(&xDataColumn);
+		fitCurve.setYDataColumn(&yDataColumn);
+
+		//prepare the fit: built-in gaussian model and the same model as custom model
+		XYFitCurve::FitData fitData = fitCurve.fitData();
+		if (k == 0) {
+			fitData.modelCategory = nsl_fit_model_peak;
+			fitData.modelType = (int)nsl_fit_model_gaussian;
+			fitData.degree = 1;
+			XYFitCurve::initFitData(fitData);
+		} else {
+			fitData.modelCategory = nsl_fit_model_custom;
+			XYFitCurve::initFitData(fitData);
+			fitData.model = "a/sqrt(2*pi)/s*exp(-((x-mu)/s)^2/2)";
+			fitData.paramNames << "a" << "s" << "mu";
+			for (int i = 0; i < 3; i++) {
+				fitData.paramLowerLimits << -std::numeric_limits<double>::max();
+				fitData.paramUpperLimits << std::numeric_limits<double>::max();
+			}
+		}
+		fitData.paramStartValues.resize(3);
+		fitData.paramStartValues[0] = 1.;
+		fitData.paramStartValues[1] = 1.;
+		fitData.paramStartValues[2] = 2.5;
+		fitCurve.setFitData(fitData);
+
+		//perform the fit
+		fitCurve.recalculate();
+		const XYFitCurve::FitResult& fitResult = fitCurve.fitResult();
+
+		//check the results
+		QCOMPARE(fitResult.available, true);
+		QCOMPARE(fitResult.valid, true);
+		QCOMPARE(fitResult.paramValues.size(), 3);
+
+		DEBUG(std::setprecision(15) << fitResult.paramValues.at(0) << ' ' << fitResult.paramValues.at(1) << ' ' << fitResult.paramValues.at(2));
+		FuzzyCompare(fitResult.paramValues.at(0), a, 1.e-9);
+		FuzzyCompare(fitResult.paramValues.at(1), s, 1.e-9);
+		FuzzyCompare(fitResult.paramValues.at(2), mu, 1.e-9);
+		paramValues[k] = fitResult.paramValues;
+	}
+
+	for (int i = 0; i < 3; i++)
+		FuzzyCompare(paramValues[0].at(i), paramValues[1].at(i), 1.e-9);
+}
+
+//##############################################################################
+//#############################  batch fits  ###################################
+//##############################################################################
+// the batch fit of several columns has to give the same results as the fits of the single columns
+void FitTest::testBatchFit() {
+	const int n = 50, count = 40;
+	QVector<double> xData(n);
+	for (int i = 0; i < n; ++i)
+		xData[i] = 10.*i/(n - 1);
+
+	Column xDataColumn("x", AbstractColumn::Numeric);
+	xDataColumn.replaceValues(0, xData);
+
+	QVector<Column*> columns;
+	QVector<const AbstractColumn*> yColumns;
+	for (int k = 0; k < count; ++k) {
+		QVector<double> yData(n);
+		for (int i = 0; i < n; ++i)
+			yData[i] = (1. + 0.1*k) * exp(-(0.5 + 0.01*k) * xData.at(i));
+		auto* column = new Column(QString::number(k), AbstractColumn::Numeric);
+		column->replaceValues(0, yData);
+		columns << column;
+		yColumns << column;
+	}
+
+	XYFitCurve::FitData fitData;
+	fitData.modelCategory = nsl_fit_model_custom;
+	XYFitCurve::initFitData(fitData);
+	fitData.model = "a*exp(-b*x)";
+	fitData.paramNames << "a" << "b";
+	fitData.paramStartValues << 1. << 1.;
+	for (int i = 0; i < 2; i++) {
+		fitData.paramLowerLimits << -std::numeric_limits<double>::max();
+		fitData.paramUpperLimits << std::numeric_limits<double>::max();
+	}
+
+	for (bool warmStart : {false, true}) {
+		const QVector<XYFitCurve::FitResult> results = XYFitCurve::fitBatch(fitData, &xDataColumn, yColumns, warmStart);
+		QCOMPARE(results.size(), count);
+
+		for (int k = 0; k < count; ++k) {
+			const XYFitCurve::FitResult& result = results.at(k);
+			QCOMPARE(result.valid, true);
+			QCOMPARE(result.paramValues.size(), 2);
+			FuzzyCompare(result.paramValues.at(0), 1. + 0.1*k, 1.e-6);
+			FuzzyCompare(result.paramValues.at(1), 0.5 + 0.01*k, 1.e-6);
+		}
+	}
+
+	//the warm start chains fixed blocks of 16 columns independent of the number of threads,
+	//the first column of a block is fitted with the start values
+	const QVector<XYFitCurve::FitResult> coldResults = XYFitCurve::fitBatch(fitData, &xDataColumn, yColumns, false);
+	const QVector<XYFitCurve::FitResult> warmResults = XYFitCurve::fitBatch(fitData, &xDataColumn, yColumns, true);
+	for (int k : {0, 16, 32}) {
+		QCOMPARE(warmResults.at(k).iterations, coldResults.at(k).iterations);
+		QCOMPARE(warmResults.at(k).paramValues, coldResults.at(k).paramValues);
+	}
+
+	//compare with the fit of a single column
+	XYFitCurve fitCurve("fit");
+	fitCurve.setXDataColumn(&xDataColumn);
+	fitCurve.setYDataColumn(columns.at(7));
+	fitCurve.setFitData(fitData);
+	fitCurve.recalculate();
+	const XYFitCurve::FitResult& fitResult = fitCurve.fitResult();
+
+	const QVector<XYFitCurve::FitResult> results = XYFitCurve::fitBatch(fitData, &xDataColumn, yColumns);
+	const XYFitCurve::FitResult& result = results.at(7);
+	QCOMPARE(result.iterations, fitResult.iterations);
+	for (int i = 0; i < 2; i++) {
+		FuzzyCompare(result.paramValues.at(i), fitResult.paramValues.at(i), 1.e-12);
+		FuzzyCompare(result.errorValues.at(i), fitResult.errorValues.at(i), 1.e-9);
+	}
+
+	qDeleteAll(columns);
+}
+
+// a canceled batch fit stops before the next column, the columns not fitted have no results
+void FitTest::testBatchFitCancel() {
+	QVector<double> xData = {1, 2, 3, 4, 5};
+	QVector<double> yData = {2, 4, 6, 8, 10};
+
+	Column xDataColumn("x", AbstractColumn::Numeric);
+	xDataColumn.replaceValues(0, xData);
+	Column yDataColumn("y", AbstractColumn::Numeric);
+	yDataColumn.replaceValues(0, yData);
+	const QVector<const AbstractColumn*> yColumns(40, &yDataColumn);
+
+	XYFitCurve::FitData fitData;
+	fitData.modelCategory = nsl_fit_model_basic;
+	fitData.modelType = nsl_fit_model_polynomial;
+	fitData.degree = 1;
+	XYFitCurve::initFitData(fitData);
+	fitData.paramStartValues.fill(1.);
+
+	const XYFitCurve::BatchData data = XYFitCurve::batchData(fitData, &xDataColumn, yColumns);
+	std::atomic<bool> canceled{false};
+	std::atomic<int> fitted{0};
+	QVector<XYFitCurve::FitResult> results = XYFitCurve::fitBatch(fitData, data, false, &canceled, &fitted);
+	QCOMPARE(fitted.load(), 40);
+	for (const auto& result : results)
+		QCOMPARE(result.valid, true);
+
+	canceled = true;
+	fitted = 0;
+	results = XYFitCurve::fitBatch(fitData, data, false, &canceled, &fitted);
+	QCOMPARE(results.size(), 40);
+	QCOMPARE(fitted.load(), 0);
+	for (const auto& result : results)
+		QCOMPARE(result.available, false);
+}
+
+// the results of all columns are written to one spreadsheet, columns that can't be fitted get a status only
+void FitTest::testBatchFitResults() {
+	QVector<double> xData = {1, 2, 3, 4, 5};
+	QVector<double> yData1 = {2, 4, 6, 8, 10};
+	QVector<double> yData2 = {3, 5, 7, 9, 11};
+	QVector<double> yData3 = {NAN, NAN, NAN, NAN, NAN};
+
+	Column xDataColumn("x", AbstractColumn::Numeric);
+	xDataColumn.replaceValues(0, xData);
+	Column yDataColumn1("y1", AbstractColumn::Numeric);
+	yDataColumn1.replaceValues(0, yData1);
+	Column yDataColumn2("y2", AbstractColumn::Numeric);
+	yDataColumn2.replaceValues(0, yData2);
+	Column yDataColumn3("y3", AbstractColumn::Numeric);
+	yDataColumn3.replaceValues(0, yData3);
+	const QVector<const AbstractColumn*> yColumns = {&yDataColumn1, &yDataColumn2, &yDataColumn3};
+
+	XYFitCurve::FitData fitData;
+	fitData.modelCategory = nsl_fit_model_basic;
+	fitData.modelType = nsl_fit_model_polynomial;
+	fitData.degree = 1;
+	XYFitCurve::initFitData(fitData);
+	fitData.paramStartValues.fill(1.);
+
+	const QVector<XYFitCurve::FitResult> results = XYFitCurve::fitBatch(fitData, &xDataColumn, yColumns);
+	QCOMPARE(results.at(0).valid, true);
+	QCOMPARE(results.at(1).valid, true);
+	QCOMPARE(results.at(2).available, true);
+	QCOMPARE(results.at(2).valid, false);
+
+	Spreadsheet spreadsheet("results", false);
+	XYFitCurve::writeBatchResults(&spreadsheet, fitData, yColumns, results);
+
+	// column, 2 parameters with errors, 7 goodness of fit values, iterations, status
+	QCOMPARE(spreadsheet.columnCount(), 1 + 4 + 7 + 2);
+	QCOMPARE(spreadsheet.rowCount(), 3);
+	QCOMPARE(spreadsheet.column(0)->textAt(0), QLatin1String("y1"));
+	QCOMPARE(spreadsheet.column(0)->textAt(2), QLatin1String("y3"));
+	QCOMPARE(spreadsheet.column(1)->name(), fitData.paramNamesUtf8.at(0));
+	FuzzyCompare(spreadsheet.column(1)->valueAt(1), 1., 1.e-10);
+	FuzzyCompare(spreadsheet.column(3)->valueAt(0), 2., 1.e-10);
+	FuzzyCompare(spreadsheet.column(3)->valueAt(1), 2., 1.e-10);
+	QVERIFY(std::isnan(spreadsheet.column(1)->valueAt(2)));
+	QCOMPARE(spreadsheet.column(spreadsheet.columnCount() - 1)->textAt(2), results.at(2).status);
+}
+
+//##############################################################################
+//#########################  compiled custom models  ###########################
+//##############################################################################
+// the values of the compiled model have to agree with the values calculated by the parser
+void FitTest::testCompiledExpressionValue() {
+	const QStringList params = {"a", "b", "c"};
+	const double p[] = {1.5, -0.7, 2.};
+	const QVector<QString> models = {"a*x + b", "-a^2", "a^b^c", "x**c*a", "a/b/c", "a - b - c*x",
+		"exp(-b*x)*sin(a*x)", "c*x^3 + sqrt(a)*pi", "gaussian(x - a, c)", "atan2(a, x) + hypot(b, x)", "2.5e-1*x + 0.5"};
+
+	CompiledExpression model;
+	for (const auto& m : models) {
+		QVERIFY(model.compile(m, params));
+		QCOMPARE(model.parameterCount(), 3);
+
+		for (int i = 0; i < params.size(); ++i)
+			assign_variable(qPrintable(params.at(i)), p[i]);
+		for (double x : {-1.3, 0.2, 2.7}) {
+			assign_variable("x", x);
+			const double expected = parse(qPrintable(m), "C");
+			DEBUG(m.toStdString() << ", x = " << x << ": " << model.value(x, p) << " vs. " << expected);
+			FuzzyCompare(model.value(x, p), expected, 1.e-15);
+		}
+	}
+}
+
+// the gradient of the compiled model w.r.t. the parameters has to agree with central differences
+void FitTest::testCompiledExpressionGradient() {
+	const QStringList params = {"a", "b", "c"};
+	const QVector<QString> models = {"a*exp(-b*x) + c", "a*sin(b*x + c)", "a^b*log(c*x)", "a/(1 + (x/b)^c)", "atan(a*x)*erf(b) - c^2",
+		"gaussian(x - a, c)*b"};
+	const double x = 1.7;
+	const double h = 1.e-6;
+
+	CompiledExpression model;
+	for (const auto& m : models) {
+		QVERIFY(model.compile(m, params));
+
+		double p[] = {1.2, 0.8, 2.3};
+		double gradient[3];
+		const double value = model.value(x, p, gradient);
+		FuzzyCompare(value, model.value(x, p), 1.e-15);
+
+		for (int j = 0; j < 3; ++j) {
+			const double pj = p[j];
+			p[j] = pj + h;
+			const double fp = model.value(x, p);
+			p[j] = pj - h;
+			const double fm = model.value(x, p);
+			p[j] = pj;
+			DEBUG(m.toStdString() << ", d/d" << params.at(j).toStdString() << ": " << gradient[j] << " vs. " << (fp - fm)/(2.*h));
+			FuzzyCompare(gradient[j], (fp - fm)/(2.*h), 1.e-6);
+		}
+	}
+}
+
+// models that can't be compiled are evaluated with the parser
+void FitTest::testCompiledExpressionInvalid() {
+	const QStringList params = {"a", "b"};
+	CompiledExpression model;
+
+	QVERIFY(!model.compile("a*y + b", params));	// unknown variable
+	QVERIFY(!model.isValid());
+	QVERIFY(!model.compile("a*(x + b", params));	// missing parenthesis
+	QVERIFY(!model.compile("a = 2", params));	// assignment
+	QVERIFY(!model.compile("unknown(x)", params));	// unknown function
+	QVERIFY(!model.compile("", params));
+	QVERIFY(model.compile("a*x + b", params));
+	QVERIFY(model.isValid());
+}
+
 QTEST_MAIN(FitTest)
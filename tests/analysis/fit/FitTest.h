@@ -87,6 +87,19 @@ private slots:
 	void testLinearGP_PY_xyerror_custom_instrumental_weight();
 	void testLinearGP_PY_xyerror_custom_inverse_weight();
 
+	//fits of large data sets (evaluated in parallel)
+	void testNonLinearGaussianLarge();
+
+	//batch fits of several columns
+	void testBatchFit();
+	void testBatchFitCancel();
+	void testBatchFitResults();
+
+	//compiled custom models
+	void testCompiledExpressionValue();
+	void testCompiledExpressionGradient();
+	void testCompiledExpressionInvalid();
+
 	void testNonLinear_yerror_zero_bug408535();
 };
 #endif
@@ -28,6 +28,27 @@
 #include "IntegrationTest.h"
 #include "backend/core/column/Column.h"
 #include "backend/worksheet/plots/cartesian/XYIntegrationCurve.h"
+#include "backend/worksheet/plots/cartesian/PlotUpdateScheduler.h"
+
+#include <cmath>
+
+/*!
+ * appends \c count rows to the columns \c x and \c y the way the live data sources do it
+ * (empty rows first, the values are written without notifications) and notifies the consumers.
+ */
+static void appendRows(Column& x, Column& y, int count) {
+	const int row = x.rowCount();
+	x.insertRows(row, count);
+	y.insertRows(row, count);
+	auto* xData = static_cast<QVector<double>*>(x.data());
+	auto* yData = static_cast<QVector<double>*>(y.data());
+	for (int i = row; i < row + count; ++i) {
+		(*xData)[i] = 0.1*i;
+		(*yData)[i] = sin(0.1*i) + 0.01*i*i;
+	}
+
+	PlotUpdateScheduler::instance()->setChanged(QVector<Column*>{&x, &y});
+}
 
 //##############################################################################
 
@@ -74,4 +95,48 @@ void IntegrationTest::testLinear() {
 	QCOMPARE(resultYDataColumn->valueAt(3), 7.5);
 }
 
+void IntegrationTest::testIncremental() {
+	for (auto method : {nsl_int_method_rectangle, nsl_int_method_trapezoid, nsl_int_method_simpson, nsl_int_method_simpson_3_8}) {
+		//data source columns
+		Column xDataColumn("x", AbstractColumn::Numeric);
+		Column yDataColumn("y", AbstractColumn::Numeric);
+		appendRows(xDataColumn, yDataColumn, 10);
+
+		XYIntegrationCurve integrationCurve("integration");
+		integrationCurve.setXDataColumn(&xDataColumn);
+		integrationCurve.setYDataColumn(&yDataColumn);
+		XYIntegrationCurve::IntegrationData integrationData = integrationCurve.integrationData();
+		integrationData.method = method;
+		integrationCurve.setIntegrationData(integrationData);
+		integrationCurve.setIncrementalRecalculation(true);
+		integrationCurve.recalculate();
+
+		//the new rows are integrated incrementally
+		appendRows(xDataColumn, yDataColumn, 1);
+		appendRows(xDataColumn, yDataColumn, 2);
+		appendRows(xDataColumn, yDataColumn, 7);
+		QCOMPARE(integrationCurve.isSourceDataChangedSinceLastRecalc(), false);
+
+		//complete integration of the same data
+		XYIntegrationCurve referenceCurve("reference");
+		referenceCurve.setXDataColumn(&xDataColumn);
+		referenceCurve.setYDataColumn(&yDataColumn);
+		referenceCurve.setIntegrationData(integrationData);
+		referenceCurve.recalculate();
+
+		const AbstractColumn* resultXDataColumn = integrationCurve.xColumn();
+		const AbstractColumn* resultYDataColumn = integrationCurve.yColumn();
+		const AbstractColumn* referenceXDataColumn = referenceCurve.xColumn();
+		const AbstractColumn* referenceYDataColumn = referenceCurve.yColumn();
+
+		const int np = resultXDataColumn->rowCount();
+		QCOMPARE(np, referenceXDataColumn->rowCount());
+		for (int i = 0; i < np; i++) {
+			DEBUG(std::setprecision(15) << i << ": " << resultYDataColumn->valueAt(i) << " " << referenceYDataColumn->valueAt(i));
+			QCOMPARE(resultXDataColumn->valueAt(i), referenceXDataColumn->valueAt(i));
+			FuzzyCompare(resultYDataColumn->valueAt(i), referenceYDataColumn->valueAt(i));
+		}
+	}
+}
+
 QTEST_MAIN(IntegrationTest)
@@ -34,6 +34,7 @@ class IntegrationTest : public AnalysisTest {
 
 private slots:
 	void testLinear();
+	void testIncremental();
 
 //	void testPerformance();
 };
@@ -0,0 +1,241 @@
+/***************************************************************************
+    File                 : InterpolationTest.cpp
+    Project              : LabPlot
+    Description          : Tests for interpolation
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "InterpolationTest.h"
+#include "backend/core/column/Column.h"
+#include "backend/worksheet/plots/cartesian/XYInterpolationCurve.h"
+
+//##############################################################################
+
+void InterpolationTest::testLinear() {
+	// data
+	QVector<double> xData = {1.,2.,3.,4.};
+	QVector<double> yData = {1.,4.,9.,16.};
+
+	//data source columns
+	Column xDataColumn("x", AbstractColumn::Numeric);
+	xDataColumn.replaceValues(0, xData);
+
+	Column yDataColumn("y", AbstractColumn::Numeric);
+	yDataColumn.replaceValues(0, yData);
+
+	XYInterpolationCurve interpolationCurve("interpolation");
+	interpolationCurve.setXDataColumn(&xDataColumn);
+	interpolationCurve.setYDataColumn(&yDataColumn);
+
+	//prepare and perform the interpolation
+	XYInterpolationCurve::InterpolationData interpolationData = interpolationCurve.interpolationData();
+	interpolationData.type = nsl_interp_type_linear;
+	interpolationData.npoints = 7;
+	interpolationCurve.setInterpolationData(interpolationData);
+
+	//check the results
+	const XYInterpolationCurve::InterpolationResult& interpolationResult = interpolationCurve.interpolationResult();
+	QCOMPARE(interpolationResult.available, true);
+	QCOMPARE(interpolationResult.valid, true);
+
+	const AbstractColumn* resultXDataColumn = interpolationCurve.xColumn();
+	const AbstractColumn* resultYDataColumn = interpolationCurve.yColumn();
+
+	const int np = resultXDataColumn->rowCount();
+	QCOMPARE(np, 7);
+
+	for (int i = 0; i < np; i++)
+		QCOMPARE(resultXDataColumn->valueAt(i), 1. + 0.5*i);
+
+	QCOMPARE(resultYDataColumn->valueAt(0), 1.);
+	QCOMPARE(resultYDataColumn->valueAt(1), 2.5);
+	QCOMPARE(resultYDataColumn->valueAt(2), 4.);
+	QCOMPARE(resultYDataColumn->valueAt(3), 6.5);
+	QCOMPARE(resultYDataColumn->valueAt(4), 9.);
+	QCOMPARE(resultYDataColumn->valueAt(5), 12.5);
+	QCOMPARE(resultYDataColumn->valueAt(6), 16.);
+}
+
+void InterpolationTest::testCosine() {
+	// data
+	QVector<double> xData = {1.,2.,3.,4.};
+	QVector<double> yData = {1.,3.,3.,1.};
+
+	//data source columns
+	Column xDataColumn("x", AbstractColumn::Numeric);
+	xDataColumn.replaceValues(0, xData);
+
+	Column yDataColumn("y", AbstractColumn::Numeric);
+	yDataColumn.replaceValues(0, yData);
+
+	XYInterpolationCurve interpolationCurve("interpolation");
+	interpolationCurve.setXDataColumn(&xDataColumn);
+	interpolationCurve.setYDataColumn(&yDataColumn);
+
+	//prepare and perform the interpolation
+	XYInterpolationCurve::InterpolationData interpolationData = interpolationCurve.interpolationData();
+	interpolationData.type = nsl_interp_type_cosine;
+	interpolationData.npoints = 7;
+	interpolationCurve.setInterpolationData(interpolationData);
+
+	//check the results
+	const XYInterpolationCurve::InterpolationResult& interpolationResult = interpolationCurve.interpolationResult();
+	QCOMPARE(interpolationResult.available, true);
+	QCOMPARE(interpolationResult.valid, true);
+
+	const AbstractColumn* resultYDataColumn = interpolationCurve.yColumn();
+	QCOMPARE(resultYDataColumn->rowCount(), 7);
+
+	QCOMPARE(resultYDataColumn->valueAt(0), 1.);
+	QCOMPARE(resultYDataColumn->valueAt(1), 2.);
+	QCOMPARE(resultYDataColumn->valueAt(2), 3.);
+	QCOMPARE(resultYDataColumn->valueAt(3), 3.);
+	QCOMPARE(resultYDataColumn->valueAt(4), 3.);
+	QCOMPARE(resultYDataColumn->valueAt(5), 2.);
+	QCOMPARE(resultYDataColumn->valueAt(6), 1.);
+}
+
+// integral of a cubic spline through points of a line, evaluated in parallel for many points
+void InterpolationTest::testIntegral() {
+	// data y = 2x + 1
+	QVector<double> xData;
+	QVector<double> yData;
+	for (int i = 0; i <= 10; i++) {
+		xData.append(i);
+		yData.append(2.*i + 1.);
+	}
+
+	//data source columns
+	Column xDataColumn("x", AbstractColumn::Numeric);
+	xDataColumn.replaceValues(0, xData);
+
+	Column yDataColumn("y", AbstractColumn::Numeric);
+	yDataColumn.replaceValues(0, yData);
+
+	XYInterpolationCurve interpolationCurve("interpolation");
+	interpolationCurve.setXDataColumn(&xDataColumn);
+	interpolationCurve.setYDataColumn(&yDataColumn);
+
+	//prepare and perform the interpolation
+	XYInterpolationCurve::InterpolationData interpolationData = interpolationCurve.interpolationData();
+	interpolationData.type = nsl_interp_type_cspline;
+	interpolationData.evaluate = nsl_interp_evaluate_integral;
+	interpolationData.npoints = 100001;
+	interpolationCurve.setInterpolationData(interpolationData);
+
+	//check the results
+	const XYInterpolationCurve::InterpolationResult& interpolationResult = interpolationCurve.interpolationResult();
+	QCOMPARE(interpolationResult.available, true);
+	QCOMPARE(interpolationResult.valid, true);
+
+	const AbstractColumn* resultXDataColumn = interpolationCurve.xColumn();
+	const AbstractColumn* resultYDataColumn = interpolationCurve.yColumn();
+
+	const int np = resultXDataColumn->rowCount();
+	QCOMPARE(np, 100001);
+
+	// integral x^2 + x
+	for (int i = 0; i < np; i += 997) {
+		const double x = resultXDataColumn->valueAt(i);
+		FuzzyCompare(resultYDataColumn->valueAt(i), x*x + x, 1.e-10);
+	}
+	FuzzyCompare(resultYDataColumn->valueAt(np - 1), 110., 1.e-10);
+}
+
+// the interpolant is kept while only the evaluation changes and calculated again for new source data
+void InterpolationTest::testSourceDataChanged() {
+	// data
+	QVector<double> xData = {1.,2.,3.,4.,5.};
+	QVector<double> yData = {1.,2.,3.,4.,5.};
+
+	//data source columns
+	Column xDataColumn("x", AbstractColumn::Numeric);
+	xDataColumn.replaceValues(0, xData);
+
+	Column yDataColumn("y", AbstractColumn::Numeric);
+	yDataColumn.replaceValues(0, yData);
+
+	XYInterpolationCurve interpolationCurve("interpolation");
+	interpolationCurve.setXDataColumn(&xDataColumn);
+	interpolationCurve.setYDataColumn(&yDataColumn);
+
+	XYInterpolationCurve::InterpolationData interpolationData = interpolationCurve.interpolationData();
+	interpolationData.type = nsl_interp_type_akima;
+	interpolationData.npoints = 5;
+	interpolationCurve.setInterpolationData(interpolationData);
+
+	const AbstractColumn* resultYDataColumn = interpolationCurve.yColumn();
+	QCOMPARE(resultYDataColumn->rowCount(), 5);
+	FuzzyCompare(resultYDataColumn->valueAt(2), 3.);
+
+	// same source data, other number of points
+	interpolationData.npoints = 9;
+	interpolationCurve.setInterpolationData(interpolationData);
+	QCOMPARE(resultYDataColumn->rowCount(), 9);
+	FuzzyCompare(resultYDataColumn->valueAt(3), 2.5);
+
+	// new source data
+	yDataColumn.replaceValues(0, QVector<double>{2.,4.,6.,8.,10.});
+	interpolationCurve.recalculate();
+	QCOMPARE(resultYDataColumn->rowCount(), 9);
+	FuzzyCompare(resultYDataColumn->valueAt(3), 5.);
+	FuzzyCompare(resultYDataColumn->valueAt(8), 10.);
+}
+
+void InterpolationTest::testPerformance() {
+	// data
+	QVector<double> xData;
+	QVector<double> yData;
+	const int N = 1e5;
+	for (int i = 0;  i < N; i++) {
+		xData.append(i);
+		yData.append(sin(0.01*i));
+	}
+
+	//data source columns
+	Column xDataColumn("x", AbstractColumn::Numeric);
+	xDataColumn.replaceValues(0, xData);
+
+	Column yDataColumn("y", AbstractColumn::Numeric);
+	yDataColumn.replaceValues(0, yData);
+
+	XYInterpolationCurve interpolationCurve("interpolation");
+	interpolationCurve.setXDataColumn(&xDataColumn);
+	interpolationCurve.setYDataColumn(&yDataColumn);
+
+	//prepare and perform the interpolation
+	XYInterpolationCurve::InterpolationData interpolationData = interpolationCurve.interpolationData();
+	interpolationData.type = nsl_interp_type_cspline;
+	interpolationData.npoints = 1e7;
+	QBENCHMARK {
+		// triggers recalculate()
+		interpolationCurve.setInterpolationData(interpolationData);
+	}
+
+	//check the results
+	const AbstractColumn* resultYDataColumn = interpolationCurve.yColumn();
+	QCOMPARE(resultYDataColumn->rowCount(), (int)1e7);
+	FuzzyCompare(resultYDataColumn->valueAt(0), 0., 1.e-15);
+}
+
+QTEST_MAIN(InterpolationTest)
@@ -28,6 +28,10 @@
 #include "AsciiFilterTest.h"
 #include "backend/datasources/filters/AsciiFilter.h"
 #include "backend/spreadsheet/Spreadsheet.h"
+#include "backend/datasources/LiveDataSource.h"
+#include "backend/core/column/Column.h"
+
+#include <QTemporaryDir>
 
 void AsciiFilterTest::initTestCase() {
 	const QString currentDir = __FILE__;
@@ -811,4 +815,59 @@ void AsciiFilterTest::testComments01() {
 	QCOMPARE(spreadsheet.column(1)->valueAt(1), 2.2);
 }
 
+//##############################################################################
+//#################################  live data  ################################
+//##############################################################################
+/*!
+ * appends \c text to the file \c fileName, truncates the file before if \c truncate is \c true.
+ */
+static void writeToFile(const QString& fileName, const QByteArray& text, bool truncate = false) {
+	QFile file(fileName);
+	file.open(truncate ? (QIODevice::WriteOnly | QIODevice::Truncate) : (QIODevice::WriteOnly | QIODevice::Append));
+	file.write(text);
+}
+
+void AsciiFilterTest::testLiveFileTail() {
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	const QString fileName = dir.path() + QLatin1String("/live.txt");
+	writeToFile(fileName, "1,1.1\n2,2.2\n", true);
+
+	LiveDataSource dataSource("test", false);
+	dataSource.setSourceType(LiveDataSource::FileOrPipe);
+	dataSource.setFileType(AbstractFileFilter::Ascii);
+	dataSource.setFileName(fileName);
+	dataSource.setReadingType(LiveDataSource::TillEnd);
+	dataSource.setUpdateType(LiveDataSource::NewData);
+	auto* filter = new AsciiFilter;
+	filter->setSeparatingCharacter(",");
+	filter->setHeaderEnabled(false);
+	dataSource.setFilter(filter);
+
+	//the first read determines the columns, the file is followed in the reader thread afterwards
+	dataSource.read();
+	QCOMPARE(dataSource.columnCount(), 2);
+	QCOMPARE(dataSource.rowCount(), 2);
+
+	//appended lines, the incomplete last line is read once its line break arrived
+	writeToFile(fileName, "3,3.3\n4,4.");
+	QTRY_COMPARE(dataSource.rowCount(), 3);
+	writeToFile(fileName, "4\n");
+	QTRY_COMPARE(dataSource.rowCount(), 4);
+	QCOMPARE(dataSource.column(0)->integerAt(3), 4);
+	QCOMPARE(dataSource.column(1)->valueAt(3), 4.4);
+
+	//truncated file, the new content is appended
+	writeToFile(fileName, "5,5.5\n", true);
+	QTRY_COMPARE(dataSource.rowCount(), 5);
+	QCOMPARE(dataSource.column(0)->integerAt(4), 5);
+
+	//replaced file (log rotation)
+	QVERIFY(QFile::rename(fileName, fileName + QLatin1String(".1")));
+	writeToFile(fileName, "6,6.6\n", true);
+	QTRY_COMPARE(dataSource.rowCount(), 6);
+	QCOMPARE(dataSource.column(0)->integerAt(5), 6);
+	QCOMPARE(dataSource.column(1)->valueAt(5), 6.6);
+}
+
 QTEST_MAIN(AsciiFilterTest)
@@ -85,6 +85,9 @@ private slots:
 	void testComments00();
 	void testComments01();
 
+	//live data
+	void testLiveFileTail();
+
 private:
 	QString m_dataDir;
 };
@@ -0,0 +1,228 @@
+/***************************************************************************
+File                 : BinaryFilterTest.cpp
+Project              : LabPlot
+Description          : Tests for the binary I/O-filter.
+--------------------------------------------------------------------
+--------------------------------------------------------------------
+Copyright            : (C) 2020 LabPlot developers
+
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "BinaryFilterTest.h"
+#include "backend/datasources/LiveDataSource.h"
+#include "backend/datasources/filters/BinaryFilter.h"
+#include "backend/core/column/Column.h"
+
+#include <QBuffer>
+#include <QUdpSocket>
+
+/*!
+ * writes one record consisting of an int64 timestamp in ms and two float values to \c out
+ */
+static void appendRecord(QDataStream& out, qint64 time, float value1, float value2) {
+	out << time << value1 << value2;
+}
+
+/*!
+ * returns a frame with the length prefix containing the records \c first, ..., \c first + count - 1
+ */
+static QByteArray frame(int first, int count, QDataStream::ByteOrder byteOrder) {
+	QByteArray records;
+	QDataStream out(&records, QIODevice::WriteOnly);
+	out.setByteOrder(byteOrder);
+	out.setFloatingPointPrecision(QDataStream::SinglePrecision);
+	for (int i = first; i < first + count; ++i)
+		appendRecord(out, 1000*i, i, 2*i);
+
+	QByteArray data;
+	QDataStream prefix(&data, QIODevice::WriteOnly);
+	prefix.setByteOrder(byteOrder);
+	prefix << (quint32)records.size();
+	return data + records;
+}
+
+static void setRecordLayout(BinaryFilter* filter, QDataStream::ByteOrder byteOrder) {
+	filter->setRecordLayout(QVector<BinaryFilter::DataType>() << BinaryFilter::INT64 << BinaryFilter::REAL32 << BinaryFilter::REAL32);
+	filter->setTimestampField(0);
+	filter->setByteOrder(byteOrder);
+}
+
+void BinaryFilterTest::initTestCase() {
+	// needed in order to have the signals triggered by SignallingUndoCommand, see LabPlot.cpp
+	//TODO: redesign/remove this
+	qRegisterMetaType<const AbstractAspect*>("const AbstractAspect*");
+	qRegisterMetaType<const AbstractColumn*>("const AbstractColumn*");
+}
+
+//##############################################################################
+//#################################  live data  ################################
+//##############################################################################
+void BinaryFilterTest::testLiveFrames() {
+	LiveDataSource dataSource("test", false);
+	auto* filter = new BinaryFilter;
+	setRecordLayout(filter, QDataStream::LittleEndian);
+	filter->setCreateIndexEnabled(true);
+	dataSource.setFilter(filter);
+
+	//two complete frames and the first half of the third frame
+	const QByteArray third = frame(5, 2, QDataStream::LittleEndian);
+	QByteArray data = frame(1, 3, QDataStream::LittleEndian) + frame(4, 1, QDataStream::LittleEndian) + third.left(10);
+	QBuffer buffer(&data);
+	buffer.open(QIODevice::ReadOnly);
+
+	filter->readFromLiveDeviceNotFile(buffer, &dataSource);
+
+	QCOMPARE(dataSource.columnCount(), 4);
+	QCOMPARE(dataSource.rowCount(), 4);
+	QCOMPARE(dataSource.column(0)->columnMode(), AbstractColumn::Integer);
+	QCOMPARE(dataSource.column(1)->columnMode(), AbstractColumn::DateTime);
+	QCOMPARE(dataSource.column(2)->columnMode(), AbstractColumn::Numeric);
+	QCOMPARE(dataSource.column(3)->columnMode(), AbstractColumn::Numeric);
+
+	for (int i = 0; i < 4; ++i) {
+		QCOMPARE(dataSource.column(0)->integerAt(i), i + 1);
+		QCOMPARE(dataSource.column(1)->dateTimeAt(i), QDateTime::fromMSecsSinceEpoch(1000*(i + 1), Qt::UTC));
+		QCOMPARE(dataSource.column(2)->valueAt(i), (double)(i + 1));
+		QCOMPARE(dataSource.column(3)->valueAt(i), (double)(2*(i + 1)));
+	}
+
+	//the incomplete frame is kept in the device
+	QCOMPARE(buffer.bytesAvailable(), (qint64)10);
+
+	//the rest of the third frame arrived
+	const qint64 pos = buffer.pos();
+	buffer.close();
+	data += third.mid(10);
+	buffer.open(QIODevice::ReadOnly);
+	buffer.seek(pos);
+
+	filter->readFromLiveDeviceNotFile(buffer, &dataSource);
+
+	QCOMPARE(dataSource.rowCount(), 6);
+	QCOMPARE(dataSource.column(0)->integerAt(5), 6);
+	QCOMPARE(dataSource.column(1)->dateTimeAt(5), QDateTime::fromMSecsSinceEpoch(6000, Qt::UTC));
+	QCOMPARE(dataSource.column(2)->valueAt(5), 6.);
+	QCOMPARE(dataSource.column(3)->valueAt(5), 12.);
+	QCOMPARE(buffer.bytesAvailable(), (qint64)0);
+}
+
+void BinaryFilterTest::testLiveFramesBigEndian() {
+	LiveDataSource dataSource("test", false);
+	auto* filter = new BinaryFilter;
+	setRecordLayout(filter, QDataStream::BigEndian);
+	dataSource.setFilter(filter);
+
+	QByteArray data = frame(1, 10, QDataStream::BigEndian);
+	QBuffer buffer(&data);
+	buffer.open(QIODevice::ReadOnly);
+
+	filter->readFromLiveDeviceNotFile(buffer, &dataSource);
+
+	QCOMPARE(dataSource.columnCount(), 3);
+	QCOMPARE(dataSource.rowCount(), 10);
+	QCOMPARE(dataSource.column(0)->dateTimeAt(9), QDateTime::fromMSecsSinceEpoch(10000, Qt::UTC));
+	QCOMPARE(dataSource.column(1)->valueAt(9), 10.);
+	QCOMPARE(dataSource.column(2)->valueAt(9), 20.);
+}
+
+void BinaryFilterTest::testLiveRecordsKeepLastValues() {
+	LiveDataSource dataSource("test", false);
+	dataSource.setKeepNValues(5);
+	auto* filter = new BinaryFilter;
+	filter->setVectors(2);
+	filter->setDataType(BinaryFilter::INT16);
+	filter->setFramesEnabled(false);
+	dataSource.setFilter(filter);
+
+	//8 records without frames, the last record is incomplete
+	QByteArray data;
+	QDataStream out(&data, QIODevice::WriteOnly);
+	out.setByteOrder(QDataStream::LittleEndian);
+	for (qint16 i = 1; i <= 7; ++i)
+		out << i << (qint16)-i;
+	out << (qint16)8;
+	QBuffer buffer(&data);
+	buffer.open(QIODevice::ReadOnly);
+
+	filter->readFromLiveDeviceNotFile(buffer, &dataSource);
+
+	//the last 5 complete records are kept
+	QCOMPARE(dataSource.columnCount(), 2);
+	QCOMPARE(dataSource.rowCount(), 5);
+	QCOMPARE(dataSource.column(0)->columnMode(), AbstractColumn::Integer);
+	for (int i = 0; i < 5; ++i) {
+		QCOMPARE(dataSource.column(0)->integerAt(i), i + 3);
+		QCOMPARE(dataSource.column(1)->integerAt(i), -(i + 3));
+	}
+	QCOMPARE(buffer.bytesAvailable(), (qint64)2);
+}
+
+void BinaryFilterTest::testLiveUdpDatagrams() {
+	QUdpSocket receiver;
+	if (!receiver.bind(QHostAddress::LocalHost, 0))
+		QSKIP("no UDP socket available");
+
+	LiveDataSource dataSource("test", false);
+	auto* filter = new BinaryFilter;
+	setRecordLayout(filter, QDataStream::LittleEndian);
+	dataSource.setFilter(filter);
+
+	//every datagram contains one frame
+	QUdpSocket sender;
+	for (int i = 0; i < 10; ++i)
+		sender.writeDatagram(frame(10*i + 1, 10, QDataStream::LittleEndian), QHostAddress::LocalHost, receiver.localPort());
+
+	int rows = 0;
+	for (int i = 0; i < 100 && rows < 100; ++i) {
+		if (receiver.hasPendingDatagrams() || receiver.waitForReadyRead(100))
+			filter->readFromLiveDeviceNotFile(receiver, &dataSource);
+		rows = dataSource.rowCount();
+	}
+
+	QCOMPARE(dataSource.rowCount(), 100);
+	for (int i = 0; i < 100; ++i)
+		QCOMPARE(dataSource.column(1)->valueAt(i), (double)(i + 1));
+}
+
+//##############################################################################
+//#################################  performance  ##############################
+//##############################################################################
+void BinaryFilterTest::testLiveFramesPerformance() {
+	//100k records in frames of 100 records
+	QByteArray data;
+	for (int i = 0; i < 1000; ++i)
+		data += frame(100*i + 1, 100, QDataStream::LittleEndian);
+
+	QBENCHMARK {
+		LiveDataSource dataSource("test", false);
+		auto* filter = new BinaryFilter;
+		setRecordLayout(filter, QDataStream::LittleEndian);
+		dataSource.setFilter(filter);
+
+		QBuffer buffer(&data);
+		buffer.open(QIODevice::ReadOnly);
+		filter->readFromLiveDeviceNotFile(buffer, &dataSource);
+		QCOMPARE(dataSource.rowCount(), 100000);
+	}
+}
+
+QTEST_MAIN(BinaryFilterTest)
@@ -0,0 +1,117 @@
+/***************************************************************************
+    File                 : FITSFilterTest.cpp
+    Project              : LabPlot
+    Description          : Tests for the FITS I/O-filter.
+    --------------------------------------------------------------------
+    Copyright            : (C) 2020 LabPlot developers
+ ***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "FITSFilterTest.h"
+#include "backend/datasources/filters/FITSFilter.h"
+#include "backend/spreadsheet/Spreadsheet.h"
+
+#include <fitsio.h>
+
+void FITSFilterTest::initTestCase() {
+	// needed in order to have the signals triggered by SignallingUndoCommand, see LabPlot.cpp
+	//TODO: redesign/remove this
+	qRegisterMetaType<const AbstractAspect*>("const AbstractAspect*");
+	qRegisterMetaType<const AbstractColumn*>("const AbstractColumn*");
+
+	QVERIFY(m_tempDir.isValid());
+}
+
+//##############################################################################
+//#################################  images  ###################################
+//##############################################################################
+void FITSFilterTest::testIntegerImageImport() {
+	// 3x2 image of 32 bit integers
+	const QString fileName = m_tempDir.filePath(QLatin1String("image.fits"));
+	int status = 0;
+	fitsfile* file = nullptr;
+	fits_create_file(&file, fileName.toLatin1().constData(), &status);
+	long naxes[2] = {3, 2};
+	fits_create_img(file, LONG_IMG, 2, naxes, &status);
+	int pixels[6] = {1, 2, 3, -4, 5, 2000000000};
+	fits_write_img(file, TINT, 1, 6, pixels, &status);
+	fits_close_file(file, &status);
+	QCOMPARE(status, 0);
+
+	Spreadsheet spreadsheet("test", false);
+	FITSFilter filter;
+	filter.readDataFromFile(fileName, &spreadsheet, AbstractFileFilter::Replace);
+
+	QCOMPARE(spreadsheet.columnCount(), 3);
+	QCOMPARE(spreadsheet.rowCount(), 2);
+	for (int c = 0; c < 3; ++c)
+		QCOMPARE(spreadsheet.column(c)->columnMode(), AbstractColumn::Integer);
+
+	QCOMPARE(spreadsheet.column(0)->integerAt(0), 1);
+	QCOMPARE(spreadsheet.column(1)->integerAt(0), 2);
+	QCOMPARE(spreadsheet.column(2)->integerAt(0), 3);
+	QCOMPARE(spreadsheet.column(0)->integerAt(1), -4);
+	QCOMPARE(spreadsheet.column(1)->integerAt(1), 5);
+	QCOMPARE(spreadsheet.column(2)->integerAt(1), 2000000000);
+}
+
+//##############################################################################
+//#################################  tables  ###################################
+//##############################################################################
+/*!
+ * binary table with a scalar and a vector integer column, the vector column is read cell by cell
+ */
+void FITSFilterTest::testTableImport() {
+	const QString fileName = m_tempDir.filePath(QLatin1String("table.fits"));
+	int status = 0;
+	fitsfile* file = nullptr;
+	fits_create_file(&file, fileName.toLatin1().constData(), &status);
+	char* types[3] = {const_cast<char*>("int"), const_cast<char*>("vector"), const_cast<char*>("double")};
+	char* forms[3] = {const_cast<char*>("1J"), const_cast<char*>("3J"), const_cast<char*>("1D")};
+	fits_create_tbl(file, BINARY_TBL, 4, 3, types, forms, nullptr, const_cast<char*>("TABLE"), &status);
+	int ints[4] = {1, 2, 3, 4};
+	int vectors[12] = {10, 11, 12, 20, 21, 22, 30, 31, 32, 40, 41, 42};
+	double doubles[4] = {0.5, 1.5, 2.5, 3.5};
+	fits_write_col(file, TINT, 1, 1, 1, 4, ints, &status);
+	fits_write_col(file, TINT, 2, 1, 1, 12, vectors, &status);
+	fits_write_col(file, TDOUBLE, 3, 1, 1, 4, doubles, &status);
+	fits_close_file(file, &status);
+	QCOMPARE(status, 0);
+
+	Spreadsheet spreadsheet("test", false);
+	FITSFilter filter;
+	filter.readDataFromFile(fileName + QLatin1String("[1]"), &spreadsheet, AbstractFileFilter::Replace);
+
+	QCOMPARE(spreadsheet.columnCount(), 3);
+	QCOMPARE(spreadsheet.rowCount(), 4);
+	QCOMPARE(spreadsheet.column(0)->columnMode(), AbstractColumn::Integer);
+	QCOMPARE(spreadsheet.column(1)->columnMode(), AbstractColumn::Numeric);
+	QCOMPARE(spreadsheet.column(2)->columnMode(), AbstractColumn::Numeric);
+
+	for (int i = 0; i < 4; ++i) {
+		QCOMPARE(spreadsheet.column(0)->integerAt(i), i + 1);
+		// only the first element of the vector column is imported
+		QCOMPARE(spreadsheet.column(1)->valueAt(i), 10.*(i + 1));
+		QCOMPARE(spreadsheet.column(2)->valueAt(i), i + 0.5);
+	}
+}
+
+QTEST_MAIN(FITSFilterTest)
@@ -80,6 +80,41 @@ void JsonFilterTest::testArrayImport() {
 	QCOMPARE(spreadsheet.column(2)->valueAt(2), 0.03);
 }
 
+/*!
+ * import an array of objects with differently ordered members, escaped strings and nested values
+ */
+void JsonFilterTest::testArrayOfObjectsImport() {
+	Spreadsheet spreadsheet("test", false);
+	JsonFilter filter;
+
+	const QString fileName = m_dataDir + "objects.json";
+	AbstractFileFilter::ImportMode mode = AbstractFileFilter::Replace;
+	filter.setDataRowType(QJsonValue::Object);
+	filter.readDataFromFile(fileName, &spreadsheet, mode);
+
+	QCOMPARE(spreadsheet.columnCount(), 3);
+	QCOMPARE(spreadsheet.rowCount(), 3);
+	QCOMPARE(spreadsheet.column(0)->columnMode(), AbstractColumn::Text);
+	QCOMPARE(spreadsheet.column(1)->columnMode(), AbstractColumn::Numeric);
+	QCOMPARE(spreadsheet.column(2)->columnMode(), AbstractColumn::Numeric);
+
+	QCOMPARE(spreadsheet.column(0)->name(), QLatin1String("name"));
+	QCOMPARE(spreadsheet.column(1)->name(), QLatin1String("x"));
+	QCOMPARE(spreadsheet.column(2)->name(), QLatin1String("y"));
+
+	QCOMPARE(spreadsheet.column(0)->textAt(0), QString::fromUtf8("caf\u00e9"));
+	QCOMPARE(spreadsheet.column(0)->textAt(1), QString("a\"b"));
+	QCOMPARE(spreadsheet.column(0)->textAt(2), QString("c"));
+
+	QCOMPARE(spreadsheet.column(1)->valueAt(0), 1.);
+	QCOMPARE(spreadsheet.column(1)->valueAt(1), 2.);
+	QCOMPARE(spreadsheet.column(1)->valueAt(2), 3.);
+
+	QCOMPARE(spreadsheet.column(2)->valueAt(0), 1.5);
+	QCOMPARE(spreadsheet.column(2)->valueAt(1), 2.5);
+	QCOMPARE(spreadsheet.column(2)->valueAt(2), 3.5);
+}
+
 /*!
  * import objects with an additional column for the index
  */
@@ -39,6 +39,7 @@ private slots:
 	void initTestCase();
 
 	void testArrayImport();
+	void testArrayOfObjectsImport();
 	void testObjectImport01();
 	void testObjectImport02();
 	void testObjectImport03();
@@ -0,0 +1,216 @@
+/***************************************************************************
+File                 : ColumnHistoryTest.cpp
+Project              : LabPlot
+Description          : Tests for the on-disk history of live data columns
+--------------------------------------------------------------------
+Copyright            : (C) 2020 LabPlot developers
+
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "ColumnHistoryTest.h"
+#include "backend/core/column/Column.h"
+#include "backend/core/column/ColumnHistory.h"
+
+void ColumnHistoryTest::initTestCase() {
+	// needed in order to have the signals triggered by SignallingUndoCommand, see LabPlot.cpp
+	//TODO: redesign/remove this
+	qRegisterMetaType<const AbstractAspect*>("const AbstractAspect*");
+	qRegisterMetaType<const AbstractColumn*>("const AbstractColumn*");
+}
+
+//##############################################################################
+//#################################  storage  ##################################
+//##############################################################################
+void ColumnHistoryTest::testValues() {
+	ColumnHistory history(AbstractColumn::Numeric);
+	const qint64 rows = 3*ColumnHistory::blockRows + 100;
+	for (qint64 i = 0; i < rows; ++i)
+		history.append(0.5*i);
+
+	QCOMPARE(history.rowCount(), rows);
+
+	//three blocks are written to the file, the last rows are still in memory
+	QVERIFY(history.diskSize() > 0);
+	QVERIFY(history.diskSize() < 3*ColumnHistory::blockRows*(qint64)sizeof(double));
+
+	QCOMPARE(history.valueAt(0), 0.);
+	QCOMPARE(history.valueAt(ColumnHistory::blockRows - 1), 0.5*(ColumnHistory::blockRows - 1));
+	QCOMPARE(history.valueAt(ColumnHistory::blockRows), 0.5*ColumnHistory::blockRows);
+	QCOMPARE(history.valueAt(2*ColumnHistory::blockRows + 7), 0.5*(2*ColumnHistory::blockRows + 7));
+	QCOMPARE(history.valueAt(10), 5.);
+	QCOMPARE(history.valueAt(rows - 1), 0.5*(rows - 1));
+	QVERIFY(std::isnan(history.valueAt(rows)));
+	QVERIFY(std::isnan(history.valueAt(-1)));
+}
+
+void ColumnHistoryTest::testRead() {
+	ColumnHistory history(AbstractColumn::Numeric);
+	const qint64 rows = 2*ColumnHistory::blockRows + 10;
+	for (qint64 i = 0; i < rows; ++i)
+		history.append(std::sin(0.001*i));
+
+	//read across the block boundaries and into the rows not written yet
+	const qint64 first = ColumnHistory::blockRows - 5;
+	const qint64 count = ColumnHistory::blockRows + 15;
+	QVector<double> data(count);
+	history.read(first, count, data.data());
+	for (qint64 i = 0; i < count; ++i)
+		QCOMPARE(data.at(i), std::sin(0.001*(first + i)));
+}
+
+void ColumnHistoryTest::testNaN() {
+	ColumnHistory history(AbstractColumn::Numeric);
+	for (int i = 0; i < ColumnHistory::blockRows + 1; ++i)
+		history.append(i % 2 ? NAN : (double)i);
+
+	QCOMPARE(history.valueAt(0), 0.);
+	QVERIFY(std::isnan(history.valueAt(1)));
+	QCOMPARE(history.valueAt(ColumnHistory::blockRows), (double)ColumnHistory::blockRows);
+
+	//NaN values are ignored in the range
+	QCOMPARE(history.minimum(), 0.);
+	QCOMPARE(history.maximum(), (double)ColumnHistory::blockRows);
+}
+
+void ColumnHistoryTest::testSummary() {
+	ColumnHistory history(AbstractColumn::Numeric);
+	const qint64 rows = 1000000;
+	for (qint64 i = 0; i < rows; ++i)
+		history.append(i % 100 == 0 ? -1. : (double)(i % 10));
+
+	QCOMPARE(history.minimum(), -1.);
+	QCOMPARE(history.maximum(), 9.);
+
+	const auto bins = history.summary(100);
+	QVERIFY(bins.size() <= 100);
+	QVERIFY(bins.size() > 50);
+	QCOMPARE(bins.constFirst().first, -1.);
+	QCOMPARE(bins.constLast().last, (double)((rows - 1) % 10));
+	for (const auto& bin : bins) {
+		QCOMPARE(bin.min, -1.);
+		QCOMPARE(bin.max, 9.);
+	}
+}
+
+//##############################################################################
+//#################################  columns  ##################################
+//##############################################################################
+void ColumnHistoryTest::testEvictNumeric() {
+	Column column("x", QVector<double>{0, 1, 2, 3, 4, 5});
+	column.setHistory(new ColumnHistory(AbstractColumn::Numeric));
+
+	column.evictRows(2);
+	column.evictRows(3);
+
+	//the evicted rows are moved to the history in the logical order
+	const ColumnHistory* history = column.history();
+	QCOMPARE(history->rowCount(), 5);
+	for (int i = 0; i < 5; ++i)
+		QCOMPARE(history->valueAt(i), (double)i);
+
+	QCOMPARE(column.valueAt(0), 5.);
+	QVERIFY(std::isnan(column.valueAt(1)));
+}
+
+void ColumnHistoryTest::testEvictDateTime() {
+	const QDateTime dateTime = QDateTime::fromMSecsSinceEpoch(1577836800000, Qt::UTC);
+	Column column("t", QVector<QDateTime>{dateTime, QDateTime(), dateTime.addSecs(1)}, AbstractColumn::DateTime);
+	column.setHistory(new ColumnHistory(AbstractColumn::DateTime));
+
+	column.evictRows(3);
+
+	const ColumnHistory* history = column.history();
+	QCOMPARE(history->rowCount(), 3);
+	QCOMPARE(history->valueAt(0), (double)dateTime.toMSecsSinceEpoch());
+	QVERIFY(std::isnan(history->valueAt(1)));
+	QCOMPARE(history->valueAt(2), (double)dateTime.addSecs(1).toMSecsSinceEpoch());
+}
+
+/*!
+ * the values written after removing rows are read back in the same logical rows
+ */
+void ColumnHistoryTest::testWriteTextAfterEvict() {
+	Column column("s", QVector<QString>{"a", "b", "c", "d"}, AbstractColumn::Text);
+	column.evictRows(2);
+	QCOMPARE(column.textAt(0), QString("c"));
+
+	column.setTextAt(2, "e");
+	column.replaceTexts(3, QVector<QString>{"f"});
+	column.setTextAt(0, "x");
+
+	QCOMPARE(column.rowCount(), 4);
+	QCOMPARE(column.textAt(0), QString("x"));
+	QCOMPARE(column.textAt(1), QString("d"));
+	QCOMPARE(column.textAt(2), QString("e"));
+	QCOMPARE(column.textAt(3), QString("f"));
+}
+
+void ColumnHistoryTest::testWriteDateTimeAfterEvict() {
+	const QDateTime dateTime = QDateTime::fromMSecsSinceEpoch(1577836800000, Qt::UTC);
+	Column column("t", QVector<QDateTime>{dateTime, dateTime.addSecs(1), dateTime.addSecs(2)}, AbstractColumn::DateTime);
+	column.evictRows(1);
+	QCOMPARE(column.dateTimeAt(0), dateTime.addSecs(1));
+
+	column.setDateTimeAt(2, dateTime.addSecs(3));
+	QCOMPARE(column.dateTimeAt(2), dateTime.addSecs(3));
+
+	column.evictRows(1);
+	column.replaceDateTimes(1, QVector<QDateTime>{dateTime.addSecs(4), dateTime.addSecs(5)});
+
+	QCOMPARE(column.rowCount(), 3);
+	QCOMPARE(column.dateTimeAt(0), dateTime.addSecs(2));
+	QCOMPARE(column.dateTimeAt(1), dateTime.addSecs(4));
+	QCOMPARE(column.dateTimeAt(2), dateTime.addSecs(5));
+}
+
+/*!
+ * the minimum and the maximum are determined in the logical order without rotating the circular buffer
+ */
+void ColumnHistoryTest::testMinMaxAfterEvict() {
+	Column column("x", QVector<double>{5, 1, 7, 3, 9, 2});
+	column.evictRows(2);
+	column.setValueAt(4, -1.);
+	column.setValueAt(5, 4.);
+	QCOMPARE(column.ringOffset(), 2);
+
+	QCOMPARE(column.minimum(0, 2), 3.);
+	QCOMPARE(column.maximum(0, 2), 7.);
+	QCOMPARE(column.minimum(2, 5), -1.);
+	QCOMPARE(column.maximum(2, 5), 9.);
+	QCOMPARE(column.ringOffset(), 2);
+}
+
+void ColumnHistoryTest::testRemoveHistory() {
+	Column column("x", QVector<double>{0, 1, 2});
+	column.setHistory(new ColumnHistory(AbstractColumn::Numeric));
+	column.evictRows(1);
+	QCOMPARE(column.history()->rowCount(), 1);
+
+	//without a history the evicted rows are discarded
+	column.setHistory(nullptr);
+	QVERIFY(!column.history());
+	column.evictRows(1);
+	QCOMPARE(column.valueAt(0), 2.);
+}
+
+QTEST_MAIN(ColumnHistoryTest)
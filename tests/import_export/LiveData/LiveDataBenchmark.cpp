@@ -0,0 +1,295 @@
+/***************************************************************************
+File                 : LiveDataBenchmark.cpp
+Project              : LabPlot
+Description          : Throughput and latency benchmark for the live data sources
+--------------------------------------------------------------------
+Copyright            : (C) 2020 LabPlot developers
+
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "LiveDataBenchmark.h"
+#include "backend/datasources/LiveDataSource.h"
+#include "backend/datasources/filters/AsciiFilter.h"
+#include "backend/datasources/filters/BinaryFilter.h"
+#include "backend/core/column/Column.h"
+
+#ifdef HAVE_MQTT
+#include "backend/datasources/MQTTClient.h"
+#include "backend/datasources/MQTTTopic.h"
+#include <QtMqtt/QMqttTopicFilter>
+#endif
+
+#include <algorithm>
+#include <memory>
+
+/*
+ * Replays data to the live data sources and reports the sustained rate, the end-to-end latency
+ * (send time until the row is available in the column), the number of lost rows and the CPU time
+ * of the sender thread, the GUI thread and the remaining threads (reader threads, Qt internals).
+ *
+ * The replay is configured with the environment variables
+ * LABPLOT_REPLAY_RATE		rows per second (default 10000)
+ * LABPLOT_REPLAY_DURATION	duration in ms (default 2000)
+ * LABPLOT_REPLAY_FILE		recorded data to replay, the first value of every line is used (default: sine)
+ */
+
+void LiveDataBenchmark::initTestCase() {
+	// needed in order to have the signals triggered by SignallingUndoCommand, see LabPlot.cpp
+	//TODO: redesign/remove this
+	qRegisterMetaType<const AbstractAspect*>("const AbstractAspect*");
+	qRegisterMetaType<const AbstractColumn*>("const AbstractColumn*");
+
+	bool ok;
+	const int rate = qEnvironmentVariableIntValue("LABPLOT_REPLAY_RATE", &ok);
+	if (ok && rate > 0)
+		m_rate = rate;
+	const int duration = qEnvironmentVariableIntValue("LABPLOT_REPLAY_DURATION", &ok);
+	if (ok && duration > 0)
+		m_duration = duration;
+
+	const QString fileName = QString::fromLocal8Bit(qgetenv("LABPLOT_REPLAY_FILE"));
+	if (!fileName.isEmpty()) {
+		QFile file(fileName);
+		if (file.open(QIODevice::ReadOnly)) {
+			while (!file.atEnd()) {
+				const QByteArray line = file.readLine().simplified();
+				const double value = line.split(' ').first().split(',').first().toDouble(&ok);
+				if (ok)
+					m_values << value;
+			}
+		}
+	}
+	if (m_values.isEmpty()) {
+		for (int i = 0; i < 1000; ++i)
+			m_values << sin(2*M_PI*i/1000.);
+	}
+
+	qInfo("replaying %d values with %d rows/s for %d ms", m_values.size(), m_rate, m_duration);
+}
+
+void LiveDataBenchmark::benchmarkFile() {
+	run(ReplaySender::File, true);
+}
+
+void LiveDataBenchmark::benchmarkTcpSocket() {
+	//the connection is reopened for every read, data sent in the meantime can be lost
+	run(ReplaySender::TcpSocket, false);
+}
+
+void LiveDataBenchmark::benchmarkTcpSocketBinary() {
+	run(ReplaySender::TcpSocketBinary, true);
+}
+
+void LiveDataBenchmark::benchmarkUdpSocket() {
+	run(ReplaySender::UdpSocket, false);
+}
+
+void LiveDataBenchmark::benchmarkLocalSocket() {
+	run(ReplaySender::LocalSocket, false);
+}
+
+#ifdef HAVE_MQTT
+void LiveDataBenchmark::benchmarkMQTT() {
+	run(ReplaySender::MQTT, true);
+}
+#endif
+
+/*!
+ * returns the value at the percentile \c p of the sorted values \c values.
+ */
+static double percentile(const QVector<qint64>& values, double p) {
+	if (values.isEmpty())
+		return NAN;
+	const int index = qMin(values.size() - 1, (int)(p * values.size()));
+	return values.at(index);
+}
+
+void LiveDataBenchmark::run(ReplaySender::Mode mode, bool lossless) {
+	QElapsedTimer clock;
+	clock.start();
+
+	QThread thread;
+	ReplaySender sender(mode, m_values, m_rate, m_duration, clock);
+	sender.moveToThread(&thread);
+	thread.start();
+	QMetaObject::invokeMethod(&sender, "prepare", Qt::BlockingQueuedConnection);
+
+	const qint64 processCpuStart = ReplaySender::processCpuTime();
+	const qint64 guiCpuStart = ReplaySender::threadCpuTime();
+
+	//determine the latency of every row once it's available in the spreadsheet
+	Spreadsheet* spreadsheet = nullptr;
+	QVector<qint64> latencies;
+	latencies.reserve(sender.rows());
+	qint64 lastReceived = 0;
+	bool scanScheduled = false;
+	QObject context;
+	auto scan = [&]() {
+		scanScheduled = false;
+		if (!spreadsheet)
+			return;
+		const qint64 now = clock.nsecsElapsed();
+		const int rows = qMin(spreadsheet->rowCount(), sender.sentRows());
+		for (int row = latencies.size(); row < rows; ++row) {
+			latencies << now - sender.sendTime(row);
+			lastReceived = now;
+		}
+	};
+	auto scheduleScan = [&]() {
+		if (!scanScheduled) {
+			scanScheduled = true;
+			QTimer::singleShot(0, &context, scan);
+		}
+	};
+	auto monitor = [&](Spreadsheet* s) {
+		spreadsheet = s;
+		auto connectColumn = [&](const AbstractAspect* aspect) {
+			const auto* column = dynamic_cast<const Column*>(aspect);
+			if (column)
+				connect(column, &Column::rowsInserted, &context, scheduleScan);
+		};
+		for (auto* column : s->children<Column>())
+			connectColumn(column);
+		connect(s, &AbstractAspect::aspectAdded, &context, connectColumn);
+	};
+
+	std::unique_ptr<LiveDataSource> source;
+#ifdef HAVE_MQTT
+	std::unique_ptr<MQTTClient> client;
+#endif
+	if (mode == ReplaySender::MQTT) {
+#ifdef HAVE_MQTT
+		client.reset(new MQTTClient("replay"));
+		auto* filter = new AsciiFilter;
+		filter->setAutoModeEnabled(true);
+		client->setFilter(filter);
+		client->setReadingType(MQTTClient::TillEnd);
+		client->setKeepNValues(0);
+		client->setUpdateType(MQTTClient::NewData);
+		client->setMQTTClientHostPort("127.0.0.1", sender.port());
+		client->setMQTTUseAuthentication(false);
+		client->setMQTTUseID(false);
+		client->addInitialMQTTSubscriptions(QMqttTopicFilter(ReplaySender::mqttTopic()), 0);
+		connect(client.get(), &MQTTClient::MQTTTopicsChanged, &context, [&]() {
+			if (spreadsheet)
+				return;
+			for (auto* topic : client->children<MQTTTopic>(AbstractAspect::Recursive)) {
+				if (topic->topicName() == ReplaySender::mqttTopic())
+					monitor(topic);
+			}
+		});
+		client->read();
+#endif
+	} else {
+		source.reset(new LiveDataSource("replay", false));
+		source->setReadingType(LiveDataSource::TillEnd);
+		source->setKeepNValues(0);
+		switch (mode) {
+		case ReplaySender::File:
+			source->setSourceType(LiveDataSource::FileOrPipe);
+			source->setFileName(sender.fileName());
+			break;
+		case ReplaySender::TcpSocket:
+		case ReplaySender::TcpSocketBinary:
+			source->setSourceType(LiveDataSource::NetworkTcpSocket);
+			source->setHost("127.0.0.1");
+			source->setPort(sender.port());
+			break;
+		case ReplaySender::UdpSocket:
+			source->setSourceType(LiveDataSource::NetworkUdpSocket);
+			source->setHost("127.0.0.1");
+			source->setPort(sender.port());
+			break;
+		case ReplaySender::LocalSocket:
+			source->setSourceType(LiveDataSource::LocalSocket);
+			source->setLocalSocketName(sender.localSocketName());
+			break;
+		case ReplaySender::MQTT:
+			break;
+		}
+		source->setUpdateType(LiveDataSource::NewData);
+
+		if (mode == ReplaySender::TcpSocketBinary) {
+			source->setFileType(AbstractFileFilter::Binary);
+			auto* filter = new BinaryFilter;
+			filter->setVectors(1);
+			filter->setDataType(BinaryFilter::REAL64);
+			filter->setByteOrder(QDataStream::LittleEndian);
+			filter->setFramesEnabled(true);
+			source->setFilter(filter);
+		} else {
+			source->setFileType(AbstractFileFilter::Ascii);
+			auto* filter = new AsciiFilter;
+			filter->setHeaderEnabled(false);
+			source->setFilter(filter);
+		}
+		monitor(source.get());
+	}
+
+	//start reading, the columns of a file are determined once the first rows were written
+	QMetaObject::invokeMethod(&sender, "start", Qt::QueuedConnection);
+	if (mode == ReplaySender::File) {
+		QTRY_VERIFY(sender.sentRows() > 0);
+		source->read();
+	} else if (source)
+		source->read();
+
+	//wait until all rows were received or until the remaining rows are considered as lost
+	QElapsedTimer timeout;
+	timeout.start();
+	while (!(sender.isFinished() && latencies.size() == sender.rows()) && timeout.elapsed() < m_duration + 5000)
+		QTest::qWait(50);
+	scan();
+
+	const qint64 guiCpu = ReplaySender::threadCpuTime() - guiCpuStart;
+	const qint64 processCpu = ReplaySender::processCpuTime() - processCpuStart;
+	const qint64 senderCpu = sender.cpuTime();
+
+	QMetaObject::invokeMethod(&sender, "stop", Qt::BlockingQueuedConnection);
+	thread.quit();
+	thread.wait();
+
+	//report
+	const int sent = sender.sentRows();
+	const int received = latencies.size();
+	const double seconds = (sent > 0 && received > 0) ? (lastReceived - sender.sendTime(0)) / 1.e9 : 0.;
+	const double rate = (seconds > 0.) ? received / seconds : 0.;
+	std::sort(latencies.begin(), latencies.end());
+	const double ms = 1.e6;
+	const double wall = clock.nsecsElapsed() / 1.e3;	// µs
+
+	qInfo("%s: %d rows sent, %d received, %d lost, %.0f rows/s", QTest::currentTestFunction(), sent, received, sent - received, rate);
+	qInfo("	latency [ms]: p50 %.3f, p90 %.3f, p99 %.3f, max %.3f", percentile(latencies, 0.5)/ms, percentile(latencies, 0.9)/ms,
+		percentile(latencies, 0.99)/ms, percentile(latencies, 1.)/ms);
+	if (processCpu >= 0)
+		qInfo("	CPU [ms]: sender %.1f (%.1f%%), GUI thread %.1f (%.1f%%), reader and other threads %.1f (%.1f%%)",
+			senderCpu/1.e3, 100.*senderCpu/wall, guiCpu/1.e3, 100.*guiCpu/wall,
+			(processCpu - guiCpu - senderCpu)/1.e3, 100.*(processCpu - guiCpu - senderCpu)/wall);
+
+	QTest::setBenchmarkResult(rate, QTest::Events);
+
+	QVERIFY(received > 0);
+	if (lossless)
+		QCOMPARE(received, sent);
+}
+
+QTEST_MAIN(LiveDataBenchmark)
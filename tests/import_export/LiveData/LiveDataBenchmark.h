@@ -0,0 +1,60 @@
+/***************************************************************************
+File                 : LiveDataBenchmark.h
+Project              : LabPlot
+Description          : Throughput and latency benchmark for the live data sources
+--------------------------------------------------------------------
+Copyright            : (C) 2020 LabPlot developers
+
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef LIVEDATABENCHMARK_H
+#define LIVEDATABENCHMARK_H
+
+#include "ReplaySender.h"
+
+#include <QtTest>
+
+class Spreadsheet;
+
+class LiveDataBenchmark : public QObject {
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+
+	void benchmarkFile();
+	void benchmarkTcpSocket();
+	void benchmarkTcpSocketBinary();
+	void benchmarkUdpSocket();
+	void benchmarkLocalSocket();
+#ifdef HAVE_MQTT
+	void benchmarkMQTT();
+#endif
+
+private:
+	void run(ReplaySender::Mode, bool lossless);
+
+	QVector<double> m_values;	// values to replay
+	int m_rate{10000};		// rows per second
+	int m_duration{2000};		// ms
+};
+#endif
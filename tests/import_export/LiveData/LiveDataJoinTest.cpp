@@ -0,0 +1,296 @@
+/***************************************************************************
+File                 : LiveDataJoinTest.cpp
+Project              : LabPlot
+Description          : Tests for the timestamp aligned join of live data sources
+--------------------------------------------------------------------
+Copyright            : (C) 2020 LabPlot developers
+
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "LiveDataJoinTest.h"
+#include "backend/datasources/LiveDataJoin.h"
+#include "backend/core/column/Column.h"
+#include "backend/worksheet/plots/cartesian/PlotUpdateScheduler.h"
+
+/*!
+ * appends the rows with the keys \c keys and the values \c values to the spreadsheet
+ * and notifies the consumers of the live data.
+ */
+static void appendRows(Spreadsheet& spreadsheet, const QVector<double>& keys, const QVector<double>& values) {
+	const int row = spreadsheet.rowCount();
+	spreadsheet.setRowCount(row + keys.size());
+	for (int i = 0; i < keys.size(); ++i) {
+		spreadsheet.column(0)->setValueAt(row + i, keys.at(i));
+		spreadsheet.column(1)->setValueAt(row + i, values.at(i));
+	}
+
+	PlotUpdateScheduler::instance()->setChanged(QVector<Column*>{spreadsheet.column(0), spreadsheet.column(1)});
+}
+
+void LiveDataJoinTest::initTestCase() {
+	// needed in order to have the signals triggered by SignallingUndoCommand, see LabPlot.cpp
+	//TODO: redesign/remove this
+	qRegisterMetaType<const AbstractAspect*>("const AbstractAspect*");
+	qRegisterMetaType<const AbstractColumn*>("const AbstractColumn*");
+}
+
+//##############################################################################
+//#################################  methods  ##################################
+//##############################################################################
+void LiveDataJoinTest::testLastValue() {
+	Spreadsheet s1("s1", false);
+	s1.setRowCount(0);
+	appendRows(s1, {0, 10, 20, 30}, {0, 1, 2, 3});
+	Spreadsheet s2("s2", false);
+	s2.setRowCount(0);
+	appendRows(s2, {5, 15, 25}, {100, 200, 300});
+
+	LiveDataJoin join("join");
+	join.setInterval(10);
+	join.setMethod(LiveDataJoin::LastValue);
+	join.addSource(&s1);
+	join.addSource(&s2);
+
+	//the timestamps up to the last key of the second source are joined
+	QCOMPARE(join.columnCount(), 3);
+	QCOMPARE(join.rowCount(), 3);
+	QCOMPARE(join.column(0)->valueAt(0), 0.);
+	QCOMPARE(join.column(0)->valueAt(1), 10.);
+	QCOMPARE(join.column(0)->valueAt(2), 20.);
+	QCOMPARE(join.column(1)->valueAt(0), 0.);
+	QCOMPARE(join.column(1)->valueAt(1), 1.);
+	QCOMPARE(join.column(1)->valueAt(2), 2.);
+	QVERIFY(std::isnan(join.column(2)->valueAt(0)));
+	QCOMPARE(join.column(2)->valueAt(1), 100.);
+	QCOMPARE(join.column(2)->valueAt(2), 200.);
+}
+
+void LiveDataJoinTest::testLinear() {
+	Spreadsheet s1("s1", false);
+	s1.setRowCount(0);
+	appendRows(s1, {0, 10, 20, 30}, {0, 1, 2, 3});
+	Spreadsheet s2("s2", false);
+	s2.setRowCount(0);
+	appendRows(s2, {5, 15, 25}, {100, 200, 300});
+
+	LiveDataJoin join("join");
+	join.setInterval(10);
+	join.setMethod(LiveDataJoin::Linear);
+	join.addSource(&s1);
+	join.addSource(&s2);
+
+	QCOMPARE(join.rowCount(), 3);
+	QCOMPARE(join.column(1)->valueAt(0), 0.);
+	QCOMPARE(join.column(1)->valueAt(1), 1.);
+	QCOMPARE(join.column(1)->valueAt(2), 2.);
+	QVERIFY(std::isnan(join.column(2)->valueAt(0)));
+	QCOMPARE(join.column(2)->valueAt(1), 150.);
+	QCOMPARE(join.column(2)->valueAt(2), 250.);
+}
+
+void LiveDataJoinTest::testNearest() {
+	Spreadsheet s1("s1", false);
+	s1.setRowCount(0);
+	appendRows(s1, {0, 10, 20, 30}, {0, 1, 2, 3});
+	Spreadsheet s2("s2", false);
+	s2.setRowCount(0);
+	appendRows(s2, {4, 16, 22}, {100, 200, 300});
+
+	LiveDataJoin join("join");
+	join.setInterval(10);
+	join.setMethod(LiveDataJoin::Nearest);
+	join.addSource(&s1);
+	join.addSource(&s2);
+
+	QCOMPARE(join.rowCount(), 3);
+	QCOMPARE(join.column(2)->valueAt(0), 100.);
+	QCOMPARE(join.column(2)->valueAt(1), 100.);
+	QCOMPARE(join.column(2)->valueAt(2), 300.);
+}
+
+//##############################################################################
+//###############################  timestamps  #################################
+//##############################################################################
+void LiveDataJoinTest::testReferenceKeys() {
+	Spreadsheet s1("s1", false);
+	s1.setRowCount(0);
+	appendRows(s1, {1, 2.5, 7, 9}, {1, 2, 3, 4});
+	Spreadsheet s2("s2", false);
+	s2.setRowCount(0);
+	appendRows(s2, {0, 5, 8}, {10, 20, 30});
+
+	//the keys of the first source are used as timestamps
+	LiveDataJoin join("join");
+	join.setInterval(0);
+	join.setMethod(LiveDataJoin::LastValue);
+	join.addSource(&s1);
+	join.addSource(&s2);
+
+	QCOMPARE(join.rowCount(), 3);
+	QCOMPARE(join.column(0)->valueAt(0), 1.);
+	QCOMPARE(join.column(0)->valueAt(1), 2.5);
+	QCOMPARE(join.column(0)->valueAt(2), 7.);
+	QCOMPARE(join.column(2)->valueAt(0), 10.);
+	QCOMPARE(join.column(2)->valueAt(1), 10.);
+	QCOMPARE(join.column(2)->valueAt(2), 20.);
+}
+
+void LiveDataJoinTest::testDateTimeKeys() {
+	const QDateTime start = QDateTime::fromMSecsSinceEpoch(1577836800000);	// 2020-01-01
+
+	Spreadsheet s1("s1", false);
+	s1.setRowCount(4);
+	s1.column(0)->setColumnMode(AbstractColumn::DateTime);
+	for (int i = 0; i < 4; ++i) {
+		s1.column(0)->setDateTimeAt(i, start.addMSecs(i * 500));
+		s1.column(1)->setValueAt(i, i);
+	}
+	Spreadsheet s2("s2", false);
+	s2.setRowCount(3);
+	s2.column(0)->setColumnMode(AbstractColumn::DateTime);
+	for (int i = 0; i < 3; ++i) {
+		s2.column(0)->setDateTimeAt(i, start.addMSecs(i * 700));
+		s2.column(1)->setValueAt(i, 10 * i);
+	}
+
+	LiveDataJoin join("join");
+	join.setInterval(1000);
+	join.setMethod(LiveDataJoin::LastValue);
+	join.addSource(&s1);
+	join.addSource(&s2);
+
+	//timestamps up to 1400 ms
+	QCOMPARE(join.column(0)->columnMode(), AbstractColumn::DateTime);
+	QCOMPARE(join.rowCount(), 2);
+	QCOMPARE(join.column(0)->dateTimeAt(0), start);
+	QCOMPARE(join.column(0)->dateTimeAt(1), start.addMSecs(1000));
+	QCOMPARE(join.column(1)->valueAt(0), 0.);
+	QCOMPARE(join.column(1)->valueAt(1), 2.);
+	QCOMPARE(join.column(2)->valueAt(0), 0.);
+	QCOMPARE(join.column(2)->valueAt(1), 10.);
+}
+
+//##############################################################################
+//###############################  live data  ##################################
+//##############################################################################
+/*!
+ * joining the data arriving in chunks gives the same result as joining all data at once.
+ */
+void LiveDataJoinTest::testIncremental() {
+	QVector<double> keys1, values1, keys2, values2;
+	for (int i = 0; i < 100; ++i) {
+		keys1 << i;
+		values1 << sin(i/10.);
+	}
+	for (int i = 0; i < 80; ++i) {
+		keys2 << 0.5 + 1.3 * i;
+		values2 << cos(i/10.);
+	}
+
+	Spreadsheet s1("s1", false);
+	s1.setRowCount(0);
+	Spreadsheet s2("s2", false);
+	s2.setRowCount(0);
+
+	LiveDataJoin join("join");
+	join.setInterval(0.7);
+	join.setMethod(LiveDataJoin::Linear);
+	join.addSource(&s1);
+	join.addSource(&s2);
+
+	for (int i = 0; 7*i < keys1.size(); ++i) {
+		appendRows(s1, keys1.mid(7*i, 7), values1.mid(7*i, 7));
+		appendRows(s2, keys2.mid(5*i, 5), values2.mid(5*i, 5));
+	}
+	QVERIFY(join.rowCount() > 100);
+
+	Spreadsheet all1("all1", false);
+	all1.setRowCount(0);
+	appendRows(all1, keys1, values1);
+	Spreadsheet all2("all2", false);
+	all2.setRowCount(0);
+	appendRows(all2, keys2.mid(0, s2.rowCount()), values2.mid(0, s2.rowCount()));
+
+	LiveDataJoin reference("reference");
+	reference.setInterval(0.7);
+	reference.setMethod(LiveDataJoin::Linear);
+	reference.addSource(&all1);
+	reference.addSource(&all2);
+
+	QCOMPARE(join.rowCount(), reference.rowCount());
+	for (int col = 0; col < 3; ++col) {
+		for (int row = 0; row < join.rowCount(); ++row) {
+			const double value = join.column(col)->valueAt(row);
+			const double expected = reference.column(col)->valueAt(row);
+			QVERIFY((std::isnan(value) && std::isnan(expected)) || value == expected);
+		}
+	}
+}
+
+void LiveDataJoinTest::testKeepNValues() {
+	Spreadsheet s1("s1", false);
+	s1.setRowCount(0);
+	Spreadsheet s2("s2", false);
+	s2.setRowCount(0);
+
+	LiveDataJoin join("join");
+	join.setInterval(1);
+	join.setKeepNValues(3);
+	join.addSource(&s1);
+	join.addSource(&s2);
+
+	appendRows(s1, {0, 1, 2, 3}, {0, 1, 2, 3});
+	appendRows(s2, {0, 1, 2, 3}, {0, 10, 20, 30});
+	appendRows(s1, {4, 5}, {4, 5});
+	appendRows(s2, {4, 5}, {40, 50});
+
+	//only the last three rows are kept
+	QCOMPARE(join.rowCount(), 3);
+	QCOMPARE(join.column(0)->valueAt(0), 3.);
+	QCOMPARE(join.column(0)->valueAt(1), 4.);
+	QCOMPARE(join.column(0)->valueAt(2), 5.);
+	QCOMPARE(join.column(2)->valueAt(0), 30.);
+	QCOMPARE(join.column(2)->valueAt(2), 50.);
+}
+
+void LiveDataJoinTest::testRemoveSource() {
+	Spreadsheet s1("s1", false);
+	s1.setRowCount(0);
+	appendRows(s1, {0, 1, 2}, {0, 1, 2});
+	Spreadsheet s2("s2", false);
+	s2.setRowCount(0);
+	appendRows(s2, {0, 1}, {10, 20});
+
+	LiveDataJoin join("join");
+	join.setInterval(1);
+	join.addSource(&s1);
+	join.addSource(&s2);
+	QCOMPARE(join.columnCount(), 3);
+	QCOMPARE(join.rowCount(), 2);
+
+	join.removeSource(&s2);
+	QCOMPARE(join.sources().size(), 1);
+	QCOMPARE(join.columnCount(), 2);
+	QCOMPARE(join.rowCount(), 3);
+}
+
+QTEST_MAIN(LiveDataJoinTest)
@@ -0,0 +1,54 @@
+/***************************************************************************
+File                 : LiveDataJoinTest.h
+Project              : LabPlot
+Description          : Tests for the timestamp aligned join of live data sources
+--------------------------------------------------------------------
+Copyright            : (C) 2020 LabPlot developers
+
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef LIVEDATAJOINTEST_H
+#define LIVEDATAJOINTEST_H
+
+#include <QtTest>
+
+class LiveDataJoinTest : public QObject {
+	Q_OBJECT
+
+private slots:
+	void initTestCase();
+
+	//methods
+	void testLastValue();
+	void testLinear();
+	void testNearest();
+
+	//timestamps
+	void testReferenceKeys();
+	void testDateTimeKeys();
+
+	//live data
+	void testIncremental();
+	void testKeepNValues();
+	void testRemoveSource();
+};
+#endif
@@ -0,0 +1,173 @@
+/***************************************************************************
+File                 : LiveDataReaderTest.cpp
+Project              : LabPlot
+Description          : Tests for the reading of live data in a separate thread
+--------------------------------------------------------------------
+Copyright            : (C) 2020 LabPlot developers
+
+***************************************************************************/
+
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+#include "LiveDataReaderTest.h"
+#include "backend/datasources/LiveDataReader.h"
+#include "backend/datasources/filters/AsciiFilter.h"
+
+#include <QUdpSocket>
+
+#include <atomic>
+#include <functional>
+
+/*!
+ * determines the columns of the filter from the content \c text.
+ */
+static void prepareFilter(AsciiFilter& filter, const QByteArray& text) {
+	QTemporaryDir dir;
+	const QString fileName = dir.path() + QLatin1String("/columns.txt");
+	QFile file(fileName);
+	file.open(QIODevice::WriteOnly);
+	file.write(text);
+	file.close();
+
+	filter.setHeaderEnabled(false);
+	filter.preview(fileName, 10);
+}
+
+/*!
+ * takes the blocks parsed by \c reader and appends the values of the first column to \c values.
+ * Returns the number of values taken so far.
+ */
+static int takeValues(LiveDataReader& reader, QVector<double>& values) {
+	QVector<LiveDataBlock> blocks;
+	reader.takeBlocks(blocks);
+	for (const auto& block : blocks)
+		values << block.numericData.at(0);
+	return values.size();
+}
+
+/*!
+ * requests new data from \c reader until \c condition is fulfilled.
+ * The datagrams sent via the loopback interface are not necessarily available immediately.
+ */
+static bool readUntil(LiveDataReader& reader, const std::function<bool()>& condition) {
+	for (int i = 0; i < 100 && !condition(); ++i) {
+		reader.requestRead();
+		QTest::qWait(50);
+	}
+	return condition();
+}
+
+//##############################################################################
+//###########################  back-pressure  ##################################
+//##############################################################################
+/*!
+ * the reader stops reading from a file while the ring is full and continues once the blocks were taken, no rows are lost.
+ */
+void LiveDataReaderTest::testFileBlocking() {
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	const QString fileName = dir.path() + QLatin1String("/live.txt");
+
+	//more data than fits into the blocks of the ring
+	const int n = 300000;
+	QByteArray text;
+	for (int i = 0; i < n; ++i)
+		text += QByteArray::number(i) + ".5\n";
+	QFile file(fileName);
+	QVERIFY(file.open(QIODevice::WriteOnly));
+	file.write(text);
+	file.close();
+
+	LiveDataSource source("test", false);
+	source.setSourceType(LiveDataSource::FileOrPipe);
+	source.setFileType(AbstractFileFilter::Ascii);
+	source.setUpdateType(LiveDataSource::TimeInterval);
+	source.setFileName(fileName);
+	AsciiFilter filter;
+	prepareFilter(filter, "0.5\n1.5\n");
+
+	LiveDataReader reader(&source, &filter, 1);
+	reader.start(0, 1);
+	reader.requestRead();
+
+	//the reader waits for the consumer
+	QTRY_VERIFY(reader.stalls() > 0);
+
+	QVector<double> values;
+	QTRY_COMPARE_WITH_TIMEOUT(takeValues(reader, values), n, 10000);
+	QCOMPARE(reader.droppedRows(), (quint64)0);
+	for (int i = 0; i < n; ++i)
+		QCOMPARE(values.at(i), i + 0.5);
+}
+
+/*!
+ * UDP datagrams are not held back, the rows are dropped and counted while the ring is full.
+ */
+void LiveDataReaderTest::testUdpDrop() {
+	//free port on the loopback interface
+	QUdpSocket probe;
+	QVERIFY(probe.bind(QHostAddress::LocalHost, 0));
+	const quint16 port = probe.localPort();
+	probe.close();
+
+	LiveDataSource source("test", false);
+	source.setSourceType(LiveDataSource::NetworkUdpSocket);
+	source.setFileType(AbstractFileFilter::Ascii);
+	source.setUpdateType(LiveDataSource::TimeInterval);
+	source.setHost(QLatin1String("127.0.0.1"));
+	source.setPort(port);
+	AsciiFilter filter;
+	prepareFilter(filter, "0.5\n1.5\n");
+
+	LiveDataReader reader(&source, &filter, 1);
+	std::atomic<int> notifications{0};
+	connect(&reader, &LiveDataReader::dataAvailable, [&notifications]() {
+		++notifications;
+	});
+	reader.start(0, 1);
+
+	QUdpSocket sender;
+	auto send = [&sender, port](const QByteArray& datagram) {
+		sender.writeDatagram(datagram, QHostAddress::LocalHost, port);
+	};
+
+	//the first block fills the ring
+	send("1.5");
+	QVERIFY(readUntil(reader, [&notifications]() { return notifications > 0; }));
+
+	//nobody takes the blocks, the following rows are dropped
+	send("2.5");
+	QVERIFY(readUntil(reader, [&reader]() { return reader.droppedRows() == 1; }));
+	send("3.5\n4.5");
+	QVERIFY(readUntil(reader, [&reader]() { return reader.droppedRows() == 3; }));
+	QCOMPARE(reader.stalls(), (quint64)0);
+
+	QVector<double> values;
+	QCOMPARE(takeValues(reader, values), 1);
+	QCOMPARE(values.at(0), 1.5);
+
+	//there is space for new rows again
+	send("5.5");
+	QVERIFY(readUntil(reader, [&reader, &values]() { return takeValues(reader, values) == 2; }));
+	QCOMPARE(values.at(1), 5.5);
+	QCOMPARE(reader.droppedRows(), (quint64)3);
+}
+
+QTEST_MAIN(LiveDataReaderTest)
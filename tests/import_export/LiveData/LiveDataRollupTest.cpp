@@ -0,0 +1,223 @@
+/***************************************************************************
+File                 : LiveDataRollupTest.cpp
+Project              : LabPlot
+Description          : Tests for the aggregation of live data in time windows
+--------------------------------------------------------------------
+Copyright            : (C) 2020 LabPlot developers
+
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+
+#include "LiveDataRollupTest.h"
+#include "backend/datasources/LiveDataRollup.h"
+#include "backend/core/column/Column.h"
+#include "backend/worksheet/plots/cartesian/PlotUpdateScheduler.h"
+
+/*!
+ * appends the rows with the keys \c keys and the values \c values to the spreadsheet
+ * and notifies the consumers of the live data.
+ */
+static void appendRows(Spreadsheet& spreadsheet, const QVector<double>& keys, const QVector<double>& values) {
+	const int row = spreadsheet.rowCount();
+	spreadsheet.setRowCount(row + keys.size());
+	for (int i = 0; i < keys.size(); ++i) {
+		spreadsheet.column(0)->setValueAt(row + i, keys.at(i));
+		spreadsheet.column(1)->setValueAt(row + i, values.at(i));
+	}
+
+	PlotUpdateScheduler::instance()->setChanged(QVector<Column*>{spreadsheet.column(0), spreadsheet.column(1)});
+}
+
+void LiveDataRollupTest::initTestCase() {
+	// needed in order to have the signals triggered by SignallingUndoCommand, see LabPlot.cpp
+	//TODO: redesign/remove this
+	qRegisterMetaType<const AbstractAspect*>("const AbstractAspect*");
+	qRegisterMetaType<const AbstractColumn*>("const AbstractColumn*");
+}
+
+//##############################################################################
+//################################  aggregates  ################################
+//##############################################################################
+void LiveDataRollupTest::testAggregates() {
+	Spreadsheet s("s", false);
+	s.setRowCount(0);
+	appendRows(s, {0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11}, {1, 2, 3, 4, 5, 10, 20, 30, 40, 50, 7, 8});
+
+	LiveDataRollup rollup("rollup");
+	rollup.setWindow(5);
+	rollup.setSourceColumn(s.column(1));
+
+	//the window starting at 10 is not complete yet
+	QCOMPARE(rollup.columnCount(), 7);
+	QCOMPARE(rollup.rowCount(), 2);
+
+	QCOMPARE(rollup.column(0)->valueAt(0), 0.);
+	QCOMPARE(rollup.column(1)->integerAt(0), 5);
+	QCOMPARE(rollup.column(2)->valueAt(0), 3.);
+	QCOMPARE(rollup.column(3)->valueAt(0), 1.);
+	QCOMPARE(rollup.column(4)->valueAt(0), 5.);
+	QCOMPARE(rollup.column(5)->valueAt(0), 5.);
+	QCOMPARE(rollup.column(6)->valueAt(0), std::sqrt(2.5));
+
+	QCOMPARE(rollup.column(0)->valueAt(1), 5.);
+	QCOMPARE(rollup.column(1)->integerAt(1), 5);
+	QCOMPARE(rollup.column(2)->valueAt(1), 30.);
+	QCOMPARE(rollup.column(3)->valueAt(1), 10.);
+	QCOMPARE(rollup.column(4)->valueAt(1), 50.);
+	QCOMPARE(rollup.column(5)->valueAt(1), 50.);
+	QCOMPARE(rollup.column(6)->valueAt(1), std::sqrt(250.));
+}
+
+void LiveDataRollupTest::testSelectedAggregates() {
+	Spreadsheet s("s", false);
+	s.setRowCount(0);
+	appendRows(s, {0, 1, 2, 3}, {4, 2, 8, 6});
+
+	LiveDataRollup rollup("rollup");
+	rollup.setWindow(2);
+	rollup.setAggregates(LiveDataRollup::Minimum | LiveDataRollup::Maximum);
+	rollup.setSourceColumn(s.column(1));
+
+	QCOMPARE(rollup.columnCount(), 3);
+	QCOMPARE(rollup.rowCount(), 1);
+	QCOMPARE(rollup.column(1)->name(), QLatin1String("min"));
+	QCOMPARE(rollup.column(1)->valueAt(0), 2.);
+	QCOMPARE(rollup.column(2)->name(), QLatin1String("max"));
+	QCOMPARE(rollup.column(2)->valueAt(0), 4.);
+}
+
+void LiveDataRollupTest::testNaN() {
+	Spreadsheet s("s", false);
+	s.setRowCount(0);
+	appendRows(s, {0, 1, 2, 3, 4, 5, 6}, {NAN, 2, NAN, NAN, NAN, 1, 1});
+
+	LiveDataRollup rollup("rollup");
+	rollup.setWindow(2);
+	rollup.setSourceColumn(s.column(1));
+
+	//NAN values are not aggregated, windows with NAN values only have the count 0
+	QCOMPARE(rollup.rowCount(), 3);
+	QCOMPARE(rollup.column(1)->integerAt(0), 1);
+	QCOMPARE(rollup.column(2)->valueAt(0), 2.);
+	QVERIFY(std::isnan(rollup.column(6)->valueAt(0)));
+	QCOMPARE(rollup.column(1)->integerAt(1), 0);
+	QVERIFY(std::isnan(rollup.column(2)->valueAt(1)));
+	QCOMPARE(rollup.column(1)->integerAt(2), 1);
+	QCOMPARE(rollup.column(5)->valueAt(2), 1.);
+}
+
+void LiveDataRollupTest::testDateTimeKeys() {
+	const QDateTime start = QDateTime::fromMSecsSinceEpoch(1577836800000);	// 2020-01-01
+
+	Spreadsheet s("s", false);
+	s.setRowCount(10);
+	s.column(0)->setColumnMode(AbstractColumn::DateTime);
+	for (int i = 0; i < 10; ++i) {
+		s.column(0)->setDateTimeAt(i, start.addMSecs(i * 300));
+		s.column(1)->setValueAt(i, i);
+	}
+
+	LiveDataRollup rollup("rollup");
+	rollup.setWindow(1000);
+	rollup.setSourceColumn(s.column(1));
+
+	//windows of one second aligned to full seconds, the last one (2700 ms) is not complete yet
+	QCOMPARE(rollup.column(0)->columnMode(), AbstractColumn::DateTime);
+	QCOMPARE(rollup.rowCount(), 2);
+	QCOMPARE(rollup.column(0)->dateTimeAt(0), start);
+	QCOMPARE(rollup.column(0)->dateTimeAt(1), start.addMSecs(1000));
+	QCOMPARE(rollup.column(1)->integerAt(0), 4);	// 0, 300, 600, 900 ms
+	QCOMPARE(rollup.column(1)->integerAt(1), 3);	// 1200, 1500, 1800 ms
+	QCOMPARE(rollup.column(5)->valueAt(1), 6.);
+}
+
+//##############################################################################
+//#################################  live data  ################################
+//##############################################################################
+void LiveDataRollupTest::testIncremental() {
+	QVector<double> keys;
+	QVector<double> values;
+	for (int i = 0; i < 100; ++i) {
+		keys << i;
+		values << std::sin(0.1 * i);
+	}
+
+	//all rows at once
+	Spreadsheet s1("s1", false);
+	s1.setRowCount(0);
+	appendRows(s1, keys, values);
+	LiveDataRollup rollup1("rollup1");
+	rollup1.setWindow(7);
+	rollup1.setSourceColumn(s1.column(1));
+
+	//the same rows in chunks not aligned to the windows
+	Spreadsheet s2("s2", false);
+	s2.setRowCount(0);
+	LiveDataRollup rollup2("rollup2");
+	rollup2.setWindow(7);
+	rollup2.setSourceColumn(s2.column(1));
+	for (int i = 0; i < 100; i += 3)
+		appendRows(s2, keys.mid(i, 3), values.mid(i, 3));
+
+	QCOMPARE(rollup2.rowCount(), rollup1.rowCount());
+	QCOMPARE(rollup2.rowCount(), 14);
+	for (int c = 0; c < rollup1.columnCount(); ++c) {
+		for (int row = 0; row < rollup1.rowCount(); ++row)
+			QVERIFY(qFuzzyCompare(rollup2.column(c)->valueAt(row) + 1., rollup1.column(c)->valueAt(row) + 1.));
+	}
+}
+
+void LiveDataRollupTest::testKeepNValues() {
+	Spreadsheet s("s", false);
+	s.setRowCount(0);
+
+	LiveDataRollup rollup("rollup");
+	rollup.setWindow(1);
+	rollup.setKeepNValues(3);
+	rollup.setSourceColumn(s.column(1));
+
+	appendRows(s, {0, 1, 2}, {0, 10, 20});
+	appendRows(s, {3, 4, 5}, {30, 40, 50});
+
+	//windows 0..4 are complete, only the last three are kept
+	QCOMPARE(rollup.rowCount(), 3);
+	QCOMPARE(rollup.column(0)->valueAt(0), 2.);
+	QCOMPARE(rollup.column(0)->valueAt(2), 4.);
+	QCOMPARE(rollup.column(2)->valueAt(0), 20.);
+	QCOMPARE(rollup.column(2)->valueAt(2), 40.);
+}
+
+void LiveDataRollupTest::testRemoveColumn() {
+	Spreadsheet s("s", false);
+	s.setRowCount(0);
+	appendRows(s, {0, 1, 2}, {0, 10, 20});
+
+	LiveDataRollup rollup("rollup");
+	rollup.setWindow(1);
+	rollup.setSourceColumn(s.column(1));
+	QCOMPARE(rollup.rowCount(), 2);
+
+	s.removeColumns(1, 1);
+	QVERIFY(!rollup.sourceColumn());
+}
+
+QTEST_MAIN(LiveDataRollupTest)
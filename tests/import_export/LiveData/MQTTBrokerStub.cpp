@@ -0,0 +1,224 @@
+/***************************************************************************
+File                 : MQTTBrokerStub.cpp
+Project              : LabPlot
+Description          : Minimal in-process MQTT broker for the live data benchmark
+--------------------------------------------------------------------
+Copyright            : (C) 2020 LabPlot developers
+
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "MQTTBrokerStub.h"
+
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QtEndian>
+
+/*!
+ * \brief Minimal MQTT 3.1.1 broker accepting connections on the local host.
+ *
+ * Supports everything needed to replay data to MQTTClient without an external broker:
+ * CONNECT, SUBSCRIBE/UNSUBSCRIBE with the wildcards '+' and '#', PINGREQ, DISCONNECT
+ * and publishing with QoS 0. Messages published by the clients are forwarded to the subscribers.
+ */
+MQTTBrokerStub::MQTTBrokerStub(QObject* parent) : QObject(parent), m_server(new QTcpServer(this)) {
+	connect(m_server, &QTcpServer::newConnection, this, &MQTTBrokerStub::newConnection);
+}
+
+bool MQTTBrokerStub::listen() {
+	return m_server->listen(QHostAddress::LocalHost, 0);
+}
+
+quint16 MQTTBrokerStub::port() const {
+	return m_server->serverPort();
+}
+
+/*!
+ * returns \c true if at least one client subscribed to the topic \c topic.
+ */
+bool MQTTBrokerStub::hasSubscribers(const QString& topic) const {
+	for (const auto& filters : m_subscriptions) {
+		for (const auto& filter : filters) {
+			if (matches(filter, topic))
+				return true;
+		}
+	}
+	return false;
+}
+
+/*!
+ * sends the message \c message with QoS 0 to all clients subscribed to the topic \c topic.
+ */
+void MQTTBrokerStub::publish(const QString& topic, const QByteArray& message) {
+	const QByteArray topicName = topic.toUtf8();
+	QByteArray data(2, 0);
+	qToBigEndian<quint16>(topicName.size(), reinterpret_cast<uchar*>(data.data()));
+	data += topicName;
+	data += message;
+	const QByteArray publishPacket = packet(0x30, data);
+
+	for (auto it = m_subscriptions.constBegin(); it != m_subscriptions.constEnd(); ++it) {
+		for (const auto& filter : it.value()) {
+			if (matches(filter, topic)) {
+				it.key()->write(publishPacket);
+				break;
+			}
+		}
+	}
+}
+
+void MQTTBrokerStub::newConnection() {
+	while (QTcpSocket* socket = m_server->nextPendingConnection()) {
+		socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+		m_buffers[socket] = QByteArray();
+		connect(socket, &QTcpSocket::readyRead, this, &MQTTBrokerStub::readyRead);
+		connect(socket, &QTcpSocket::disconnected, this, &MQTTBrokerStub::disconnected);
+	}
+}
+
+void MQTTBrokerStub::disconnected() {
+	auto* socket = static_cast<QTcpSocket*>(sender());
+	m_buffers.remove(socket);
+	m_subscriptions.remove(socket);
+	socket->deleteLater();
+}
+
+/*!
+ * splits the received data into packets: fixed header, remaining length (1-4 bytes) and the packet data.
+ */
+void MQTTBrokerStub::readyRead() {
+	auto* socket = static_cast<QTcpSocket*>(sender());
+	QByteArray& buffer = m_buffers[socket];
+	buffer += socket->readAll();
+
+	int pos = 0;
+	while (buffer.size() - pos >= 2) {
+		int length = 0;
+		int multiplier = 1;
+		int i = pos + 1;
+		bool complete = false;
+		for (; i < buffer.size() && i < pos + 5; ++i) {
+			const auto byte = static_cast<quint8>(buffer.at(i));
+			length += (byte & 0x7f) * multiplier;
+			multiplier *= 128;
+			if (!(byte & 0x80)) {
+				complete = true;
+				break;
+			}
+		}
+		if (!complete || buffer.size() - (i + 1) < length)
+			break;
+
+		const auto header = static_cast<quint8>(buffer.at(pos));
+		handlePacket(socket, header, buffer.mid(i + 1, length));
+		pos = i + 1 + length;
+	}
+	buffer.remove(0, pos);
+}
+
+void MQTTBrokerStub::handlePacket(QTcpSocket* socket, quint8 header, const QByteArray& data) {
+	const auto* bytes = reinterpret_cast<const uchar*>(data.constData());
+	switch (header >> 4) {
+	case 1:	// CONNECT -> CONNACK, session not present, accepted
+		socket->write(packet(0x20, QByteArray(2, 0)));
+		break;
+	case 3: {	// PUBLISH -> forward to the subscribers
+		if (data.size() < 2)
+			break;
+		const int topicLength = qFromBigEndian<quint16>(bytes);
+		const QString topic = QString::fromUtf8(data.constData() + 2, topicLength);
+		int pos = 2 + topicLength;
+		const int qos = (header >> 1) & 0x03;
+		if (qos > 0) {
+			// PUBACK for QoS 1, QoS 2 is not supported
+			socket->write(packet(0x40, data.mid(pos, 2)));
+			pos += 2;
+		}
+		publish(topic, data.mid(pos));
+		break;
+	}
+	case 8: {	// SUBSCRIBE -> SUBACK granting QoS 0 for all filters
+		QByteArray ack = data.left(2);
+		int pos = 2;
+		while (pos + 2 <= data.size()) {
+			const int length = qFromBigEndian<quint16>(bytes + pos);
+			m_subscriptions[socket] << QString::fromUtf8(data.constData() + pos + 2, length);
+			pos += 2 + length + 1;
+			ack += '\0';
+		}
+		socket->write(packet(0x90, ack));
+		break;
+	}
+	case 10: {	// UNSUBSCRIBE -> UNSUBACK
+		int pos = 2;
+		while (pos + 2 <= data.size()) {
+			const int length = qFromBigEndian<quint16>(bytes + pos);
+			m_subscriptions[socket].removeAll(QString::fromUtf8(data.constData() + pos + 2, length));
+			pos += 2 + length;
+		}
+		socket->write(packet(0xB0, data.left(2)));
+		break;
+	}
+	case 12:	// PINGREQ -> PINGRESP
+		socket->write(packet(0xD0, QByteArray()));
+		break;
+	case 14:	// DISCONNECT
+		socket->disconnectFromHost();
+		break;
+	default:
+		break;
+	}
+}
+
+/*!
+ * returns the packet with the fixed header \c header and the data \c data.
+ */
+QByteArray MQTTBrokerStub::packet(quint8 header, const QByteArray& data) {
+	QByteArray result;
+	result += static_cast<char>(header);
+	int length = data.size();
+	do {
+		quint8 byte = length % 128;
+		length /= 128;
+		if (length > 0)
+			byte |= 0x80;
+		result += static_cast<char>(byte);
+	} while (length > 0);
+	result += data;
+	return result;
+}
+
+/*!
+ * returns \c true if the topic \c topic matches the topic filter \c filter.
+ */
+bool MQTTBrokerStub::matches(const QString& filter, const QString& topic) {
+	const QStringList filterLevels = filter.split(QLatin1Char('/'));
+	const QStringList topicLevels = topic.split(QLatin1Char('/'));
+	for (int i = 0; i < filterLevels.size(); ++i) {
+		if (filterLevels.at(i) == QLatin1String("#"))
+			return true;
+		if (i >= topicLevels.size())
+			return false;
+		if (filterLevels.at(i) != QLatin1String("+") && filterLevels.at(i) != topicLevels.at(i))
+			return false;
+	}
+	return filterLevels.size() == topicLevels.size();
+}
@@ -0,0 +1,65 @@
+/***************************************************************************
+File                 : MQTTBrokerStub.h
+Project              : LabPlot
+Description          : Minimal in-process MQTT broker for the live data benchmark
+--------------------------------------------------------------------
+Copyright            : (C) 2020 LabPlot developers
+
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef MQTTBROKERSTUB_H
+#define MQTTBROKERSTUB_H
+
+#include <QHash>
+#include <QObject>
+#include <QStringList>
+
+class QTcpServer;
+class QTcpSocket;
+
+class MQTTBrokerStub : public QObject {
+	Q_OBJECT
+
+public:
+	explicit MQTTBrokerStub(QObject* parent = nullptr);
+
+	bool listen();
+	quint16 port() const;
+	bool hasSubscribers(const QString& topic) const;
+	void publish(const QString& topic, const QByteArray& message);
+
+private slots:
+	void newConnection();
+	void readyRead();
+	void disconnected();
+
+private:
+	void handlePacket(QTcpSocket*, quint8 header, const QByteArray& data);
+	static QByteArray packet(quint8 header, const QByteArray& data);
+	static bool matches(const QString& filter, const QString& topic);
+
+	QTcpServer* m_server;
+	QHash<QTcpSocket*, QByteArray> m_buffers;	// data of incomplete packets
+	QHash<QTcpSocket*, QStringList> m_subscriptions;	// topic filters of the clients
+};
+
+#endif
@@ -0,0 +1,317 @@
+/***************************************************************************
+File                 : ReplaySender.cpp
+Project              : LabPlot
+Description          : Replays data at a given rate to the live data sources
+--------------------------------------------------------------------
+Copyright            : (C) 2020 LabPlot developers
+
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#include "ReplaySender.h"
+#include "MQTTBrokerStub.h"
+
+#include <QCoreApplication>
+#include <QDir>
+#include <QFile>
+#include <QLocalServer>
+#include <QLocalSocket>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QTimer>
+#include <QUdpSocket>
+#include <QtEndian>
+
+#include <cstring>
+
+#ifdef Q_OS_LINUX
+#include <sys/resource.h>
+#endif
+
+/*!
+ * \brief Replays the values \c values cyclically with \c rate rows per second for \c duration ms.
+ *
+ * The sender lives in its own thread and acts as the counterpart of the live data source:
+ * it appends the rows to a file, serves them via TCP or local socket servers, sends them
+ * as UDP datagrams or publishes them via an in-process MQTT broker. The send time of every row
+ * is recorded with the clock \c clock shared with the receiver to determine the end-to-end latency.
+ */
+ReplaySender::ReplaySender(Mode mode, const QVector<double>& values, int rate, int duration, const QElapsedTimer& clock)
+	: m_mode(mode), m_values(values), m_rate(rate), m_duration(duration), m_clock(clock) {
+	m_sendTimes.resize(rows());
+}
+
+QString ReplaySender::fileName() const {
+	return m_fileName;
+}
+
+QString ReplaySender::localSocketName() const {
+	return m_localSocketName;
+}
+
+quint16 ReplaySender::port() const {
+	return m_port;
+}
+
+QString ReplaySender::mqttTopic() {
+	return QLatin1String("labplot/replay");
+}
+
+/*!
+ * returns the total number of rows to be sent.
+ */
+int ReplaySender::rows() const {
+	return (int)((qint64)m_rate * m_duration / 1000);
+}
+
+/*!
+ * returns the number of rows sent so far, can be called from any thread.
+ */
+int ReplaySender::sentRows() const {
+	return m_sentRows.load(std::memory_order_acquire);
+}
+
+/*!
+ * returns the send time of the row \c row in ns, \c row has to be smaller than sentRows().
+ */
+qint64 ReplaySender::sendTime(int row) const {
+	return m_sendTimes[row];
+}
+
+/*!
+ * returns the CPU time in µs used by the sender thread, available once all rows were sent.
+ */
+qint64 ReplaySender::cpuTime() const {
+	return m_cpuTime;
+}
+
+bool ReplaySender::isFinished() const {
+	return m_finished;
+}
+
+/*!
+ * returns the CPU time in µs used by the calling thread so far, -1 if not available.
+ */
+qint64 ReplaySender::threadCpuTime() {
+#ifdef Q_OS_LINUX
+	struct rusage usage;
+	if (getrusage(RUSAGE_THREAD, &usage) == 0)
+		return (qint64)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#endif
+	return -1;
+}
+
+/*!
+ * returns the CPU time in µs used by all threads of the process so far, -1 if not available.
+ */
+qint64 ReplaySender::processCpuTime() {
+#ifdef Q_OS_LINUX
+	struct rusage usage;
+	if (getrusage(RUSAGE_SELF, &usage) == 0)
+		return (qint64)(usage.ru_utime.tv_sec + usage.ru_stime.tv_sec) * 1000000 + usage.ru_utime.tv_usec + usage.ru_stime.tv_usec;
+#endif
+	return -1;
+}
+
+/*!
+ * creates the file or the servers the live data source connects to. Called in the sender thread.
+ */
+void ReplaySender::prepare() {
+	const qint64 pid = QCoreApplication::applicationPid();
+	switch (m_mode) {
+	case File:
+		m_fileName = QDir::temp().filePath(QString("labplot_replay_%1.txt").arg(pid));
+		m_file = new QFile(m_fileName, this);
+		m_file->open(QIODevice::WriteOnly | QIODevice::Truncate);
+		break;
+	case TcpSocket:
+	case TcpSocketBinary:
+		m_tcpServer = new QTcpServer(this);
+		m_tcpServer->listen(QHostAddress::LocalHost, 0);
+		m_port = m_tcpServer->serverPort();
+		connect(m_tcpServer, &QTcpServer::newConnection, this, &ReplaySender::newConnection);
+		break;
+	case UdpSocket: {
+		//determine a free port, the live data source binds to it
+		QUdpSocket socket;
+		socket.bind(QHostAddress::LocalHost, 0);
+		m_port = socket.localPort();
+		m_udpSocket = new QUdpSocket(this);
+		break;
+	}
+	case LocalSocket:
+		m_localSocketName = QString("labplot_replay_%1").arg(pid);
+		QLocalServer::removeServer(m_localSocketName);
+		m_localServer = new QLocalServer(this);
+		m_localServer->listen(m_localSocketName);
+		connect(m_localServer, &QLocalServer::newConnection, this, &ReplaySender::newConnection);
+		break;
+	case MQTT:
+		m_broker = new MQTTBrokerStub(this);
+		m_broker->listen();
+		m_port = m_broker->port();
+		break;
+	}
+
+	m_timer = new QTimer(this);
+	m_timer->setTimerType(Qt::PreciseTimer);
+	connect(m_timer, &QTimer::timeout, this, &ReplaySender::send);
+}
+
+/*!
+ * starts sending, the rows are sent in batches every millisecond.
+ */
+void ReplaySender::start() {
+	m_timer->start(1);
+}
+
+/*!
+ * closes the connections and removes the file. Called in the sender thread.
+ */
+void ReplaySender::stop() {
+	m_timer->stop();
+	delete m_file;
+	m_file = nullptr;
+	if (!m_fileName.isEmpty())
+		QFile::remove(m_fileName);
+	delete m_tcpServer;
+	m_tcpServer = nullptr;
+	delete m_localServer;
+	m_localServer = nullptr;
+	delete m_udpSocket;
+	m_udpSocket = nullptr;
+	delete m_broker;
+	m_broker = nullptr;
+	m_connection = nullptr;
+}
+
+/*!
+ * sends all rows due since the start.
+ */
+void ReplaySender::send() {
+	//the replay starts once the MQTT client subscribed to the topic
+	if (m_mode == MQTT && !m_broker->hasSubscribers(mqttTopic()))
+		return;
+
+	const qint64 now = m_clock.nsecsElapsed();
+	if (m_start == -1)
+		m_start = now;
+
+	const int total = rows();
+	const int sent = m_sentRows.load(std::memory_order_relaxed);
+	const int due = (int)qMin((qint64)total, (now - m_start) * m_rate / 1000000000);
+	if (due > sent) {
+		//record the send times before the rows become visible to the receiver
+		for (int row = sent; row < due; ++row)
+			m_sendTimes[row] = now;
+		m_sentRows.store(due, std::memory_order_release);
+
+		QByteArray data;
+		for (int row = sent; row < due; ++row) {
+			const double value = m_values.at(row % m_values.size());
+			switch (m_mode) {
+			case TcpSocketBinary: {
+				uchar bytes[8];
+				quint64 bits;
+				memcpy(&bits, &value, sizeof(bits));
+				qToLittleEndian<quint64>(bits, bytes);
+				data.append(reinterpret_cast<const char*>(bytes), 8);
+				break;
+			}
+			case MQTT:
+				m_broker->publish(mqttTopic(), QByteArray::number(value, 'g', 16));
+				break;
+			case File:
+			case TcpSocket:
+			case UdpSocket:
+			case LocalSocket:
+				data += QByteArray::number(value, 'g', 16) + '\n';
+				//one datagram contains complete lines only
+				if (m_mode == UdpSocket && data.size() > 1400) {
+					m_udpSocket->writeDatagram(data, QHostAddress::LocalHost, m_port);
+					data.clear();
+				}
+				break;
+			}
+		}
+
+		switch (m_mode) {
+		case File:
+			m_file->write(data);
+			m_file->flush();
+			break;
+		case TcpSocketBinary: {
+			//one frame with the length prefix for all rows
+			uchar prefix[4];
+			qToLittleEndian<quint32>(data.size(), prefix);
+			write(QByteArray(reinterpret_cast<const char*>(prefix), 4) + data);
+			break;
+		}
+		case TcpSocket:
+		case LocalSocket:
+			write(data);
+			break;
+		case UdpSocket:
+			if (!data.isEmpty())
+				m_udpSocket->writeDatagram(data, QHostAddress::LocalHost, m_port);
+			break;
+		case MQTT:
+			break;
+		}
+	}
+
+	if (due == total) {
+		m_timer->stop();
+		m_cpuTime = threadCpuTime();
+		m_finished = true;
+	}
+}
+
+/*!
+ * writes \c data to the current connection or keeps it until the receiver connects.
+ */
+void ReplaySender::write(const QByteArray& data) {
+	if (m_connection && m_connection->isOpen())
+		m_connection->write(data);
+	else
+		m_pending += data;
+}
+
+/*!
+ * called when the live data source (re)connects, the data not sent yet is sent to the new connection.
+ */
+void ReplaySender::newConnection() {
+	if (m_tcpServer) {
+		auto* socket = m_tcpServer->nextPendingConnection();
+		socket->setSocketOption(QAbstractSocket::LowDelayOption, 1);
+		connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+		m_connection = socket;
+	} else {
+		auto* socket = m_localServer->nextPendingConnection();
+		connect(socket, &QLocalSocket::disconnected, socket, &QObject::deleteLater);
+		m_connection = socket;
+	}
+
+	if (!m_pending.isEmpty()) {
+		m_connection->write(m_pending);
+		m_pending.clear();
+	}
+}
@@ -0,0 +1,107 @@
+/***************************************************************************
+File                 : ReplaySender.h
+Project              : LabPlot
+Description          : Replays data at a given rate to the live data sources
+--------------------------------------------------------------------
+Copyright            : (C) 2020 LabPlot developers
+
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+ ***************************************************************************/
+
+#ifndef REPLAYSENDER_H
+#define REPLAYSENDER_H
+
+#include <QElapsedTimer>
+#include <QObject>
+#include <QPointer>
+#include <QVector>
+
+#include <atomic>
+#include <vector>
+
+class QFile;
+class QIODevice;
+class QLocalServer;
+class QTcpServer;
+class QTimer;
+class QUdpSocket;
+class MQTTBrokerStub;
+
+class ReplaySender : public QObject {
+	Q_OBJECT
+
+public:
+	enum Mode {File, TcpSocket, TcpSocketBinary, UdpSocket, LocalSocket, MQTT};
+
+	ReplaySender(Mode, const QVector<double>& values, int rate, int duration, const QElapsedTimer& clock);
+
+	QString fileName() const;
+	QString localSocketName() const;
+	quint16 port() const;
+	static QString mqttTopic();
+
+	int rows() const;
+	int sentRows() const;
+	qint64 sendTime(int row) const;
+	qint64 cpuTime() const;
+	bool isFinished() const;
+
+	static qint64 threadCpuTime();
+	static qint64 processCpuTime();
+
+public slots:
+	void prepare();
+	void start();
+	void stop();
+
+private slots:
+	void send();
+	void newConnection();
+
+private:
+	void write(const QByteArray&);
+
+	const Mode m_mode;
+	const QVector<double> m_values;
+	const int m_rate;	// rows per second
+	const int m_duration;	// ms
+	const QElapsedTimer& m_clock;	// common clock of sender and receiver
+
+	QTimer* m_timer{nullptr};
+	QFile* m_file{nullptr};
+	QTcpServer* m_tcpServer{nullptr};
+	QLocalServer* m_localServer{nullptr};
+	QUdpSocket* m_udpSocket{nullptr};
+	MQTTBrokerStub* m_broker{nullptr};
+	QPointer<QIODevice> m_connection;	// current connection of the receiver
+	QByteArray m_pending;			// data not sent yet since the receiver is not connected
+	QString m_fileName;
+	QString m_localSocketName;
+	quint16 m_port{0};
+	qint64 m_start{-1};
+
+	std::vector<qint64> m_sendTimes;	// send time of every row in ns of m_clock
+	std::atomic<int> m_sentRows{0};
+	std::atomic<qint64> m_cpuTime{0};
+	std::atomic<bool> m_finished{false};
+};
+
+#endif
@@ -0,0 +1,132 @@
+/***************************************************************************
+File                 : SPSCRingBufferTest.cpp
+Project              : LabPlot
+Description          : Tests for the single producer/single consumer ring buffer
+--------------------------------------------------------------------
+Copyright            : (C) 2020 LabPlot developers
+
+***************************************************************************/
+
+***************************************************************************/
+
+/***************************************************************************
+ *                                                                         *
+ *  This program is free software; you can redistribute it and/or modify   *
+ *  it under the terms of the GNU General Public License as published by   *
+ *  the Free Software Foundation; either version 2 of the License, or      *
+ *  (at your option) any later version.                                    *
+ *                                                                         *
+ *  This program is distributed in the hope that it will be useful,        *
+ *  but WITHOUT ANY WARRANTY; without even the implied warranty of         *
+ *  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the          *
+ *  GNU General Public License for more details.                           *
+ *                                                                         *
+ *   You should have received a copy of the GNU General Public License     *
+ *   along with this program; if not, write to the Free Software           *
+ *   Foundation, Inc., 51 Franklin Street, Fifth Floor,                    *
+ *   Boston, MA  02110-1301  USA                                           *
+ *                                                                         *
+#include "SPSCRingBufferTest.h"
+#include "backend/lib/SPSCRingBuffer.h"
+
+#include <QtConcurrentRun>
+
+#include <thread>
+
+void SPSCRingBufferTest::testEmptyFull() {
+	SPSCRingBuffer<QString> ring(3);
+	QCOMPARE(ring.capacity(), (size_t)3);
+	QCOMPARE(ring.isEmpty(), true);
+	QCOMPARE(ring.isFull(), false);
+
+	QString value;
+	QCOMPARE(ring.pop(value), false);
+
+	QString a("a"), b("b"), c("c"), d("d");
+	QCOMPARE(ring.push(std::move(a)), true);
+	QCOMPARE(ring.isEmpty(), false);
+	QCOMPARE(ring.push(std::move(b)), true);
+	QCOMPARE(ring.push(std::move(c)), true);
+	QCOMPARE(ring.isFull(), true);
+
+	//the value is not moved into the full buffer
+	QCOMPARE(ring.push(std::move(d)), false);
+	QCOMPARE(d, QLatin1String("d"));
+
+	QCOMPARE(ring.pop(value), true);
+	QCOMPARE(value, QLatin1String("a"));
+	QCOMPARE(ring.isFull(), false);
+	QCOMPARE(ring.push(std::move(d)), true);
+
+	QCOMPARE(ring.pop(value), true);
+	QCOMPARE(value, QLatin1String("b"));
+	QCOMPARE(ring.pop(value), true);
+	QCOMPARE(value, QLatin1String("c"));
+	QCOMPARE(ring.pop(value), true);
+	QCOMPARE(value, QLatin1String("d"));
+	QCOMPARE(ring.isEmpty(), true);
+	QCOMPARE(ring.pop(value), false);
+}
+
+void SPSCRingBufferTest::testWraparound() {
+	SPSCRingBuffer<int> ring(4);
+
+	//head and tail pass the end of the storage several times, the order is kept
+	int next = 0;
+	int expected = 0;
+	for (int round = 0; round < 10; ++round) {
+		for (int i = 0; i < 3; ++i)
+			QCOMPARE(ring.push(int(next++)), true);
+		for (int i = 0; i < 3; ++i) {
+			int value;
+			QCOMPARE(ring.pop(value), true);
+			QCOMPARE(value, expected++);
+		}
+		QCOMPARE(ring.isEmpty(), true);
+	}
+
+	//completely filled after the wraparound
+	for (int i = 0; i < 4; ++i)
+		QCOMPARE(ring.push(int(next++)), true);
+	QCOMPARE(ring.isFull(), true);
+	for (int i = 0; i < 4; ++i) {
+		int value;
+		QCOMPARE(ring.pop(value), true);
+		QCOMPARE(value, expected++);
+	}
+	QCOMPARE(ring.isEmpty(), true);
+}
+
+void SPSCRingBufferTest::testTwoThreads() {
+	const int n = 1000000;
+	SPSCRingBuffer<QVector<int>> ring(16);
+
+	//the producer waits while the buffer is full, the consumer while it's empty
+	QFuture<void> producer = QtConcurrent::run([&ring]() {
+		for (int i = 0; i < n; ++i) {
+			QVector<int> value{i, -i};
+			while (!ring.push(std::move(value)))
+				std::this_thread::yield();
+		}
+	});
+
+	int received = 0;
+	bool ordered = true;
+	QVector<int> value;
+	while (received < n) {
+		if (!ring.pop(value)) {
+			std::this_thread::yield();
+			continue;
+		}
+		if (value.size() != 2 || value.at(0) != received || value.at(1) != -received)
+			ordered = false;
+		++received;
+	}
+	producer.waitForFinished();
+
+	QCOMPARE(received, n);
+	QVERIFY(ordered);
+	QCOMPARE(ring.isEmpty(), true);
+}
+
+QTEST_MAIN(SPSCRingBufferTest)
@@ -49,6 +49,55 @@ void ProjectImportTest::initTestCase() {
 //##############################################################################
 //#####################  import of LabPlot projects ############################
 //##############################################################################
+/*!
+ * save a project with numeric, integer and text columns into an archive (.lmlz)
+ * and check that the data is the same after loading the archive again.
+ */
+void ProjectImportTest::testArchiveRoundTrip() {
+	QTemporaryDir dir;
+	QVERIFY(dir.isValid());
+	const QString fileName = dir.path() + QLatin1String("/test.lmlz");
+
+	Project project;
+	auto* spreadsheet = new Spreadsheet(QLatin1String("spreadsheet"));
+	project.addChild(spreadsheet);
+	spreadsheet->setColumnCount(3);
+	spreadsheet->setRowCount(1000);
+
+	Column* numeric = spreadsheet->column(0);
+	Column* integer = spreadsheet->column(1);
+	integer->setColumnMode(AbstractColumn::Integer);
+	Column* text = spreadsheet->column(2);
+	text->setColumnMode(AbstractColumn::Text);
+	for (int i = 0; i < 1000; ++i) {
+		numeric->setValueAt(i, std::sin(0.1 * i));
+		integer->setIntegerAt(i, i % 7);	//compressible
+		text->setTextAt(i, QString::number(i));
+	}
+
+	QVERIFY(project.saveArchive(QPixmap(), fileName));
+	QCOMPARE(Project::isLabPlotProject(fileName), true);
+
+	Project project2;
+	QVERIFY(project2.load(fileName));
+
+	auto* spreadsheet2 = project2.child<Spreadsheet>(0);
+	QVERIFY(spreadsheet2 != nullptr);
+	QCOMPARE(spreadsheet2->columnCount(), 3);
+	QCOMPARE(spreadsheet2->rowCount(), 1000);
+
+	Column* numeric2 = spreadsheet2->column(0);
+	Column* integer2 = spreadsheet2->column(1);
+	Column* text2 = spreadsheet2->column(2);
+	QCOMPARE(numeric2->columnMode(), AbstractColumn::Numeric);
+	QCOMPARE(integer2->columnMode(), AbstractColumn::Integer);
+	QCOMPARE(text2->columnMode(), AbstractColumn::Text);
+	for (int i = 0; i < 1000; ++i) {
+		QCOMPARE(numeric2->valueAt(i), numeric->valueAt(i));
+		QCOMPARE(integer2->integerAt(i), i % 7);
+		QCOMPARE(text2->textAt(i), QString::number(i));
+	}
+}
 
 
 #ifdef HAVE_LIBORIGIN
@@ -36,6 +36,7 @@ private slots:
 	void initTestCase();
 
 	//import of LabPlot projects
+	void testArchiveRoundTrip();
 
 #ifdef HAVE_LIBORIGIN
 	//import of Origin projects
@@ -30,8 +30,15 @@
 
 extern "C" {
 #include "backend/nsl/nsl_dft.h"
+#ifdef HAVE_FFTW3
+#include "backend/nsl/nsl_fftw.h"
+#endif
 }
 
+#include <QElapsedTimer>
+#include <QFile>
+#include <QTemporaryDir>
+
 #define ONESIDED 0
 #define TWOSIDED 1
 const int N = 10;
@@ -244,6 +251,147 @@ void NSLDFTTest::testTwosided_normdB() {
 		QCOMPARE(data[i], result[i]);
 }
 
+//##############################################################################
+//#################  FFTW plan cache
+//##############################################################################
+
+#ifdef HAVE_FFTW3
+// the cached plan, only valid as long as the cache holds it
+static fftw_plan planOf(size_t n, nsl_fftw_kind kind, double* in, double* out) {
+	nsl_fftw_plan_ref* ref = nsl_fftw_plan(n, kind, in, out);
+	const fftw_plan plan = nsl_fftw_get(ref);
+	nsl_fftw_release(ref);
+	return plan;
+}
+#endif
+
+// plans are reused for the same size, kind, placement and alignment
+void NSLDFTTest::testPlanCache() {
+#ifdef HAVE_FFTW3
+	double* in = fftw_alloc_real(2*N);
+	double* out = fftw_alloc_real(2*N);
+	double* in2 = fftw_alloc_real(2*N);
+	double* out2 = fftw_alloc_real(2*N);
+
+	nsl_fftw_plan_ref* ref = nsl_fftw_plan(N, nsl_fftw_r2c, in, out);
+	QVERIFY(ref != nullptr);
+	const fftw_plan plan = nsl_fftw_get(ref);
+	QCOMPARE(planOf(N, nsl_fftw_r2c, in2, out2), plan);
+	QVERIFY(planOf(N, nsl_fftw_c2r, in, out) != plan);
+	QVERIFY(planOf(N, nsl_fftw_r2c, in, in) != plan);
+	QVERIFY(planOf(N + 2, nsl_fftw_r2c, in, out) != plan);
+	QVERIFY(planOf(N, nsl_fftw_r2c, in + 1, out) != plan);	// different alignment
+	nsl_fftw_release(ref);
+
+	fftw_free(in);
+	fftw_free(out);
+	fftw_free(in2);
+	fftw_free(out2);
+
+	// repeated transforms with the cached plan
+	for (int k = 0; k < 3; k++) {
+		double data[] = {1, 1, 3, 3, 1, -1, 0, 1, 1, 0};
+		double result[] = {10, 2, -5.85410196624968, 2, 0.854101966249685};
+
+		nsl_dft_transform(data, 1, N, ONESIDED, nsl_dft_result_real);
+		for (unsigned int i = 0; i < N/2; i++)
+			FuzzyCompare(data[i], result[i], 1.e-14);
+	}
+	nsl_fftw_cleanup();
+#else
+	QSKIP("FFTW not available");
+#endif
+}
+
+// the measured plans replace the cached plans in the background and are stored as wisdom
+void NSLDFTTest::testPlanCacheMeasure() {
+#ifdef HAVE_FFTW3
+	QTemporaryDir dir;
+	const QString wisdomFile = dir.path() + QLatin1String("/wisdom");
+	nsl_fftw_set_wisdom_file(QFile::encodeName(wisdomFile).constData());
+	nsl_fftw_set_measure(1);
+
+	const int n = 1024;
+	double* data = fftw_alloc_real(2*(n/2 + 1));
+	nsl_fftw_plan_ref* ref = nsl_fftw_plan(n, nsl_fftw_r2c, data, data);
+	const fftw_plan estimated = nsl_fftw_get(ref);
+
+	// sizes requested only once are not measured
+	QTest::qWait(200);
+	QCOMPARE(planOf(n, nsl_fftw_r2c, data, data), estimated);
+
+	// the second request queued the measurement
+	QElapsedTimer timer;
+	timer.start();
+	while (planOf(n, nsl_fftw_r2c, data, data) == estimated && timer.elapsed() < 10000)
+		QTest::qWait(10);
+	QVERIFY(planOf(n, nsl_fftw_r2c, data, data) != estimated);
+
+	// the replaced plan is still valid while it is referenced
+	for (int i = 0; i < n; i++)
+		data[i] = i % 2;
+	fftw_execute_dft_r2c(estimated, data, (fftw_complex*)data);
+	FuzzyCompare(data[0], n/2., 1.e-15);
+	nsl_fftw_release(ref);
+
+	// the result of the measured plan
+	for (int i = 0; i < n; i++)
+		data[i] = i % 2;
+	QCOMPARE(nsl_fftw_execute(n, nsl_fftw_r2c, data, data), 0);
+	FuzzyCompare(data[0], n/2., 1.e-15);
+	FuzzyCompare(data[n], -n/2., 1.e-15);	// Nyquist frequency
+	fftw_free(data);
+
+	// the wisdom is only exported in the cleanup
+	QVERIFY(!QFile::exists(wisdomFile));
+	nsl_fftw_set_measure(0);
+	nsl_fftw_cleanup();
+	QVERIFY(QFile::exists(wisdomFile));
+	nsl_fftw_set_wisdom_file(nullptr);
+#else
+	QSKIP("FFTW not available");
+#endif
+}
+
+// the least recently used plans are evicted from the cache
+void NSLDFTTest::testPlanCacheEviction() {
+#ifdef HAVE_FFTW3
+	nsl_fftw_set_cache_size(2);
+	double* data = fftw_alloc_real(2*(N/2 + 8));
+
+	const fftw_plan plan = planOf(N, nsl_fftw_r2c, data, data);
+	nsl_fftw_plan_ref* ref2 = nsl_fftw_plan(N + 2, nsl_fftw_r2c, data, data);
+	const fftw_plan plan2 = nsl_fftw_get(ref2);
+	QCOMPARE(planOf(N, nsl_fftw_r2c, data, data), plan);	// most recently used
+	planOf(N + 4, nsl_fftw_r2c, data, data);	// evicts the plan of N + 2
+	QCOMPARE(planOf(N, nsl_fftw_r2c, data, data), plan);
+	QVERIFY(planOf(N + 2, nsl_fftw_r2c, data, data) != plan2);
+
+	// the evicted plan is still valid while it is referenced
+	for (int i = 0; i < N + 2; i++)
+		data[i] = 1.;
+	fftw_execute_dft_r2c(plan2, data, (fftw_complex*)data);
+	FuzzyCompare(data[0], N + 2., 1.e-15);
+	nsl_fftw_release(ref2);
+
+	// transforms with the new plans
+	for (int k = 0; k < 3; k++) {
+		double values[] = {1, 1, 3, 3, 1, -1, 0, 1, 1, 0};
+		double result[] = {10, 2, -5.85410196624968, 2, 0.854101966249685};
+
+		nsl_dft_transform(values, 1, N, ONESIDED, nsl_dft_result_real);
+		for (unsigned int i = 0; i < N/2; i++)
+			FuzzyCompare(values[i], result[i], 1.e-14);
+	}
+
+	fftw_free(data);
+	nsl_fftw_set_cache_size(64);
+	nsl_fftw_cleanup();
+#else
+	QSKIP("FFTW not available");
+#endif
+}
+
 //##############################################################################
 //#################  performance
 //##############################################################################
@@ -56,6 +56,10 @@ private slots:
 	void testTwosided_squareamplitude();
 	void testTwosided_normdB();
 	// performance
+	void testPlanCache();
+	void testPlanCacheMeasure();
+	void testPlanCacheEviction();
+
 	void testPerformance_onesided();
 	void testPerformance_twosided();
 private:
@@ -283,4 +283,45 @@ void NSLGeomTest::testLineSimMorse() {
 //#################  performance
 //##############################################################################
 
+void NSLGeomTest::testLineSimLarge() {
+	const size_t N = 1000000;
+	QScopedArrayPointer<double> xdata(new double[N]);
+	QScopedArrayPointer<double> ydata(new double[N]);
+	QScopedArrayPointer<size_t> index(new size_t[N]);
+	for (size_t i = 0; i < N; i++) {
+		xdata[i] = i;
+		ydata[i] = 100. * sin(i * 1.e-3) + (i * 7919 % 101) / 100.;
+	}
+
+	size_t nout;
+	printf("* minimum area (Visvalingam-Whyatt) N = %zu\n", N);
+	QBENCHMARK {
+		nout = nsl_geom_linesim_visvalingam_whyatt(xdata.data(), ydata.data(), N, 1., index.data());
+	}
+	printf("nout = %zu\n", nout);
+	QVERIFY(nout > 2 && nout < N);
+	QCOMPARE(index[0], (size_t)0);
+	QCOMPARE(index[nout-1], N-1);
+	for (size_t i = 1; i < nout; i++)
+		QVERIFY(index[i] > index[i-1]);
+
+	printf("* Simplification (Douglas Peucker) N = %zu\n", N);
+	nout = nsl_geom_linesim_douglas_peucker(xdata.data(), ydata.data(), N, 0.5, index.data());
+	printf("nout = %zu\n", nout);
+	QVERIFY(nout > 2 && nout < N);
+	QCOMPARE(index[0], (size_t)0);
+	QCOMPARE(index[nout-1], N-1);
+	for (size_t i = 1; i < nout; i++)
+		QVERIFY(index[i] > index[i-1]);
+
+	printf("* Simplification (Douglas Peucker variant) nout = %zu\n", nout);
+	const double tolout = nsl_geom_linesim_douglas_peucker_variant(xdata.data(), ydata.data(), N, nout, index.data());
+	printf("tolout = %.15g\n", tolout);
+	QVERIFY(tolout > 0.);
+	QCOMPARE(index[0], (size_t)0);
+	QCOMPARE(index[nout-1], N-1);
+	for (size_t i = 1; i < nout; i++)
+		QVERIFY(index[i] > index[i-1]);
+}
+
 QTEST_MAIN(NSLGeomTest)
@@ -38,6 +38,7 @@ private slots:
 	void testDist();
 	void testLineSim();
 	void testLineSimMorse();
+	void testLineSimLarge();
 	// performance
 	//void testPerformance();
 private:
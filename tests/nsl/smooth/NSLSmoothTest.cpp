@@ -29,8 +29,11 @@
 
 extern "C" {
 #include "backend/nsl/nsl_smooth.h"
+#include "backend/nsl/nsl_stats.h"
 }
 
+#include <random>
+
 //##############################################################################
 //#################  moving average tests
 //##############################################################################
@@ -43,7 +46,7 @@ void NSLSmoothTest::testMA_padnone() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {2, 3, 2.4, 2, 1.8, 1.6, 3, 14/3., 9};
 
-	int status = nsl_smooth_moving_average(data, N, points, weight, nsl_smooth_pad_none);
+	int status = nsl_smooth_moving_average(data, N, points, weight, nsl_smooth_pad_none, 0., 0.);
 	QCOMPARE(status, 0);
 	for(int i = 0; i < N; i++)
 		QCOMPARE(data[i], result[i]);
@@ -53,7 +56,7 @@ void NSLSmoothTest::testMA_padmirror() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {3.2, 2.6, 2.4, 2, 1.8, 1.6, 3, 3.6, 3.8};
 
-	int status = nsl_smooth_moving_average(data, N, points, weight, nsl_smooth_pad_mirror);
+	int status = nsl_smooth_moving_average(data, N, points, weight, nsl_smooth_pad_mirror, 0., 0.);
 	QCOMPARE(status, 0);
 	for(int i = 0; i < N; i++)
 		QCOMPARE(data[i], result[i]);
@@ -63,7 +66,7 @@ void NSLSmoothTest::testMA_padnearest() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {2.6, 2.6, 2.4, 2, 1.8, 1.6, 3, 4.6, 6.4};
 
-	int status = nsl_smooth_moving_average(data, N, points, weight, nsl_smooth_pad_nearest);
+	int status = nsl_smooth_moving_average(data, N, points, weight, nsl_smooth_pad_nearest, 0., 0.);
 	QCOMPARE(status, 0);
 	for(int i = 0; i < N; i++)
 		QCOMPARE(data[i], result[i]);
@@ -73,7 +76,7 @@ void NSLSmoothTest::testMA_padconstant() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {1.8, 2.2, 2.4, 2, 1.8, 1.6, 3, 2.8, 2.8};
 
-	int status = nsl_smooth_moving_average(data, N, points, weight, nsl_smooth_pad_constant);
+	int status = nsl_smooth_moving_average(data, N, points, weight, nsl_smooth_pad_constant, 0., 0.);
 	QCOMPARE(status, 0);
 	for(int i = 0; i < N; i++)
 		QCOMPARE(data[i], result[i]);
@@ -83,7 +86,7 @@ void NSLSmoothTest::testMA_padperiodic() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {4.4, 4, 2.4, 2, 1.8, 1.6, 3, 3.2, 3.6};
 
-	int status = nsl_smooth_moving_average(data, N, points, weight, nsl_smooth_pad_periodic);
+	int status = nsl_smooth_moving_average(data, N, points, weight, nsl_smooth_pad_periodic, 0., 0.);
 	QCOMPARE(status, 0);
 	for(int i = 0; i < N; i++)
 		QCOMPARE(data[i], result[i]);
@@ -97,7 +100,7 @@ void NSLSmoothTest::testMAL_padnone() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {2, 2, 3, 2.75, 2.4, 2, 1.8, 1.6, 3};
 
-	int status = nsl_smooth_moving_average_lagged(data, N, points, weight, nsl_smooth_pad_none);
+	int status = nsl_smooth_moving_average_lagged(data, N, points, weight, nsl_smooth_pad_none, 0.);
 	QCOMPARE(status, 0);
 	for(int i = 0; i < N; i++)
 		QCOMPARE(data[i], result[i]);
@@ -107,7 +110,7 @@ void NSLSmoothTest::testMAL_padmirror() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {2.4, 2.6, 3.2, 2.6, 2.4, 2, 1.8, 1.6, 3};
 
-	int status = nsl_smooth_moving_average_lagged(data, N, points, weight, nsl_smooth_pad_mirror);
+	int status = nsl_smooth_moving_average_lagged(data, N, points, weight, nsl_smooth_pad_mirror, 0.);
 	QCOMPARE(status, 0);
 	for(int i = 0; i < N; i++)
 		QCOMPARE(data[i], result[i]);
@@ -117,7 +120,7 @@ void NSLSmoothTest::testMAL_padnearest() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {2., 2., 2.6, 2.6, 2.4, 2, 1.8, 1.6, 3};
 
-	int status = nsl_smooth_moving_average_lagged(data, N, points, weight, nsl_smooth_pad_nearest);
+	int status = nsl_smooth_moving_average_lagged(data, N, points, weight, nsl_smooth_pad_nearest, 0.);
 	QCOMPARE(status, 0);
 	for(int i = 0; i < N; i++)
 		QCOMPARE(data[i], result[i]);
@@ -127,7 +130,7 @@ void NSLSmoothTest::testMAL_padconstant() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {0.4, 0.8, 1.8, 2.2, 2.4, 2, 1.8, 1.6, 3};
 
-	int status = nsl_smooth_moving_average_lagged(data, N, points, weight, nsl_smooth_pad_constant);
+	int status = nsl_smooth_moving_average_lagged(data, N, points, weight, nsl_smooth_pad_constant, 0.);
 	QCOMPARE(status, 0);
 	for(int i = 0; i < N; i++)
 		QCOMPARE(data[i], result[i]);
@@ -137,7 +140,7 @@ void NSLSmoothTest::testMAL_padperiodic() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {3.2, 3.6, 4.4, 4, 2.4, 2, 1.8, 1.6, 3};
 
-	int status = nsl_smooth_moving_average_lagged(data, N, points, weight, nsl_smooth_pad_periodic);
+	int status = nsl_smooth_moving_average_lagged(data, N, points, weight, nsl_smooth_pad_periodic, 0.);
 	QCOMPARE(status, 0);
 	for(int i = 0; i < N; i++)
 		QCOMPARE(data[i], result[i]);
@@ -153,7 +156,7 @@ void NSLSmoothTest::testPercentile_padnone() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {2, 2, 2, 1.5, 1, 1, 1, 2.5, 9};
 
-	int status = nsl_smooth_percentile(data, N, points, percentile, nsl_smooth_pad_none);
+	int status = nsl_smooth_percentile(data, N, points, percentile, nsl_smooth_pad_none, 0., 0.);
 	QCOMPARE(status, 0);
 	for(int i = 0; i < N; i++)
 		QCOMPARE(data[i], result[i]);
@@ -163,7 +166,7 @@ void NSLSmoothTest::testPercentile_padmirror() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {2, 2, 2, 1.5, 1, 1, 1, 2.5, 2.5};
 
-	int status = nsl_smooth_percentile(data, N, points, percentile, nsl_smooth_pad_mirror);
+	int status = nsl_smooth_percentile(data, N, points, percentile, nsl_smooth_pad_mirror, 0., 0.);
 	QCOMPARE(status, 0);
 	for(int i = 0; i < N; i++)
 		QCOMPARE(data[i], result[i]);
@@ -173,7 +176,7 @@ void NSLSmoothTest::testPercentile_padnearest() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {2, 2, 2, 1.5, 1, 1, 1, 2.5, 6.5};
 
-	int status = nsl_smooth_percentile(data, N, points, percentile, nsl_smooth_pad_nearest);
+	int status = nsl_smooth_percentile(data, N, points, percentile, nsl_smooth_pad_nearest, 0., 0.);
 	QCOMPARE(status, 0);
 	for(int i = 0; i < N; i++)
 		QCOMPARE(data[i], result[i]);
@@ -183,7 +186,7 @@ void NSLSmoothTest::testPercentile_padconstant() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {1, 2, 2, 1.5, 1, 1, 1, 0.5, 0.5};
 
-	int status = nsl_smooth_percentile(data, N, points, percentile, nsl_smooth_pad_constant);
+	int status = nsl_smooth_percentile(data, N, points, percentile, nsl_smooth_pad_constant, 0., 0.);
 	QCOMPARE(status, 0);
 	for(int i = 0; i < N; i++)
 		QCOMPARE(data[i], result[i]);
@@ -193,12 +196,66 @@ void NSLSmoothTest::testPercentile_padperiodic() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {3, 2, 2, 1.5, 1, 1, 1, 1.5, 2};
 
-	int status = nsl_smooth_percentile(data, N, points, percentile, nsl_smooth_pad_periodic);
+	int status = nsl_smooth_percentile(data, N, points, percentile, nsl_smooth_pad_periodic, 0., 0.);
 	QCOMPARE(status, 0);
 	for(int i = 0; i < N; i++)
 		QCOMPARE(data[i], result[i]);
 }
 
+// compare with the quantile of each window sorted separately
+void NSLSmoothTest::testPercentile_reference() {
+	const int n = 200;
+	const nsl_smooth_pad_mode modes[] = {nsl_smooth_pad_none, nsl_smooth_pad_mirror, nsl_smooth_pad_nearest,
+		nsl_smooth_pad_constant, nsl_smooth_pad_periodic};
+	const double percentiles[] = {0., 0.1, 0.5, 0.75, 1.};
+	const double lvalue = -2., rvalue = 3.;
+
+	std::mt19937 rng(1);
+	std::uniform_int_distribution<int> dist(-5, 5);	// many equal values
+	double input[n];
+	for (int i = 0; i < n; i++)
+		input[i] = dist(rng) / 2.;
+
+	for (auto mode : modes) {
+		for (int np : {1, 2, 4, 5, 16, 51}) {
+			for (double p : percentiles) {
+				double data[n];
+				std::copy(input, input + n, data);
+				int status = nsl_smooth_percentile(data, n, np, p, mode, lvalue, rvalue);
+				QCOMPARE(status, 0);
+
+				for (int i = 0; i < n; i++) {
+					int half = (np - 1)/2, size = np;
+					if (mode == nsl_smooth_pad_none) {
+						half = std::min(std::min(half, i), n - i - 1);
+						size = 2*half + 1;
+					}
+					std::vector<double> values;
+					for (int j = i - half; j < i - half + size; j++) {
+						if (j < 0) {
+							switch (mode) {
+							case nsl_smooth_pad_mirror: values.push_back(input[-j]); break;
+							case nsl_smooth_pad_nearest: values.push_back(input[0]); break;
+							case nsl_smooth_pad_constant: values.push_back(lvalue); break;
+							default: values.push_back(input[j + n]);
+							}
+						} else if (j > n - 1) {
+							switch (mode) {
+							case nsl_smooth_pad_mirror: values.push_back(input[2*(n-1) - j]); break;
+							case nsl_smooth_pad_nearest: values.push_back(input[n-1]); break;
+							case nsl_smooth_pad_constant: values.push_back(rvalue); break;
+							default: values.push_back(input[j - n]);
+							}
+						} else
+							values.push_back(input[j]);
+					}
+					QCOMPARE(data[i], nsl_stats_quantile(values.data(), 1, values.size(), p, nsl_stats_quantile_type4));
+				}
+			}
+		}
+	}
+}
+
 //##############################################################################
 //#################  Savitzky-Golay coeff tests
 //##############################################################################
@@ -313,7 +370,7 @@ void NSLSmoothTest::testSG_mode_interp() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {1.65714285714286, 3.17142857142857, 3.54285714285714, 2.85714285714285, 0.65714285714287, 0.17142857142858, 1., 4., 9.};
 
-	int status = nsl_smooth_savgol(data, n, m, order, nsl_smooth_pad_interp);
+	int status = nsl_smooth_savgol(data, n, m, order, nsl_smooth_pad_interp, 0., 0.);
 	QCOMPARE(status, 0);
 
 	for(int i = 0; i < n; i++)
@@ -325,7 +382,7 @@ void NSLSmoothTest::testSG_mode_mirror() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {1.48571428571430, 3.02857142857143, 3.542857142857, 2.857142857143, 0.657142857143, 0.171428571429, 1., 5.02857142857142, 6.94285714285713};
 
-	int status = nsl_smooth_savgol(data, n, m, order, nsl_smooth_pad_mirror);
+	int status = nsl_smooth_savgol(data, n, m, order, nsl_smooth_pad_mirror, 0., 0.);
 	QCOMPARE(status, 0);
 
 	for(int i = 0; i < n; i++)
@@ -337,7 +394,7 @@ void NSLSmoothTest::testSG_mode_nearest() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {1.74285714285715, 3.02857142857143, 3.542857142857, 2.857142857143, 0.657142857143, 0.171428571429, 1., 4.6, 7.97142857142856};
 
-	int status = nsl_smooth_savgol(data, n, m, order, nsl_smooth_pad_nearest);
+	int status = nsl_smooth_savgol(data, n, m, order, nsl_smooth_pad_nearest, 0., 0.);
 	QCOMPARE(status, 0);
 
 	for(int i = 0; i < n; i++)
@@ -349,7 +406,7 @@ void NSLSmoothTest::testSG_mode_constant() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {1.22857142857143, 3.2, 3.542857142857, 2.857142857143, 0.657142857143, 0.171428571429, 1., 5.37142857142855, 5.65714285714284};
 
-	int status = nsl_smooth_savgol(data, n, m, order, nsl_smooth_pad_constant);
+	int status = nsl_smooth_savgol(data, n, m, order, nsl_smooth_pad_constant, 0., 0.);
 	QCOMPARE(status, 0);
 
 	for(int i = 0; i < n; i++)
@@ -361,7 +418,7 @@ void NSLSmoothTest::testSG_mode_periodic() {
 	double data[] = {2, 2, 5, 2, 1, 0, 1, 4, 9};
 	double result[] = {3.97142857142858, 2.42857142857144, 3.542857142857, 2.857142857143, 0.657142857143, 0.171428571429, 1., 5.2, 6.17142857142856};
 
-	int status = nsl_smooth_savgol(data, n, m, order, nsl_smooth_pad_periodic);
+	int status = nsl_smooth_savgol(data, n, m, order, nsl_smooth_pad_periodic, 0., 0.);
 	QCOMPARE(status, 0);
 
 	for(int i = 0; i < n; i++)
@@ -381,7 +438,7 @@ void NSLSmoothTest::testPerformance_interp() {
 	QBENCHMARK {
 		for (int i = 0;  i < nn; i++)
 			data[i] = i;
-		int status = nsl_smooth_savgol(data.data(), nn, m, order, nsl_smooth_pad_interp);
+		int status = nsl_smooth_savgol(data.data(), nn, m, order, nsl_smooth_pad_interp, 0., 0.);
 		QCOMPARE(status, 0);
 	}
 }
@@ -392,7 +449,7 @@ void NSLSmoothTest::testPerformance_mirror() {
 	QBENCHMARK {
 		for (int i = 0;  i < nn; i++)
 			data[i] = i;
-		int status = nsl_smooth_savgol(data.data(), nn, m, order, nsl_smooth_pad_mirror);
+		int status = nsl_smooth_savgol(data.data(), nn, m, order, nsl_smooth_pad_mirror, 0., 0.);
 		QCOMPARE(status, 0);
 	}
 }
@@ -403,7 +460,7 @@ void NSLSmoothTest::testPerformance_nearest() {
 	QBENCHMARK {
 		for (int i = 0;  i < nn; i++)
 			data[i] = i;
-		int status = nsl_smooth_savgol(data.data(), nn, m, order, nsl_smooth_pad_nearest);
+		int status = nsl_smooth_savgol(data.data(), nn, m, order, nsl_smooth_pad_nearest, 0., 0.);
 		QCOMPARE(status, 0);
 	}
 }
@@ -414,7 +471,7 @@ void NSLSmoothTest::testPerformance_constant() {
 	QBENCHMARK {
 		for (int i = 0;  i < nn; i++)
 			data[i] = i;
-		int status = nsl_smooth_savgol(data.data(), nn, m, order, nsl_smooth_pad_constant);
+		int status = nsl_smooth_savgol(data.data(), nn, m, order, nsl_smooth_pad_constant, 0., 0.);
 		QCOMPARE(status, 0);
 	}
 }
@@ -425,7 +482,18 @@ void NSLSmoothTest::testPerformance_periodic() {
 	QBENCHMARK {
 		for (int i = 0;  i < nn; i++)
 			data[i] = i;
-		int status = nsl_smooth_savgol(data.data(), nn, m, order, nsl_smooth_pad_periodic);
+		int status = nsl_smooth_savgol(data.data(), nn, m, order, nsl_smooth_pad_periodic, 0., 0.);
+		QCOMPARE(status, 0);
+	}
+}
+
+void NSLSmoothTest::testPerformance_percentile() {
+	QScopedArrayPointer<double> data(new double[nn]);
+
+	QBENCHMARK {
+		for (int i = 0;  i < nn; i++)
+			data[i] = (i * 37) % 1001;
+		int status = nsl_smooth_percentile(data.data(), nn, 1001, 0.5, nsl_smooth_pad_mirror, 0., 0.);
 		QCOMPARE(status, 0);
 	}
 }